@@ -49,11 +49,46 @@
 namespace dart {
 namespace collision {
 
+namespace {
+
+/// Copy _from to _to. The manifolds of the pairs in both maps are assigned in
+/// place, which keeps the map nodes and the feature buffers of _to.
+void copyContactManifolds(const CollisionDetector::ContactManifoldMap& _from,
+                          CollisionDetector::ContactManifoldMap& _to) {
+  if (&_from == &_to)
+    return;
+
+  auto to = _to.begin();
+  for (const auto& entry : _from) {
+    while (to != _to.end() && to->first < entry.first)
+      to = _to.erase(to);
+
+    if (to != _to.end() && to->first == entry.first) {
+      to->second = entry.second;
+      ++to;
+    } else {
+      _to.insert(to, entry);
+    }
+  }
+
+  _to.erase(to, _to.end());
+}
+
+}  // anonymous namespace
+
 CollisionDetector::CollisionDetector()
-  : mNumMaxContacts(100) {
+  : mNumMaxContacts(100),
+#ifdef DART_ENABLE_PROFILING
+    mProfiler(nullptr),
+#endif
+    mNextContactManifoldId(0),
+    mContactMatchingTolerance(1e-2) {
 }
 
 CollisionDetector::~CollisionDetector() {
+  for (auto& entry : mStructuralChangeConnections)
+    entry.second.disconnect();
+
   for (size_t i = 0; i < mCollisionNodes.size(); i++)
     delete mCollisionNodes[i];
 }
@@ -128,9 +163,28 @@ void CollisionDetector::addCollisionSkeletonNode(dynamics::BodyNode* _bodyNode,
   // Add the collision node to map (BodyNode -> CollisionNode)
   mBodyCollisionMap[_bodyNode] = collNode;
 
-  // Add collidable pairs for the collision node
-  mCollidablePairs.push_back(
-        std::vector<bool>(mCollisionNodes.size() - 1, true));
+  // Add the collision node to the filter, where it is adjacent to the
+  // collision nodes of its parent and children
+  mCollisionFilter.addObject(_bodyNode->getSkeleton().get());
+
+  CollisionNode* parentNode = getCollisionNode(_bodyNode->getParentBodyNode());
+  if (parentNode)
+    mCollisionFilter.setParent(collNode->getIndex(), parentNode->getIndex());
+
+  for (size_t i = 0; i < _bodyNode->getNumChildBodyNodes(); ++i)
+  {
+    CollisionNode* childNode
+        = getCollisionNode(_bodyNode->getChildBodyNode(i));
+    if (childNode)
+      mCollisionFilter.setParent(childNode->getIndex(), collNode->getIndex());
+  }
+
+  // The skeleton and the parent change when the body node is moved
+  mStructuralChangeConnections[_bodyNode]
+      = _bodyNode->onStructuralChange.connect(
+          [this](const dynamics::BodyNode* _changedBodyNode) {
+            updateCollisionFilter(_changedBodyNode);
+          });
 
   if (_isRecursive) {
     for (size_t i = 0; i < _bodyNode->getNumChildBodyNodes(); i++)
@@ -164,17 +218,36 @@ void CollisionDetector::removeCollisionSkeletonNode(
   // Remove collNode-_bodyNode pair from mBodyCollisionMap
   mBodyCollisionMap.erase(_bodyNode);
 
+  const auto connection = mStructuralChangeConnections.find(_bodyNode);
+  if (connection != mStructuralChangeConnections.end()) {
+    connection->second.disconnect();
+    mStructuralChangeConnections.erase(connection);
+  }
+
   // Delete collNode
   delete collNode;
 
-  // Update mCollidablePairs
-  for (size_t i = iCollNode + 1; i < mCollidablePairs.size(); ++i) {
-    for (size_t j = 0; j < iCollNode; ++j)
-      mCollidablePairs[i-1][j] = mCollidablePairs[i][j];
-    for (size_t j = iCollNode + 1; j < mCollidablePairs[i].size(); ++j)
-      mCollidablePairs[i-1][j-1] = mCollidablePairs[i][j];
+  // Update the filter
+  mCollisionFilter.removeObject(iCollNode);
+
+  // Remove the contact manifolds of collNode, and shift the indices of the
+  // following collision nodes in the keys of the others
+  ContactManifoldMap manifolds;
+  for (const auto& entry : mContactManifolds) {
+    size_t index1 = entry.first.first;
+    size_t index2 = entry.first.second;
+    if (index1 == iCollNode || index2 == iCollNode)
+      continue;
+
+    if (index1 > iCollNode)
+      --index1;
+    if (index2 > iCollNode)
+      --index2;
+    manifolds.insert(manifolds.end(),
+                     std::make_pair(std::make_pair(index1, index2),
+                                    entry.second));
   }
-  mCollidablePairs.pop_back();
+  mContactManifolds.swap(manifolds);
 
   if (_isRecursive) {
     for (size_t i = 0; i < _bodyNode->getNumChildBodyNodes(); i++)
@@ -202,6 +275,14 @@ void CollisionDetector::clearAllContacts() {
   mContacts.clear();
 }
 
+const std::vector<Contact>& CollisionDetector::getContacts() const {
+  return mContacts;
+}
+
+void CollisionDetector::setContacts(const std::vector<Contact>& _contacts) {
+  mContacts = _contacts;
+}
+
 int CollisionDetector::getNumMaxContacts() const {
   return mNumMaxContacts;
 }
@@ -210,131 +291,263 @@ void CollisionDetector::setNumMaxContacs(int _num) {
   mNumMaxContacts = _num;
 }
 
+void CollisionDetector::setContactMergeTolerance(double _tolerance) {
+  mContactReduction.setTolerance(_tolerance);
+}
+
+double CollisionDetector::getContactMergeTolerance() const {
+  return mContactReduction.getTolerance();
+}
+
+void CollisionDetector::setMaxNumContactsPerPair(size_t _num) {
+  mContactReduction.setMaxNumContacts(_num);
+}
+
+size_t CollisionDetector::getMaxNumContactsPerPair() const {
+  return mContactReduction.getMaxNumContacts();
+}
+
+void CollisionDetector::reduceContacts(size_t _begin) {
+  mContactReduction.reduce(mContacts, _begin);
+}
+
+size_t CollisionDetector::getNumContactManifolds() const {
+  return mContactManifolds.size();
+}
+
+const CollisionDetector::ContactManifoldMap&
+CollisionDetector::getContactManifolds() const {
+  return mContactManifolds;
+}
+
+void CollisionDetector::getContactManifolds(
+    ContactManifoldMap& _manifolds) const {
+  copyContactManifolds(mContactManifolds, _manifolds);
+}
+
+void CollisionDetector::setContactManifolds(
+    const ContactManifoldMap& _manifolds) {
+  copyContactManifolds(_manifolds, mContactManifolds);
+
+  // Keep the IDs of new manifolds unique
+  for (const auto& entry : mContactManifolds) {
+    mNextContactManifoldId = std::max(mNextContactManifoldId,
+                                      entry.second.getId() + 1);
+  }
+}
+
+void CollisionDetector::clearContactManifolds() {
+  mContacts.clear();
+  mContactManifolds.clear();
+  mNextContactManifoldId = 0;
+}
+
+void CollisionDetector::setContactMatchingTolerance(double _tolerance) {
+  mContactMatchingTolerance = _tolerance;
+}
+
+double CollisionDetector::getContactMatchingTolerance() const {
+  return mContactMatchingTolerance;
+}
+
+void CollisionDetector::updateContactManifolds() {
+  for (auto& entry : mContactManifolds)
+    entry.second.beginUpdate();
+
+  for (Contact& contact : mContacts) {
+    const dynamics::BodyNodePtr bodyNode1 = contact.bodyNode1.lock();
+    const dynamics::BodyNodePtr bodyNode2 = contact.bodyNode2.lock();
+    const size_t index1 = getCollisionNode(bodyNode1.get())->getIndex();
+    const size_t index2 = getCollisionNode(bodyNode2.get())->getIndex();
+
+    // The contact points are expressed in the frame of the body node whose
+    // collision node has the smaller index, so the manifold doesn't depend on
+    // the order of the body nodes of the contacts
+    const bool isSwapped = index2 < index1;
+    const auto key = isSwapped ? std::make_pair(index2, index1)
+                               : std::make_pair(index1, index2);
+
+    auto it = mContactManifolds.find(key);
+    if (it == mContactManifolds.end()) {
+      it = mContactManifolds.insert(
+            std::make_pair(key, ContactManifold(mNextContactManifoldId++)))
+          .first;
+      it->second.beginUpdate();
+    }
+
+    const dynamics::BodyNode* firstBodyNode
+        = isSwapped ? bodyNode2.get() : bodyNode1.get();
+    const Eigen::Vector3d localPoint
+        = firstBodyNode->getTransform().inverse() * contact.point;
+    it->second.addContact(contact, localPoint, isSwapped,
+                          mContactMatchingTolerance);
+  }
+
+  // Remove the manifolds of the pairs that are not in contact anymore
+  for (auto it = mContactManifolds.begin(); it != mContactManifolds.end();) {
+    if (it->second.endUpdate())
+      ++it;
+    else
+      it = mContactManifolds.erase(it);
+  }
+}
+
+#ifdef DART_ENABLE_PROFILING
+void CollisionDetector::setProfiler(common::Profiler* _profiler) {
+  mProfiler = _profiler;
+}
+
+common::Profiler* CollisionDetector::getProfiler() const {
+  return mProfiler;
+}
+#endif
+
 void CollisionDetector::enablePair(dynamics::BodyNode* _node1,
                                    dynamics::BodyNode* _node2) {
   CollisionNode* collisionNode1 = getCollisionNode(_node1);
   CollisionNode* collisionNode2 = getCollisionNode(_node2);
-  if (collisionNode1 && collisionNode2)
-    setPairCollidable(collisionNode1, collisionNode2, true);
+  if (collisionNode1 && collisionNode2 && collisionNode1 != collisionNode2)
+  {
+    mCollisionFilter.setPairEnabled(collisionNode1->getIndex(),
+                                    collisionNode2->getIndex(), true);
+  }
 }
 
 void CollisionDetector::disablePair(dynamics::BodyNode* _node1,
                                     dynamics::BodyNode* _node2) {
   CollisionNode* collisionNode1 = getCollisionNode(_node1);
   CollisionNode* collisionNode2 = getCollisionNode(_node2);
-  if (collisionNode1 && collisionNode2)
-    setPairCollidable(collisionNode1, collisionNode2, false);
+  if (collisionNode1 && collisionNode2 && collisionNode1 != collisionNode2)
+  {
+    mCollisionFilter.setPairEnabled(collisionNode1->getIndex(),
+                                    collisionNode2->getIndex(), false);
+  }
 }
 
 //==============================================================================
 bool CollisionDetector::isCollidable(const CollisionNode* _node1,
                                      const CollisionNode* _node2)
 {
-  dynamics::BodyNode* bn1 = _node1->getBodyNode();
-  dynamics::BodyNode* bn2 = _node2->getBodyNode();
+  const size_t index1 = _node1->getIndex();
+  const size_t index2 = _node2->getIndex();
 
-  if (!getPairCollidable(_node1, _node2))
+  // The pair flags and the groups are checked first since they don't access
+  // the body nodes
+  if (!mCollisionFilter.isCollidable(index1, index2))
     return false;
 
-  if (!bn1->isCollidable() || !bn2->isCollidable())
+  if (!_node1->getBodyNode()->isCollidable()
+      || !_node2->getBodyNode()->isCollidable())
     return false;
 
-  if (bn1->getSkeleton() == bn2->getSkeleton())
+  // Sleeping skeletons only collide with awake mobile skeletons, which can
+  // wake them up. The constraint solver detects the collisions again after
+  // waking them up, so their other contacts are found in the same step.
+  const dynamics::Skeleton* skel1 = mCollisionFilter.getSkeleton(index1);
+  const dynamics::Skeleton* skel2 = mCollisionFilter.getSkeleton(index2);
+  if (skel1->isSleeping() || skel2->isSleeping())
   {
-    if (bn1->getSkeleton()->isEnabledSelfCollisionCheck())
-    {
-      if (isAdjacentBodies(bn1, bn2))
-      {
-        if (!bn1->getSkeleton()->isEnabledAdjacentBodyCheck())
-          return false;
-      }
-    }
-    else
-    {
+    const bool isAwake1 = !skel1->isSleeping() && skel1->isMobile();
+    const bool isAwake2 = !skel2->isSleeping() && skel2->isMobile();
+    if (!isAwake1 && !isAwake2)
       return false;
-    }
   }
 
-  return true;
-}
-
-//==============================================================================
-bool CollisionDetector::containSkeleton(const dynamics::SkeletonPtr& _skeleton)
-{
-  for (std::vector<dynamics::SkeletonPtr>::const_iterator it = mSkeletons.begin();
-       it != mSkeletons.end(); ++it)
+  if (mCollisionFilter.isSameSkeleton(index1, index2))
   {
-    if ((*it) == _skeleton)
-      return true;
+    const dynamics::Skeleton* skel = skel1;
+
+    if (!skel->isEnabledSelfCollisionCheck())
+      return false;
+
+    if (mCollisionFilter.isAdjacent(index1, index2)
+        && !skel->isEnabledAdjacentBodyCheck())
+      return false;
   }
 
-  return false;
+  return true;
 }
 
-bool isValidIndex(const std::vector<std::vector<bool>>& _collidablePairs,
-                  const std::size_t _index1,
-                  const std::size_t _index2)
+//==============================================================================
+void CollisionDetector::updateCollisionFilter(
+    const dynamics::BodyNode* _bodyNode)
 {
-  assert(_index1 >= _index2);
+  CollisionNode* collisionNode = getCollisionNode(_bodyNode);
+  if (collisionNode == nullptr)
+    return;
 
-  if (_collidablePairs.size() > _index1
-      && _collidablePairs[_index1].size() > _index2)
-    return true;
+  const size_t index = collisionNode->getIndex();
+  mCollisionFilter.setSkeleton(index, _bodyNode->getSkeleton().get());
 
-  return false;
+  CollisionNode* parentNode = getCollisionNode(_bodyNode->getParentBodyNode());
+  mCollisionFilter.setParent(
+        index, parentNode ? parentNode->getIndex() : CollisionFilter::NO_PARENT);
 }
 
-bool CollisionDetector::getPairCollidable(const CollisionNode* _node1,
-                                          const CollisionNode* _node2)
+//==============================================================================
+void CollisionDetector::setCollisionGroup(const dynamics::BodyNode* _bodyNode,
+                                          uint32_t _group, uint32_t _mask)
 {
-  assert(_node1 != _node2);
-
-  size_t index1 = _node1->getIndex();
-  size_t index2 = _node2->getIndex();
-
-  if (index1 < index2)
-    std::swap(index1, index2);
+  CollisionNode* collisionNode = getCollisionNode(_bodyNode);
+  if (collisionNode == nullptr)
+  {
+    dtwarn << "[CollisionDetector::setCollisionGroup] BodyNode ["
+           << _bodyNode->getName() << "] is not in the collision detector.\n";
+    return;
+  }
 
-  // Index validity check. The indices are not valid if the body nodes are not
-  // completely added to the collision detector yet.
-  if (!isValidIndex(mCollidablePairs, index1, index2))
-    return false;
+  mCollisionFilter.setGroup(collisionNode->getIndex(), _group, _mask);
+}
 
-  if (index1 == index2)
-    return false;
-  
-  return mCollidablePairs[index1][index2];
+//==============================================================================
+void CollisionDetector::setCollisionGroup(
+    const dynamics::SkeletonPtr& _skeleton, uint32_t _group, uint32_t _mask)
+{
+  for (size_t i = 0; i < _skeleton->getNumBodyNodes(); ++i)
+  {
+    CollisionNode* collisionNode
+        = getCollisionNode(_skeleton->getBodyNode(i));
+    if (collisionNode)
+      mCollisionFilter.setGroup(collisionNode->getIndex(), _group, _mask);
+  }
 }
 
-void CollisionDetector::setPairCollidable(const CollisionNode* _node1,
-                                          const CollisionNode* _node2,
-                                          bool _val)
+//==============================================================================
+uint32_t CollisionDetector::getCollisionGroup(
+    const dynamics::BodyNode* _bodyNode)
 {
-  assert(_node1 != _node2);
+  CollisionNode* collisionNode = getCollisionNode(_bodyNode);
+  if (collisionNode == nullptr)
+    return 0;
 
-  size_t index1 = _node1->getIndex();
-  size_t index2 = _node2->getIndex();
+  return mCollisionFilter.getGroup(collisionNode->getIndex());
+}
 
-  if (index1 < index2)
-    std::swap(index1, index2);
+//==============================================================================
+uint32_t CollisionDetector::getCollisionMask(
+    const dynamics::BodyNode* _bodyNode)
+{
+  CollisionNode* collisionNode = getCollisionNode(_bodyNode);
+  if (collisionNode == nullptr)
+    return 0;
 
-  // Index validity check. The indices are not valid if the body nodes are not
-  // completely added to the collision detector yet.
-  if (!isValidIndex(mCollidablePairs, index1, index2))
-    return;
+  return mCollisionFilter.getMask(collisionNode->getIndex());
+}
 
-  mCollidablePairs[index1][index2] = _val;
+//==============================================================================
+const CollisionFilter& CollisionDetector::getCollisionFilter() const
+{
+  return mCollisionFilter;
 }
 
-bool CollisionDetector::isAdjacentBodies(
-    const dynamics::BodyNode* _bodyNode1,
-    const dynamics::BodyNode* _bodyNode2) const
+//==============================================================================
+bool CollisionDetector::containSkeleton(const dynamics::SkeletonPtr& _skeleton)
 {
-  if ((_bodyNode1->getParentBodyNode() == _bodyNode2)
-      || (_bodyNode2->getParentBodyNode() == _bodyNode1))
+  for (std::vector<dynamics::SkeletonPtr>::const_iterator it = mSkeletons.begin();
+       it != mSkeletons.end(); ++it)
   {
-    assert(_bodyNode1->getSkeleton() == _bodyNode2->getSkeleton());
-    return true;
+    if ((*it) == _skeleton)
+      return true;
   }
 
   return false;
@@ -342,8 +555,9 @@ bool CollisionDetector::isAdjacentBodies(
 
 CollisionNode* CollisionDetector::getCollisionNode(
     const dynamics::BodyNode* _bodyNode) {
-  if (mBodyCollisionMap.find(_bodyNode) != mBodyCollisionMap.end())
-    return mBodyCollisionMap[_bodyNode];
+  const auto it = mBodyCollisionMap.find(_bodyNode);
+  if (it != mBodyCollisionMap.end())
+    return it->second;
   else
     return nullptr;
 }
@@ -43,7 +43,12 @@
 
 #include <Eigen/Dense>
 
+#include "dart/common/Profiler.h"
+#include "dart/common/Signal.h"
+#include "dart/collision/CollisionFilter.h"
 #include "dart/collision/CollisionNode.h"
+#include "dart/collision/ContactManifold.h"
+#include "dart/collision/ContactReduction.h"
 #include "dart/dynamics/SmartPointer.h"
 
 namespace dart {
@@ -81,6 +86,15 @@ struct Contact {
   /// Penetration depth
   double penetrationDepth;
 
+  /// ID of the manifold of this contact. The contacts between the same pair
+  /// of body nodes share the manifold ID, which persists over time steps while
+  /// the body nodes are in contact.
+  size_t manifoldId;
+
+  /// ID of this contact in its manifold, which persists over time steps while
+  /// the contact point stays at the same place on the body nodes
+  size_t featureId;
+
   // TODO(JS): triID1 will be deprecated when we don't use fcl_mesh
   /// \brief
   int triID1;
@@ -98,6 +112,11 @@ struct Contact {
 class CollisionDetector
 {
 public:
+  /// Contact manifolds keyed by the indices of the collision nodes of their
+  /// pairs, where the first index is smaller than the second one
+  typedef std::map<std::pair<size_t, size_t>, ContactManifold>
+      ContactManifoldMap;
+
   /// \brief Constructor
   CollisionDetector();
 
@@ -152,6 +171,13 @@ public:
   /// \brief
   void clearAllContacts();
 
+  /// Get the contacts found by the last collision detection
+  const std::vector<Contact>& getContacts() const;
+
+  /// Replace the contacts found by the last collision detection, for example
+  /// to restore a snapshot of a world
+  void setContacts(const std::vector<Contact>& _contacts);
+
   /// \brief
   int getNumMaxContacts() const;
 
@@ -161,11 +187,98 @@ public:
   /// \brief
   bool isCollidable(const CollisionNode* _node1, const CollisionNode* _node2);
 
+  /// Set the collision group and mask of _bodyNode. Two body nodes are only
+  /// checked for collision if the group of each body node shares a bit with
+  /// the mask of the other. By default, every body node is in
+  /// CollisionFilter::DEFAULT_GROUP and its mask is CollisionFilter::ALL_GROUPS.
+  void setCollisionGroup(const dynamics::BodyNode* _bodyNode, uint32_t _group,
+                         uint32_t _mask = CollisionFilter::ALL_GROUPS);
+
+  /// Set the collision group and mask of all the body nodes of _skeleton that
+  /// are in this collision detector. The body nodes that are added to the
+  /// collision detector afterwards, for example when the skeleton grows, are
+  /// in the default group until their groups are set.
+  void setCollisionGroup(const dynamics::SkeletonPtr& _skeleton,
+                         uint32_t _group,
+                         uint32_t _mask = CollisionFilter::ALL_GROUPS);
+
+  /// Get the collision group of _bodyNode
+  uint32_t getCollisionGroup(const dynamics::BodyNode* _bodyNode);
+
+  /// Get the collision mask of _bodyNode
+  uint32_t getCollisionMask(const dynamics::BodyNode* _bodyNode);
+
+  /// Get the filter of the pairs of collision nodes, which is indexed by the
+  /// indices of the collision nodes
+  const CollisionFilter& getCollisionFilter() const;
+
+  /// Set the distance under which the contacts between a pair of body nodes
+  /// are merged into one contact
+  void setContactMergeTolerance(double _tolerance);
+
+  /// Get the distance under which the contacts between a pair of body nodes
+  /// are merged into one contact
+  double getContactMergeTolerance() const;
+
+  /// Set the maximum number of contacts between a pair of body nodes. The
+  /// deepest contact and the contacts that span the largest area are kept.
+  /// Every contact is kept if _num is zero, which is the default.
+  void setMaxNumContactsPerPair(size_t _num);
+
+  /// Get the maximum number of contacts between a pair of body nodes
+  size_t getMaxNumContactsPerPair() const;
+
+  /// Get the number of the pairs of body nodes in contact
+  size_t getNumContactManifolds() const;
+
+  /// Get the contact manifolds of the pairs of body nodes in contact
+  const ContactManifoldMap& getContactManifolds() const;
+
+  /// Copy the contact manifolds to _manifolds. The entries and the buffers of
+  /// the pairs that are already in _manifolds are reused, so copying the
+  /// manifolds of the same pairs repeatedly doesn't allocate memory.
+  void getContactManifolds(ContactManifoldMap& _manifolds) const;
+
+  /// Replace the contact manifolds, for example to restore a snapshot of a
+  /// world along with the contacts. The manifolds of the pairs that are in
+  /// both this collision detector and _manifolds are overwritten in place.
+  void setContactManifolds(const ContactManifoldMap& _manifolds);
+
+  /// Clear the contacts and the contact manifolds. The contacts found next are
+  /// not matched to any earlier contact, and the manifold IDs start over.
+  void clearContactManifolds();
+
+  /// Set the distance that a contact point can move on the body nodes between
+  /// time steps while it keeps its feature ID
+  void setContactMatchingTolerance(double _tolerance);
+
+  /// Get the distance that a contact point can move on the body nodes between
+  /// time steps while it keeps its feature ID
+  double getContactMatchingTolerance() const;
+
+#ifdef DART_ENABLE_PROFILING
+  /// Set the profiler that the broadphase and the narrowphase are reported
+  /// to. Nothing is reported if _profiler is nullptr.
+  void setProfiler(common::Profiler* _profiler);
+
+  /// Get the profiler
+  common::Profiler* getProfiler() const;
+#endif
+
 protected:
   /// \brief
   virtual bool detectCollision(CollisionNode* _node1, CollisionNode* _node2,
                                bool _calculateContactPoints) = 0;
 
+  /// Merge and reduce mContacts[_begin], ..., mContacts.back(), which are the
+  /// contacts between a pair of body nodes
+  void reduceContacts(size_t _begin);
+
+  /// Update the contact manifolds with mContacts, and set the manifold IDs and
+  /// the feature IDs of the contacts. The manifolds of the pairs that are not
+  /// in contact anymore are removed.
+  void updateContactManifolds();
+
   /// \brief
   std::vector<Contact> mContacts;
 
@@ -178,31 +291,45 @@ protected:
   /// \brief Skeleton array
   std::vector<dynamics::SkeletonPtr> mSkeletons;
 
-private:
-  /// \brief Return true if _skeleton is contained
-  bool containSkeleton(const dynamics::SkeletonPtr& _skeleton);
+#ifdef DART_ENABLE_PROFILING
+  /// Profiler
+  common::Profiler* mProfiler;
+#endif
 
-  /// \brief
-  bool getPairCollidable(const CollisionNode* _node1,
-                         const CollisionNode* _node2);
+  /// Reduction of the contacts between each pair of body nodes
+  ContactReduction mContactReduction;
 
-  /// \brief
-  void setPairCollidable(const CollisionNode* _node1,
-                         const CollisionNode* _node2,
-                         bool _val);
+  /// Contact manifolds of the pairs of body nodes in contact
+  ContactManifoldMap mContactManifolds;
+
+  /// ID of the next new contact manifold
+  size_t mNextContactManifoldId;
 
-  /// \brief Return true if _bodyNode1 and _bodyNode2 are adjacent bodies
-  bool isAdjacentBodies(const dynamics::BodyNode* _bodyNode1,
-                        const dynamics::BodyNode* _bodyNode2) const;
+  /// Distance that a contact point can move while it keeps its feature ID
+  double mContactMatchingTolerance;
+
+private:
+  /// \brief Return true if _skeleton is contained
+  bool containSkeleton(const dynamics::SkeletonPtr& _skeleton);
 
   /// \brief
   CollisionNode* getCollisionNode(const dynamics::BodyNode* _bodyNode);
 
+  /// Update the skeleton and the parent of the collision node of _bodyNode in
+  /// the filter after _bodyNode is moved, for example by BodyNode::moveTo()
+  /// or BodyNode::split()
+  void updateCollisionFilter(const dynamics::BodyNode* _bodyNode);
+
   /// \brief
   std::map<const dynamics::BodyNode*, CollisionNode*> mBodyCollisionMap;
 
-  /// \brief
-  std::vector<std::vector<bool> > mCollidablePairs;
+  /// Connections to the structural change signals of the body nodes of the
+  /// collision nodes
+  std::map<const dynamics::BodyNode*, common::Connection>
+      mStructuralChangeConnections;
+
+  /// Filter of the pairs of collision nodes
+  CollisionFilter mCollisionFilter;
 };
 
 }  // namespace collision
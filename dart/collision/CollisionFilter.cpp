@@ -0,0 +1,272 @@
+/*
+ * Copyright (c) 2016, Graphics Lab, Georgia Tech Research Corporation
+ * Copyright (c) 2016, Humanoid Lab, Georgia Tech Research Corporation
+ * Copyright (c) 2016, Personal Robotics Lab, Carnegie Mellon University
+ * All rights reserved.
+ *
+ * This file is provided under the following "BSD-style" License:
+ *   Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following
+ *   conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ *   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ *   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ *   USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *   POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "dart/collision/CollisionFilter.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace dart {
+namespace collision {
+
+const uint32_t CollisionFilter::DEFAULT_GROUP;
+const uint32_t CollisionFilter::ALL_GROUPS;
+const size_t CollisionFilter::NO_PARENT;
+
+//==============================================================================
+CollisionFilter::CollisionFilter()
+  : mNumObjects(0),
+    mNumWords(0)
+{
+  // Do nothing
+}
+
+//==============================================================================
+CollisionFilter::~CollisionFilter()
+{
+  // Do nothing
+}
+
+//==============================================================================
+void CollisionFilter::addObject(const dynamics::Skeleton* _skeleton)
+{
+  // Grow the matrix geometrically so that adding objects is cheap. The new
+  // rows and columns are already zero, that is, the pairs are enabled.
+  if (mNumObjects == 64 * mNumWords)
+    reserve(std::max<size_t>(64, 2 * mNumObjects));
+
+  ++mNumObjects;
+  mGroups.push_back(DEFAULT_GROUP);
+  mMasks.push_back(ALL_GROUPS);
+  mSkeletons.push_back(_skeleton);
+  mParents.push_back(NO_PARENT);
+}
+
+//==============================================================================
+void CollisionFilter::removeObject(size_t _index)
+{
+  assert(_index < mNumObjects);
+
+  // Remove the row of the object
+  const auto rows = mDisabledPairs.begin();
+  std::copy(rows + (_index + 1) * mNumWords, rows + mNumObjects * mNumWords,
+            rows + _index * mNumWords);
+  --mNumObjects;
+  std::fill(rows + mNumObjects * mNumWords,
+            rows + (mNumObjects + 1) * mNumWords, 0);
+
+  // Remove the column of the object by shifting the following bits of every
+  // row down by one
+  const size_t word = _index / 64;
+  const uint64_t lowBits = (uint64_t(1) << (_index % 64)) - 1;
+  for (size_t i = 0; i < mNumObjects; ++i)
+  {
+    uint64_t* row = &mDisabledPairs[i * mNumWords];
+    row[word] = (row[word] & lowBits) | ((row[word] >> 1) & ~lowBits);
+    for (size_t k = word + 1; k < mNumWords; ++k)
+    {
+      row[k - 1] |= row[k] << 63;
+      row[k] >>= 1;
+    }
+  }
+
+  mGroups.erase(mGroups.begin() + _index);
+  mMasks.erase(mMasks.begin() + _index);
+  mSkeletons.erase(mSkeletons.begin() + _index);
+  mParents.erase(mParents.begin() + _index);
+  for (size_t& parent : mParents)
+  {
+    if (parent == _index)
+      parent = NO_PARENT;
+    else if (parent != NO_PARENT && parent > _index)
+      --parent;
+  }
+}
+
+//==============================================================================
+void CollisionFilter::clear()
+{
+  mNumObjects = 0;
+  std::fill(mDisabledPairs.begin(), mDisabledPairs.end(), 0);
+  mGroups.clear();
+  mMasks.clear();
+  mSkeletons.clear();
+  mParents.clear();
+}
+
+//==============================================================================
+size_t CollisionFilter::getNumObjects() const
+{
+  return mNumObjects;
+}
+
+//==============================================================================
+void CollisionFilter::setSkeleton(size_t _index,
+                                  const dynamics::Skeleton* _skeleton)
+{
+  assert(_index < mNumObjects);
+
+  mSkeletons[_index] = _skeleton;
+}
+
+//==============================================================================
+const dynamics::Skeleton* CollisionFilter::getSkeleton(size_t _index) const
+{
+  assert(_index < mNumObjects);
+
+  return mSkeletons[_index];
+}
+
+//==============================================================================
+void CollisionFilter::setParent(size_t _index, size_t _parentIndex)
+{
+  assert(_index < mNumObjects);
+  assert(_parentIndex == NO_PARENT || _parentIndex < mNumObjects);
+
+  mParents[_index] = _parentIndex;
+}
+
+//==============================================================================
+size_t CollisionFilter::getParent(size_t _index) const
+{
+  assert(_index < mNumObjects);
+
+  return mParents[_index];
+}
+
+//==============================================================================
+void CollisionFilter::setGroup(size_t _index, uint32_t _group, uint32_t _mask)
+{
+  assert(_index < mNumObjects);
+
+  mGroups[_index] = _group;
+  mMasks[_index] = _mask;
+}
+
+//==============================================================================
+uint32_t CollisionFilter::getGroup(size_t _index) const
+{
+  assert(_index < mNumObjects);
+
+  return mGroups[_index];
+}
+
+//==============================================================================
+uint32_t CollisionFilter::getMask(size_t _index) const
+{
+  assert(_index < mNumObjects);
+
+  return mMasks[_index];
+}
+
+//==============================================================================
+void CollisionFilter::setPairEnabled(size_t _index1, size_t _index2,
+                                     bool _enabled)
+{
+  assert(_index1 < mNumObjects && _index2 < mNumObjects);
+
+  const uint64_t bit1 = uint64_t(1) << (_index1 % 64);
+  const uint64_t bit2 = uint64_t(1) << (_index2 % 64);
+  uint64_t& word1 = mDisabledPairs[_index2 * mNumWords + _index1 / 64];
+  uint64_t& word2 = mDisabledPairs[_index1 * mNumWords + _index2 / 64];
+
+  if (_enabled)
+  {
+    word1 &= ~bit1;
+    word2 &= ~bit2;
+  }
+  else
+  {
+    word1 |= bit1;
+    word2 |= bit2;
+  }
+}
+
+//==============================================================================
+bool CollisionFilter::isPairEnabled(size_t _index1, size_t _index2) const
+{
+  assert(_index1 < mNumObjects && _index2 < mNumObjects);
+
+  return !(mDisabledPairs[_index1 * mNumWords + _index2 / 64]
+           & (uint64_t(1) << (_index2 % 64)));
+}
+
+//==============================================================================
+bool CollisionFilter::isCollidable(size_t _index1, size_t _index2) const
+{
+  // The indices are not valid if the objects are not completely added yet
+  if (_index1 >= mNumObjects || _index2 >= mNumObjects || _index1 == _index2)
+    return false;
+
+  if (!(mGroups[_index1] & mMasks[_index2])
+      || !(mGroups[_index2] & mMasks[_index1]))
+    return false;
+
+  return isPairEnabled(_index1, _index2);
+}
+
+//==============================================================================
+bool CollisionFilter::isSameSkeleton(size_t _index1, size_t _index2) const
+{
+  assert(_index1 < mNumObjects && _index2 < mNumObjects);
+
+  return mSkeletons[_index1] == mSkeletons[_index2];
+}
+
+//==============================================================================
+bool CollisionFilter::isAdjacent(size_t _index1, size_t _index2) const
+{
+  assert(_index1 < mNumObjects && _index2 < mNumObjects);
+
+  return mParents[_index1] == _index2 || mParents[_index2] == _index1;
+}
+
+//==============================================================================
+void CollisionFilter::reserve(size_t _capacity)
+{
+  const size_t numWords = (_capacity + 63) / 64;
+  if (numWords <= mNumWords)
+    return;
+
+  std::vector<uint64_t> disabledPairs(64 * numWords * numWords, 0);
+  for (size_t i = 0; i < mNumObjects; ++i)
+  {
+    std::copy(mDisabledPairs.begin() + i * mNumWords,
+              mDisabledPairs.begin() + (i + 1) * mNumWords,
+              disabledPairs.begin() + i * numWords);
+  }
+
+  mDisabledPairs.swap(disabledPairs);
+  mNumWords = numWords;
+}
+
+}  // namespace collision
+}  // namespace dart
@@ -0,0 +1,157 @@
+/*
+ * Copyright (c) 2016, Graphics Lab, Georgia Tech Research Corporation
+ * Copyright (c) 2016, Humanoid Lab, Georgia Tech Research Corporation
+ * Copyright (c) 2016, Personal Robotics Lab, Carnegie Mellon University
+ * All rights reserved.
+ *
+ * This file is provided under the following "BSD-style" License:
+ *   Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following
+ *   conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ *   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ *   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ *   USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *   POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef DART_COLLISION_COLLISIONFILTER_H_
+#define DART_COLLISION_COLLISIONFILTER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace dart {
+
+namespace dynamics {
+class Skeleton;
+}  // namespace dynamics
+
+namespace collision {
+
+/// CollisionFilter decides which pairs of collision objects are checked for
+/// collision. The objects are identified by consecutive indices.
+///
+/// A pair is filtered out if it is disabled explicitly, or if the group of one
+/// object is not in the mask of the other. The disabled pairs are stored in a
+/// packed bit matrix, and the groups, the masks, the skeletons and the parents
+/// of the objects are stored in arrays, so every query takes constant time
+/// without accessing the body nodes.
+class CollisionFilter
+{
+public:
+  /// Group of the objects unless it is changed
+  static const uint32_t DEFAULT_GROUP = 0x1u;
+
+  /// Mask that contains every group
+  static const uint32_t ALL_GROUPS = 0xffffffffu;
+
+  /// Parent index of the objects that don't have a parent
+  static const size_t NO_PARENT = static_cast<size_t>(-1);
+
+  /// Constructor
+  CollisionFilter();
+
+  /// Destructor
+  virtual ~CollisionFilter();
+
+  /// Add an object whose index is the number of objects before it is added.
+  /// The object is in the default group and collides with every group.
+  /// _skeleton is the skeleton of the object.
+  void addObject(const dynamics::Skeleton* _skeleton);
+
+  /// Remove the object of _index. The indices of the following objects
+  /// decrease by one.
+  void removeObject(size_t _index);
+
+  /// Remove all the objects
+  void clear();
+
+  /// Get the number of objects
+  size_t getNumObjects() const;
+
+  /// Set the skeleton of the object of _index
+  void setSkeleton(size_t _index, const dynamics::Skeleton* _skeleton);
+
+  /// Get the skeleton of the object of _index
+  const dynamics::Skeleton* getSkeleton(size_t _index) const;
+
+  /// Set the index of the parent of the object of _index, which is the object
+  /// that the object is adjacent to in its skeleton
+  void setParent(size_t _index, size_t _parentIndex);
+
+  /// Get the index of the parent of the object of _index
+  size_t getParent(size_t _index) const;
+
+  /// Set the group and the mask of the object of _index
+  void setGroup(size_t _index, uint32_t _group, uint32_t _mask = ALL_GROUPS);
+
+  /// Get the group of the object of _index
+  uint32_t getGroup(size_t _index) const;
+
+  /// Get the mask of the object of _index
+  uint32_t getMask(size_t _index) const;
+
+  /// Enable or disable the pair of the objects of _index1 and _index2
+  void setPairEnabled(size_t _index1, size_t _index2, bool _enabled);
+
+  /// Return true if the pair of the objects of _index1 and _index2 is enabled
+  bool isPairEnabled(size_t _index1, size_t _index2) const;
+
+  /// Return true if the pair of the objects of _index1 and _index2 is enabled
+  /// and their groups are in the masks of each other
+  bool isCollidable(size_t _index1, size_t _index2) const;
+
+  /// Return true if the objects of _index1 and _index2 are in the same
+  /// skeleton
+  bool isSameSkeleton(size_t _index1, size_t _index2) const;
+
+  /// Return true if one of the objects of _index1 and _index2 is the parent of
+  /// the other
+  bool isAdjacent(size_t _index1, size_t _index2) const;
+
+private:
+  /// Make room for _capacity objects in the matrix of the disabled pairs
+  void reserve(size_t _capacity);
+
+  /// Number of objects
+  size_t mNumObjects;
+
+  /// Number of words in each row of mDisabledPairs
+  size_t mNumWords;
+
+  /// Symmetric bit matrix of the disabled pairs, row after row
+  std::vector<uint64_t> mDisabledPairs;
+
+  /// Group of each object
+  std::vector<uint32_t> mGroups;
+
+  /// Mask of each object
+  std::vector<uint32_t> mMasks;
+
+  /// Skeleton of each object
+  std::vector<const dynamics::Skeleton*> mSkeletons;
+
+  /// Parent index of each object
+  std::vector<size_t> mParents;
+};
+
+}  // namespace collision
+}  // namespace dart
+
+#endif  // DART_COLLISION_COLLISIONFILTER_H_
@@ -0,0 +1,144 @@
+/*
+ * Copyright (c) 2016, Graphics Lab, Georgia Tech Research Corporation
+ * Copyright (c) 2016, Humanoid Lab, Georgia Tech Research Corporation
+ * Copyright (c) 2016, Personal Robotics Lab, Carnegie Mellon University
+ * All rights reserved.
+ *
+ * This file is provided under the following "BSD-style" License:
+ *   Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following
+ *   conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ *   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ *   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ *   USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *   POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "dart/collision/ContactManifold.h"
+
+#include <cassert>
+
+#include "dart/collision/CollisionDetector.h"
+
+namespace dart {
+namespace collision {
+
+//==============================================================================
+ContactManifold::ContactManifold(size_t _id)
+  : mId(_id),
+    mNextFeatureId(0)
+{
+  // Do nothing
+}
+
+//==============================================================================
+ContactManifold::~ContactManifold()
+{
+  // Do nothing
+}
+
+//==============================================================================
+size_t ContactManifold::getId() const
+{
+  return mId;
+}
+
+//==============================================================================
+size_t ContactManifold::getNumContacts() const
+{
+  return mFeatures.size();
+}
+
+//==============================================================================
+size_t ContactManifold::getFeatureId(size_t _index) const
+{
+  assert(_index < mFeatures.size());
+  return mFeatures[_index].id;
+}
+
+//==============================================================================
+const Eigen::Vector3d& ContactManifold::getLocalPoint(size_t _index) const
+{
+  assert(_index < mFeatures.size());
+  return mFeatures[_index].localPoint;
+}
+
+//==============================================================================
+void ContactManifold::beginUpdate()
+{
+  mNewFeatures.clear();
+}
+
+//==============================================================================
+void ContactManifold::addContact(Contact& _contact,
+                                 const Eigen::Vector3d& _localPoint,
+                                 bool _isSwapped, double _tolerance)
+{
+  Feature feature;
+  feature.localPoint = _localPoint;
+  feature.shape1 = _isSwapped ? _contact.shape2.get() : _contact.shape1.get();
+  feature.shape2 = _isSwapped ? _contact.shape1.get() : _contact.shape2.get();
+  feature.isMatched = false;
+
+  // Take the ID of the closest previous contact between the same shapes. A
+  // manifold has only a few contacts, so they are searched linearly.
+  Feature* closest = nullptr;
+  double minDistance2 = _tolerance * _tolerance;
+  for (Feature& previous : mFeatures)
+  {
+    if (previous.isMatched || previous.shape1 != feature.shape1
+        || previous.shape2 != feature.shape2)
+    {
+      continue;
+    }
+
+    const double distance2 = (previous.localPoint - _localPoint).squaredNorm();
+    if (distance2 < minDistance2)
+    {
+      closest = &previous;
+      minDistance2 = distance2;
+    }
+  }
+
+  if (closest)
+  {
+    closest->isMatched = true;
+    feature.id = closest->id;
+  }
+  else
+  {
+    feature.id = mNextFeatureId++;
+  }
+
+  mNewFeatures.push_back(feature);
+
+  _contact.manifoldId = mId;
+  _contact.featureId = feature.id;
+}
+
+//==============================================================================
+bool ContactManifold::endUpdate()
+{
+  mFeatures.swap(mNewFeatures);
+  mNewFeatures.clear();
+
+  return !mFeatures.empty();
+}
+
+}  // namespace collision
+}  // namespace dart
@@ -0,0 +1,129 @@
+/*
+ * Copyright (c) 2016, Graphics Lab, Georgia Tech Research Corporation
+ * Copyright (c) 2016, Humanoid Lab, Georgia Tech Research Corporation
+ * Copyright (c) 2016, Personal Robotics Lab, Carnegie Mellon University
+ * All rights reserved.
+ *
+ * This file is provided under the following "BSD-style" License:
+ *   Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following
+ *   conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ *   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ *   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ *   USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *   POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef DART_COLLISION_CONTACTMANIFOLD_H_
+#define DART_COLLISION_CONTACTMANIFOLD_H_
+
+#include <cstddef>
+#include <vector>
+
+#include <Eigen/Dense>
+
+namespace dart {
+
+namespace dynamics {
+class Shape;
+}  // namespace dynamics
+
+namespace collision {
+
+struct Contact;
+
+/// ContactManifold is the set of the contacts between a pair of body nodes,
+/// which persists over time steps while the body nodes are in contact.
+///
+/// Every contact of the manifold has a feature ID. When the manifold is
+/// updated with the contacts of a new time step, a contact takes the feature ID
+/// of the closest previous contact between the same shapes if the contact
+/// point hasn't moved more than a tolerance with respect to the first body
+/// node of the pair. Otherwise, it takes a new feature ID.
+class ContactManifold
+{
+public:
+  /// Constructor
+  explicit ContactManifold(size_t _id = 0);
+
+  /// Destructor
+  virtual ~ContactManifold();
+
+  /// Get the ID of this manifold
+  size_t getId() const;
+
+  /// Get the number of the contacts of the last update
+  size_t getNumContacts() const;
+
+  /// Get the feature ID of the contact of _index
+  size_t getFeatureId(size_t _index) const;
+
+  /// Get the contact point of _index w.r.t. the first body node of the pair
+  const Eigen::Vector3d& getLocalPoint(size_t _index) const;
+
+  /// Start updating the contacts of this manifold
+  void beginUpdate();
+
+  /// Add _contact to this manifold, and set the manifold ID and the feature ID
+  /// of _contact. _localPoint is the contact point w.r.t. the first body node
+  /// of the pair, and _isSwapped is true if the first body node of the pair is
+  /// _contact.bodyNode2.
+  void addContact(Contact& _contact, const Eigen::Vector3d& _localPoint,
+                  bool _isSwapped, double _tolerance);
+
+  /// Finish updating the contacts of this manifold. Return false if no contact
+  /// is added since beginUpdate(), that is, the body nodes are separated.
+  bool endUpdate();
+
+private:
+  /// Contact of the manifold
+  struct Feature
+  {
+    /// Contact point w.r.t. the first body node of the pair
+    Eigen::Vector3d localPoint;
+
+    /// Colliding shape of the first body node of the pair
+    const dynamics::Shape* shape1;
+
+    /// Colliding shape of the second body node of the pair
+    const dynamics::Shape* shape2;
+
+    /// Feature ID
+    size_t id;
+
+    /// Whether a contact of the current update took this feature ID
+    bool isMatched;
+  };
+
+  /// ID of this manifold
+  size_t mId;
+
+  /// Feature ID of the next new contact
+  size_t mNextFeatureId;
+
+  /// Contacts of the last update
+  std::vector<Feature> mFeatures;
+
+  /// Contacts of the current update
+  std::vector<Feature> mNewFeatures;
+};
+
+}  // namespace collision
+}  // namespace dart
+
+#endif  // DART_COLLISION_CONTACTMANIFOLD_H_
@@ -0,0 +1,390 @@
+/*
+ * Copyright (c) 2016, Graphics Lab, Georgia Tech Research Corporation
+ * Copyright (c) 2016, Humanoid Lab, Georgia Tech Research Corporation
+ * Copyright (c) 2016, Personal Robotics Lab, Carnegie Mellon University
+ * All rights reserved.
+ *
+ * This file is provided under the following "BSD-style" License:
+ *   Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following
+ *   conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ *   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ *   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ *   USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *   POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "dart/collision/ContactReduction.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+#include "dart/collision/CollisionDetector.h"
+
+namespace dart {
+namespace collision {
+
+namespace {
+
+/// Number of contacts from which the spatial hash grid is used for merging
+const size_t GRID_THRESHOLD = 16;
+
+//==============================================================================
+/// Twice the signed area of the triangle (_a, _b, _p), which is negative if _p
+/// is on the right side of the edge from _a to _b
+double cross2(const Eigen::Vector2d& _a, const Eigen::Vector2d& _b,
+              const Eigen::Vector2d& _p)
+{
+  const Eigen::Vector2d ab = _b - _a;
+  const Eigen::Vector2d ap = _p - _a;
+  return ab.x() * ap.y() - ab.y() * ap.x();
+}
+
+}  // anonymous namespace
+
+//==============================================================================
+ContactReduction::ContactReduction(double _tolerance, size_t _maxNumContacts)
+  : mTolerance(_tolerance),
+    mMaxNumContacts(_maxNumContacts)
+{
+  // Do nothing
+}
+
+//==============================================================================
+ContactReduction::~ContactReduction()
+{
+  // Do nothing
+}
+
+//==============================================================================
+void ContactReduction::setTolerance(double _tolerance)
+{
+  mTolerance = _tolerance;
+}
+
+//==============================================================================
+double ContactReduction::getTolerance() const
+{
+  return mTolerance;
+}
+
+//==============================================================================
+void ContactReduction::setMaxNumContacts(size_t _maxNumContacts)
+{
+  mMaxNumContacts = _maxNumContacts;
+}
+
+//==============================================================================
+size_t ContactReduction::getMaxNumContacts() const
+{
+  return mMaxNumContacts;
+}
+
+//==============================================================================
+void ContactReduction::reduce(std::vector<Contact>& _contacts, size_t _begin)
+{
+  assert(_begin <= _contacts.size());
+
+  size_t end = _contacts.size();
+
+  if (end - _begin > 1 && mTolerance > 0.0)
+    end = mergeContacts(_contacts, _begin, end);
+
+  if (mMaxNumContacts > 0 && end - _begin > mMaxNumContacts)
+    end = selectContacts(_contacts, _begin, end);
+
+  _contacts.erase(_contacts.begin() + end, _contacts.end());
+}
+
+//==============================================================================
+size_t ContactReduction::mergeContacts(std::vector<Contact>& _contacts,
+                                       size_t _begin, size_t _end)
+{
+  if (_end - _begin < GRID_THRESHOLD)
+    return mergeContactsBruteForce(_contacts, _begin, _end);
+
+  return mergeContactsGrid(_contacts, _begin, _end);
+}
+
+//==============================================================================
+size_t ContactReduction::mergeContactsBruteForce(
+    std::vector<Contact>& _contacts, size_t _begin, size_t _end)
+{
+  const double tolerance2 = mTolerance * mTolerance;
+
+  size_t numKept = _begin;
+  for (size_t i = _begin; i < _end; ++i)
+  {
+    const Eigen::Vector3d& point = _contacts[i].point;
+
+    size_t j = _begin;
+    for (; j < numKept; ++j)
+    {
+      if ((_contacts[j].point - point).squaredNorm() < tolerance2)
+        break;
+    }
+
+    if (j < numKept)
+    {
+      _contacts[j].penetrationDepth = std::max(_contacts[j].penetrationDepth,
+                                               _contacts[i].penetrationDepth);
+      continue;
+    }
+
+    if (numKept != i)
+      _contacts[numKept] = _contacts[i];
+    ++numKept;
+  }
+
+  return numKept;
+}
+
+//==============================================================================
+size_t ContactReduction::mergeContactsGrid(std::vector<Contact>& _contacts,
+                                           size_t _begin, size_t _end)
+{
+  const size_t numContacts = _end - _begin;
+  const double tolerance2 = mTolerance * mTolerance;
+  const double invTolerance = 1.0 / mTolerance;
+
+  // Keep the load factor of the hash table under one half
+  size_t numCells = 1;
+  while (numCells < 2 * numContacts)
+    numCells <<= 1;
+  mCells.assign(numCells, Cell{0, 0, 0, -1});
+  mNext.resize(numContacts);
+
+  size_t numKept = _begin;
+  for (size_t i = _begin; i < _end; ++i)
+  {
+    const Eigen::Vector3d& point = _contacts[i].point;
+    const int64_t x = static_cast<int64_t>(std::floor(point.x() * invTolerance));
+    const int64_t y = static_cast<int64_t>(std::floor(point.y() * invTolerance));
+    const int64_t z = static_cast<int64_t>(std::floor(point.z() * invTolerance));
+
+    // A contact closer than the tolerance is in one of the neighboring cells
+    // since the cells are as large as the tolerance
+    int duplicate = -1;
+    for (int64_t dx = -1; dx <= 1 && duplicate < 0; ++dx)
+    {
+      for (int64_t dy = -1; dy <= 1 && duplicate < 0; ++dy)
+      {
+        for (int64_t dz = -1; dz <= 1 && duplicate < 0; ++dz)
+        {
+          for (int k = findCell(x + dx, y + dy, z + dz).head; k >= 0;
+               k = mNext[k])
+          {
+            if ((_contacts[_begin + k].point - point).squaredNorm()
+                < tolerance2)
+            {
+              duplicate = k;
+              break;
+            }
+          }
+        }
+      }
+    }
+
+    if (duplicate >= 0)
+    {
+      Contact& contact = _contacts[_begin + duplicate];
+      contact.penetrationDepth = std::max(contact.penetrationDepth,
+                                          _contacts[i].penetrationDepth);
+      continue;
+    }
+
+    const int index = static_cast<int>(numKept - _begin);
+    Cell& cell = findCell(x, y, z);
+    cell.x = x;
+    cell.y = y;
+    cell.z = z;
+    mNext[index] = cell.head;
+    cell.head = index;
+
+    if (numKept != i)
+      _contacts[numKept] = _contacts[i];
+    ++numKept;
+  }
+
+  return numKept;
+}
+
+//==============================================================================
+ContactReduction::Cell& ContactReduction::findCell(int64_t _x, int64_t _y,
+                                                   int64_t _z)
+{
+  const size_t mask = mCells.size() - 1;
+  size_t index = static_cast<size_t>(
+        (static_cast<uint64_t>(_x) * 73856093u)
+        ^ (static_cast<uint64_t>(_y) * 19349663u)
+        ^ (static_cast<uint64_t>(_z) * 83492791u)) & mask;
+
+  // Linear probing. The table always has an empty cell, so this terminates.
+  while (mCells[index].head >= 0
+         && (mCells[index].x != _x || mCells[index].y != _y
+             || mCells[index].z != _z))
+  {
+    index = (index + 1) & mask;
+  }
+
+  return mCells[index];
+}
+
+//==============================================================================
+size_t ContactReduction::selectContacts(std::vector<Contact>& _contacts,
+                                        size_t _begin, size_t _end)
+{
+  const size_t numContacts = _end - _begin;
+  mSelected.assign(numContacts, false);
+  mPolygon.clear();
+
+  // The deepest contact is always kept
+  size_t deepest = 0;
+  for (size_t i = 1; i < numContacts; ++i)
+  {
+    if (_contacts[_begin + i].penetrationDepth
+        > _contacts[_begin + deepest].penetrationDepth)
+    {
+      deepest = i;
+    }
+  }
+  mSelected[deepest] = true;
+  mPolygon.push_back(deepest);
+
+  // The contact polygon is built on the plane perpendicular to the normal of
+  // the deepest contact
+  Eigen::Vector3d normal = _contacts[_begin + deepest].normal;
+  if (normal.squaredNorm() < 1e-12)
+    normal = Eigen::Vector3d::UnitZ();
+  const Eigen::Vector3d u = normal.unitOrthogonal();
+  const Eigen::Vector3d v = normal.normalized().cross(u);
+
+  mPoints.resize(numContacts);
+  for (size_t i = 0; i < numContacts; ++i)
+  {
+    const Eigen::Vector3d& point = _contacts[_begin + i].point;
+    mPoints[i] = Eigen::Vector2d(u.dot(point), v.dot(point));
+  }
+
+  // The second contact is the farthest one from the deepest contact
+  if (mMaxNumContacts > 1)
+  {
+    size_t farthest = deepest;
+    double maxDistance2 = 0.0;
+    for (size_t i = 0; i < numContacts; ++i)
+    {
+      const double distance2 = (mPoints[i] - mPoints[deepest]).squaredNorm();
+      if (distance2 > maxDistance2)
+      {
+        farthest = i;
+        maxDistance2 = distance2;
+      }
+    }
+
+    if (farthest != deepest)
+    {
+      mSelected[farthest] = true;
+      mPolygon.push_back(farthest);
+    }
+  }
+
+  // Each of the other contacts is the one that increases the area of the
+  // convex contact polygon the most. The increase is the sum of the areas of
+  // the triangles between the contact and the edges of the polygon that it
+  // sees from outside. Contacts inside the polygon are not selected.
+  while (mPolygon.size() > 1 && mPolygon.size() < mMaxNumContacts)
+  {
+    const size_t numVertices = mPolygon.size();
+
+    size_t best = numContacts;
+    double maxArea = 0.0;
+    for (size_t i = 0; i < numContacts; ++i)
+    {
+      if (mSelected[i])
+        continue;
+
+      double area = 0.0;
+      for (size_t e = 0; e < numVertices; ++e)
+      {
+        const double cross = cross2(mPoints[mPolygon[e]],
+                                    mPoints[mPolygon[(e + 1) % numVertices]],
+                                    mPoints[i]);
+        if (cross < 0.0)
+          area -= cross;
+      }
+
+      if (area > maxArea)
+      {
+        best = i;
+        maxArea = area;
+      }
+    }
+
+    if (best == numContacts || maxArea < 1e-12)
+      break;
+
+    // Replace the chain of the vertices between the visible edges with the
+    // new contact. The visible edges are consecutive since the polygon is
+    // convex.
+    mVisible.resize(numVertices);
+    for (size_t e = 0; e < numVertices; ++e)
+    {
+      mVisible[e] = cross2(mPoints[mPolygon[e]],
+                           mPoints[mPolygon[(e + 1) % numVertices]],
+                           mPoints[best]) < 0.0;
+    }
+
+    size_t first = 0;
+    while (first < numVertices
+           && (!mVisible[first]
+               || mVisible[(first + numVertices - 1) % numVertices]))
+      ++first;
+    if (first == numVertices)
+      break;
+
+    size_t numVisible = 0;
+    while (numVisible < numVertices
+           && mVisible[(first + numVisible) % numVertices])
+      ++numVisible;
+
+    mNewPolygon.clear();
+    mNewPolygon.push_back(best);
+    for (size_t k = first + numVisible; k <= first + numVertices; ++k)
+      mNewPolygon.push_back(mPolygon[k % numVertices]);
+    mPolygon.swap(mNewPolygon);
+
+    mSelected[best] = true;
+  }
+
+  size_t numKept = _begin;
+  for (size_t i = 0; i < numContacts; ++i)
+  {
+    if (!mSelected[i])
+      continue;
+
+    if (numKept != _begin + i)
+      _contacts[numKept] = _contacts[_begin + i];
+    ++numKept;
+  }
+
+  return numKept;
+}
+
+}  // namespace collision
+}  // namespace dart
@@ -0,0 +1,150 @@
+/*
+ * Copyright (c) 2016, Graphics Lab, Georgia Tech Research Corporation
+ * Copyright (c) 2016, Humanoid Lab, Georgia Tech Research Corporation
+ * Copyright (c) 2016, Personal Robotics Lab, Carnegie Mellon University
+ * All rights reserved.
+ *
+ * This file is provided under the following "BSD-style" License:
+ *   Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following
+ *   conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ *   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ *   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ *   USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *   POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef DART_COLLISION_CONTACTREDUCTION_H_
+#define DART_COLLISION_CONTACTREDUCTION_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <Eigen/Dense>
+
+#include "dart/math/MathTypes.h"
+
+namespace dart {
+namespace collision {
+
+struct Contact;
+
+/// ContactReduction reduces the contacts between a pair of bodies before they
+/// are passed on to the constraint solver.
+///
+/// First, the contacts closer to each other than the tolerance are merged into
+/// one contact, which keeps the largest penetration depth. The merging uses a
+/// spatial hash grid whose cells are as large as the tolerance, so it takes
+/// linear time in the number of contacts. Then, if the maximum number of
+/// contacts is set, the deepest contact and the contacts that maximize the
+/// area of the contact polygon are kept and the others are removed.
+class ContactReduction
+{
+public:
+  /// Constructor
+  explicit ContactReduction(double _tolerance = 1e-3,
+                            size_t _maxNumContacts = 0);
+
+  /// Destructor
+  virtual ~ContactReduction();
+
+  /// Set the distance under which two contacts are merged. Contacts are not
+  /// merged if _tolerance is not positive.
+  void setTolerance(double _tolerance);
+
+  /// Get the distance under which two contacts are merged
+  double getTolerance() const;
+
+  /// Set the maximum number of contacts that are kept. Every contact is kept
+  /// if _maxNumContacts is zero.
+  void setMaxNumContacts(size_t _maxNumContacts);
+
+  /// Get the maximum number of contacts that are kept
+  size_t getMaxNumContacts() const;
+
+  /// Reduce _contacts[_begin], ..., _contacts.back(), which are the contacts
+  /// between a pair of bodies. The kept contacts stay in their order.
+  void reduce(std::vector<Contact>& _contacts, size_t _begin);
+
+private:
+  /// Cell of the spatial hash grid
+  struct Cell
+  {
+    int64_t x;
+    int64_t y;
+    int64_t z;
+
+    /// Index of the first contact in this cell, or -1 if the cell is empty
+    int head;
+  };
+
+  /// Merge the contacts closer than the tolerance, and return the new end
+  size_t mergeContacts(std::vector<Contact>& _contacts, size_t _begin,
+                       size_t _end);
+
+  /// Merge the contacts by comparing every pair of them, which is faster
+  /// than the grid for a few contacts
+  size_t mergeContactsBruteForce(std::vector<Contact>& _contacts,
+                                 size_t _begin, size_t _end);
+
+  /// Merge the contacts using the spatial hash grid
+  size_t mergeContactsGrid(std::vector<Contact>& _contacts, size_t _begin,
+                           size_t _end);
+
+  /// Find the cell of the given coordinates, or the empty cell where it is
+  /// supposed to be
+  Cell& findCell(int64_t _x, int64_t _y, int64_t _z);
+
+  /// Keep at most mMaxNumContacts contacts, and return the new end
+  size_t selectContacts(std::vector<Contact>& _contacts, size_t _begin,
+                        size_t _end);
+
+  /// Distance under which two contacts are merged
+  double mTolerance;
+
+  /// Maximum number of contacts that are kept
+  size_t mMaxNumContacts;
+
+  /// Open addressing hash table of the grid cells
+  std::vector<Cell> mCells;
+
+  /// Index of the next contact in the same cell for each contact
+  std::vector<int> mNext;
+
+  /// Indices of the selected contacts in the order of the contact polygon
+  std::vector<size_t> mPolygon;
+
+  /// Contact polygon that replaces mPolygon when a contact is added
+  std::vector<size_t> mNewPolygon;
+
+  /// Whether each contact is selected
+  std::vector<bool> mSelected;
+
+  /// Whether each edge of the contact polygon is visible from the contact
+  /// that is added
+  std::vector<bool> mVisible;
+
+  /// Contacts projected onto the plane of the contact polygon
+  Eigen::aligned_vector<Eigen::Vector2d> mPoints;
+};
+
+}  // namespace collision
+}  // namespace dart
+
+#endif  // DART_COLLISION_CONTACTREDUCTION_H_
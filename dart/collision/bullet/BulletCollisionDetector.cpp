@@ -158,9 +158,15 @@ bool BulletCollisionDetector::detectCollision(bool _checkAllCollisions,
                                               bool _calculateContactPoints)
 {
   // Update all the transformations of the collision nodes
+  DART_PROFILE_BEGIN(broadphaseTimer, mProfiler, BROADPHASE);
   for (size_t i = 0; i < mCollisionNodes.size(); ++i)
     static_cast<BulletCollisionNode*>(
         mCollisionNodes[i])->updateBulletCollisionObjects();
+  DART_PROFILE_END(broadphaseTimer);
+
+  // Bullet runs its broadphase and narrowphase together, so both of them are
+  // reported as the narrowphase
+  DART_PROFILE_SCOPE(mProfiler, NARROWPHASE);
 
   // Setting up broadphase collision detection options
   btDispatcherInfo& dispatchInfo = mBulletCollisionWorld->getDispatchInfo();
@@ -215,6 +221,8 @@ bool BulletCollisionDetector::detectCollision(bool _checkAllCollisions,
     }
   }
 
+  updateContactManifolds();
+
   // Return true if there are contacts
   return !mContacts.empty();
 }
@@ -36,17 +36,90 @@
 
 #include "dart/collision/dart/DARTCollisionDetector.h"
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
 #include <vector>
 
 #include "dart/dynamics/Shape.h"
+#include "dart/dynamics/BoxShape.h"
+#include "dart/dynamics/EllipsoidShape.h"
+#include "dart/dynamics/CylinderShape.h"
 #include "dart/dynamics/BodyNode.h"
 #include "dart/collision/dart/DARTCollide.h"
 
 namespace dart {
 namespace collision {
 
+namespace {
+
+//==============================================================================
+/// Compute the world-space axis-aligned bounding box of a collision shape as
+/// it is seen by collide(). Shape types that collide() does not handle get an
+/// unbounded box so that the broadphase never rejects them on its own.
+void computeBoundingBox(const dynamics::Shape* _shape,
+                        const Eigen::Isometry3d& _T,
+                        Eigen::Vector3d& _min, Eigen::Vector3d& _max)
+{
+  Eigen::Vector3d halfSize;
+
+  switch (_shape->getShapeType())
+  {
+    case dynamics::Shape::BOX:
+    {
+      const dynamics::BoxShape* box
+          = static_cast<const dynamics::BoxShape*>(_shape);
+      halfSize = 0.5 * box->getSize();
+      break;
+    }
+    case dynamics::Shape::ELLIPSOID:
+    {
+      // collide() treats an ellipsoid as a sphere, so the largest diameter
+      // gives a bound that holds for either interpretation.
+      const dynamics::EllipsoidShape* ellipsoid
+          = static_cast<const dynamics::EllipsoidShape*>(_shape);
+      const double radius = 0.5 * ellipsoid->getSize().maxCoeff();
+      _min = _T.translation().array() - radius;
+      _max = _T.translation().array() + radius;
+      return;
+    }
+    case dynamics::Shape::CYLINDER:
+    {
+      // collide() approximates a cylinder by a box that encloses it
+      const dynamics::CylinderShape* cylinder
+          = static_cast<const dynamics::CylinderShape*>(_shape);
+      halfSize << cylinder->getRadius() * sqrt(2.0),
+                  cylinder->getRadius() * sqrt(2.0),
+                  cylinder->getHeight();
+      halfSize *= 0.5;
+      break;
+    }
+    default:
+    {
+      _min.setConstant(-std::numeric_limits<double>::infinity());
+      _max.setConstant(std::numeric_limits<double>::infinity());
+      return;
+    }
+  }
+
+  const Eigen::Vector3d extents = _T.linear().cwiseAbs() * halfSize;
+  _min = _T.translation() - extents;
+  _max = _T.translation() + extents;
+}
+
+//==============================================================================
+bool boxesOverlap(const Eigen::Vector3d& _min1, const Eigen::Vector3d& _max1,
+                  const Eigen::Vector3d& _min2, const Eigen::Vector3d& _max2)
+{
+  return (_min1.array() <= _max2.array()).all()
+      && (_min2.array() <= _max1.array()).all();
+}
+
+}  // anonymous namespace
+
 DARTCollisionDetector::DARTCollisionDetector()
-  : CollisionDetector() {
+  : CollisionDetector(),
+    mSweepAxis(0) {
 }
 
 DARTCollisionDetector::~DARTCollisionDetector() {
@@ -65,67 +138,67 @@ bool DARTCollisionDetector::detectCollision(bool /*_checkAllCollisions*/,
   for (size_t i = 0; i < mCollisionNodes.size(); i++)
     mCollisionNodes[i]->getBodyNode()->setColliding(false);
 
+  // Broadphase: only the pairs whose bounding boxes overlap are passed on to
+  // the narrowphase below
+  DART_PROFILE_BEGIN(broadphaseTimer, mProfiler, BROADPHASE);
+  updateBoundingBoxes();
+  findOverlappingPairs();
+  DART_PROFILE_END(broadphaseTimer);
+
+  DART_PROFILE_SCOPE(mProfiler, NARROWPHASE);
+
   std::vector<Contact> contacts;
 
-  for (size_t i = 0; i < mCollisionNodes.size(); i++) {
-    for (size_t j = i + 1; j < mCollisionNodes.size(); j++) {
-      CollisionNode* collNode1 = mCollisionNodes[i];
-      CollisionNode* collNode2 = mCollisionNodes[j];
-      dynamics::BodyNode* BodyNode1 = collNode1->getBodyNode();
-      dynamics::BodyNode* BodyNode2 = collNode2->getBodyNode();
-
-      if (!isCollidable(collNode1, collNode2))
-        continue;
-
-      for (size_t k = 0; k < BodyNode1->getNumCollisionShapes(); k++) {
-        for (size_t l = 0; l < BodyNode2->getNumCollisionShapes(); l++) {
-          int currContactNum = mContacts.size();
-
-          contacts.clear();
-          collide(BodyNode1->getCollisionShape(k),
-                  BodyNode1->getTransform()
-                  * BodyNode1->getCollisionShape(k)->getLocalTransform(),
-                  BodyNode2->getCollisionShape(l),
-                  BodyNode2->getTransform()
-                  * BodyNode2->getCollisionShape(l)->getLocalTransform(),
-                  &contacts);
-
-          size_t numContacts = contacts.size();
-
-          for (unsigned int m = 0; m < numContacts; ++m) {
-            Contact contactPair;
-            contactPair = contacts[m];
-            contactPair.bodyNode1 = BodyNode1;
-            contactPair.bodyNode2 = BodyNode2;
-            assert(contactPair.bodyNode1.lock() != nullptr);
-            assert(contactPair.bodyNode2.lock() != nullptr);
-
-            mContacts.push_back(contactPair);
-          }
-
-          std::vector<bool> markForDeletion(numContacts, false);
-          for (size_t m = 0; m < numContacts; m++) {
-            for (size_t n = m + 1; n < numContacts; n++) {
-              Eigen::Vector3d diff =
-                  mContacts[currContactNum + m].point -
-                  mContacts[currContactNum + n].point;
-              if (diff.dot(diff) < 1e-6) {
-                markForDeletion[m] = true;
-                break;
-              }
-            }
-          }
-
-          for (int m = numContacts - 1; m >= 0; m--)
-          {
-            if (markForDeletion[m])
-              mContacts.erase(mContacts.begin() + currContactNum + m);
-          }
+  for (const auto& pair : mOverlappingPairs) {
+    const size_t i = pair.first;
+    const size_t j = pair.second;
+    CollisionNode* collNode1 = mCollisionNodes[i];
+    CollisionNode* collNode2 = mCollisionNodes[j];
+    dynamics::BodyNode* BodyNode1 = collNode1->getBodyNode();
+    dynamics::BodyNode* BodyNode2 = collNode2->getBodyNode();
+
+    if (!isCollidable(collNode1, collNode2))
+      continue;
+
+    const size_t pairBegin = mContacts.size();
+
+    for (size_t k = 0; k < BodyNode1->getNumCollisionShapes(); k++) {
+      for (size_t l = 0; l < BodyNode2->getNumCollisionShapes(); l++) {
+        const size_t shapeIndex1 = mShapeOffsets[i] + k;
+        const size_t shapeIndex2 = mShapeOffsets[j] + l;
+
+        if (!shapesOverlap(shapeIndex1, shapeIndex2))
+          continue;
+
+        contacts.clear();
+        collide(BodyNode1->getCollisionShape(k),
+                mShapeTransforms[shapeIndex1],
+                BodyNode2->getCollisionShape(l),
+                mShapeTransforms[shapeIndex2],
+                &contacts);
+
+        size_t numContacts = contacts.size();
+
+        for (unsigned int m = 0; m < numContacts; ++m) {
+          Contact contactPair;
+          contactPair = contacts[m];
+          contactPair.bodyNode1 = BodyNode1;
+          contactPair.bodyNode2 = BodyNode2;
+          assert(contactPair.bodyNode1.lock() != nullptr);
+          assert(contactPair.bodyNode2.lock() != nullptr);
+
+          mContacts.push_back(contactPair);
         }
       }
     }
+
+    // Merge the close contacts of this pair, and reduce them if the maximum
+    // number of contacts per pair is set
+    reduceContacts(pairBegin);
   }
 
+  updateContactManifolds();
+
   for (size_t i = 0; i < mContacts.size(); ++i)
   {
     // Set these two bodies are in colliding
@@ -158,5 +231,154 @@ bool DARTCollisionDetector::detectCollision(CollisionNode* _collNode1,
   return contacts.size() > 0 ? true : false;
 }
 
+//==============================================================================
+void DARTCollisionDetector::updateBoundingBoxes()
+{
+  const size_t numNodes = mCollisionNodes.size();
+
+  mShapeOffsets.resize(numNodes + 1);
+  mShapeOffsets[0] = 0;
+  for (size_t i = 0; i < numNodes; ++i)
+  {
+    mShapeOffsets[i + 1] = mShapeOffsets[i]
+        + mCollisionNodes[i]->getBodyNode()->getNumCollisionShapes();
+  }
+
+  const size_t numShapes = mShapeOffsets[numNodes];
+  mShapeTransforms.resize(numShapes);
+  mShapeBoundsMin.resize(numShapes);
+  mShapeBoundsMax.resize(numShapes);
+  mBoundsMin.resize(numNodes);
+  mBoundsMax.resize(numNodes);
+
+  for (size_t i = 0; i < numNodes; ++i)
+  {
+    dynamics::BodyNode* bodyNode = mCollisionNodes[i]->getBodyNode();
+
+    // A node without any collision shape gets an empty box, which never
+    // overlaps with anything.
+    mBoundsMin[i].setConstant(std::numeric_limits<double>::infinity());
+    mBoundsMax[i].setConstant(-std::numeric_limits<double>::infinity());
+
+    for (size_t k = 0; k < bodyNode->getNumCollisionShapes(); ++k)
+    {
+      const size_t index = mShapeOffsets[i] + k;
+      const dynamics::ConstShapePtr shape = bodyNode->getCollisionShape(k);
+
+      mShapeTransforms[index]
+          = bodyNode->getTransform() * shape->getLocalTransform();
+      computeBoundingBox(shape.get(), mShapeTransforms[index],
+                         mShapeBoundsMin[index], mShapeBoundsMax[index]);
+
+      mBoundsMin[i] = mBoundsMin[i].cwiseMin(mShapeBoundsMin[index]);
+      mBoundsMax[i] = mBoundsMax[i].cwiseMax(mShapeBoundsMax[index]);
+    }
+  }
+}
+
+//==============================================================================
+void DARTCollisionDetector::findOverlappingPairs()
+{
+  const size_t numNodes = mCollisionNodes.size();
+
+  mOverlappingPairs.clear();
+
+  // Sweep along the axis where the centers of the bounding boxes are spread the
+  // most, which leaves the fewest boxes overlapping on the sweep axis.
+  Eigen::Vector3d sum = Eigen::Vector3d::Zero();
+  Eigen::Vector3d squaredSum = Eigen::Vector3d::Zero();
+  size_t numBounded = 0;
+  for (size_t i = 0; i < numNodes; ++i)
+  {
+    const Eigen::Vector3d center = 0.5 * (mBoundsMin[i] + mBoundsMax[i]);
+    if (!std::isfinite(center.sum()))
+      continue;
+
+    sum += center;
+    squaredSum += center.cwiseProduct(center);
+    ++numBounded;
+  }
+
+  int axis = mSweepAxis;
+  if (numBounded > 1)
+  {
+    const Eigen::Vector3d variance
+        = squaredSum - sum.cwiseProduct(sum) / static_cast<double>(numBounded);
+    variance.maxCoeff(&axis);
+  }
+
+  // Sort the nodes by the lower bound along the sweep axis. The order from the
+  // last call is reused, so insertion sort runs in near linear time as long as
+  // the bodies don't move much between the calls.
+  const auto lessThan = [&](size_t _index1, size_t _index2)
+  {
+    return mBoundsMin[_index1][axis] < mBoundsMin[_index2][axis];
+  };
+
+  if (mSortedIndices.size() != numNodes)
+  {
+    mSortedIndices.resize(numNodes);
+    for (size_t i = 0; i < numNodes; ++i)
+      mSortedIndices[i] = i;
+    std::sort(mSortedIndices.begin(), mSortedIndices.end(), lessThan);
+  }
+  else if (axis != mSweepAxis)
+  {
+    std::sort(mSortedIndices.begin(), mSortedIndices.end(), lessThan);
+  }
+  else
+  {
+    for (size_t i = 1; i < numNodes; ++i)
+    {
+      const size_t index = mSortedIndices[i];
+      size_t j = i;
+      while (j > 0 && lessThan(index, mSortedIndices[j - 1]))
+      {
+        mSortedIndices[j] = mSortedIndices[j - 1];
+        --j;
+      }
+      mSortedIndices[j] = index;
+    }
+  }
+  mSweepAxis = axis;
+
+  // Sweep
+  for (size_t a = 0; a < numNodes; ++a)
+  {
+    const size_t i = mSortedIndices[a];
+
+    for (size_t b = a + 1; b < numNodes; ++b)
+    {
+      const size_t j = mSortedIndices[b];
+
+      // The rest of the nodes start after this one ends on the sweep axis.
+      if (mBoundsMin[j][axis] > mBoundsMax[i][axis])
+        break;
+
+      if (overlaps(i, j))
+        mOverlappingPairs.push_back(std::make_pair(std::min(i, j),
+                                                   std::max(i, j)));
+    }
+  }
+
+  // Keep the order of the brute-force double loop so that the contacts are
+  // generated in the same order.
+  std::sort(mOverlappingPairs.begin(), mOverlappingPairs.end());
+}
+
+//==============================================================================
+bool DARTCollisionDetector::overlaps(size_t _index1, size_t _index2) const
+{
+  return boxesOverlap(mBoundsMin[_index1], mBoundsMax[_index1],
+                      mBoundsMin[_index2], mBoundsMax[_index2]);
+}
+
+//==============================================================================
+bool DARTCollisionDetector::shapesOverlap(size_t _index1, size_t _index2) const
+{
+  return boxesOverlap(mShapeBoundsMin[_index1], mShapeBoundsMax[_index1],
+                      mShapeBoundsMin[_index2], mShapeBoundsMax[_index2]);
+}
+
 }  // namespace collision
 }  // namespace dart
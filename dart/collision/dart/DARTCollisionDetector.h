@@ -37,6 +37,12 @@
 #ifndef  DART_COLLISION_DART_DARTCOLLISIONDETECTOR_H_
 #define  DART_COLLISION_DART_DARTCOLLISIONDETECTOR_H_
 
+#include <utility>
+#include <vector>
+
+#include <Eigen/Dense>
+
+#include "dart/math/MathTypes.h"
 #include "dart/collision/CollisionDetector.h"
 
 namespace dart {
@@ -63,6 +69,52 @@ protected:
   virtual bool detectCollision(CollisionNode* _collNode1,
                                CollisionNode* _collNode2,
                                bool _calculateContactPoints);
+
+private:
+  /// Update the world transforms and the world-space axis-aligned bounding
+  /// boxes of all the collision shapes and collision nodes
+  void updateBoundingBoxes();
+
+  /// Collect the pairs of collision nodes whose bounding boxes overlap by
+  /// sweep-and-prune along the axis of the largest spread. The pairs are
+  /// stored in mOverlappingPairs as (i, j) with i < j in ascending order.
+  void findOverlappingPairs();
+
+  /// Return true if the bounding boxes of the two collision nodes overlap
+  bool overlaps(size_t _index1, size_t _index2) const;
+
+  /// Return true if the bounding boxes of the two collision shapes, given by
+  /// their indices into mShapeBoundsMin and mShapeBoundsMax, overlap
+  bool shapesOverlap(size_t _index1, size_t _index2) const;
+
+  /// World transforms of the collision shapes of all the collision nodes
+  Eigen::aligned_vector<Eigen::Isometry3d> mShapeTransforms;
+
+  /// Lower corners of the bounding boxes of the collision shapes
+  std::vector<Eigen::Vector3d> mShapeBoundsMin;
+
+  /// Upper corners of the bounding boxes of the collision shapes
+  std::vector<Eigen::Vector3d> mShapeBoundsMax;
+
+  /// Index of the first collision shape of each collision node in the shape
+  /// arrays above
+  std::vector<size_t> mShapeOffsets;
+
+  /// Lower corners of the bounding boxes of the collision nodes
+  std::vector<Eigen::Vector3d> mBoundsMin;
+
+  /// Upper corners of the bounding boxes of the collision nodes
+  std::vector<Eigen::Vector3d> mBoundsMax;
+
+  /// Collision node indices sorted along mSweepAxis. This is kept between the
+  /// calls so that the order is mostly sorted already in the next call.
+  std::vector<size_t> mSortedIndices;
+
+  /// Axis used by the last sweep
+  int mSweepAxis;
+
+  /// Pairs of collision nodes that passed the broadphase
+  std::vector<std::pair<size_t, size_t>> mOverlappingPairs;
 };
 
 }  // namespace collision
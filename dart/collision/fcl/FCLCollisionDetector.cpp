@@ -37,6 +37,7 @@
 
 #include "dart/collision/fcl/FCLCollisionDetector.h"
 
+#include <algorithm>
 #include <vector>
 
 #include "dart/dynamics/Shape.h"
@@ -108,6 +109,8 @@ FCLCollisionDetector::FCLCollisionDetector()
   : CollisionDetector(),
     mBroadPhaseAlg(new fcl::DynamicAABBTreeCollisionManager())
 {
+  // FCL reports duplicate contacts at the same point
+  setContactMergeTolerance(1e-6);
 }
 
 //==============================================================================
@@ -137,27 +140,6 @@ CollisionNode* FCLCollisionDetector::createCollisionNode(
   return collNode;
 }
 
-//==============================================================================
-bool isClose(const Eigen::Vector3d& _point1, const Eigen::Vector3d& _point2)
-{
-  if ((_point1 - _point2).squaredNorm() < 1e-12)
-    return true;
-  return false;
-}
-
-//==============================================================================
-bool hasClosePoint(const std::vector<Contact>& _contacts,
-                   const Eigen::Vector3d& _point)
-{
-  for (const auto& contact : _contacts)
-  {
-    if (isClose(contact.point, _point))
-      return true;
-  }
-
-  return false;
-}
-
 //==============================================================================
 bool FCLCollisionDetector::detectCollision(bool /*_checkAllCollisions*/,
                                            bool _calculateContactPoints)
@@ -170,9 +152,15 @@ bool FCLCollisionDetector::detectCollision(bool /*_checkAllCollisions*/,
     mCollisionNodes[i]->getBodyNode()->setColliding(false);
 
   // Update all the transformations of the collision nodes
+  DART_PROFILE_BEGIN(broadphaseTimer, mProfiler, BROADPHASE);
   for (auto& collNode : mCollisionNodes)
     static_cast<FCLCollisionNode*>(collNode)->updateFCLCollisionObjects();
   mBroadPhaseAlg->update();
+  DART_PROFILE_END(broadphaseTimer);
+
+  // FCL runs the narrowphase from its broadphase traversal, so the traversal
+  // is reported as a part of the narrowphase
+  DART_PROFILE_SCOPE(mProfiler, NARROWPHASE);
 
   CollisionData collData;
   collData.request.enable_contact = _calculateContactPoints;
@@ -186,17 +174,31 @@ bool FCLCollisionDetector::detectCollision(bool /*_checkAllCollisions*/,
   mBroadPhaseAlg->collide(&collData, collisionCallBack);
 
   const size_t numContacts = collData.result.numContacts();
+  mFCLContacts.resize(numContacts);
   for (size_t m = 0; m < numContacts; ++m)
   {
     const fcl::Contact& contact = collData.result.getContact(m);
+    const size_t index1 = findCollisionNode(contact.o1)->getIndex();
+    const size_t index2 = findCollisionNode(contact.o2)->getIndex();
+    mFCLContacts[m] = std::make_pair(
+          std::make_pair(std::min(index1, index2), std::max(index1, index2)), m);
+  }
 
-    Eigen::Vector3d point = FCLTypes::convertVector3(contact.pos);
+  // FCL reports the contacts of each pair of shapes together, but a pair of
+  // body nodes can have several pairs of shapes. Sort the contacts by the pairs
+  // of the collision nodes so that they are reduced per pair of body nodes.
+  std::stable_sort(mFCLContacts.begin(), mFCLContacts.end(),
+                   [](const FCLContact& _a, const FCLContact& _b)
+                   { return _a.first < _b.first; });
 
-    if (hasClosePoint(mContacts, point))
-      continue;
+  size_t pairBegin = 0;
+  for (size_t m = 0; m < numContacts; ++m)
+  {
+    const fcl::Contact& contact
+        = collData.result.getContact(mFCLContacts[m].second);
 
     Contact contactPair;
-    contactPair.point = point;
+    contactPair.point = FCLTypes::convertVector3(contact.pos);
     contactPair.normal = -FCLTypes::convertVector3(contact.normal);
     contactPair.bodyNode1 = findCollisionNode(contact.o1)->getBodyNode();
     contactPair.bodyNode2 = findCollisionNode(contact.o2)->getBodyNode();
@@ -207,8 +209,17 @@ bool FCLCollisionDetector::detectCollision(bool /*_checkAllCollisions*/,
     assert(contactPair.bodyNode2.lock());
 
     mContacts.push_back(contactPair);
+
+    if (m + 1 == numContacts
+        || mFCLContacts[m + 1].first != mFCLContacts[m].first)
+    {
+      reduceContacts(pairBegin);
+      pairBegin = mContacts.size();
+    }
   }
 
+  updateContactManifolds();
+
   for (size_t i = 0; i < mContacts.size(); ++i)
   {
     // Set these two bodies are in colliding
@@ -38,6 +38,9 @@
 #ifndef DART_COLLISION_FCL_FCLCOLLISIONDETECTOR_H_
 #define DART_COLLISION_FCL_FCLCOLLISIONDETECTOR_H_
 
+#include <utility>
+#include <vector>
+
 #include <fcl/collision_object.h>
 #include <fcl/collision_data.h>
 #include <fcl/broadphase/broadphase.h>
@@ -82,6 +85,12 @@ protected:
 
   /// Broad-phase collision checker of FCL
   fcl::DynamicAABBTreeCollisionManager* mBroadPhaseAlg;
+
+  /// Pair of the indices of the collision nodes and index of an FCL contact
+  typedef std::pair<std::pair<size_t, size_t>, size_t> FCLContact;
+
+  /// FCL contacts sorted by the pairs of the collision nodes
+  std::vector<FCLContact> mFCLContacts;
 };
 
 }  // namespace collision
@@ -49,6 +49,7 @@
 #include "dart/dynamics/MeshShape.h"
 #include "dart/dynamics/SoftMeshShape.h"
 #include "dart/collision/fcl/FCLTypes.h"
+#include "dart/collision/fcl/FCLGeometryCache.h"
 
 #define FCL_VERSION_AT_LEAST(x,y,z) \
   (FCL_MAJOR_VERSION > x || (FCL_MAJOR_VERSION >= x && \
@@ -347,6 +348,10 @@ FCLCollisionNode::FCLCollisionNode(dynamics::BodyNode* _bodyNode)
   using dynamics::MeshShape;
   using dynamics::SoftMeshShape;
 
+  // Identical shapes share their geometries, which saves building the BVHs of
+  // the same meshes over and over
+  typedef FCLGeometryCache<fcl::CollisionGeometry> GeometryCache;
+
   for (size_t i = 0; i < _bodyNode->getNumCollisionShapes(); i++)
   {
     dynamics::ShapePtr shape = _bodyNode->getCollisionShape(i);
@@ -360,7 +365,9 @@ FCLCollisionNode::FCLCollisionNode(dynamics::BodyNode* _bodyNode)
         assert(dynamic_cast<BoxShape*>(shape.get()));
         const BoxShape* box = static_cast<const BoxShape*>(shape.get());
         const Eigen::Vector3d& size = box->getSize();
-        fclCollGeom.reset(new fcl::Box(size[0], size[1], size[2]));
+        fclCollGeom = GeometryCache::getGeometry(
+              shape, {Shape::BOX, nullptr, {size[0], size[1], size[2]}},
+              [&]() { return new fcl::Box(size[0], size[1], size[2]); });
 
         break;
       }
@@ -373,19 +380,22 @@ FCLCollisionNode::FCLCollisionNode(dynamics::BodyNode* _bodyNode)
 
         if (ellipsoid->isSphere())
         {
-          fclCollGeom.reset(new fcl::Sphere(size[0] * 0.5));
+          fclCollGeom = GeometryCache::getGeometry(
+                shape, {Shape::ELLIPSOID, nullptr, {size[0]}},
+                [&]() { return new fcl::Sphere(size[0] * 0.5); });
         }
         else
         {
+          fclCollGeom = GeometryCache::getGeometry(
+                shape, {Shape::ELLIPSOID, nullptr, {size[0], size[1], size[2]}},
+                [&]() -> fcl::CollisionGeometry*
+          {
 #ifdef FCL_DART5
-          fclCollGeom.reset(
-                new fcl::Ellipsoid(FCLTypes::convertVector3(size * 0.5)));
+            return new fcl::Ellipsoid(FCLTypes::convertVector3(size * 0.5));
 #else
-          fclCollGeom.reset(
-                createEllipsoid<fcl::OBBRSS>(ellipsoid->getSize()[0],
-                                             ellipsoid->getSize()[1],
-                                             ellipsoid->getSize()[2]));
+            return createEllipsoid<fcl::OBBRSS>(size[0], size[1], size[2]);
 #endif
+          });
         }
 
         break;
@@ -396,7 +406,9 @@ FCLCollisionNode::FCLCollisionNode(dynamics::BodyNode* _bodyNode)
         CylinderShape* cylinder = static_cast<CylinderShape*>(shape.get());
         const double radius = cylinder->getRadius();
         const double height = cylinder->getHeight();
-        fclCollGeom.reset(new fcl::Cylinder(radius, height));
+        fclCollGeom = GeometryCache::getGeometry(
+              shape, {Shape::CYLINDER, nullptr, {radius, height}},
+              [&]() { return new fcl::Cylinder(radius, height); });
 
         break;
       }
@@ -406,8 +418,14 @@ FCLCollisionNode::FCLCollisionNode(dynamics::BodyNode* _bodyNode)
         dynamics::PlaneShape* plane = static_cast<PlaneShape*>(shape.get());
         const Eigen::Vector3d normal = plane->getNormal();
         const double          offset = plane->getOffset();
-        fclCollGeom.reset(
-              new fcl::Halfspace(FCLTypes::convertVector3(normal), offset));
+        fclCollGeom = GeometryCache::getGeometry(
+              shape,
+              {Shape::PLANE, nullptr,
+               {normal[0], normal[1], normal[2], offset}},
+              [&]()
+        {
+          return new fcl::Halfspace(FCLTypes::convertVector3(normal), offset);
+        });
 
         break;
       }
@@ -415,11 +433,16 @@ FCLCollisionNode::FCLCollisionNode(dynamics::BodyNode* _bodyNode)
       {
         assert(dynamic_cast<MeshShape*>(shape.get()));
         MeshShape* shapeMesh = static_cast<MeshShape*>(shape.get());
-        fclCollGeom.reset(
-            createMesh<fcl::OBBRSS>(shapeMesh->getScale()[0],
-                                    shapeMesh->getScale()[1],
-                                    shapeMesh->getScale()[2],
-                                    shapeMesh->getMesh()));
+        const Eigen::Vector3d& scale = shapeMesh->getScale();
+        fclCollGeom = GeometryCache::getGeometry(
+              shape,
+              {Shape::MESH, shapeMesh->getMesh(),
+               {scale[0], scale[1], scale[2]}},
+              [&]()
+        {
+          return createMesh<fcl::OBBRSS>(scale[0], scale[1], scale[2],
+                                         shapeMesh->getMesh());
+        });
 
         break;
       }
@@ -0,0 +1,228 @@
+/*
+ * Copyright (c) 2016, Graphics Lab, Georgia Tech Research Corporation
+ * Copyright (c) 2016, Humanoid Lab, Georgia Tech Research Corporation
+ * Copyright (c) 2016, Personal Robotics Lab, Carnegie Mellon University
+ * All rights reserved.
+ *
+ * This file is provided under the following "BSD-style" License:
+ *   Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following
+ *   conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ *   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ *   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ *   USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *   POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef DART_COLLISION_FCL_FCLGEOMETRYCACHE_H_
+#define DART_COLLISION_FCL_FCLGEOMETRYCACHE_H_
+
+#include <functional>
+#include <algorithm>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <assimp/scene.h>
+
+#include "dart/dynamics/Shape.h"
+#include "dart/dynamics/MeshShape.h"
+#include "dart/collision/fcl/FCLTypes.h"
+
+namespace dart {
+namespace collision {
+
+/// FCLGeometryCache shares the FCL geometries that are built from the same
+/// shape data, such as the BVH of a mesh with a scale or the tessellation of a
+/// primitive with a size, across the collision nodes of all the collision
+/// detectors. The cache only holds weak references, so a geometry is released
+/// together with the last collision node that uses it.
+///
+/// The shared geometries must not be modified, so geometries that are updated
+/// over time, such as the ones of soft meshes, shouldn't be cached.
+template <class GeometryT>
+class FCLGeometryCache
+{
+public:
+  typedef fcl_shared_ptr<GeometryT> GeometryPtr;
+
+  /// Key of a geometry
+  struct Key
+  {
+    /// Type of the shape
+    int type;
+
+    /// Mesh that the geometry is built from, or nullptr for primitives
+    const aiScene* mesh;
+
+    /// Parameters of the geometry such as the size or the scale
+    std::vector<double> params;
+
+    /// Lexicographic order of the keys
+    bool operator<(const Key& _other) const;
+  };
+
+  /// Return the geometry of _key, which is built from _shape. _create is
+  /// called to build a new geometry if there is none in use.
+  static GeometryPtr getGeometry(const dynamics::ShapePtr& _shape,
+                                 const Key& _key,
+                                 const std::function<GeometryT*()>& _create);
+
+  /// Get the number of geometries in the cache that are still in use
+  static size_t getNumGeometries();
+
+protected:
+  /// Cached geometry
+  struct Entry
+  {
+    /// Geometry
+    fcl_weak_ptr<GeometryT> geometry;
+
+    /// Shape that the geometry was built from. This is used to tell whether
+    /// the mesh of the key is still alive, because its address could be
+    /// reused by another mesh once it is released.
+    std::weak_ptr<dynamics::Shape> shape;
+  };
+
+  /// Process-wide state of the cache
+  struct Cache
+  {
+    /// Mutex for building the geometries from several threads
+    std::mutex mutex;
+
+    /// Cached geometries
+    std::map<Key, Entry> entries;
+
+    /// Number of entries at which the expired geometries are removed next.
+    /// Doubling it after every removal keeps the cost of the removals constant
+    /// per built geometry.
+    size_t nextPruneSize = 16;
+
+    /// Remove the geometries that are not in use anymore
+    void removeExpiredEntries();
+  };
+
+  /// Return true if the geometry of _entry can be used for _key
+  static bool isValid(const Key& _key, const Entry& _entry);
+
+  /// Get the process-wide state of the cache
+  static Cache& getCache();
+};
+
+//==============================================================================
+template <class GeometryT>
+bool FCLGeometryCache<GeometryT>::Key::operator<(const Key& _other) const
+{
+  if (type != _other.type)
+    return type < _other.type;
+
+  if (mesh != _other.mesh)
+    return mesh < _other.mesh;
+
+  return params < _other.params;
+}
+
+//==============================================================================
+template <class GeometryT>
+typename FCLGeometryCache<GeometryT>::GeometryPtr
+FCLGeometryCache<GeometryT>::getGeometry(
+    const dynamics::ShapePtr& _shape, const Key& _key,
+    const std::function<GeometryT*()>& _create)
+{
+  Cache& cache = getCache();
+  std::lock_guard<std::mutex> lock(cache.mutex);
+
+  // Expired geometries are removed lazily, so the entry can be stale
+  Entry& entry = cache.entries[_key];
+  if (isValid(_key, entry))
+  {
+    GeometryPtr geometry = entry.geometry.lock();
+    if (geometry)
+      return geometry;
+  }
+
+  GeometryPtr geometry(_create());
+  entry.geometry = geometry;
+  entry.shape = _shape;
+
+  if (cache.entries.size() >= cache.nextPruneSize)
+    cache.removeExpiredEntries();
+
+  return geometry;
+}
+
+//==============================================================================
+template <class GeometryT>
+size_t FCLGeometryCache<GeometryT>::getNumGeometries()
+{
+  Cache& cache = getCache();
+  std::lock_guard<std::mutex> lock(cache.mutex);
+
+  cache.removeExpiredEntries();
+
+  return cache.entries.size();
+}
+
+//==============================================================================
+template <class GeometryT>
+void FCLGeometryCache<GeometryT>::Cache::removeExpiredEntries()
+{
+  for (auto it = entries.begin(); it != entries.end();)
+  {
+    if (it->second.geometry.expired())
+      it = entries.erase(it);
+    else
+      ++it;
+  }
+
+  nextPruneSize = std::max<size_t>(16, 2 * entries.size());
+}
+
+//==============================================================================
+template <class GeometryT>
+bool FCLGeometryCache<GeometryT>::isValid(const Key& _key,
+                                          const Entry& _entry)
+{
+  if (nullptr == _key.mesh)
+    return true;
+
+  // The mesh is alive as long as the shape that the geometry was built from
+  // still uses it
+  const dynamics::ShapePtr shape = _entry.shape.lock();
+  if (!shape || shape->getShapeType() != dynamics::Shape::MESH)
+    return false;
+
+  return static_cast<const dynamics::MeshShape*>(shape.get())->getMesh()
+      == _key.mesh;
+}
+
+//==============================================================================
+template <class GeometryT>
+typename FCLGeometryCache<GeometryT>::Cache&
+FCLGeometryCache<GeometryT>::getCache()
+{
+  static Cache cache;
+  return cache;
+}
+
+}  // namespace collision
+}  // namespace dart
+
+#endif  // DART_COLLISION_FCL_FCLGEOMETRYCACHE_H_
@@ -75,6 +75,9 @@ CollisionNode*FCLMeshCollisionDetector::createCollisionNode(
 bool FCLMeshCollisionDetector::detectCollision(bool _checkAllCollisions,
                                                bool _calculateContactPoints)
 {
+  // Every pair of the collision nodes is checked without a broadphase
+  DART_PROFILE_SCOPE(mProfiler, NARROWPHASE);
+
   //----------------------------------------------------------------------------
   // Clear previous contact informations
   //----------------------------------------------------------------------------
@@ -116,12 +119,16 @@ bool FCLMeshCollisionDetector::detectCollision(bool _checkAllCollisions,
         mCollisionNodes[i]->getBodyNode()->setColliding(true);
         mCollisionNodes[j]->getBodyNode()->setColliding(true);
 
+        // The manifolds are not updated with the contacts of the first
+        // colliding pair only since the other pairs would lose theirs
         if (!_checkAllCollisions)
           return true;
       }
     }
   }
 
+  updateContactManifolds();
+
   return collision;
 }
 
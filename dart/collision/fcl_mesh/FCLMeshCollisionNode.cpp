@@ -54,10 +54,36 @@
 #include "dart/renderer/LoadOpengl.h"
 #include "dart/collision/fcl_mesh/CollisionShapes.h"
 #include "dart/collision/fcl_mesh/FCLMeshCollisionDetector.h"
+#include "dart/collision/fcl/FCLGeometryCache.h"
 
 namespace dart {
 namespace collision {
 
+namespace {
+
+typedef FCLGeometryCache<fcl::BVHModel<fcl::OBBRSS>> MeshCache;
+
+//==============================================================================
+/// Return the key of the BVH of a shape whose type is _type and whose local
+/// transform is _transform, which is baked into the BVH
+MeshCache::Key getMeshKey(int _type, const aiScene* _mesh,
+                          const fcl::Transform3f& _transform,
+                          std::vector<double> _params)
+{
+  const fcl::Matrix3f& R = _transform.getRotation();
+  const fcl::Vec3f& t = _transform.getTranslation();
+  for (int i = 0; i < 3; ++i)
+  {
+    for (int j = 0; j < 3; ++j)
+      _params.push_back(R(i, j));
+    _params.push_back(t[i]);
+  }
+
+  return {_type, _mesh, _params};
+}
+
+}  // anonymous namespace
+
 //==============================================================================
 FCLMeshCollisionNode::FCLMeshCollisionNode(dynamics::BodyNode* _bodyNode)
   : CollisionNode(_bodyNode)
@@ -70,7 +96,8 @@ FCLMeshCollisionNode::FCLMeshCollisionNode(dynamics::BodyNode* _bodyNode)
   using dart::dynamics::MeshShape;
   using dart::dynamics::SoftMeshShape;
 
-  // Create meshes according to types of the shapes
+  // Create meshes according to types of the shapes. Identical rigid shapes
+  // share their BVHs.
   for (size_t i = 0; i < _bodyNode->getNumCollisionShapes(); i++)
   {
     dynamics::ShapePtr shape = _bodyNode->getCollisionShape(i);
@@ -81,27 +108,46 @@ FCLMeshCollisionNode::FCLMeshCollisionNode(dynamics::BodyNode* _bodyNode)
       {
         EllipsoidShape* ellipsoid = static_cast<EllipsoidShape*>(shape.get());
         // Sphere
+        const Eigen::Vector3d& size = ellipsoid->getSize();
         if (ellipsoid->isSphere())
         {
-          fcl::BVHModel<fcl::OBBRSS>* mesh = new fcl::BVHModel<fcl::OBBRSS>;
-          fcl::generateBVHModel<fcl::OBBRSS>(
-              *mesh, fcl::Sphere(ellipsoid->getSize()[0]*0.5), shapeT, 10, 10);
-          mMeshes.push_back(mesh);
+          mMeshes.push_back(MeshCache::getGeometry(
+              shape, getMeshKey(Shape::ELLIPSOID, nullptr, shapeT, {size[0]}),
+              [&]()
+          {
+            fcl::BVHModel<fcl::OBBRSS>* mesh = new fcl::BVHModel<fcl::OBBRSS>;
+            fcl::generateBVHModel<fcl::OBBRSS>(
+                *mesh, fcl::Sphere(size[0]*0.5), shapeT, 10, 10);
+            return mesh;
+          }));
         // Ellipsoid
         }
         else
         {
-          mMeshes.push_back(createEllipsoid<fcl::OBBRSS>(
-              ellipsoid->getSize()[0], ellipsoid->getSize()[1],
-              ellipsoid->getSize()[2], shapeT));
+          mMeshes.push_back(MeshCache::getGeometry(
+              shape,
+              getMeshKey(Shape::ELLIPSOID, nullptr, shapeT,
+                         {size[0], size[1], size[2]}),
+              [&]()
+          {
+            return createEllipsoid<fcl::OBBRSS>(size[0], size[1], size[2],
+                                                shapeT);
+          }));
         }
         break;
       }
       case dynamics::Shape::BOX:
       {
         BoxShape* box = static_cast<BoxShape*>(shape.get());
-        mMeshes.push_back(createCube<fcl::OBBRSS>(
-            box->getSize()[0], box->getSize()[1], box->getSize()[2], shapeT));
+        const Eigen::Vector3d& size = box->getSize();
+        mMeshes.push_back(MeshCache::getGeometry(
+            shape,
+            getMeshKey(Shape::BOX, nullptr, shapeT,
+                       {size[0], size[1], size[2]}),
+            [&]()
+        {
+          return createCube<fcl::OBBRSS>(size[0], size[1], size[2], shapeT);
+        }));
         break;
       }
       case dynamics::Shape::CYLINDER:
@@ -109,25 +155,38 @@ FCLMeshCollisionNode::FCLMeshCollisionNode(dynamics::BodyNode* _bodyNode)
         CylinderShape* cylinder = static_cast<CylinderShape*>(shape.get());
         double radius = cylinder->getRadius();
         double height = cylinder->getHeight();
-        mMeshes.push_back(createCylinder<fcl::OBBRSS>(
-                            radius, radius, height, 16, 16, shapeT));
+        mMeshes.push_back(MeshCache::getGeometry(
+            shape,
+            getMeshKey(Shape::CYLINDER, nullptr, shapeT, {radius, height}),
+            [&]()
+        {
+          return createCylinder<fcl::OBBRSS>(radius, radius, height, 16, 16,
+                                             shapeT);
+        }));
         break;
       }
       case dynamics::Shape::MESH:
       {
         MeshShape* shapeMesh = static_cast<MeshShape*>(shape.get());
-        mMeshes.push_back(createMesh<fcl::OBBRSS>(shapeMesh->getScale()[0],
-                                                  shapeMesh->getScale()[1],
-                                                  shapeMesh->getScale()[2],
-                                                  shapeMesh->getMesh(),
-                                                  shapeT));
+        const Eigen::Vector3d& scale = shapeMesh->getScale();
+        mMeshes.push_back(MeshCache::getGeometry(
+            shape,
+            getMeshKey(Shape::MESH, shapeMesh->getMesh(), shapeT,
+                       {scale[0], scale[1], scale[2]}),
+            [&]()
+        {
+          return createMesh<fcl::OBBRSS>(scale[0], scale[1], scale[2],
+                                         shapeMesh->getMesh(), shapeT);
+        }));
         break;
       }
       case dynamics::Shape::SOFT_MESH:
       {
+        // Soft meshes are updated over time, so their BVHs are not shared
         SoftMeshShape* softMeshShape = static_cast<SoftMeshShape*>(shape.get());
-        mMeshes.push_back(createSoftMesh<fcl::OBBRSS>(
-                            softMeshShape->getAssimpMesh(), shapeT));
+        mMeshes.push_back(fcl_shared_ptr<fcl::BVHModel<fcl::OBBRSS>>(
+            createSoftMesh<fcl::OBBRSS>(softMeshShape->getAssimpMesh(),
+                                        shapeT)));
         break;
       }
       default:
@@ -143,8 +202,6 @@ FCLMeshCollisionNode::FCLMeshCollisionNode(dynamics::BodyNode* _bodyNode)
 //==============================================================================
 FCLMeshCollisionNode::~FCLMeshCollisionNode()
 {
-  for (size_t i = 0; i < mMeshes.size(); i++)
-    delete mMeshes[i];
 }
 
 //==============================================================================
@@ -167,9 +224,9 @@ bool FCLMeshCollisionNode::detectCollision(FCLMeshCollisionNode* _otherNode,
       // contact points was provided
       req.enable_contact = _contactPoints;
       req.num_max_contacts = _num_max_contact;
-      fcl::collide(mMeshes[i],
+      fcl::collide(mMeshes[i].get(),
                    mFclWorldTrans,
-                   _otherNode->mMeshes[j],
+                   _otherNode->mMeshes[j].get(),
                    _otherNode->mFclWorldTrans,
                    req, res);
 
@@ -210,8 +267,8 @@ bool FCLMeshCollisionNode::detectCollision(FCLMeshCollisionNode* _otherNode,
         pair1.shape2 = pair1.bodyNode2.lock()->getCollisionShape(j);
         pair2 = pair1;
         int contactResult =
-            evalContactPosition(res.getContact(k), mMeshes[i],
-                                _otherNode->mMeshes[j],
+            evalContactPosition(res.getContact(k), mMeshes[i].get(),
+                                _otherNode->mMeshes[j].get(),
                                 mFclWorldTrans, _otherNode->mFclWorldTrans,
                                 &pair1.point, &pair2.point);
         if (contactResult == COPLANAR_CONTACT)
@@ -47,6 +47,7 @@
 
 #include "dart/collision/CollisionNode.h"
 #include "dart/collision/CollisionDetector.h"
+#include "dart/collision/fcl/FCLTypes.h"
 #include "dart/collision/fcl_mesh/tri_tri_intersection_test.h"
 
 namespace dart {
@@ -71,8 +72,9 @@ public:
   /// Destructor
   virtual ~FCLMeshCollisionNode();
 
-  ///
-  std::vector<fcl::BVHModel<fcl::OBBRSS>*> mMeshes;
+  /// BVHs of the collision shapes. The BVHs of rigid shapes are shared with
+  /// the other collision nodes that have the same shapes.
+  std::vector<fcl_shared_ptr<fcl::BVHModel<fcl::OBBRSS>>> mMeshes;
 
   ///
   fcl::Transform3f mFclWorldTrans;
@@ -74,5 +74,14 @@ common::ResourcePtr LocalResourceRetriever::retrieve(const Uri& _uri)
     return nullptr;
 }
 
+//==============================================================================
+std::string LocalResourceRetriever::getFilePath(const Uri& _uri)
+{
+  if(!exists(_uri))
+    return "";
+
+  return _uri.getFilesystemPath();
+}
+
 } // namespace common
 } // namespace dart
@@ -54,6 +54,9 @@ public:
 
   // Documentation inherited.
   ResourcePtr retrieve(const Uri& _uri) override;
+
+  // Documentation inherited.
+  std::string getFilePath(const Uri& _uri) override;
 };
 
 using LocalResourceRetrieverPtr = std::shared_ptr<LocalResourceRetriever>;
@@ -0,0 +1,348 @@
+/*
+ * Copyright (c) 2016, Graphics Lab, Georgia Tech Research Corporation
+ * Copyright (c) 2016, Humanoid Lab, Georgia Tech Research Corporation
+ * Copyright (c) 2016, Personal Robotics Lab, Carnegie Mellon University
+ * All rights reserved.
+ *
+ * This file is provided under the following "BSD-style" License:
+ *   Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following
+ *   conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ *   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ *   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ *   USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *   POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "dart/common/Profiler.h"
+
+#include <cassert>
+#include <iomanip>
+
+#include "dart/common/Console.h"
+
+namespace dart {
+namespace common {
+
+//==============================================================================
+Profiler::StepRecord::StepRecord()
+  : stepTime(0.0)
+{
+  times.fill(0.0);
+  counts.fill(0u);
+}
+
+//==============================================================================
+Profiler::Profiler(size_t _windowSize)
+  : mStepTimer("Profiler step"),
+    mWindowSize(1),
+    mNextRecordIndex(0),
+    mNumSteps(0)
+{
+  setWindowSize(_windowSize);
+}
+
+//==============================================================================
+Profiler::~Profiler()
+{
+}
+
+//==============================================================================
+bool Profiler::isEnabled()
+{
+#ifdef DART_ENABLE_PROFILING
+  return true;
+#else
+  return false;
+#endif
+}
+
+//==============================================================================
+void Profiler::setWindowSize(size_t _windowSize)
+{
+  if (_windowSize == 0)
+  {
+    dtwarn << "[Profiler::setWindowSize] Attempting to set the window size to "
+           << "zero, which is not allowed. Using 1 instead.\n";
+    _windowSize = 1;
+  }
+
+  std::lock_guard<std::mutex> lock(mMutex);
+  mWindowSize = _windowSize;
+  mRecords.clear();
+  mRecords.reserve(mWindowSize);
+  mNextRecordIndex = 0;
+  mNumSteps = 0;
+}
+
+//==============================================================================
+size_t Profiler::getWindowSize() const
+{
+  return mWindowSize;
+}
+
+//==============================================================================
+void Profiler::beginStep()
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+  mCurrentRecord = StepRecord();
+  mStepTimer.start();
+}
+
+//==============================================================================
+void Profiler::endStep()
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+  mStepTimer.stop();
+  mCurrentRecord.stepTime = mStepTimer.getLastElapsedTime();
+
+  if (mRecords.size() < mWindowSize)
+    mRecords.push_back(mCurrentRecord);
+  else
+    mRecords[mNextRecordIndex] = mCurrentRecord;
+
+  mNextRecordIndex = (mNextRecordIndex + 1) % mWindowSize;
+  ++mNumSteps;
+}
+
+//==============================================================================
+void Profiler::addTime(Phase _phase, double _time)
+{
+  assert(_phase < NUM_PHASES);
+
+  std::lock_guard<std::mutex> lock(mMutex);
+  mCurrentRecord.times[_phase] += _time;
+}
+
+//==============================================================================
+void Profiler::addCount(Counter _counter, size_t _count)
+{
+  assert(_counter < NUM_COUNTERS);
+
+  std::lock_guard<std::mutex> lock(mMutex);
+  mCurrentRecord.counts[_counter] += _count;
+}
+
+//==============================================================================
+size_t Profiler::getNumSteps() const
+{
+  return mNumSteps;
+}
+
+//==============================================================================
+double Profiler::getLastStepTime() const
+{
+  return getLastRecord().stepTime;
+}
+
+//==============================================================================
+double Profiler::getAverageStepTime() const
+{
+  if (mRecords.empty())
+    return 0.0;
+
+  double sum = 0.0;
+  for (const auto& record : mRecords)
+    sum += record.stepTime;
+
+  return sum / mRecords.size();
+}
+
+//==============================================================================
+double Profiler::getLastTime(Phase _phase) const
+{
+  assert(_phase < NUM_PHASES);
+  return getLastRecord().times[_phase];
+}
+
+//==============================================================================
+double Profiler::getAverageTime(Phase _phase) const
+{
+  assert(_phase < NUM_PHASES);
+
+  if (mRecords.empty())
+    return 0.0;
+
+  double sum = 0.0;
+  for (const auto& record : mRecords)
+    sum += record.times[_phase];
+
+  return sum / mRecords.size();
+}
+
+//==============================================================================
+size_t Profiler::getLastCount(Counter _counter) const
+{
+  assert(_counter < NUM_COUNTERS);
+  return getLastRecord().counts[_counter];
+}
+
+//==============================================================================
+double Profiler::getAverageCount(Counter _counter) const
+{
+  assert(_counter < NUM_COUNTERS);
+
+  if (mRecords.empty())
+    return 0.0;
+
+  double sum = 0.0;
+  for (const auto& record : mRecords)
+    sum += record.counts[_counter];
+
+  return sum / mRecords.size();
+}
+
+//==============================================================================
+void Profiler::reset()
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+  mCurrentRecord = StepRecord();
+  mRecords.clear();
+  mNextRecordIndex = 0;
+  mNumSteps = 0;
+}
+
+//==============================================================================
+void Profiler::print(std::ostream& _os) const
+{
+  if (mNumSteps == 0)
+  {
+    _os << "Profiler doesn't have any record." << std::endl;
+    return;
+  }
+
+  const std::ios::fmtflags flags = _os.flags();
+  const std::streamsize precision = _os.precision();
+  _os << std::fixed << std::setprecision(4);
+
+  _os << "Profiler [" << mNumSteps << " steps, averaged over the last "
+      << mRecords.size() << "] (last / average in ms):" << std::endl;
+
+  _os << "  " << std::left << std::setw(22) << "step" << std::right
+      << std::setw(12) << getLastStepTime() * 1e+3
+      << std::setw(12) << getAverageStepTime() * 1e+3 << std::endl;
+
+  for (size_t i = 0; i < NUM_PHASES; ++i)
+  {
+    const Phase phase = static_cast<Phase>(i);
+    _os << "  " << std::left << std::setw(22) << getPhaseName(phase)
+        << std::right
+        << std::setw(12) << getLastTime(phase) * 1e+3
+        << std::setw(12) << getAverageTime(phase) * 1e+3 << std::endl;
+  }
+
+  for (size_t i = 0; i < NUM_COUNTERS; ++i)
+  {
+    const Counter counter = static_cast<Counter>(i);
+    _os << "  " << std::left << std::setw(22) << getCounterName(counter)
+        << std::right
+        << std::setw(12) << getLastCount(counter)
+        << std::setw(12) << getAverageCount(counter) << std::endl;
+  }
+
+  _os.flags(flags);
+  _os.precision(precision);
+}
+
+//==============================================================================
+const char* Profiler::getPhaseName(Phase _phase)
+{
+  switch (_phase)
+  {
+    case FORWARD_DYNAMICS:
+      return "forward dynamics";
+    case BROADPHASE:
+      return "broadphase";
+    case NARROWPHASE:
+      return "narrowphase";
+    case CONSTRAINT_CREATION:
+      return "constraint creation";
+    case LCP_ASSEMBLY:
+      return "LCP assembly";
+    case LCP_SOLVE:
+      return "LCP solve";
+    case IMPULSE_DYNAMICS:
+      return "impulse dynamics";
+    case INTEGRATION:
+      return "integration";
+    default:
+      return "unknown";
+  }
+}
+
+//==============================================================================
+const char* Profiler::getCounterName(Counter _counter)
+{
+  switch (_counter)
+  {
+    case NUM_CONTACTS:
+      return "contacts";
+    case NUM_CONTACT_MANIFOLDS:
+      return "contact manifolds";
+    case NUM_CONSTRAINTS:
+      return "constraints";
+    case NUM_CONSTRAINED_GROUPS:
+      return "constrained groups";
+    case LCP_SIZE:
+      return "LCP size";
+    default:
+      return "unknown";
+  }
+}
+
+//==============================================================================
+const Profiler::StepRecord& Profiler::getLastRecord() const
+{
+  static const StepRecord emptyRecord;
+
+  if (mRecords.empty())
+    return emptyRecord;
+
+  const size_t index = (mNextRecordIndex + mWindowSize - 1) % mWindowSize;
+  return mRecords[index];
+}
+
+//==============================================================================
+ProfileTimer::ProfileTimer(Profiler* _profiler, Profiler::Phase _phase)
+  : Timer(Profiler::getPhaseName(_phase)),
+    mProfiler(_profiler),
+    mPhase(_phase)
+{
+  if (mProfiler)
+    start();
+}
+
+//==============================================================================
+ProfileTimer::~ProfileTimer()
+{
+  if (isStarted())
+    report();
+}
+
+//==============================================================================
+void ProfileTimer::report()
+{
+  if (!isStarted())
+    return;
+
+  stop();
+  mProfiler->addTime(mPhase, getLastElapsedTime());
+}
+
+}  // namespace common
+}  // namespace dart
@@ -0,0 +1,254 @@
+/*
+ * Copyright (c) 2016, Graphics Lab, Georgia Tech Research Corporation
+ * Copyright (c) 2016, Humanoid Lab, Georgia Tech Research Corporation
+ * Copyright (c) 2016, Personal Robotics Lab, Carnegie Mellon University
+ * All rights reserved.
+ *
+ * This file is provided under the following "BSD-style" License:
+ *   Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following
+ *   conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ *   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ *   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ *   USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *   POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef DART_COMMON_PROFILER_H_
+#define DART_COMMON_PROFILER_H_
+
+#include <array>
+#include <iostream>
+#include <mutex>
+#include <vector>
+
+#include "dart/config.h"
+#include "dart/common/Timer.h"
+
+namespace dart {
+namespace common {
+
+/// Profiler aggregates the time spent in each phase of a simulation step and a
+/// few counters describing the step. The phases are measured by ProfileTimer,
+/// usually through the DART_PROFILE_* macros below, which compile to nothing
+/// unless DART is built with DART_ENABLE_PROFILING.
+///
+/// The times measured in parallel regions are accumulated over the threads, so
+/// the sum of the phases can exceed the wall time of the step.
+class Profiler
+{
+public:
+  /// Phases of a simulation step
+  enum Phase
+  {
+    FORWARD_DYNAMICS = 0,
+    BROADPHASE,
+    NARROWPHASE,
+    CONSTRAINT_CREATION,
+    LCP_ASSEMBLY,
+    LCP_SOLVE,
+    IMPULSE_DYNAMICS,
+    INTEGRATION,
+    NUM_PHASES
+  };
+
+  /// Quantities counted in a simulation step
+  enum Counter
+  {
+    NUM_CONTACTS = 0,
+    NUM_CONTACT_MANIFOLDS,
+    NUM_CONSTRAINTS,
+    NUM_CONSTRAINED_GROUPS,
+    LCP_SIZE,
+    NUM_COUNTERS
+  };
+
+  /// Constructor. The averages are taken over the last _windowSize steps.
+  explicit Profiler(size_t _windowSize = 100);
+
+  /// Destructor
+  virtual ~Profiler();
+
+  /// Return true if DART is built with the profiling timers
+  static bool isEnabled();
+
+  /// Set the number of steps the averages are taken over. This clears the
+  /// recorded steps.
+  void setWindowSize(size_t _windowSize);
+
+  /// Get the number of steps the averages are taken over
+  size_t getWindowSize() const;
+
+  /// Start recording a new step
+  void beginStep();
+
+  /// Finish recording the current step
+  void endStep();
+
+  /// Add _time seconds to _phase of the current step. This is thread-safe.
+  void addTime(Phase _phase, double _time);
+
+  /// Add _count to _counter of the current step. This is thread-safe.
+  void addCount(Counter _counter, size_t _count);
+
+  /// Get the number of recorded steps
+  size_t getNumSteps() const;
+
+  /// Get the wall time of the last step in seconds
+  double getLastStepTime() const;
+
+  /// Get the average wall time of the recorded steps in seconds
+  double getAverageStepTime() const;
+
+  /// Get the time spent in _phase in the last step in seconds
+  double getLastTime(Phase _phase) const;
+
+  /// Get the average time spent in _phase over the recorded steps in seconds
+  double getAverageTime(Phase _phase) const;
+
+  /// Get the value of _counter in the last step
+  size_t getLastCount(Counter _counter) const;
+
+  /// Get the average value of _counter over the recorded steps
+  double getAverageCount(Counter _counter) const;
+
+  /// Clear all the recorded steps
+  void reset();
+
+  /// Print the last and average times and counters
+  void print(std::ostream& _os = std::cout) const;
+
+  /// Get the name of _phase
+  static const char* getPhaseName(Phase _phase);
+
+  /// Get the name of _counter
+  static const char* getCounterName(Counter _counter);
+
+protected:
+  /// Times and counters of a single step
+  struct StepRecord
+  {
+    /// Constructor
+    StepRecord();
+
+    /// Wall time of the step
+    double stepTime;
+
+    /// Time spent in each phase
+    std::array<double, NUM_PHASES> times;
+
+    /// Value of each counter
+    std::array<size_t, NUM_COUNTERS> counts;
+  };
+
+  /// Return the record of the last step
+  const StepRecord& getLastRecord() const;
+
+  /// Timer for the wall time of the current step
+  Timer mStepTimer;
+
+  /// Record of the current step
+  StepRecord mCurrentRecord;
+
+  /// Records of the last mWindowSize steps used as a ring buffer
+  std::vector<StepRecord> mRecords;
+
+  /// Number of steps the averages are taken over
+  size_t mWindowSize;
+
+  /// Index of the next record to be overwritten in mRecords
+  size_t mNextRecordIndex;
+
+  /// Number of recorded steps
+  size_t mNumSteps;
+
+  /// Mutex for adding times and counts from several threads
+  mutable std::mutex mMutex;
+};
+
+/// ProfileTimer is a Timer that reports the elapsed time to a Profiler. It
+/// starts when it is constructed and reports when it is stopped by report() or
+/// destructed, whichever comes first.
+class ProfileTimer : public Timer
+{
+public:
+  /// Constructor. Nothing is measured if _profiler is nullptr.
+  ProfileTimer(Profiler* _profiler, Profiler::Phase _phase);
+
+  /// Destructor
+  virtual ~ProfileTimer();
+
+  /// Stop the timer and add the elapsed time to the profiler
+  void report();
+
+protected:
+  /// Profiler to report to
+  Profiler* mProfiler;
+
+  /// Phase being measured
+  Profiler::Phase mPhase;
+};
+
+}  // namespace common
+}  // namespace dart
+
+#ifdef DART_ENABLE_PROFILING
+
+#define DART_PROFILE_DETAIL_CONCAT_IMPL(a, b) a##b
+#define DART_PROFILE_DETAIL_CONCAT(a, b) DART_PROFILE_DETAIL_CONCAT_IMPL(a, b)
+
+/// Measure the time until the end of the enclosing scope as _phase
+#define DART_PROFILE_SCOPE(_profiler, _phase)                                  \
+  ::dart::common::ProfileTimer                                                 \
+      DART_PROFILE_DETAIL_CONCAT(dartProfileTimer, __LINE__)(                  \
+          _profiler, ::dart::common::Profiler::_phase)
+
+/// Start measuring _phase with a timer called _name
+#define DART_PROFILE_BEGIN(_name, _profiler, _phase)                           \
+  ::dart::common::ProfileTimer _name(_profiler,                                \
+                                     ::dart::common::Profiler::_phase)
+
+/// Stop the timer called _name and report the time
+#define DART_PROFILE_END(_name) _name.report()
+
+/// Add _count to _counter
+#define DART_PROFILE_COUNT(_profiler, _counter, _count)                        \
+  do                                                                           \
+  {                                                                            \
+    if (_profiler)                                                             \
+      (_profiler)->addCount(::dart::common::Profiler::_counter, _count);       \
+  } while (false)
+
+/// Start recording a step
+#define DART_PROFILE_BEGIN_STEP(_profiler) (_profiler)->beginStep()
+
+/// Finish recording a step
+#define DART_PROFILE_END_STEP(_profiler) (_profiler)->endStep()
+
+#else
+
+#define DART_PROFILE_SCOPE(_profiler, _phase)
+#define DART_PROFILE_BEGIN(_name, _profiler, _phase)
+#define DART_PROFILE_END(_name)
+#define DART_PROFILE_COUNT(_profiler, _counter, _count)
+#define DART_PROFILE_BEGIN_STEP(_profiler)
+#define DART_PROFILE_END_STEP(_profiler)
+
+#endif  // DART_ENABLE_PROFILING
+
+#endif  // DART_COMMON_PROFILER_H_
@@ -59,6 +59,12 @@ public:
   /// \brief Return the resource specified by a URI or nullptr on failure.
   virtual ResourcePtr retrieve(const Uri& _uri) = 0;
 
+  /// Return the path of the local file that the resource specified by a URI
+  /// is retrieved from, or an empty string if the resource doesn't exist or is
+  /// not a local file. This identifies the resources of different URIs, e.g.
+  /// package:// and file:// URIs, that refer to the same file.
+  virtual std::string getFilePath(const Uri& _uri);
+
   // We don't const-qualify for exists and retrieve here. Derived classes of
   // ResourceRetriever will be interacting with external resources that you
   // don't necessarily have control over so we cannot guarantee that you get the
@@ -68,6 +74,12 @@ public:
 
 using ResourceRetrieverPtr = std::shared_ptr<ResourceRetriever>;
 
+//==============================================================================
+inline std::string ResourceRetriever::getFilePath(const Uri& /*_uri*/)
+{
+  return "";
+}
+
 } // namespace common
 } // namespace dart
 
@@ -0,0 +1,350 @@
+/*
+ * Copyright (c) 2016, Graphics Lab, Georgia Tech Research Corporation
+ * Copyright (c) 2016, Humanoid Lab, Georgia Tech Research Corporation
+ * Copyright (c) 2016, Personal Robotics Lab, Carnegie Mellon University
+ * All rights reserved.
+ *
+ * This file is provided under the following "BSD-style" License:
+ *   Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following
+ *   conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ *   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ *   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ *   USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *   POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "dart/constraint/BlockPGSLCPSolver.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+#include "dart/dynamics/BodyNode.h"
+#include "dart/dynamics/Skeleton.h"
+#include "dart/constraint/ConstraintBase.h"
+#include "dart/constraint/ConstrainedGroup.h"
+
+#define DART_BLOCK_PGS_DEFAULT_MAX_ITERATIONS 50
+#define DART_BLOCK_PGS_DEFAULT_TOLERANCE      1e-6
+#define DART_BLOCK_PGS_EPS_DIVIDE             1e-9
+
+namespace dart {
+namespace constraint {
+
+//==============================================================================
+BlockPGSLCPSolver::BlockPGSLCPSolver(double _timestep)
+  : LCPSolver(_timestep),
+    mFallbackSolver(_timestep),
+    mMaxIterations(DART_BLOCK_PGS_DEFAULT_MAX_ITERATIONS),
+    mTolerance(DART_BLOCK_PGS_DEFAULT_TOLERANCE),
+    mWarmStarting(true)
+{
+}
+
+//==============================================================================
+BlockPGSLCPSolver::~BlockPGSLCPSolver()
+{
+}
+
+//==============================================================================
+void BlockPGSLCPSolver::solve(ConstrainedGroup* _group)
+{
+  // If there is no constraint, then just return true.
+  size_t numConstraints = _group->getNumConstraints();
+  if (numConstraints == 0)
+    return;
+
+  if (!collectBodyJacobians(_group))
+  {
+    mFallbackSolver.solve(_group);
+    return;
+  }
+
+  // Build LCP terms except for the LCP matrix
+  DART_PROFILE_BEGIN(assemblyTimer, mProfiler, LCP_ASSEMBLY);
+  size_t n = _group->getTotalDimension();
+
+  LCPWorkspace& workspace = _group->getWorkspace();
+  workspace.resize(n, numConstraints, 0);
+  double* x = workspace.x.data();
+  double* b = workspace.b.data();
+  double* w = workspace.w.data();
+  double* lo = workspace.lo.data();
+  double* hi = workspace.hi.data();
+  int* findex = workspace.findex.data();
+  size_t* offset = workspace.offset.data();
+
+  std::fill(w, w + n, 0.0);
+  std::memset(findex, -1, n * sizeof(int));
+
+  offset[0] = 0;
+  for (size_t i = 1; i < numConstraints; ++i)
+    offset[i] = offset[i - 1] + _group->getConstraint(i - 1)->getDimension();
+
+  ConstraintInfo constInfo;
+  constInfo.invTimeStep = 1.0 / mTimeStep;
+  for (size_t i = 0; i < numConstraints; ++i)
+  {
+    ConstraintBase* constraint = _group->getConstraint(i);
+
+    constInfo.x      = x      + offset[i];
+    constInfo.lo     = lo     + offset[i];
+    constInfo.hi     = hi     + offset[i];
+    constInfo.b      = b      + offset[i];
+    constInfo.findex = findex + offset[i];
+    constInfo.w      = w      + offset[i];
+
+    // Fill vectors: lo, hi, b, w
+    constraint->getInformation(&constInfo);
+
+    // Adjust findex for global index
+    for (size_t j = 0; j < constraint->getDimension(); ++j)
+    {
+      if (findex[offset[i] + j] >= 0)
+        findex[offset[i] + j] += offset[i];
+    }
+  }
+
+  if (!mWarmStarting)
+    std::fill(x, x + n, 0.0);
+
+  const std::vector<BodyJacobianInfo>& infos = workspace.bodyJacobians;
+  const std::vector<dynamics::Skeleton*>& skeletons = workspace.skeletons;
+
+  // Each row acts on at most two skeletons. For each of them, keep the
+  // generalized Jacobian of the row and the velocity change due to the unit
+  // impulse of the row. The vectors are kept in the workspace, so they are
+  // only reallocated when the group changes.
+  std::vector<int>& rowSkeletons = workspace.rowSkeletons;
+  std::vector<Eigen::VectorXd>& jacobians = workspace.rowJacobians;
+  std::vector<Eigen::VectorXd>& invMassJacobians = workspace.rowResponses;
+  Eigen::VectorXd& diagonal = workspace.diagonal;
+  Eigen::VectorXd& mixing = workspace.mixing;
+  rowSkeletons.assign(2 * n, -1);
+  jacobians.resize(2 * n);
+  invMassJacobians.resize(2 * n);
+  diagonal.setZero(n);
+  mixing.setZero(n);
+
+  for (size_t i = 0; i < numConstraints; ++i)
+  {
+    const BodyJacobianInfo& info = infos[i];
+    const size_t dim = _group->getConstraint(i)->getDimension();
+
+    for (size_t k = 0; k < 2; ++k)
+    {
+      dynamics::BodyNode* bodyNode = info.bodyNodes[k];
+      if (nullptr == bodyNode || !bodyNode->isReactive())
+        continue;
+
+      dynamics::Skeleton* skel = bodyNode->getSkeleton().get();
+      const int skelIndex = static_cast<int>(
+            std::find(skeletons.begin(), skeletons.end(), skel)
+            - skeletons.begin());
+
+      const math::Jacobian& J = bodyNode->getJacobian();
+      const size_t numDepDofs = bodyNode->getNumDependentGenCoords();
+
+      for (size_t r = 0; r < dim; ++r)
+      {
+        const size_t row = offset[i] + r;
+
+        // Both body nodes can belong to the same skeleton
+        size_t slot = 2 * row;
+        if (rowSkeletons[slot] >= 0 && rowSkeletons[slot] != skelIndex)
+          ++slot;
+
+        if (rowSkeletons[slot] < 0)
+        {
+          rowSkeletons[slot] = skelIndex;
+          jacobians[slot].setZero(skel->getNumDofs());
+        }
+
+        for (size_t d = 0; d < numDepDofs; ++d)
+        {
+          jacobians[slot][bodyNode->getDependentGenCoordIndex(d)]
+              += J.col(d).dot(info.jacobians[k][r]);
+        }
+      }
+    }
+
+    for (size_t r = 0; r < dim; ++r)
+    {
+      const size_t row = offset[i] + r;
+
+      for (size_t slot = 2 * row; slot < 2 * row + 2; ++slot)
+      {
+        if (rowSkeletons[slot] < 0)
+          continue;
+
+        invMassJacobians[slot] = jacobians[slot];
+        skeletons[rowSkeletons[slot]]->solveMassMatrixInPlace(
+              invMassJacobians[slot]);
+        diagonal[row] += jacobians[slot].dot(invMassJacobians[slot]);
+      }
+
+      // Add small values to the diagonal to keep it away from singular
+      mixing[row] = diagonal[row] * info.cfm;
+      diagonal[row] += mixing[row];
+    }
+  }
+
+  // Velocity changes of the skeletons due to the initial impulses
+  std::vector<Eigen::VectorXd>& velocityChanges = workspace.velocityChanges;
+  velocityChanges.resize(skeletons.size());
+  for (size_t s = 0; s < skeletons.size(); ++s)
+    velocityChanges[s].setZero(skeletons[s]->getNumDofs());
+
+  for (size_t row = 0; row < n; ++row)
+  {
+    if (diagonal[row] < DART_BLOCK_PGS_EPS_DIVIDE)
+    {
+      x[row] = 0.0;
+      continue;
+    }
+
+    for (size_t slot = 2 * row; slot < 2 * row + 2; ++slot)
+    {
+      if (rowSkeletons[slot] >= 0)
+        velocityChanges[rowSkeletons[slot]] += invMassJacobians[slot] * x[row];
+    }
+  }
+
+  DART_PROFILE_END(assemblyTimer);
+
+  // Projected Gauss-Seidel iterations
+  DART_PROFILE_BEGIN(solveTimer, mProfiler, LCP_SOLVE);
+  for (size_t iter = 0; iter < mMaxIterations; ++iter)
+  {
+    double maxChange = 0.0;
+
+    for (size_t row = 0; row < n; ++row)
+    {
+      if (diagonal[row] < DART_BLOCK_PGS_EPS_DIVIDE)
+        continue;
+
+      // Current value of the row of A * x
+      double Ax = mixing[row] * x[row];
+      for (size_t slot = 2 * row; slot < 2 * row + 2; ++slot)
+      {
+        if (rowSkeletons[slot] >= 0)
+          Ax += jacobians[slot].dot(velocityChanges[rowSkeletons[slot]]);
+      }
+
+      double newX = x[row] + (b[row] - Ax) / diagonal[row];
+
+      // Friction impulses are bounded by the normal impulse
+      double lower = lo[row];
+      double upper = hi[row];
+      if (findex[row] >= 0)
+      {
+        upper = std::abs(hi[row] * x[findex[row]]);
+        lower = -upper;
+      }
+      newX = std::min(std::max(newX, lower), upper);
+
+      const double change = newX - x[row];
+      if (change == 0.0)
+        continue;
+
+      x[row] = newX;
+      maxChange = std::max(maxChange, std::abs(change));
+
+      for (size_t slot = 2 * row; slot < 2 * row + 2; ++slot)
+      {
+        if (rowSkeletons[slot] >= 0)
+        {
+          velocityChanges[rowSkeletons[slot]]
+              += invMassJacobians[slot] * change;
+        }
+      }
+    }
+
+    if (maxChange < mTolerance)
+      break;
+  }
+
+  DART_PROFILE_END(solveTimer);
+
+  // Apply constraint impulses
+  for (size_t i = 0; i < numConstraints; ++i)
+  {
+    ConstraintBase* constraint = _group->getConstraint(i);
+    constraint->applyImpulse(x + offset[i]);
+    constraint->excite();
+  }
+}
+
+//==============================================================================
+void BlockPGSLCPSolver::setTimeStep(double _timeStep)
+{
+  LCPSolver::setTimeStep(_timeStep);
+  mFallbackSolver.setTimeStep(_timeStep);
+}
+
+#ifdef DART_ENABLE_PROFILING
+//==============================================================================
+void BlockPGSLCPSolver::setProfiler(common::Profiler* _profiler)
+{
+  LCPSolver::setProfiler(_profiler);
+  mFallbackSolver.setProfiler(_profiler);
+}
+#endif
+
+//==============================================================================
+void BlockPGSLCPSolver::setMaxIterations(size_t _maxIterations)
+{
+  mMaxIterations = _maxIterations;
+}
+
+//==============================================================================
+size_t BlockPGSLCPSolver::getMaxIterations() const
+{
+  return mMaxIterations;
+}
+
+//==============================================================================
+void BlockPGSLCPSolver::setTolerance(double _tolerance)
+{
+  assert(_tolerance >= 0.0);
+  mTolerance = _tolerance;
+}
+
+//==============================================================================
+double BlockPGSLCPSolver::getTolerance() const
+{
+  return mTolerance;
+}
+
+//==============================================================================
+void BlockPGSLCPSolver::setWarmStarting(bool _warmStarting)
+{
+  mWarmStarting = _warmStarting;
+}
+
+//==============================================================================
+bool BlockPGSLCPSolver::isWarmStarting() const
+{
+  return mWarmStarting;
+}
+
+}  // namespace constraint
+}  // namespace dart
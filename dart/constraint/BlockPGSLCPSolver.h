@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2016, Graphics Lab, Georgia Tech Research Corporation
+ * Copyright (c) 2016, Humanoid Lab, Georgia Tech Research Corporation
+ * Copyright (c) 2016, Personal Robotics Lab, Carnegie Mellon University
+ * All rights reserved.
+ *
+ * This file is provided under the following "BSD-style" License:
+ *   Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following
+ *   conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ *   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ *   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ *   USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *   POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef DART_CONSTRAINT_BLOCKPGSLCPSOLVER_H_
+#define DART_CONSTRAINT_BLOCKPGSLCPSOLVER_H_
+
+#include <cstddef>
+
+#include "dart/constraint/LCPSolver.h"
+#include "dart/constraint/PGSLCPSolver.h"
+
+namespace dart {
+namespace constraint {
+
+/// BlockPGSLCPSolver solves the constraint impulses with projected
+/// Gauss-Seidel iterations in the manner of sequential impulses. Instead of
+/// forming the dense LCP matrix, it keeps the generalized Jacobian of each
+/// constraint row and accumulates the velocity changes of the skeletons, so
+/// the memory grows linearly with the number of constraints.
+///
+/// The initial impulses given by the constraints, e.g., the impulses of the
+/// last time step of persistent contacts, are used as the warm start. Groups
+/// that contain constraints without body Jacobians are solved by
+/// PGSLCPSolver.
+class BlockPGSLCPSolver : public LCPSolver
+{
+public:
+  /// Constructor
+  explicit BlockPGSLCPSolver(double _timestep);
+
+  /// Destructor
+  virtual ~BlockPGSLCPSolver();
+
+  // Documentation inherited
+  virtual void solve(ConstrainedGroup* _group);
+
+  // Documentation inherited
+  virtual void setTimeStep(double _timeStep);
+
+#ifdef DART_ENABLE_PROFILING
+  // Documentation inherited
+  virtual void setProfiler(common::Profiler* _profiler);
+#endif
+
+  /// Set the maximum number of iterations
+  void setMaxIterations(size_t _maxIterations);
+
+  /// Get the maximum number of iterations
+  size_t getMaxIterations() const;
+
+  /// Set the tolerance of the impulse changes. The iterations stop when no
+  /// impulse changes more than this value in an iteration.
+  void setTolerance(double _tolerance);
+
+  /// Get the tolerance of the impulse changes
+  double getTolerance() const;
+
+  /// Set whether the initial impulses given by the constraints are used
+  void setWarmStarting(bool _warmStarting);
+
+  /// Return true if the initial impulses given by the constraints are used
+  bool isWarmStarting() const;
+
+protected:
+  /// Solver for the groups that can't be solved in the block-sparse form
+  PGSLCPSolver mFallbackSolver;
+
+  /// Maximum number of iterations
+  size_t mMaxIterations;
+
+  /// Tolerance of the impulse changes
+  double mTolerance;
+
+  /// Whether the initial impulses given by the constraints are used
+  bool mWarmStarting;
+};
+
+}  // namespace constraint
+}  // namespace dart
+
+#endif  // DART_CONSTRAINT_BLOCKPGSLCPSOLVER_H_
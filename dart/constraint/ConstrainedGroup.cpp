@@ -136,5 +136,11 @@ size_t ConstrainedGroup::getTotalDimension() const
   return totalDim;
 }
 
+//==============================================================================
+LCPWorkspace& ConstrainedGroup::getWorkspace()
+{
+  return mWorkspace;
+}
+
 }  // namespace constraint
 }  // namespace dart
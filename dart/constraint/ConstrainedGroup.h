@@ -41,6 +41,8 @@
 #include <memory>
 #include <Eigen/Dense>
 
+#include "dart/constraint/LCPSolver.h"
+
 namespace dart {
 
 namespace dynamics {
@@ -91,6 +93,9 @@ public:
   /// Get total dimension of contraints in this group
   size_t getTotalDimension() const;
 
+  /// Get the buffers that the LCP solver reuses for this group
+  LCPWorkspace& getWorkspace();
+
   //----------------------------------------------------------------------------
   // Friendship
   //----------------------------------------------------------------------------
@@ -109,6 +114,9 @@ private:
 
   ///
   std::shared_ptr<dynamics::Skeleton> mRootSkeleton;
+
+  /// Buffers of the LCP solver
+  LCPWorkspace mWorkspace;
 };
 
 }  // namespace constraint
@@ -63,6 +63,12 @@ size_t ConstraintBase::getDimension() const
   return mDim;
 }
 
+//==============================================================================
+bool ConstraintBase::getBodyJacobians(BodyJacobianInfo* /*_info*/) const
+{
+  return false;
+}
+
 //==============================================================================
 dynamics::SkeletonPtr ConstraintBase::compressPath(
     dynamics::SkeletonPtr _skeleton)
@@ -39,11 +39,13 @@
 
 #include <cstddef>
 
+#include "dart/math/MathTypes.h"
 #include "dart/dynamics/SmartPointer.h"
 
 namespace dart {
 
 namespace dynamics {
+class BodyNode;
 class Skeleton;
 }  // namespace dynamics
 
@@ -74,6 +76,21 @@ struct ConstraintInfo
   double invTimeStep;
 };
 
+/// BodyJacobianInfo
+struct BodyJacobianInfo
+{
+  /// Body nodes that the constraint acts on. The second one is null if the
+  /// constraint acts on a single body node.
+  dynamics::BodyNode* bodyNodes[2];
+
+  /// Jacobians of the constraint rows with respect to the spatial velocities
+  /// of the body nodes, expressed in the frames of the body nodes
+  const Eigen::Vector6d* jacobians[2];
+
+  /// Constraint force mixing, which scales the diagonal of the LCP matrix
+  double cfm;
+};
+
 /// Constraint is a base class of concrete constraints classes
 class ConstraintBase
 {
@@ -102,6 +119,11 @@ public:
   /// Apply computed constraint impulse to constrained skeletons
   virtual void applyImpulse(double* _lambda) = 0;
 
+  /// Get the Jacobians of this constraint with respect to the body nodes that
+  /// it acts on. Return false if this constraint doesn't provide them, in
+  /// which case the LCP matrix is filled by the unit impulse tests.
+  virtual bool getBodyJacobians(BodyJacobianInfo* _info) const;
+
   /// Return true if this constraint is active
   virtual bool isActive() const = 0;
 
@@ -36,6 +36,8 @@
 
 #include "dart/constraint/ConstraintSolver.h"
 
+#include <algorithm>
+
 #include "dart/common/Console.h"
 #include "dart/dynamics/BodyNode.h"
 #include "dart/dynamics/SoftBodyNode.h"
@@ -59,11 +61,18 @@ namespace constraint {
 
 using namespace dynamics;
 
+const size_t ConstraintSolver::NO_CONSTRAINED_GROUP;
+
 //==============================================================================
 ConstraintSolver::ConstraintSolver(double _timeStep)
   : mCollisionDetector(new collision::FCLMeshCollisionDetector()),
     mTimeStep(_timeStep),
-    mLCPSolver(new DantzigLCPSolver(mTimeStep))
+    mLCPSolver(new DantzigLCPSolver(mTimeStep)),
+    mNumThreads(1),
+#ifdef DART_ENABLE_PROFILING
+    mProfiler(nullptr),
+#endif
+    mNumConstrainedGroups(0)
 {
   assert(_timeStep > 0.0);
 }
@@ -73,6 +82,22 @@ ConstraintSolver::~ConstraintSolver()
 {
   delete mCollisionDetector;
   delete mLCPSolver;
+
+  for (const auto& contactConstraint : mContactConstraints)
+    delete contactConstraint;
+  for (const auto& contactConstraint : mContactConstraintPool)
+    delete contactConstraint;
+
+  for (const auto& softContactConstraint : mSoftContactConstraints)
+    delete softContactConstraint;
+  for (const auto& softContactConstraint : mSoftContactConstraintPool)
+    delete softContactConstraint;
+
+  for (const auto& jointLimitConstraint : mJointLimitConstraints)
+    delete jointLimitConstraint;
+
+  for (const auto& jointFrictionConstraint : mJointCoulombFrictionConstraints)
+    delete jointFrictionConstraint;
 }
 
 //==============================================================================
@@ -244,6 +269,10 @@ void ConstraintSolver::setCollisionDetector(
   for (size_t i = 0; i < mSkeletons.size(); ++i)
     _collisionDetector->addSkeleton(mSkeletons[i]);
 
+#ifdef DART_ENABLE_PROFILING
+  _collisionDetector->setProfiler(mProfiler);
+#endif
+
   // Release the old collision detector
   delete mCollisionDetector;
 
@@ -257,6 +286,60 @@ collision::CollisionDetector* ConstraintSolver::getCollisionDetector() const
   return mCollisionDetector;
 }
 
+//==============================================================================
+void ConstraintSolver::setLCPSolver(LCPSolver* _lcpSolver)
+{
+  assert(_lcpSolver && "Invalid LCP solver.");
+
+  if (_lcpSolver == mLCPSolver)
+    return;
+
+  _lcpSolver->setTimeStep(mTimeStep);
+#ifdef DART_ENABLE_PROFILING
+  _lcpSolver->setProfiler(mProfiler);
+#endif
+
+  // Release the old LCP solver
+  delete mLCPSolver;
+
+  mLCPSolver = _lcpSolver;
+}
+
+//==============================================================================
+LCPSolver* ConstraintSolver::getLCPSolver() const
+{
+  return mLCPSolver;
+}
+
+//==============================================================================
+void ConstraintSolver::setNumThreads(size_t _numThreads)
+{
+  assert(_numThreads > 0 && "Number of threads should be positive.");
+  mNumThreads = _numThreads;
+}
+
+//==============================================================================
+size_t ConstraintSolver::getNumThreads() const
+{
+  return mNumThreads;
+}
+
+#ifdef DART_ENABLE_PROFILING
+//==============================================================================
+void ConstraintSolver::setProfiler(common::Profiler* _profiler)
+{
+  mProfiler = _profiler;
+  mCollisionDetector->setProfiler(_profiler);
+  mLCPSolver->setProfiler(_profiler);
+}
+
+//==============================================================================
+common::Profiler* ConstraintSolver::getProfiler() const
+{
+  return mProfiler;
+}
+#endif
+
 //==============================================================================
 void ConstraintSolver::solve()
 {
@@ -269,10 +352,205 @@ void ConstraintSolver::solve()
   // Build constrained groups
   buildConstrainedGroups();
 
+  // The skeletons that are woken up by the skeletons they are constrained with
+  // missed the forward dynamics of this step, and the collision detection
+  // skipped their contacts with the sleeping and the immobile skeletons. They
+  // catch up on both, and the constraints are updated again until no more
+  // skeleton wakes up.
+  while (!mWokenSkeletons.empty())
+  {
+    for (dynamics::Skeleton* skel : mWokenSkeletons)
+    {
+      skel->computeForwardDynamics();
+      skel->integrateVelocities(mTimeStep);
+    }
+
+    updateConstraints();
+    buildConstrainedGroups();
+  }
+
+  DART_PROFILE_COUNT(mProfiler, NUM_CONSTRAINTS, mActiveConstraints.size());
+  DART_PROFILE_COUNT(mProfiler, NUM_CONSTRAINED_GROUPS, mNumConstrainedGroups);
+
   // Solve constrained groups
   solveConstrainedGroups();
 }
 
+//==============================================================================
+void ConstraintSolver::reset()
+{
+  clearConstrainedGroups();
+
+  // Keep the contact constraints in the pools to reinitialize them without
+  // warm starts
+  mContactConstraintPool.insert(mContactConstraintPool.end(),
+                                mContactConstraints.begin(),
+                                mContactConstraints.end());
+  mContactConstraints.clear();
+  mSoftContactConstraintPool.insert(mSoftContactConstraintPool.end(),
+                                    mSoftContactConstraints.begin(),
+                                    mSoftContactConstraints.end());
+  mSoftContactConstraints.clear();
+
+  // The joint constraints keep their impulses, so destroy them
+  for (JointLimitConstraint* constraint : mJointLimitConstraints)
+    delete constraint;
+  mJointLimitConstraints.clear();
+
+  for (JointCoulombFrictionConstraint* constraint
+       : mJointCoulombFrictionConstraints)
+  {
+    delete constraint;
+  }
+  mJointCoulombFrictionConstraints.clear();
+
+  if (mCollisionDetector)
+    mCollisionDetector->clearContactManifolds();
+}
+
+//==============================================================================
+size_t ConstraintSolver::getNumConstrainedGroups() const
+{
+  return mNumConstrainedGroups;
+}
+
+//==============================================================================
+size_t ConstraintSolver::getConstrainedGroupIndex(size_t _index) const
+{
+  assert(_index < mSkeletons.size());
+
+  if (_index >= mConstrainedGroupIndices.size())
+    return NO_CONSTRAINED_GROUP;
+
+  return mConstrainedGroupIndices[_index];
+}
+
+//==============================================================================
+size_t ConstraintSolver::getWarmStartStateSize() const
+{
+  // The numbers of the constraints are followed by the impulses of the contact
+  // constraints and six values per joint constraint
+  return 3 + 3 * mContactConstraints.size()
+      + 6 * (mJointLimitConstraints.size()
+             + mJointCoulombFrictionConstraints.size());
+}
+
+//==============================================================================
+void ConstraintSolver::getWarmStartState(double* _state) const
+{
+  *_state++ = mContactConstraints.size();
+  *_state++ = mJointLimitConstraints.size();
+  *_state++ = mJointCoulombFrictionConstraints.size();
+
+  // The contacts are identified by their manifold IDs and feature IDs, which
+  // are restored along with the contacts of the collision detector
+  for (const ContactConstraint* constraint : mContactConstraints)
+  {
+    Eigen::Vector3d::Map(_state) = constraint->mImpulse;
+    _state += 3;
+  }
+
+  for (const JointLimitConstraint* constraint : mJointLimitConstraints)
+  {
+    std::copy(constraint->mOldX, constraint->mOldX + 6, _state);
+    _state += 6;
+  }
+
+  for (const JointCoulombFrictionConstraint* constraint
+       : mJointCoulombFrictionConstraints)
+  {
+    std::copy(constraint->mOldX, constraint->mOldX + 6, _state);
+    _state += 6;
+  }
+}
+
+//==============================================================================
+void ConstraintSolver::setWarmStartState(const double* _state)
+{
+  const size_t numContacts = static_cast<size_t>(*_state++);
+  const size_t numJointLimits = static_cast<size_t>(*_state++);
+  const size_t numJointFrictions = static_cast<size_t>(*_state++);
+
+  // The groups are built again in the next step
+  clearConstrainedGroups();
+
+  // Recreate the contact constraints for the contacts of the collision
+  // detector, which are the contacts of the step the state was written in
+  mContactConstraintPool.insert(mContactConstraintPool.end(),
+                                mContactConstraints.begin(),
+                                mContactConstraints.end());
+  mContactConstraints.clear();
+  mSoftContactConstraintPool.insert(mSoftContactConstraintPool.end(),
+                                    mSoftContactConstraints.begin(),
+                                    mSoftContactConstraints.end());
+  mSoftContactConstraints.clear();
+
+  for (size_t i = 0; i < mCollisionDetector->getNumContacts(); ++i)
+  {
+    collision::Contact& ct = mCollisionDetector->getContact(i);
+
+    if (isSoftContact(ct))
+    {
+      mSoftContactConstraints.push_back(getSoftContactConstraint(ct));
+      continue;
+    }
+
+    ContactConstraint* constraint = getContactConstraint(ct);
+    if (mContactConstraints.size() < numContacts)
+    {
+      constraint->mImpulse = Eigen::Map<const Eigen::Vector3d>(
+            _state + 3 * mContactConstraints.size());
+    }
+    mContactConstraints.push_back(constraint);
+  }
+
+  if (mContactConstraints.size() != numContacts)
+  {
+    dtwarn << "[ConstraintSolver::setWarmStartState] The warm start state has "
+           << numContacts << " contacts while the collision detector has "
+           << mContactConstraints.size() << ".\n";
+  }
+  _state += 3 * numContacts;
+
+  // The joint constraints are created in the same order in every step, so
+  // they match the state if their numbers do
+  if (mJointLimitConstraints.size() == numJointLimits)
+  {
+    for (JointLimitConstraint* constraint : mJointLimitConstraints)
+    {
+      std::copy(_state, _state + 6, constraint->mOldX);
+      _state += 6;
+    }
+  }
+  else
+  {
+    for (JointLimitConstraint* constraint : mJointLimitConstraints)
+      delete constraint;
+    mJointLimitConstraints.clear();
+    _state += 6 * numJointLimits;
+  }
+
+  if (mJointCoulombFrictionConstraints.size() == numJointFrictions)
+  {
+    for (JointCoulombFrictionConstraint* constraint
+         : mJointCoulombFrictionConstraints)
+    {
+      std::copy(_state, _state + 6, constraint->mOldX);
+      _state += 6;
+    }
+  }
+  else
+  {
+    for (JointCoulombFrictionConstraint* constraint
+         : mJointCoulombFrictionConstraints)
+    {
+      delete constraint;
+    }
+    mJointCoulombFrictionConstraints.clear();
+    _state += 6 * numJointFrictions;
+  }
+}
+
 //==============================================================================
 bool ConstraintSolver::containSkeleton(const ConstSkeletonPtr& _skeleton) const
 {
@@ -330,6 +608,8 @@ bool ConstraintSolver::checkAndAddConstraint(ConstraintBase* _constraint)
 //==============================================================================
 void ConstraintSolver::updateConstraints()
 {
+  DART_PROFILE_BEGIN(manualConstraintTimer, mProfiler, CONSTRAINT_CREATION);
+
   // Clear previous active constraint list
   mActiveConstraints.clear();
 
@@ -344,20 +624,37 @@ void ConstraintSolver::updateConstraints()
       mActiveConstraints.push_back(manualConstraint);
   }
 
+  DART_PROFILE_END(manualConstraintTimer);
+
   //----------------------------------------------------------------------------
   // Update automatic constraints: contact constraints
   //----------------------------------------------------------------------------
   mCollisionDetector->clearAllContacts();
   mCollisionDetector->detectCollision(true, true);
 
-  // Destroy previous contact constraints
-  for (const auto& contactConstraint : mContactConstraints)
-    delete contactConstraint;
-  mContactConstraints.clear();
+  DART_PROFILE_COUNT(mProfiler, NUM_CONTACTS,
+                     mCollisionDetector->getNumContacts());
+  DART_PROFILE_COUNT(mProfiler, NUM_CONTACT_MANIFOLDS,
+                     mCollisionDetector->getNumContactManifolds());
+  DART_PROFILE_SCOPE(mProfiler, CONSTRAINT_CREATION);
 
-  // Destroy previous soft contact constraints
-  for (const auto& softContactConstraint : mSoftContactConstraints)
-    delete softContactConstraint;
+  // Keep the previous contact constraints to reuse them for the same contacts.
+  // They are sorted by the manifold IDs and the feature IDs of their contacts
+  // to look them up quickly.
+  mPrevContactConstraints.swap(mContactConstraints);
+  mContactConstraints.clear();
+  std::sort(mPrevContactConstraints.begin(), mPrevContactConstraints.end(),
+            [](const ContactConstraint* _a, const ContactConstraint* _b)
+            {
+              return std::make_pair(_a->mManifoldId, _a->mFeatureId)
+                  < std::make_pair(_b->mManifoldId, _b->mFeatureId);
+            });
+  mIsPrevContactConstraintReused.assign(mPrevContactConstraints.size(), false);
+
+  // Soft contacts are not matched with the previous ones
+  mSoftContactConstraintPool.insert(mSoftContactConstraintPool.end(),
+                                    mSoftContactConstraints.begin(),
+                                    mSoftContactConstraints.end());
   mSoftContactConstraints.clear();
 
   // Create new contact constraints
@@ -366,15 +663,18 @@ void ConstraintSolver::updateConstraints()
     collision::Contact& ct = mCollisionDetector->getContact(i);
 
     if (isSoftContact(ct))
-    {
-      mSoftContactConstraints.push_back(
-            new SoftContactConstraint(ct, mTimeStep));
-    }
+      mSoftContactConstraints.push_back(getSoftContactConstraint(ct));
     else
-    {
-      mContactConstraints.push_back(new ContactConstraint(ct, mTimeStep));
-    }
+      mContactConstraints.push_back(getContactConstraint(ct));
+  }
+
+  // Return the previous contact constraints that are not reused to the pool
+  for (size_t i = 0; i < mPrevContactConstraints.size(); ++i)
+  {
+    if (!mIsPrevContactConstraintReused[i])
+      mContactConstraintPool.push_back(mPrevContactConstraints[i]);
   }
+  mPrevContactConstraints.clear();
 
   // Add the new contact constraints to dynamic constraint list
   for (const auto& contactConstraint : mContactConstraints)
@@ -397,24 +697,40 @@ void ConstraintSolver::updateConstraints()
   //----------------------------------------------------------------------------
   // Update automatic constraints: joint limit constraints
   //----------------------------------------------------------------------------
-  // Destroy previous joint limit constraints
-  for (const auto& jointLimitConstraint : mJointLimitConstraints)
-    delete jointLimitConstraint;
+  // Keep the previous joint limit constraints to reuse them for the same
+  // joints, which also carries over their impulses as the initial guess
+  mPrevJointLimitConstraints.swap(mJointLimitConstraints);
   mJointLimitConstraints.clear();
+  size_t numReusedJointLimitConstraints = 0;
 
   // Create new joint limit constraints
   for (const auto& skel : mSkeletons)
   {
+    if (skel->isSleeping())
+      continue;
+
     const size_t numBodyNodes = skel->getNumBodyNodes();
     for (size_t i = 0; i < numBodyNodes; i++)
     {
       dynamics::Joint* joint = skel->getBodyNode(i)->getParentJoint();
 
       if (joint->isDynamic() && joint->isPositionLimitEnforced())
-        mJointLimitConstraints.push_back(new JointLimitConstraint(joint));
+      {
+        mJointLimitConstraints.push_back(
+              getJointConstraint(mPrevJointLimitConstraints,
+                                 numReusedJointLimitConstraints, joint));
+      }
     }
   }
 
+  // Destroy previous joint limit constraints that are not reused
+  for (size_t i = numReusedJointLimitConstraints;
+       i < mPrevJointLimitConstraints.size(); ++i)
+  {
+    delete mPrevJointLimitConstraints[i];
+  }
+  mPrevJointLimitConstraints.clear();
+
   // Add active joint limit
   for (auto& jointLimitConstraint : mJointLimitConstraints)
   {
@@ -427,14 +743,18 @@ void ConstraintSolver::updateConstraints()
   //----------------------------------------------------------------------------
   // Update automatic constraints: joint Coulomb friction constraints
   //----------------------------------------------------------------------------
-  // Destroy previous joint limit constraints
-  for (const auto& jointFrictionConstraint : mJointCoulombFrictionConstraints)
-    delete jointFrictionConstraint;
+  // Keep the previous joint Coulomb friction constraints to reuse them for the
+  // same joints
+  mPrevJointCoulombFrictionConstraints.swap(mJointCoulombFrictionConstraints);
   mJointCoulombFrictionConstraints.clear();
+  size_t numReusedJointFrictionConstraints = 0;
 
   // Create new joint limit constraints
   for (const auto& skel : mSkeletons)
   {
+    if (skel->isSleeping())
+      continue;
+
     const size_t numBodyNodes = skel->getNumBodyNodes();
     for (size_t i = 0; i < numBodyNodes; i++)
     {
@@ -448,7 +768,9 @@ void ConstraintSolver::updateConstraints()
           if (joint->getCoulombFriction(i) != 0.0)
           {
             mJointCoulombFrictionConstraints.push_back(
-                  new JointCoulombFrictionConstraint(joint));
+                  getJointConstraint(mPrevJointCoulombFrictionConstraints,
+                                     numReusedJointFrictionConstraints,
+                                     joint));
             break;
           }
         }
@@ -456,6 +778,14 @@ void ConstraintSolver::updateConstraints()
     }
   }
 
+  // Destroy previous joint Coulomb friction constraints that are not reused
+  for (size_t i = numReusedJointFrictionConstraints;
+       i < mPrevJointCoulombFrictionConstraints.size(); ++i)
+  {
+    delete mPrevJointCoulombFrictionConstraints[i];
+  }
+  mPrevJointCoulombFrictionConstraints.clear();
+
   // Add active joint limit
   for (auto& jointFrictionConstraint : mJointCoulombFrictionConstraints)
   {
@@ -469,8 +799,18 @@ void ConstraintSolver::updateConstraints()
 //==============================================================================
 void ConstraintSolver::buildConstrainedGroups()
 {
-  // Clear constrained groups
-  mConstrainedGroups.clear();
+  DART_PROFILE_SCOPE(mProfiler, CONSTRAINT_CREATION);
+
+  // Clear constrained groups. The groups themselves are kept so that their
+  // LCP buffers are reused in the next time steps.
+  for (size_t i = 0; i < mNumConstrainedGroups; ++i)
+  {
+    mConstrainedGroups[i].removeAllConstraints();
+    mConstrainedGroups[i].mRootSkeleton.reset();
+  }
+  mNumConstrainedGroups = 0;
+  mConstrainedGroupIndices.assign(mSkeletons.size(), NO_CONSTRAINED_GROUP);
+  mWokenSkeletons.clear();
 
   // Exit if there is no active constraint
   if (mActiveConstraints.empty())
@@ -494,11 +834,9 @@ void ConstraintSolver::buildConstrainedGroups()
     bool found = false;
     dynamics::SkeletonPtr skel = (*it)->getRootSkeleton();
 
-    for (std::vector<ConstrainedGroup>::const_iterator itConstGroup
-         = mConstrainedGroups.begin();
-         itConstGroup != mConstrainedGroups.end(); ++itConstGroup)
+    for (size_t i = 0; i < mNumConstrainedGroups; ++i)
     {
-      if ((*itConstGroup).mRootSkeleton == skel)
+      if (mConstrainedGroups[i].mRootSkeleton == skel)
       {
         found = true;
         break;
@@ -508,10 +846,12 @@ void ConstraintSolver::buildConstrainedGroups()
     if (found)
       continue;
 
-    ConstrainedGroup newConstGroup;
-    newConstGroup.mRootSkeleton = skel;
-    skel->mUnionIndex = mConstrainedGroups.size();
-    mConstrainedGroups.push_back(newConstGroup);
+    if (mNumConstrainedGroups == mConstrainedGroups.size())
+      mConstrainedGroups.push_back(ConstrainedGroup());
+
+    mConstrainedGroups[mNumConstrainedGroups].mRootSkeleton = skel;
+    skel->mUnionIndex = mNumConstrainedGroups;
+    ++mNumConstrainedGroups;
   }
 
   // Add active constraints to constrained groups
@@ -522,6 +862,42 @@ void ConstraintSolver::buildConstrainedGroups()
     mConstrainedGroups[skel->mUnionIndex].addConstraint(*it);
   }
 
+  //----------------------------------------------------------------------------
+  // Wake up the sleeping skeletons constrained with awake skeletons
+  //----------------------------------------------------------------------------
+  mIsConstrainedGroupAwake.assign(mNumConstrainedGroups, false);
+  for (size_t i = 0; i < mSkeletons.size(); ++i)
+  {
+    const dynamics::SkeletonPtr& skel = mSkeletons[i];
+    if (!skel->isMobile() || skel->getNumDofs() == 0)
+      continue;
+
+    const dynamics::SkeletonPtr root = ConstraintBase::getRootSkeleton(skel);
+    const size_t index = root->mUnionIndex;
+    if (index >= mNumConstrainedGroups
+        || mConstrainedGroups[index].mRootSkeleton != root)
+    {
+      continue;
+    }
+
+    mConstrainedGroupIndices[i] = index;
+    if (!skel->isSleeping())
+      mIsConstrainedGroupAwake[index] = true;
+  }
+
+  for (size_t i = 0; i < mSkeletons.size(); ++i)
+  {
+    const size_t index = mConstrainedGroupIndices[i];
+    if (index == NO_CONSTRAINED_GROUP || !mIsConstrainedGroupAwake[index]
+        || !mSkeletons[i]->isSleeping())
+    {
+      continue;
+    }
+
+    mSkeletons[i]->setSleeping(false);
+    mWokenSkeletons.push_back(mSkeletons[i].get());
+  }
+
   //----------------------------------------------------------------------------
   // Reset union since we don't need union information anymore.
   //----------------------------------------------------------------------------
@@ -535,11 +911,128 @@ void ConstraintSolver::buildConstrainedGroups()
 //==============================================================================
 void ConstraintSolver::solveConstrainedGroups()
 {
-  for (std::vector<ConstrainedGroup>::iterator it = mConstrainedGroups.begin();
-       it != mConstrainedGroups.end(); ++it)
+  // Each group only touches its own skeletons, so the groups can be solved in
+  // any order
+  const int numGroups = static_cast<int>(mNumConstrainedGroups);
+  const int numThreads = static_cast<int>(mNumThreads);
+
+#ifdef DART_ENABLE_PROFILING
+  for (int i = 0; i < numGroups; ++i)
+  {
+    DART_PROFILE_COUNT(mProfiler, LCP_SIZE,
+                       mConstrainedGroups[i].getTotalDimension());
+  }
+#endif
+
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(numThreads) if(numThreads > 1) \
+  schedule(dynamic)
+#endif
+  for (int i = 0; i < numGroups; ++i)
+    mLCPSolver->solve(&mConstrainedGroups[i]);
+}
+
+//==============================================================================
+void ConstraintSolver::clearConstrainedGroups()
+{
+  // Empty the groups before forgetting them, or the next build would append
+  // to constraints that are pooled or destroyed meanwhile
+  mActiveConstraints.clear();
+  for (size_t i = 0; i < mNumConstrainedGroups; ++i)
+  {
+    mConstrainedGroups[i].removeAllConstraints();
+    mConstrainedGroups[i].mRootSkeleton.reset();
+  }
+  mNumConstrainedGroups = 0;
+  mConstrainedGroupIndices.clear();
+}
+
+//==============================================================================
+ContactConstraint* ConstraintSolver::getContactConstraint(
+    collision::Contact& _contact)
+{
+  // Find the constraint of the same contact in the previous step
+  const auto id = std::make_pair(_contact.manifoldId, _contact.featureId);
+  auto it = std::lower_bound(
+        mPrevContactConstraints.begin(), mPrevContactConstraints.end(), id,
+        [](const ContactConstraint* _constraint,
+           const std::pair<size_t, size_t>& _id)
+        {
+          return std::make_pair(_constraint->mManifoldId,
+                                _constraint->mFeatureId) < _id;
+        });
+  if (it != mPrevContactConstraints.end())
+  {
+    ContactConstraint* constraint = *it;
+    const size_t index = it - mPrevContactConstraints.begin();
+    if (!mIsPrevContactConstraintReused[index]
+        && constraint->isSameContact(_contact))
+    {
+      mIsPrevContactConstraintReused[index] = true;
+      constraint->initialize(_contact, mTimeStep, true);
+
+      return constraint;
+    }
+  }
+
+  // Otherwise, reuse an unused constraint
+  if (!mContactConstraintPool.empty())
+  {
+    ContactConstraint* constraint = mContactConstraintPool.back();
+    mContactConstraintPool.pop_back();
+    constraint->initialize(_contact, mTimeStep);
+
+    return constraint;
+  }
+
+  return new ContactConstraint(_contact, mTimeStep);
+}
+
+//==============================================================================
+template <class JointConstraintT>
+JointConstraintT* ConstraintSolver::getJointConstraint(
+    std::vector<JointConstraintT*>& _prevConstraints, size_t& _numReused,
+    Joint* _joint)
+{
+  // The joints are visited in the same order in every step so the constraint
+  // is usually the first one that is not reused yet
+  for (size_t i = _numReused; i < _prevConstraints.size(); ++i)
   {
-    mLCPSolver->solve(&(*it));
+    JointConstraintT* constraint = _prevConstraints[i];
+
+    // A Joint that was deleted may be followed by another one at the same
+    // address, so check that the Joint of the constraint still exists
+    if (constraint->mJoint != _joint
+        || constraint->mWeakJoint.lock().get() != _joint)
+      continue;
+
+    // Move the reused constraint to the front so that the remaining ones are
+    // the constraints that are not reused
+    std::swap(_prevConstraints[i], _prevConstraints[_numReused]);
+    ++_numReused;
+
+    constraint->mBodyNode = _joint->getChildBodyNode();
+
+    return constraint;
   }
+
+  return new JointConstraintT(_joint);
+}
+
+//==============================================================================
+SoftContactConstraint* ConstraintSolver::getSoftContactConstraint(
+    collision::Contact& _contact)
+{
+  if (!mSoftContactConstraintPool.empty())
+  {
+    SoftContactConstraint* constraint = mSoftContactConstraintPool.back();
+    mSoftContactConstraintPool.pop_back();
+    constraint->initialize(_contact, mTimeStep);
+
+    return constraint;
+  }
+
+  return new SoftContactConstraint(_contact, mTimeStep);
 }
 
 //==============================================================================
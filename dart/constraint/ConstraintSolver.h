@@ -48,6 +48,7 @@ namespace dart {
 
 namespace dynamics {
 class Skeleton;
+class Joint;
 }  // namespace dynamics
 
 namespace constraint {
@@ -119,9 +120,66 @@ public:
   /// Get collision detector
   collision::CollisionDetector* getCollisionDetector() const;
 
+  /// Set LCP solver. The constraint solver takes the ownership of the LCP
+  /// solver and deletes the old one.
+  void setLCPSolver(LCPSolver* _lcpSolver);
+
+  /// Get LCP solver
+  LCPSolver* getLCPSolver() const;
+
+  /// Set the number of threads that solve the constrained groups in parallel.
+  /// The groups don't share any skeleton, so the results don't depend on the
+  /// number of threads.
+  void setNumThreads(size_t _numThreads);
+
+  /// Get the number of threads that solve the constrained groups
+  size_t getNumThreads() const;
+
+#ifdef DART_ENABLE_PROFILING
+  /// Set the profiler that the phases of solve() are reported to. The
+  /// profiler is passed on to the collision detector and the LCP solver.
+  /// Nothing is reported if _profiler is nullptr.
+  void setProfiler(common::Profiler* _profiler);
+
+  /// Get the profiler
+  common::Profiler* getProfiler() const;
+#endif
+
   /// Solve constraint impulses and apply them to the skeletons
   void solve();
 
+  /// Discard the contacts of the collision detector and the automatic
+  /// constraints of the last step along with their impulses, so that the next
+  /// solve() doesn't reuse or warm start anything
+  void reset();
+
+  /// Get the number of values in the warm start state
+  size_t getWarmStartStateSize() const;
+
+  /// Write the warm start state to _state, which should hold
+  /// getWarmStartStateSize() values. The warm start state consists of the
+  /// impulses of the contact, joint limit and joint Coulomb friction
+  /// constraints of the last step, which are the initial guesses of the same
+  /// constraints in the next step.
+  void getWarmStartState(double* _state) const;
+
+  /// Get the number of the constrained groups of the last solve()
+  size_t getNumConstrainedGroups() const;
+
+  /// Get the index of the constrained group of the skeleton of _index, in the
+  /// order the skeletons were added, in the last solve(). The skeletons that
+  /// are not in any constrained group have NO_CONSTRAINED_GROUP.
+  size_t getConstrainedGroupIndex(size_t _index) const;
+
+  /// Constrained group index of the skeletons that are not constrained
+  static const size_t NO_CONSTRAINED_GROUP = static_cast<size_t>(-1);
+
+  /// Restore the warm start state written by getWarmStartState(). The contacts
+  /// of the collision detector should be the ones of the step that the state
+  /// was written in. Joint constraints that don't match the state are
+  /// discarded and start without initial guesses.
+  void setWarmStartState(const double* _state);
+
 private:
   /// Check if the skeleton is contained in this solver
   bool containSkeleton(const dynamics::ConstSkeletonPtr& _skeleton) const;
@@ -138,15 +196,39 @@ private:
   /// Update constraints
   void updateConstraints();
 
-  /// Build constrained groupsContact
+  /// Build constrained groups, and wake up the sleeping skeletons that are in
+  /// the same group as an awake skeleton. The woken skeletons are collected in
+  /// mWokenSkeletons.
   void buildConstrainedGroups();
 
   /// Solve constrained groups
   void solveConstrainedGroups();
 
+  /// Empty the constrained groups and forget them along with the active
+  /// constraints, which must be done before the constraints that the groups
+  /// point to are pooled or destroyed
+  void clearConstrainedGroups();
+
   /// Return true if at least one of colliding body is soft body
   bool isSoftContact(const collision::Contact& _contact) const;
 
+  /// Return a contact constraint for _contact. The constraint of the same
+  /// contact in the previous step is reused and warm started if there is one,
+  /// otherwise an unused constraint is taken from the pool.
+  ContactConstraint* getContactConstraint(collision::Contact& _contact);
+
+  /// Return a soft contact constraint for _contact from the pool
+  SoftContactConstraint* getSoftContactConstraint(collision::Contact& _contact);
+
+  /// Return the constraint of _joint among _prevConstraints, which are the
+  /// constraints of the previous step, or a new constraint if there is none.
+  /// The reused constraints are moved to the first _numReused elements of
+  /// _prevConstraints.
+  template <class JointConstraintT>
+  JointConstraintT* getJointConstraint(
+      std::vector<JointConstraintT*>& _prevConstraints, size_t& _numReused,
+      dynamics::Joint* _joint);
+
   /// Collision detector
   collision::CollisionDetector* mCollisionDetector;
 
@@ -156,6 +238,14 @@ private:
   /// LCP solver
   LCPSolver* mLCPSolver;
 
+  /// Number of threads that solve the constrained groups
+  size_t mNumThreads;
+
+#ifdef DART_ENABLE_PROFILING
+  /// Profiler
+  common::Profiler* mProfiler;
+#endif
+
   /// Skeleton list
   std::vector<dynamics::SkeletonPtr> mSkeletons;
 
@@ -171,14 +261,47 @@ private:
   /// Joint limit constraints those are automatically created
   std::vector<JointCoulombFrictionConstraint*> mJointCoulombFrictionConstraints;
 
+  /// Contact constraints of the previous step sorted by the IDs of their
+  /// contacts, which are candidates to be reused for the same contacts
+  std::vector<ContactConstraint*> mPrevContactConstraints;
+
+  /// Whether each of mPrevContactConstraints is reused in the current step
+  std::vector<bool> mIsPrevContactConstraintReused;
+
+  /// Contact constraints that are not in use, kept to avoid reallocation
+  std::vector<ContactConstraint*> mContactConstraintPool;
+
+  /// Soft contact constraints that are not in use, kept to avoid reallocation
+  std::vector<SoftContactConstraint*> mSoftContactConstraintPool;
+
+  /// Joint limit constraints of the previous step
+  std::vector<JointLimitConstraint*> mPrevJointLimitConstraints;
+
+  /// Joint Coulomb friction constraints of the previous step
+  std::vector<JointCoulombFrictionConstraint*>
+      mPrevJointCoulombFrictionConstraints;
+
   /// Constraints that manually added
   std::vector<ConstraintBase*> mManualConstraints;
 
   /// Active constraints
   std::vector<ConstraintBase*> mActiveConstraints;
 
-  /// Constraint group list
+  /// Constraint group list. Only the first mNumConstrainedGroups groups are
+  /// used in the current time step.
   std::vector<ConstrainedGroup> mConstrainedGroups;
+
+  /// Number of constrained groups in the current time step
+  size_t mNumConstrainedGroups;
+
+  /// Index of the constrained group of each skeleton in the current time step
+  std::vector<size_t> mConstrainedGroupIndices;
+
+  /// Whether each constrained group has an awake skeleton
+  std::vector<bool> mIsConstrainedGroupAwake;
+
+  /// Skeletons woken up by the last buildConstrainedGroups()
+  std::vector<dynamics::Skeleton*> mWokenSkeletons;
 };
 
 }  // namespace constraint
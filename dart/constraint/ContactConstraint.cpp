@@ -36,6 +36,7 @@
 
 #include "dart/constraint/ContactConstraint.h"
 
+#include <algorithm>
 #include <iostream>
 
 #include "dart/common/Console.h"
@@ -75,7 +76,30 @@ ContactConstraint::ContactConstraint(collision::Contact& _contact,
     mIsBounceOn(false),
     mActive(false)
 {
+  initialize(_contact, _timeStep);
+}
+
+//==============================================================================
+ContactConstraint::~ContactConstraint()
+{
+}
+
+//==============================================================================
+void ContactConstraint::initialize(collision::Contact& _contact,
+                                   double _timeStep, bool _warmStart)
+{
+  mTimeStep = _timeStep;
+  mFirstFrictionalDirection = Eigen::Vector3d::UnitZ();
+  mAppliedImpulseIndex = -1;
+  mActive = false;
+
+  // The impulse of the last solve is only valid for the same contact
+  mIsWarmStarted = _warmStart;
+  if (!mIsWarmStarted)
+    mImpulse.setZero();
+
   // TODO(JS): Assumed single contact
+  mContacts.clear();
   mContacts.push_back(&_contact);
 
   // TODO(JS):
@@ -247,6 +271,9 @@ ContactConstraint::ContactConstraint(collision::Contact& _contact,
     }
   }
 
+  mManifoldId = _contact.manifoldId;
+  mFeatureId = _contact.featureId;
+
   //----------------------------------------------------------------------------
   // Union finding
   //----------------------------------------------------------------------------
@@ -254,8 +281,13 @@ ContactConstraint::ContactConstraint(collision::Contact& _contact,
 }
 
 //==============================================================================
-ContactConstraint::~ContactConstraint()
+bool ContactConstraint::isSameContact(
+    const collision::Contact& _contact) const
 {
+  return _contact.manifoldId == mManifoldId
+      && _contact.featureId == mFeatureId
+      && _contact.bodyNode1.lock() == mBodyNode1
+      && _contact.bodyNode2.lock() == mBodyNode2;
 }
 
 //==============================================================================
@@ -456,11 +488,21 @@ void ContactConstraint::getInformation(ConstraintInfo* _info)
       _info->b[index] += bouncingVelocity;
 //      std::cout << "_lcp->b[_idx]: " << _lcp->b[_idx] << std::endl;
 
-      // TODO(JS): Initial guess
-      // x
-      _info->x[index] = 0.0;
-      _info->x[index + 1] = 0.0;
-      _info->x[index + 2] = 0.0;
+      // Initial guess: project the impulse of the same contact in the
+      // previous step onto the current contact frame
+      if (mIsWarmStarted)
+      {
+        const Eigen::MatrixXd D = getTangentBasisMatrixODE(mContacts[i]->normal);
+        _info->x[index] = std::max(mImpulse.dot(mContacts[i]->normal), 0.0);
+        _info->x[index + 1] = mImpulse.dot(D.col(0));
+        _info->x[index + 2] = mImpulse.dot(D.col(1));
+      }
+      else
+      {
+        _info->x[index] = 0.0;
+        _info->x[index + 1] = 0.0;
+        _info->x[index + 2] = 0.0;
+      }
 
       // Increase index
       index += 3;
@@ -522,9 +564,11 @@ void ContactConstraint::getInformation(ConstraintInfo* _info)
       _info->b[i] += bouncingVelocity;
 //      std::cout << "_lcp->b[_idx]: " << _lcp->b[_idx] << std::endl;
 
-      // TODO(JS): Initial guess
-      // x
-      _info->x[i] = 0.0;
+      // Initial guess
+      if (mIsWarmStarted)
+        _info->x[i] = std::max(mImpulse.dot(mContacts[i]->normal), 0.0);
+      else
+        _info->x[i] = 0.0;
 
       // Increase index
     }
@@ -703,6 +747,9 @@ void ContactConstraint::applyImpulse(double* _lambda)
       // Add contact impulse (force) toward the tangential w.r.t. world frame
       mContacts[i]->force += D.col(1) * _lambda[index] / mTimeStep;
 
+      // Keep the impulse to warm start the same contact in the next step
+      mImpulse = mContacts[i]->force * mTimeStep;
+
       // Tangential direction-2 impulsive force
 //      mContacts[i]->lambda[2] = _lambda[_idx];
       if (mBodyNode1->isReactive())
@@ -730,6 +777,9 @@ void ContactConstraint::applyImpulse(double* _lambda)
 
       // Store contact impulse (force) toward the normal w.r.t. world frame
       mContacts[i]->force = mContacts[i]->normal * _lambda[i] / mTimeStep;
+
+      // Keep the impulse to warm start the same contact in the next step
+      mImpulse = mContacts[i]->normal * _lambda[i];
     }
   }
 }
@@ -759,6 +809,18 @@ bool ContactConstraint::isActive() const
   return mActive;
 }
 
+//==============================================================================
+bool ContactConstraint::getBodyJacobians(BodyJacobianInfo* _info) const
+{
+  _info->bodyNodes[0] = mBodyNode1;
+  _info->bodyNodes[1] = mBodyNode2;
+  _info->jacobians[0] = mJacobians1.data();
+  _info->jacobians[1] = mJacobians2.data();
+  _info->cfm = mConstraintForceMixing;
+
+  return true;
+}
+
 //==============================================================================
 dynamics::SkeletonPtr ContactConstraint::getRootSkeleton() const
 {
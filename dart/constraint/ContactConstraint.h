@@ -46,6 +46,7 @@ namespace dart {
 
 namespace dynamics {
 class BodyNode;
+class Shape;
 class Skeleton;
 }  // namespace dynamics
 
@@ -128,6 +129,9 @@ protected:
   // Documentation inherited
   virtual void applyImpulse(double* _lambda);
 
+  // Documentation inherited
+  virtual bool getBodyJacobians(BodyJacobianInfo* _info) const;
+
   // Documentation inherited
   virtual dynamics::SkeletonPtr getRootSkeleton() const;
 
@@ -138,6 +142,19 @@ protected:
   virtual bool isActive() const;
 
 private:
+  /// Reinitialize this constraint for a new contact so that the constraint
+  /// object can be reused across time steps without reallocation. If
+  /// _warmStart is true, the impulse applied in the last solve of this
+  /// constraint is used as the initial guess of the LCP solver, which is only
+  /// meaningful when _contact is the same contact (see isSameContact()).
+  void initialize(collision::Contact& _contact, double _timeStep,
+                  bool _warmStart = false);
+
+  /// Return true if _contact is the same contact as the one this constraint
+  /// was created for, that is, the contact has the same manifold ID and feature
+  /// ID and it is between the body nodes in the same order
+  bool isSameContact(const collision::Contact& _contact) const;
+
   /// Get change in relative velocity at contact point due to external impulse
   /// \param[out] _relVel Change in relative velocity at contact point of the
   ///                     two colliding bodies
@@ -162,6 +179,18 @@ private:
   /// Contacts between mBodyNode1 and mBodyNode2
   std::vector<collision::Contact*> mContacts;
 
+  /// Manifold ID of the contact
+  size_t mManifoldId;
+
+  /// Feature ID of the contact in its manifold
+  size_t mFeatureId;
+
+  /// Contact impulse w.r.t. world frame that is applied in the last solve
+  Eigen::Vector3d mImpulse;
+
+  /// Whether mImpulse is used as the initial guess of the impulse
+  bool mIsWarmStarted;
+
   /// First frictional direction
   Eigen::Vector3d mFirstFrictionalDirection;
 
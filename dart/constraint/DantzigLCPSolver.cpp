@@ -69,15 +69,20 @@ void DantzigLCPSolver::solve(ConstrainedGroup* _group)
     return;
 
   // Build LCP terms by aggregating them from constraints
+  DART_PROFILE_BEGIN(assemblyTimer, mProfiler, LCP_ASSEMBLY);
   size_t n = _group->getTotalDimension();
   int nSkip = dPAD(n);
-  double* A = new double[n * nSkip];
-  double* x = new double[n];
-  double* b = new double[n];
-  double* w = new double[n];
-  double* lo = new double[n];
-  double* hi = new double[n];
-  int* findex = new int[n];
+
+  // Reuse the buffers of the group, which only grow over the time steps
+  LCPWorkspace& workspace = _group->getWorkspace();
+  workspace.resize(n, numConstraints, dEstimateSolveLCPMemoryReq(n, true));
+  double* A = workspace.A.data();
+  double* x = workspace.x.data();
+  double* b = workspace.b.data();
+  double* w = workspace.w.data();
+  double* lo = workspace.lo.data();
+  double* hi = workspace.hi.data();
+  int* findex = workspace.findex.data();
 
   // Set w to 0 and findex to -1
 #ifndef NDEBUG
@@ -87,7 +92,7 @@ void DantzigLCPSolver::solve(ConstrainedGroup* _group)
   std::memset(findex, -1, n * sizeof(int));
 
   // Compute offset indices
-  size_t* offset = new size_t[n];
+  size_t* offset = workspace.offset.data();
   offset[0] = 0;
 //  std::cout << "offset[" << 0 << "]: " << offset[0] << std::endl;
   for (size_t i = 1; i < numConstraints; ++i)
@@ -98,6 +103,11 @@ void DantzigLCPSolver::solve(ConstrainedGroup* _group)
 //    std::cout << "offset[" << i << "]: " << offset[i] << std::endl;
   }
 
+  // Fill A from the constraint Jacobians if all the constraints provide them,
+  // which is much cheaper than the impulse tests below
+  const bool isDelassusComputed = computeDelassusMatrix(_group, A, nSkip,
+                                                        offset);
+
   // For each constraint
   ConstraintInfo constInfo;
   constInfo.invTimeStep = 1.0 / mTimeStep;
@@ -116,14 +126,20 @@ void DantzigLCPSolver::solve(ConstrainedGroup* _group)
     // Fill vectors: lo, hi, b, w
     constraint->getInformation(&constInfo);
 
-    // Fill a matrix by impulse tests: A
-    constraint->excite();
+    // Adjust findex for global index
     for (size_t j = 0; j < constraint->getDimension(); ++j)
     {
-      // Adjust findex for global index
       if (findex[offset[i] + j] >= 0)
         findex[offset[i] + j] += offset[i];
+    }
+
+    if (isDelassusComputed)
+      continue;
 
+    // Fill a matrix by impulse tests: A
+    constraint->excite();
+    for (size_t j = 0; j < constraint->getDimension(); ++j)
+    {
       // Apply impulse for mipulse test
       constraint->applyUnitImpulse(j);
 
@@ -157,13 +173,18 @@ void DantzigLCPSolver::solve(ConstrainedGroup* _group)
 
   assert(isSymmetric(n, A));
 
+  DART_PROFILE_END(assemblyTimer);
+
   // Print LCP formulation
 //  dtdbg << "Before solve:" << std::endl;
 //  print(n, A, x, lo, hi, b, w, findex);
 //  std::cout << std::endl;
 
   // Solve LCP using ODE's Dantzig algorithm
-  dSolveLCP(n, A, x, b, w, 0, lo, hi, findex);
+  DART_PROFILE_BEGIN(solveTimer, mProfiler, LCP_SOLVE);
+  dSolveLCP(n, A, x, b, w, 0, lo, hi, findex,
+            workspace.tmpBuffer.data());
+  DART_PROFILE_END(solveTimer);
 
   // Print LCP formulation
 //  dtdbg << "After solve:" << std::endl;
@@ -178,15 +199,6 @@ void DantzigLCPSolver::solve(ConstrainedGroup* _group)
     constraint->excite();
   }
 
-  delete[] offset;
-
-  delete[] A;
-  delete[] x;
-  delete[] b;
-  delete[] w;
-  delete[] lo;
-  delete[] hi;
-  delete[] findex;
 }
 
 //==============================================================================
@@ -56,6 +56,7 @@ JointCoulombFrictionConstraint::JointCoulombFrictionConstraint(
     dynamics::Joint* _joint)
   : ConstraintBase(),
     mJoint(_joint),
+    mWeakJoint(_joint),
     mBodyNode(_joint->getChildBodyNode()),
     mAppliedImpulseIndex(0)
 {
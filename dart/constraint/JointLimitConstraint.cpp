@@ -61,6 +61,7 @@ double JointLimitConstraint::mConstraintForceMixing     = DART_CFM;
 JointLimitConstraint::JointLimitConstraint(dynamics::Joint* _joint)
   : ConstraintBase(),
     mJoint(_joint),
+    mWeakJoint(_joint),
     mBodyNode(_joint->getChildBodyNode()),
     mAppliedImpulseIndex(0)
 {
@@ -130,6 +130,10 @@ private:
   ///
   dynamics::Joint* mJoint;
 
+  /// Weak reference to mJoint, which expires when mJoint is deleted even if
+  /// another Joint is created at the same address later
+  dynamics::WeakJointPtr mWeakJoint;
+
   ///
   dynamics::BodyNode* mBodyNode;
 
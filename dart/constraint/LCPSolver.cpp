@@ -36,11 +36,59 @@
 
 #include "dart/constraint/LCPSolver.h"
 
+#include <algorithm>
 #include <cassert>
 
+#include "dart/dynamics/BodyNode.h"
+#include "dart/dynamics/Joint.h"
+#include "dart/dynamics/Skeleton.h"
+#include "dart/constraint/ConstrainedGroup.h"
+#include "dart/lcpsolver/lcp.h"
+
 namespace dart {
 namespace constraint {
 
+namespace {
+
+//==============================================================================
+/// Return true if any joint of _skel is prescribed, that is, its velocity
+/// doesn't change by impulses. The mass matrix doesn't tell this, so the
+/// impulse responses of such skeletons are found by the unit impulse tests.
+bool hasPrescribedJoints(const dynamics::Skeleton* _skel)
+{
+  for (size_t i = 0; i < _skel->getNumBodyNodes(); ++i)
+  {
+    switch (_skel->getBodyNode(i)->getParentJoint()->getActuatorType())
+    {
+      case dynamics::Joint::FORCE:
+      case dynamics::Joint::PASSIVE:
+      case dynamics::Joint::SERVO:
+        break;
+      default:
+        return true;
+    }
+  }
+
+  return false;
+}
+
+}  // anonymous namespace
+
+//==============================================================================
+void LCPWorkspace::resize(size_t _n, size_t _numConstraints,
+                          size_t _tmpBufferSize)
+{
+  A.resize(_n * dPAD(_n));
+  x.resize(_n);
+  b.resize(_n);
+  w.resize(_n);
+  lo.resize(_n);
+  hi.resize(_n);
+  findex.resize(_n);
+  offset.resize(_numConstraints);
+  tmpBuffer.resize((_tmpBufferSize + sizeof(double) - 1) / sizeof(double));
+}
+
 //==============================================================================
 void LCPSolver::setTimeStep(double _timeStep)
 {
@@ -54,8 +102,26 @@ double LCPSolver::getTimeStep() const
   return mTimeStep;
 }
 
+#ifdef DART_ENABLE_PROFILING
 //==============================================================================
-LCPSolver::LCPSolver(double _timeStep) : mTimeStep(_timeStep)
+void LCPSolver::setProfiler(common::Profiler* _profiler)
+{
+  mProfiler = _profiler;
+}
+
+//==============================================================================
+common::Profiler* LCPSolver::getProfiler() const
+{
+  return mProfiler;
+}
+#endif
+
+//==============================================================================
+LCPSolver::LCPSolver(double _timeStep)
+  : mTimeStep(_timeStep)
+#ifdef DART_ENABLE_PROFILING
+    , mProfiler(nullptr)
+#endif
 {
 }
 
@@ -64,5 +130,132 @@ LCPSolver::~LCPSolver()
 {
 }
 
+//==============================================================================
+bool LCPSolver::collectBodyJacobians(ConstrainedGroup* _group)
+{
+  const size_t numConstraints = _group->getNumConstraints();
+
+  LCPWorkspace& workspace = _group->getWorkspace();
+  std::vector<BodyJacobianInfo>& infos = workspace.bodyJacobians;
+  std::vector<dynamics::Skeleton*>& skeletons = workspace.skeletons;
+  infos.resize(numConstraints);
+  skeletons.clear();
+
+  for (size_t i = 0; i < numConstraints; ++i)
+  {
+    BodyJacobianInfo& info = infos[i];
+    info.bodyNodes[1] = nullptr;
+    if (!_group->getConstraint(i)->getBodyJacobians(&info))
+      return false;
+
+    for (size_t k = 0; k < 2; ++k)
+    {
+      dynamics::BodyNode* bodyNode = info.bodyNodes[k];
+      if (nullptr == bodyNode || !bodyNode->isReactive())
+        continue;
+
+      dynamics::Skeleton* skel = bodyNode->getSkeleton().get();
+
+      if (std::find(skeletons.begin(), skeletons.end(), skel)
+          != skeletons.end())
+      {
+        continue;
+      }
+
+      // The mass matrix doesn't include the point masses of soft bodies, nor
+      // the joints whose velocities are prescribed
+      if (skel->getNumSoftBodyNodes() > 0 || hasPrescribedJoints(skel))
+        return false;
+
+      skeletons.push_back(skel);
+    }
+  }
+
+  return true;
+}
+
+//==============================================================================
+bool LCPSolver::computeDelassusMatrix(ConstrainedGroup* _group, double* _A,
+                                      int _nSkip, const size_t* _offset)
+{
+  if (!collectBodyJacobians(_group))
+    return false;
+
+  const size_t numConstraints = _group->getNumConstraints();
+  const size_t n = _group->getTotalDimension();
+
+  LCPWorkspace& workspace = _group->getWorkspace();
+  const std::vector<BodyJacobianInfo>& infos = workspace.bodyJacobians;
+  const std::vector<dynamics::Skeleton*>& skeletons = workspace.skeletons;
+
+  Eigen::Map<Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic,
+      Eigen::RowMajor>, 0, Eigen::OuterStride<> > A(
+        _A, n, n, Eigen::OuterStride<>(_nSkip));
+  A.setZero();
+
+  // The matrices are kept in the workspace, so they are only reallocated when
+  // the dimensions of the group change
+  workspace.jacobianTransposes.resize(skeletons.size());
+  workspace.unitImpulseResponses.resize(skeletons.size());
+
+  for (size_t s = 0; s < skeletons.size(); ++s)
+  {
+    dynamics::Skeleton* skel = skeletons[s];
+    const size_t numDofs = skel->getNumDofs();
+
+    // Transpose of the constraint Jacobian with respect to the generalized
+    // velocities of this skeleton
+    Eigen::MatrixXd& JT = workspace.jacobianTransposes[s];
+    JT.setZero(numDofs, n);
+    for (size_t i = 0; i < numConstraints; ++i)
+    {
+      const BodyJacobianInfo& info = infos[i];
+      const size_t dim = _group->getConstraint(i)->getDimension();
+
+      for (size_t k = 0; k < 2; ++k)
+      {
+        dynamics::BodyNode* bodyNode = info.bodyNodes[k];
+        if (nullptr == bodyNode || !bodyNode->isReactive()
+            || bodyNode->getSkeleton().get() != skel)
+        {
+          continue;
+        }
+
+        const math::Jacobian& J = bodyNode->getJacobian();
+        const size_t numDepDofs = bodyNode->getNumDependentGenCoords();
+        for (size_t r = 0; r < dim; ++r)
+        {
+          for (size_t d = 0; d < numDepDofs; ++d)
+          {
+            JT(bodyNode->getDependentGenCoordIndex(d), _offset[i] + r)
+                += J.col(d).dot(info.jacobians[k][r]);
+          }
+        }
+      }
+    }
+
+    // Velocity changes of the skeleton due to the unit impulses
+    Eigen::MatrixXd& invMJT = workspace.unitImpulseResponses[s];
+    invMJT = JT;
+    for (size_t c = 0; c < n; ++c)
+    {
+      if (!JT.col(c).isZero(0.0))
+        skel->solveMassMatrixInPlace(invMJT.col(c));
+    }
+
+    A.noalias() += JT.transpose() * invMJT;
+  }
+
+  // Add small values to the diagonal to keep it away from singular
+  for (size_t i = 0; i < numConstraints; ++i)
+  {
+    const size_t dim = _group->getConstraint(i)->getDimension();
+    for (size_t r = 0; r < dim; ++r)
+      A(_offset[i] + r, _offset[i] + r) *= 1.0 + infos[i].cfm;
+  }
+
+  return true;
+}
+
 }  // namespace constraint
 }  // namespace dart
@@ -37,11 +37,93 @@
 #ifndef DART_CONSTRAINT_LCPSOLVER_H_
 #define DART_CONSTRAINT_LCPSOLVER_H_
 
+#include <cstddef>
+#include <vector>
+
+#include <Eigen/Dense>
+
+#include "dart/common/Profiler.h"
+#include "dart/constraint/ConstraintBase.h"
+
 namespace dart {
 namespace constraint {
 
 class ConstrainedGroup;
 
+/// LCPWorkspace holds the buffers of an LCP problem so that they can be reused
+/// over the time steps. The buffers only grow, so an LCP that is not larger
+/// than the previous ones is solved without allocating memory.
+struct LCPWorkspace
+{
+  typedef std::vector<double, Eigen::aligned_allocator<double>> Buffer;
+
+  /// Resize the buffers for an LCP of dimension _n that is composed of
+  /// _numConstraints constraints. _tmpBufferSize is the size in bytes of the
+  /// temporary buffer that the LCP solver needs.
+  void resize(size_t _n, size_t _numConstraints, size_t _tmpBufferSize);
+
+  /// Matrix of the LCP whose leading dimension is padded
+  Buffer A;
+
+  /// Solution of the LCP
+  Buffer x;
+
+  /// Right hand side of the LCP
+  Buffer b;
+
+  /// Slack variables of the LCP
+  Buffer w;
+
+  /// Lower bounds of the solution
+  Buffer lo;
+
+  /// Upper bounds of the solution
+  Buffer hi;
+
+  /// Friction indices
+  std::vector<int> findex;
+
+  /// Index of the first row of each constraint
+  std::vector<size_t> offset;
+
+  /// Temporary buffer of the LCP solver
+  Buffer tmpBuffer;
+
+  /// Body Jacobians of the constraints
+  std::vector<BodyJacobianInfo> bodyJacobians;
+
+  /// Skeletons that the constraints act on
+  std::vector<dynamics::Skeleton*> skeletons;
+
+  /// Transposes of the constraint Jacobians with respect to the generalized
+  /// velocities of each of the skeletons
+  std::vector<Eigen::MatrixXd> jacobianTransposes;
+
+  /// Velocity changes of each of the skeletons due to the unit impulses of
+  /// the constraint rows
+  std::vector<Eigen::MatrixXd> unitImpulseResponses;
+
+  /// Indices into skeletons of the (at most two) skeletons that each row acts
+  /// on, or -1 for an unused slot. Used by the block PGS solver.
+  std::vector<int> rowSkeletons;
+
+  /// Generalized Jacobians of the rows for the skeletons in rowSkeletons
+  std::vector<Eigen::VectorXd> rowJacobians;
+
+  /// Velocity changes of the skeletons in rowSkeletons due to the unit
+  /// impulses of the rows
+  std::vector<Eigen::VectorXd> rowResponses;
+
+  /// Diagonal of the LCP matrix
+  Eigen::VectorXd diagonal;
+
+  /// Constraint force mixing added to the diagonal of the LCP matrix
+  Eigen::VectorXd mixing;
+
+  /// Velocity changes of the skeletons due to the current impulses
+  std::vector<Eigen::VectorXd> velocityChanges;
+};
+
 /// LCPSolver
 class LCPSolver
 {
@@ -50,11 +132,20 @@ public:
   virtual void solve(ConstrainedGroup* _group) = 0;
 
   /// Set time step
-  void setTimeStep(double _timeStep);
+  virtual void setTimeStep(double _timeStep);
 
   /// Return time step
   double getTimeStep() const;
 
+#ifdef DART_ENABLE_PROFILING
+  /// Set the profiler that the assembly and the solution of the LCPs are
+  /// reported to. Nothing is reported if _profiler is nullptr.
+  virtual void setProfiler(common::Profiler* _profiler);
+
+  /// Get the profiler
+  common::Profiler* getProfiler() const;
+#endif
+
   /// Destructor
   virtual ~LCPSolver();
 
@@ -62,9 +153,29 @@ protected:
   /// Constructor
   LCPSolver(double _timeStep);
 
+  /// Collect the body Jacobians of the constraints in the group and the
+  /// skeletons that they act on into the workspace of the group. Return false
+  /// if any of the constraints doesn't provide its body Jacobians or acts on a
+  /// skeleton with soft bodies or with joints whose actuator type is not
+  /// FORCE, PASSIVE or SERVO.
+  bool collectBodyJacobians(ConstrainedGroup* _group);
+
+  /// Fill the LCP matrix _A of the group, A = J * M^-1 * J^T, from the body
+  /// Jacobians of the constraints and the mass matrices of the skeletons.
+  /// Return false without touching _A if collectBodyJacobians() fails, in
+  /// which case the LCP matrix should be
+  /// filled by the unit impulse tests.
+  bool computeDelassusMatrix(ConstrainedGroup* _group, double* _A, int _nSkip,
+                             const size_t* _offset);
+
 protected:
   /// Simulation time step
   double mTimeStep;
+
+#ifdef DART_ENABLE_PROFILING
+  /// Profiler
+  common::Profiler* mProfiler;
+#endif
 };
 
 } // namespace constraint
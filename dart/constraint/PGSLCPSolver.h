@@ -83,10 +83,12 @@ struct PGSOption
   void setDefault();
 };
 
+/// Solve the LCP with projected Gauss-Seidel. order is a buffer of n integers
+/// that is allocated if it's null.
 bool solvePGS(int n, int nskip, int /*nub*/, double* A,
                             double* x, double * b,
                             double * lo, double * hi, int * findex,
-                            PGSOption * option);
+                            PGSOption * option, int * order = nullptr);
 
 
 } // namespace constraint
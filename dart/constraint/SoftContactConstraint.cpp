@@ -73,20 +73,45 @@ SoftContactConstraint::SoftContactConstraint(
     collision::Contact& _contact, double _timeStep)
   : ConstraintBase(),
     mTimeStep(_timeStep),
-    mBodyNode1(_contact.bodyNode1.lock()),
-    mBodyNode2(_contact.bodyNode2.lock()),
-    mSoftBodyNode1(dynamic_cast<dynamics::SoftBodyNode*>(mBodyNode1)),
-    mSoftBodyNode2(dynamic_cast<dynamics::SoftBodyNode*>(mBodyNode2)),
+    mBodyNode1(nullptr),
+    mBodyNode2(nullptr),
+    mSoftBodyNode1(nullptr),
+    mSoftBodyNode2(nullptr),
     mPointMass1(nullptr),
     mPointMass2(nullptr),
-    mSoftCollInfo(static_cast<collision::SoftCollisionInfo*>(_contact.userData)),
+    mSoftCollInfo(nullptr),
     mFirstFrictionalDirection(Eigen::Vector3d::UnitZ()),
     mIsFrictionOn(true),
     mAppliedImpulseIndex(-1),
     mIsBounceOn(false),
     mActive(false)
 {
+  initialize(_contact, _timeStep);
+}
+
+//==============================================================================
+SoftContactConstraint::~SoftContactConstraint()
+{
+}
+
+//==============================================================================
+void SoftContactConstraint::initialize(collision::Contact& _contact,
+                                       double _timeStep)
+{
+  mTimeStep = _timeStep;
+  mBodyNode1 = _contact.bodyNode1.lock();
+  mBodyNode2 = _contact.bodyNode2.lock();
+  mSoftBodyNode1 = dynamic_cast<dynamics::SoftBodyNode*>(mBodyNode1);
+  mSoftBodyNode2 = dynamic_cast<dynamics::SoftBodyNode*>(mBodyNode2);
+  mPointMass1 = nullptr;
+  mPointMass2 = nullptr;
+  mSoftCollInfo = static_cast<collision::SoftCollisionInfo*>(_contact.userData);
+  mFirstFrictionalDirection = Eigen::Vector3d::UnitZ();
+  mAppliedImpulseIndex = -1;
+  mActive = false;
+
   // TODO(JS): Assumed single contact
+  mContacts.clear();
   mContacts.push_back(&_contact);
 
   // Set the colliding state of body nodes and point masses to false
@@ -290,11 +315,6 @@ SoftContactConstraint::SoftContactConstraint(
 //  uniteSkeletons();
 }
 
-//==============================================================================
-SoftContactConstraint::~SoftContactConstraint()
-{
-}
-
 //==============================================================================
 void SoftContactConstraint::setErrorAllowance(double _allowance)
 {
@@ -144,6 +144,10 @@ protected:
   virtual bool isActive() const;
 
 private:
+  /// Reinitialize this constraint for a new contact so that the constraint
+  /// object can be reused across time steps without reallocation
+  void initialize(collision::Contact& _contact, double _timeStep);
+
   /// Get change in relative velocity at contact point due to external impulse
   /// \param[out] _vel Change in relative velocity at contact point of the two
   ///                  colliding bodies
@@ -139,6 +139,12 @@ void BallJoint::integratePositions(double _dt)
   setPositionsStatic(convertToPositions(Rnext));
 }
 
+//==============================================================================
+bool BallJoint::hasEuclideanPositions() const
+{
+  return false;
+}
+
 //==============================================================================
 void BallJoint::updateDegreeOfFreedomNames()
 {
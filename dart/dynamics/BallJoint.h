@@ -99,6 +99,9 @@ public:
   Eigen::Vector3d getPositionDifferencesStatic(
       const Eigen::Vector3d& _q2, const Eigen::Vector3d& _q1) const override;
 
+  // Documentation inherited
+  bool hasEuclideanPositions() const override;
+
 protected:
 
   /// Constructor called by Skeleton class
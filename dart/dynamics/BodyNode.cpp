@@ -1266,13 +1266,13 @@ void BodyNode::drawMarkers(renderer::RenderInterface* _ri,
 //==============================================================================
 void BodyNode::notifyTransformUpdate()
 {
-  notifyVelocityUpdate(); // Global Velocity depends on the Global Transform
-
-  if(mNeedTransformUpdate)
+  // A dirty flag on this BodyNode implies the same dirty flag on its entire
+  // subtree, so repeated notices stop here
+  if(mNeedTransformUpdate && mNeedVelocityUpdate && mNeedAccelerationUpdate)
     return;
 
-  mNeedTransformUpdate = true;
-
+  // The whole subtree belongs to the tree of this BodyNode, so the Skeleton
+  // only needs to be locked and flagged once
   const SkeletonPtr& skel = getSkeleton();
   if(skel)
   {
@@ -1280,50 +1280,92 @@ void BodyNode::notifyTransformUpdate()
     // be dirtied whenever mNeedTransformUpdate is dirtied, and if
     // mTransformUpdate is already dirty, then these must already be dirty as
     // well
+    if(!mNeedTransformUpdate)
+    {
+      SET_FLAGS(mCoriolisForces);
+      SET_FLAGS(mGravityForces);
+      SET_FLAGS(mCoriolisAndGravityForces);
+      SET_FLAGS(mExternalForces);
+    }
+    else if(!mNeedVelocityUpdate)
+    {
+      SET_FLAGS(mCoriolisForces);
+      SET_FLAGS(mCoriolisAndGravityForces);
+    }
+  }
+
+  dirtyTransformSubtree();
+}
+
+//==============================================================================
+void BodyNode::notifyVelocityUpdate()
+{
+  if(mNeedVelocityUpdate && mNeedAccelerationUpdate)
+    return;
+
+  const SkeletonPtr& skel = getSkeleton();
+  if(skel && !mNeedVelocityUpdate)
+  {
     SET_FLAGS(mCoriolisForces);
-    SET_FLAGS(mGravityForces);
     SET_FLAGS(mCoriolisAndGravityForces);
-    SET_FLAGS(mExternalForces);
   }
 
+  dirtyVelocitySubtree();
+}
+
+//==============================================================================
+void BodyNode::notifyAccelerationUpdate()
+{
+  dirtyAccelerationSubtree();
+}
+
+//==============================================================================
+void BodyNode::dirtyTransformSubtree()
+{
+  // Global Velocity depends on the Global Transform
+  if(mNeedTransformUpdate)
+  {
+    dirtyVelocitySubtree();
+    return;
+  }
+
+  mNeedTransformUpdate = true;
+  mNeedVelocityUpdate = true;
+  mIsPartialAccelerationDirty = true;
+  mNeedAccelerationUpdate = true;
+
   // Child BodyNodes and other generic Entities are notified separately to allow
   // some optimizations
-  for(size_t i=0; i<mChildBodyNodes.size(); ++i)
-    mChildBodyNodes[i]->notifyTransformUpdate();
+  for(BodyNode* child : mChildBodyNodes)
+    child->dirtyTransformSubtree();
 
   for(Entity* entity : mNonBodyNodeEntities)
     entity->notifyTransformUpdate();
 }
 
 //==============================================================================
-void BodyNode::notifyVelocityUpdate()
+void BodyNode::dirtyVelocitySubtree()
 {
-  notifyAccelerationUpdate(); // Global Acceleration depends on Global Velocity
-
+  // Global Acceleration depends on Global Velocity
   if(mNeedVelocityUpdate)
+  {
+    dirtyAccelerationSubtree();
     return;
+  }
 
   mNeedVelocityUpdate = true;
   mIsPartialAccelerationDirty = true;
+  mNeedAccelerationUpdate = true;
 
-  const SkeletonPtr& skel = getSkeleton();
-  if(skel)
-  {
-    SET_FLAGS(mCoriolisForces);
-    SET_FLAGS(mCoriolisAndGravityForces);
-  }
-
-  // Child BodyNodes and other generic Entities are notified separately to allow
-  // some optimizations
-  for(size_t i=0; i<mChildBodyNodes.size(); ++i)
-    mChildBodyNodes[i]->notifyVelocityUpdate();
+  for(BodyNode* child : mChildBodyNodes)
+    child->dirtyVelocitySubtree();
 
   for(Entity* entity : mNonBodyNodeEntities)
     entity->notifyVelocityUpdate();
 }
 
 //==============================================================================
-void BodyNode::notifyAccelerationUpdate()
+void BodyNode::dirtyAccelerationSubtree()
 {
   // If we already know we need to update, just quit
   if(mNeedAccelerationUpdate)
@@ -1331,8 +1373,8 @@ void BodyNode::notifyAccelerationUpdate()
 
   mNeedAccelerationUpdate = true;
 
-  for(size_t i=0; i<mChildBodyNodes.size(); ++i)
-    mChildBodyNodes[i]->notifyAccelerationUpdate();
+  for(BodyNode* child : mChildBodyNodes)
+    child->dirtyAccelerationSubtree();
 
   for(Entity* entity : mNonBodyNodeEntities)
     entity->notifyAccelerationUpdate();
@@ -1490,7 +1532,7 @@ void BodyNode::updateBiasForce(const Eigen::Vector3d& _gravity,
     Joint* childJoint = childBodyNode->getParentJoint();
 
     childJoint->addChildBiasForceTo(mBiasForce,
-                                childBodyNode->getArticulatedInertiaImplicit(),
+                                childBodyNode->mArtInertiaImplicit,
                                 childBodyNode->mBiasForce,
                                 childBodyNode->getPartialAcceleration());
   }
@@ -1500,7 +1542,7 @@ void BodyNode::updateBiasForce(const Eigen::Vector3d& _gravity,
 
   // Update parent joint's total force with implicit joint damping and spring
   // forces
-  mParentJoint->updateTotalForce( getArticulatedInertiaImplicit()
+  mParentJoint->updateTotalForce( mArtInertiaImplicit
                                   * getPartialAcceleration() + mBiasForce,
                                   _timeStep);
 }
@@ -1517,7 +1559,7 @@ void BodyNode::updateBiasImpulse()
     Joint* childJoint = childBodyNode->getParentJoint();
 
     childJoint->addChildBiasImpulseTo(mBiasImpulse,
-                                      childBodyNode->getArticulatedInertia(),
+                                      childBodyNode->mArtInertia,
                                       childBodyNode->mBiasImpulse);
   }
 
@@ -1532,7 +1574,7 @@ void BodyNode::updateBiasImpulse()
 void BodyNode::updateTransmittedForceFD()
 {
   mF = mBiasForce;
-  mF.noalias() += getArticulatedInertiaImplicit() * getSpatialAcceleration();
+  mF.noalias() += mArtInertiaImplicit * getSpatialAcceleration();
 
   assert(!math::isNan(mF));
 }
@@ -1541,7 +1583,7 @@ void BodyNode::updateTransmittedForceFD()
 void BodyNode::updateTransmittedImpulse()
 {
   mImpF = mBiasImpulse;
-  mImpF.noalias() += getArticulatedInertia() * mDelV;
+  mImpF.noalias() += mArtInertia * mDelV;
 
   assert(!math::isNan(mImpF));
 }
@@ -1552,13 +1594,13 @@ void BodyNode::updateAccelerationFD()
   if (mParentBodyNode)
   {
     // Update joint acceleration
-    mParentJoint->updateAcceleration(getArticulatedInertiaImplicit(),
+    mParentJoint->updateAcceleration(mArtInertiaImplicit,
                                      mParentBodyNode->getSpatialAcceleration());
   }
   else
   {
     // Update joint acceleration
-    mParentJoint->updateAcceleration(getArticulatedInertiaImplicit(),
+    mParentJoint->updateAcceleration(mArtInertiaImplicit,
                                      Eigen::Vector6d::Zero());
   }
 
@@ -1572,7 +1614,7 @@ void BodyNode::updateVelocityChangeFD()
   if (mParentBodyNode)
   {
     // Update joint velocity change
-    mParentJoint->updateVelocityChange(getArticulatedInertia(),
+    mParentJoint->updateVelocityChange(mArtInertia,
                                        mParentBodyNode->mDelV);
 
     // Transmit spatial acceleration of parent body to this body
@@ -1582,7 +1624,7 @@ void BodyNode::updateVelocityChangeFD()
   else
   {
     // Update joint velocity change
-    mParentJoint->updateVelocityChange(getArticulatedInertia(),
+    mParentJoint->updateVelocityChange(mArtInertia,
                                        Eigen::Vector6d::Zero());
 
     // Transmit spatial acceleration of parent body to this body
@@ -1950,6 +1992,61 @@ void BodyNode::aggregateMassMatrix(Eigen::MatrixXd& _MCol, size_t _col)
   }
 }
 
+//==============================================================================
+void BodyNode::updateCompositeInertia()
+{
+  mM_Ic = mBodyP.mInertia.getSpatialTensor();
+
+  for (const auto& child : mChildBodyNodes)
+  {
+    mM_Ic += math::transformInertia(
+          child->getParentJoint()->getLocalTransform().inverse(),
+          child->mM_Ic);
+  }
+
+  assert(!math::isNan(mM_Ic));
+
+  if (mParentJoint->getNumDofs() > 0)
+    mM_S = mParentJoint->getLocalJacobian();
+}
+
+//==============================================================================
+void BodyNode::aggregateCompositeMassMatrix(Eigen::MatrixXd& _M)
+{
+  const size_t dof = mParentJoint->getNumDofs();
+  if (dof == 0)
+    return;
+
+  const size_t iStart = mParentJoint->getIndexInTree(0);
+
+  // Spatial forces required to accelerate the subtree by the unit
+  // accelerations of the parent joint
+  Eigen::Matrix<double, 6, Eigen::Dynamic, 0, 6, 6> F = mM_Ic * mM_S;
+  _M.block(iStart, iStart, dof, dof).noalias() = mM_S.transpose() * F;
+
+  // The forces are transmitted only to the ancestors so the other blocks of
+  // the columns stay zero
+  const BodyNode* body = this;
+  while (body->mParentBodyNode)
+  {
+    const Eigen::Isometry3d& T = body->mParentJoint->getLocalTransform();
+    for (size_t i = 0; i < dof; ++i)
+      F.col(i) = math::dAdInvT(T, F.col(i));
+
+    body = body->mParentBodyNode;
+
+    const size_t parentDof = body->mParentJoint->getNumDofs();
+    if (parentDof == 0)
+      continue;
+
+    const size_t jStart = body->mParentJoint->getIndexInTree(0);
+    _M.block(jStart, iStart, parentDof, dof).noalias()
+        = body->mM_S.transpose() * F;
+    _M.block(iStart, jStart, dof, parentDof)
+        = _M.block(jStart, iStart, parentDof, dof).transpose();
+  }
+}
+
 //==============================================================================
 void BodyNode::aggregateAugMassMatrix(Eigen::MatrixXd& _MCol, size_t _col,
                                       double _timeStep)
@@ -2006,7 +2103,7 @@ void BodyNode::updateInvMassMatrix()
        it != mChildBodyNodes.end(); ++it)
   {
     (*it)->getParentJoint()->addChildBiasForceForInvMassMatrix(
-          mInvM_c, (*it)->getArticulatedInertia(), (*it)->mInvM_c);
+          mInvM_c, (*it)->mArtInertia, (*it)->mInvM_c);
   }
 
   // Verification
@@ -2027,7 +2124,7 @@ void BodyNode::updateInvAugMassMatrix()
        it != mChildBodyNodes.end(); ++it)
   {
     (*it)->getParentJoint()->addChildBiasForceForInvAugMassMatrix(
-          mInvM_c, (*it)->getArticulatedInertiaImplicit(), (*it)->mInvM_c);
+          mInvM_c, (*it)->mArtInertiaImplicit, (*it)->mInvM_c);
   }
 
   // Verification
@@ -2044,7 +2141,7 @@ void BodyNode::aggregateInvMassMatrix(Eigen::MatrixXd& _InvMCol, size_t _col)
   {
     //
     mParentJoint->getInvMassMatrixSegment(
-          _InvMCol, _col, getArticulatedInertia(), mParentBodyNode->mInvM_U);
+          _InvMCol, _col, mArtInertia, mParentBodyNode->mInvM_U);
 
     //
     mInvM_U = math::AdInvT(mParentJoint->getLocalTransform(),
@@ -2054,7 +2151,7 @@ void BodyNode::aggregateInvMassMatrix(Eigen::MatrixXd& _InvMCol, size_t _col)
   {
     //
     mParentJoint->getInvMassMatrixSegment(
-          _InvMCol, _col, getArticulatedInertia(), Eigen::Vector6d::Zero());
+          _InvMCol, _col, mArtInertia, Eigen::Vector6d::Zero());
 
     //
     mInvM_U.setZero();
@@ -2072,7 +2169,7 @@ void BodyNode::aggregateInvAugMassMatrix(Eigen::MatrixXd& _InvMCol, size_t _col,
   {
     //
     mParentJoint->getInvAugMassMatrixSegment(
-          _InvMCol, _col, getArticulatedInertiaImplicit(),
+          _InvMCol, _col, mArtInertiaImplicit,
           mParentBodyNode->mInvM_U);
 
     //
@@ -2083,7 +2180,7 @@ void BodyNode::aggregateInvAugMassMatrix(Eigen::MatrixXd& _InvMCol, size_t _col,
   {
     //
     mParentJoint->getInvAugMassMatrixSegment(
-          _InvMCol, _col, getArticulatedInertiaImplicit(),
+          _InvMCol, _col, mArtInertiaImplicit,
           Eigen::Vector6d::Zero());
 
     //
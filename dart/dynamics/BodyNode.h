@@ -848,6 +848,10 @@ protected:
 
   //----------------------------------------------------------------------------
   /// \{ \name Recursive dynamics routines
+  ///
+  /// The forward dynamics, impulse, and inverse mass matrix routines read
+  /// mArtInertia and mArtInertiaImplicit directly. The Skeleton must update
+  /// the articulated inertias before it starts any of those recursions.
   //----------------------------------------------------------------------------
 
   /// Separate generic child Entities from child BodyNodes for more efficient
@@ -857,6 +861,18 @@ protected:
   /// Remove this Entity from mChildBodyNodes or mNonBodyNodeEntities
   void processRemovedEntity(Entity* _oldChildEntity) override;
 
+  /// Dirty the transform, velocity, and acceleration of this BodyNode and of
+  /// its whole subtree in a single pass. The dirty flags of the Skeleton are
+  /// left to the caller, since they only need to be set once per tree.
+  void dirtyTransformSubtree();
+
+  /// Dirty the velocity and acceleration of this BodyNode and of its whole
+  /// subtree in a single pass
+  void dirtyVelocitySubtree();
+
+  /// Dirty the acceleration of this BodyNode and of its whole subtree
+  void dirtyAccelerationSubtree();
+
   /// Update transformation
   virtual void updateTransform();
 
@@ -944,6 +960,16 @@ protected:
   virtual void aggregateAugMassMatrix(Eigen::MatrixXd& _MCol, size_t _col,
                                       double _timeStep);
 
+  /// Update the composite rigid body inertia, which is the spatial inertia of
+  /// the subtree rooted at this BodyNode. The children should be updated
+  /// first.
+  void updateCompositeInertia();
+
+  /// Fill the blocks of the mass matrix that couple the parent joint of this
+  /// BodyNode with itself and with the parent joints of the ancestors using
+  /// the composite rigid body inertia.
+  void aggregateCompositeMassMatrix(Eigen::MatrixXd& _M);
+
   ///
   virtual void updateInvMassMatrix();
   virtual void updateInvAugMassMatrix();
@@ -1124,6 +1150,12 @@ protected:
   Eigen::Vector6d mM_dV;
   Eigen::Vector6d mM_F;
 
+  /// Cache data for mass matrix of the system computed by the composite rigid
+  /// body algorithm: the composite rigid body inertia and the local Jacobian
+  /// of the parent joint.
+  math::Inertia mM_Ic;
+  math::Jacobian mM_S;
+
   /// Cache data for inverse mass matrix of the system.
   Eigen::Vector6d mInvM_c;
   Eigen::Vector6d mInvM_U;
@@ -324,6 +324,8 @@ bool Entity::isFrame() const
 //==============================================================================
 void Entity::notifyTransformUpdate()
 {
+  notifyVelocityUpdate(); // Global Velocity depends on the Global Transform
+
   mNeedTransformUpdate = true;
 
   // The actual transform hasn't updated yet. But when its getter is called,
@@ -340,6 +342,8 @@ bool Entity::needsTransformUpdate() const
 //==============================================================================
 void Entity::notifyVelocityUpdate()
 {
+  notifyAccelerationUpdate(); // Global Acceleration depends on Global Velocity
+
   mNeedVelocityUpdate = true;
 
   // The actual velocity hasn't updated yet. But when its getter is called,
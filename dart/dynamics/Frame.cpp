@@ -467,17 +467,27 @@ void Frame::draw(renderer::RenderInterface* _ri, const Eigen::Vector4d& _color,
 //==============================================================================
 void Frame::notifyTransformUpdate()
 {
-  notifyVelocityUpdate(); // Global Velocity depends on the Global Transform
-
-  // Always trigger the signal, in case a new subscriber has registered in the
-  // time since the last signal
-  mTransformUpdatedSignal.raise(this);
-
-  // If we already know we need to update, just quit
+  // If we already know we need to update, only the velocity and acceleration
+  // of this subtree might still be clean
   if(mNeedTransformUpdate)
+  {
+    notifyVelocityUpdate(); // Global Velocity depends on the Global Transform
+
+    // Always trigger the signal, in case a new subscriber has registered in the
+    // time since the last signal
+    mTransformUpdatedSignal.raise(this);
     return;
+  }
 
+  // The velocity and acceleration are dirtied here too, so that the subtree
+  // only gets walked once
   mNeedTransformUpdate = true;
+  mNeedVelocityUpdate = true;
+  mNeedAccelerationUpdate = true;
+
+  mAccelerationChangedSignal.raise(this);
+  mVelocityChangedSignal.raise(this);
+  mTransformUpdatedSignal.raise(this);
 
   for(Entity* entity : mChildEntities)
     entity->notifyTransformUpdate();
@@ -486,17 +496,22 @@ void Frame::notifyTransformUpdate()
 //==============================================================================
 void Frame::notifyVelocityUpdate()
 {
-  notifyAccelerationUpdate(); // Global Acceleration depends on Global Velocity
-
-  // Always trigger the signal, in case a new subscriber has registered in the
-  // time since the last signal
-  mVelocityChangedSignal.raise(this);
-
-  // If we already know we need to update, just quit
   if(mNeedVelocityUpdate)
+  {
+    // Global Acceleration depends on Global Velocity
+    notifyAccelerationUpdate();
+
+    // Always trigger the signal, in case a new subscriber has registered in the
+    // time since the last signal
+    mVelocityChangedSignal.raise(this);
     return;
+  }
 
   mNeedVelocityUpdate = true;
+  mNeedAccelerationUpdate = true;
+
+  mAccelerationChangedSignal.raise(this);
+  mVelocityChangedSignal.raise(this);
 
   for(Entity* entity : mChildEntities)
     entity->notifyVelocityUpdate();
@@ -570,6 +570,12 @@ void FreeJoint::integratePositions(double _dt)
   setPositionsStatic(convertToPositions(Qnext));
 }
 
+//==============================================================================
+bool FreeJoint::hasEuclideanPositions() const
+{
+  return false;
+}
+
 //==============================================================================
 void FreeJoint::updateDegreeOfFreedomNames()
 {
@@ -268,6 +268,9 @@ public:
   Eigen::Vector6d getPositionDifferencesStatic(
       const Eigen::Vector6d& _q2, const Eigen::Vector6d& _q1) const override;
 
+  // Documentation inherited
+  bool hasEuclideanPositions() const override;
+
 protected:
 
   /// Constructor called by Skeleton class
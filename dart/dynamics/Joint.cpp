@@ -318,6 +318,12 @@ size_t Joint::getTreeIndex() const
   return mChildBodyNode->getTreeIndex();
 }
 
+//==============================================================================
+bool Joint::hasEuclideanPositions() const
+{
+  return false;
+}
+
 //==============================================================================
 bool Joint::checkSanity(bool _printWarnings) const
 {
@@ -471,6 +477,33 @@ void Joint::notifyPositionUpdate()
     mChildBodyNode->notifyJacobianDerivUpdate();
   }
 
+  notifyLocalPositionUpdate();
+}
+
+//==============================================================================
+void Joint::notifyVelocityUpdate()
+{
+  if(mChildBodyNode)
+  {
+    mChildBodyNode->notifyVelocityUpdate();
+    mChildBodyNode->notifyJacobianDerivUpdate();
+  }
+
+  notifyLocalVelocityUpdate();
+}
+
+//==============================================================================
+void Joint::notifyAccelerationUpdate()
+{
+  if(mChildBodyNode)
+    mChildBodyNode->notifyAccelerationUpdate();
+
+  notifyLocalAccelerationUpdate();
+}
+
+//==============================================================================
+void Joint::notifyLocalPositionUpdate()
+{
   mIsLocalJacobianDirty = true;
   mIsLocalJacobianTimeDerivDirty = true;
   mNeedPrimaryAccelerationUpdate = true;
@@ -490,14 +523,8 @@ void Joint::notifyPositionUpdate()
 }
 
 //==============================================================================
-void Joint::notifyVelocityUpdate()
+void Joint::notifyLocalVelocityUpdate()
 {
-  if(mChildBodyNode)
-  {
-    mChildBodyNode->notifyVelocityUpdate();
-    mChildBodyNode->notifyJacobianDerivUpdate();
-  }
-
   mIsLocalJacobianTimeDerivDirty = true;
 
   mNeedSpatialVelocityUpdate = true;
@@ -505,11 +532,8 @@ void Joint::notifyVelocityUpdate()
 }
 
 //==============================================================================
-void Joint::notifyAccelerationUpdate()
+void Joint::notifyLocalAccelerationUpdate()
 {
-  if(mChildBodyNode)
-    mChildBodyNode->notifyAccelerationUpdate();
-
   mNeedSpatialAccelerationUpdate = true;
   mNeedPrimaryAccelerationUpdate = true;
 }
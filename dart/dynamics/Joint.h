@@ -553,6 +553,11 @@ public:
   /// Integrate velocities using Euler method
   virtual void integrateVelocities(double _dt) = 0;
 
+  /// Return true if integratePositions() of this Joint is the plain Euler
+  /// update q += dq * dt, which lets the Skeleton integrate the positions of
+  /// this Joint in a single pass together with the other Euclidean joints.
+  virtual bool hasEuclideanPositions() const;
+
   /// Return the difference of two generalized coordinates which are measured in
   /// the configuration space of this Skeleton.
   virtual Eigen::VectorXd getPositionDifferences(
@@ -702,6 +707,14 @@ protected:
   /// Called by the Skeleton class
   virtual void registerDofs() = 0;
 
+  /// Make the commands, positions, velocities, accelerations, and forces of
+  /// this Joint view into the given arrays, after copying their current values
+  /// into them. Passing nullptr makes the Joint use its own storage again. This
+  /// is called by the Skeleton class whenever its DOFs are rearranged.
+  virtual void bindState(double* _commands, double* _positions,
+                         double* _velocities, double* _accelerations,
+                         double* _forces) = 0;
+
   /// \brief Create a DegreeOfFreedom pointer.
   /// \param[in] _name DegreeOfFreedom's name.
   /// \param[in] _indexInJoint DegreeOfFreedom's index within the joint. Note
@@ -901,6 +914,19 @@ protected:
   /// Notify that an acceleration update is needed
   void notifyAccelerationUpdate();
 
+  /// Same as notifyPositionUpdate(), except that the subtree of the child
+  /// BodyNode is not notified. Batched updates use this when an ancestor Joint
+  /// in the same batch has already notified that subtree.
+  void notifyLocalPositionUpdate();
+
+  /// Same as notifyVelocityUpdate(), except that the subtree of the child
+  /// BodyNode is not notified
+  void notifyLocalVelocityUpdate();
+
+  /// Same as notifyAccelerationUpdate(), except that the subtree of the child
+  /// BodyNode is not notified
+  void notifyLocalAccelerationUpdate();
+
 protected:
 
   /// Properties of this Joint
@@ -37,11 +37,16 @@
 
 #include "dart/dynamics/MeshShape.h"
 
+#include <algorithm>
 #include <limits>
+#include <map>
+#include <mutex>
 #include <string>
+#include <tuple>
 
 #include <assimp/Importer.hpp>
 #include <assimp/postprocess.h>
+#include <assimp/cexport.h>
 #include <assimp/cimport.h>
 
 #include "dart/config.h"
@@ -132,6 +137,76 @@ aiMaterial::~aiMaterial()
 namespace dart {
 namespace dynamics {
 
+namespace {
+
+/// Process-wide cache of the meshes loaded by MeshShape::loadSharedMesh(). The
+/// cache doesn't keep the meshes alive by itself; a mesh is released once the
+/// last shape that uses it is destroyed.
+struct SharedMeshCache
+{
+  /// Key of a mesh: the path of its file, or its URI and the retriever that
+  /// loaded it if it isn't a local file, and the import flags
+  typedef std::tuple<std::string, const common::ResourceRetriever*,
+                     unsigned int> Key;
+
+  /// Mutex for loading the meshes from several threads
+  std::mutex mMutex;
+
+  /// Meshes that have been loaded
+  std::map<Key, std::weak_ptr<const aiScene>> mMeshes;
+
+  /// Number of entries of mMeshes at which the expired meshes are removed
+  /// next. Doubling it after every removal keeps the cost of the removals
+  /// constant per loaded mesh.
+  size_t mNextPruneSize = 16;
+
+  /// Remove the meshes that are not in use anymore
+  void removeExpiredMeshes()
+  {
+    for (auto it = mMeshes.begin(); it != mMeshes.end();)
+    {
+      if (it->second.expired())
+        it = mMeshes.erase(it);
+      else
+        ++it;
+    }
+
+    mNextPruneSize = std::max<size_t>(16, 2 * mMeshes.size());
+  }
+
+  /// Add _mesh as the mesh of _key unless another thread has added a mesh
+  /// that is still in use meanwhile, and return the mesh of _key
+  std::shared_ptr<const aiScene> addMesh(
+      const Key& _key, const std::shared_ptr<const aiScene>& _mesh)
+  {
+    std::weak_ptr<const aiScene>& entry = mMeshes[_key];
+    std::shared_ptr<const aiScene> mesh = entry.lock();
+    if (mesh)
+      return mesh;
+
+    entry = _mesh;
+    if (mMeshes.size() >= mNextPruneSize)
+      removeExpiredMeshes();
+
+    return _mesh;
+  }
+};
+
+SharedMeshCache& getSharedMeshCache()
+{
+  static SharedMeshCache cache;
+  return cache;
+}
+
+}  // anonymous namespace
+
+const unsigned int MeshShape::DEFAULT_IMPORT_FLAGS =
+    aiProcess_GenNormals
+  | aiProcess_Triangulate
+  | aiProcess_JoinIdenticalVertices
+  | aiProcess_SortByPType
+  | aiProcess_OptimizeMeshes;
+
 MeshShape::MeshShape(const Eigen::Vector3d& _scale, const aiScene* _mesh,
                      const std::string& _path,
                      const common::ResourceRetrieverPtr& _resourceRetriever)
@@ -149,8 +224,28 @@ MeshShape::MeshShape(const Eigen::Vector3d& _scale, const aiScene* _mesh,
   setScale(_scale);
 }
 
+MeshShape::MeshShape(const Eigen::Vector3d& _scale,
+                     const std::shared_ptr<const aiScene>& _mesh,
+                     const std::string& _path,
+                     const common::ResourceRetrieverPtr& _resourceRetriever)
+  : Shape(MESH),
+    mResourceRetriever(_resourceRetriever),
+    mDisplayList(0),
+    mColorMode(MATERIAL_COLOR),
+    mColorIndex(0)
+{
+  assert(_scale[0] > 0.0);
+  assert(_scale[1] > 0.0);
+  assert(_scale[2] > 0.0);
+
+  setMesh(_mesh, _path, _resourceRetriever);
+  setScale(_scale);
+}
+
 MeshShape::~MeshShape() {
-  delete mMesh;
+  // Shared meshes are released by their last owner
+  if (!mSharedMesh)
+    delete mMesh;
 }
 
 const aiScene* MeshShape::getMesh() const {
@@ -168,14 +263,44 @@ void MeshShape::update()
 }
 
 void MeshShape::setAlpha(double _alpha) {
+  Shape::setAlpha(_alpha);
+
+  if(nullptr == mMesh)
+    return;
+
+  bool hasColors = false;
+  for(size_t i=0; i<mMesh->mNumMeshes; ++i)
+    hasColors = hasColors || mMesh->mMeshes[i]->mColors[0] != nullptr;
+
+  if(!hasColors)
+    return;
+
+  // Change a copy of a shared mesh, which keeps the colors of the other
+  // shapes that share it
+  if(mSharedMesh)
+  {
+    aiScene* copy = nullptr;
+    aiCopyScene(mMesh, &copy);
+    if(nullptr == copy)
+    {
+      dtwarn << "[MeshShape::setAlpha] Failed copying the shared mesh '"
+             << mMeshUri << "'.\n";
+      return;
+    }
+
+    mSharedMesh.reset();
+    mMesh = copy;
+  }
 
   for(size_t i=0; i<mMesh->mNumMeshes; ++i)
   {
     aiMesh* mesh = mMesh->mMeshes[i];
+    if(nullptr == mesh->mColors[0])
+      continue;
+
     for(size_t j=0; j<mesh->mNumVertices; ++j)
       mesh->mColors[0][j][3] = _alpha;
   }
-
 }
 
 const std::string &MeshShape::getMeshPath() const
@@ -187,6 +312,9 @@ void MeshShape::setMesh(
   const aiScene* _mesh, const std::string& _path,
   const common::ResourceRetrieverPtr& _resourceRetriever)
 {
+  if (mSharedMesh.get() != _mesh)
+    mSharedMesh.reset();
+
   mMesh = _mesh;
 
   if(nullptr == _mesh) {
@@ -217,6 +345,14 @@ void MeshShape::setMesh(
   computeVolume();
 }
 
+void MeshShape::setMesh(
+  const std::shared_ptr<const aiScene>& _mesh, const std::string& _path,
+  const common::ResourceRetrieverPtr& _resourceRetriever)
+{
+  mSharedMesh = _mesh;
+  setMesh(_mesh.get(), _path, _resourceRetriever);
+}
+
 void MeshShape::setScale(const Eigen::Vector3d& _scale) {
   assert(_scale[0] > 0.0);
   assert(_scale[1] > 0.0);
@@ -330,7 +466,8 @@ void MeshShape::_updateBoundingBoxDim() {
 }
 
 const aiScene* MeshShape::loadMesh(
-  const std::string& _uri, const common::ResourceRetrieverPtr& _retriever)
+  const std::string& _uri, const common::ResourceRetrieverPtr& _retriever,
+  unsigned int _importFlags)
 {
   // Remove points and lines from the import.
   aiPropertyStore* propertyStore = aiCreatePropertyStore();
@@ -348,12 +485,8 @@ const aiScene* MeshShape::loadMesh(
 
   // Import the file.
   const aiScene* scene = aiImportFileExWithProperties(
-    _uri.c_str(), 
-      aiProcess_GenNormals
-    | aiProcess_Triangulate
-    | aiProcess_JoinIdenticalVertices
-    | aiProcess_SortByPType
-    | aiProcess_OptimizeMeshes,
+    _uri.c_str(),
+    _importFlags,
     &fileIO,
     propertyStore
   );
@@ -397,5 +530,75 @@ const aiScene* MeshShape::loadMesh(const std::string& _fileName)
   return loadMesh("file://" + _fileName, retriever);
 }
 
+std::shared_ptr<const aiScene> MeshShape::loadSharedMesh(
+  const std::string& _uri, const common::ResourceRetrieverPtr& _retriever,
+  unsigned int _importFlags)
+{
+  // Key the mesh by the file that the retriever resolves the URI to, so that
+  // the same file is shared whether it's referred by a path, a file:// URI or
+  // a package:// URI, and the same package:// URI doesn't collide across
+  // retrievers that resolve it to different files. The resources that aren't
+  // local files are told apart by their retrievers.
+  SharedMeshCache::Key key;
+  const std::string filePath = _retriever->getFilePath(
+        common::Uri::createFromStringOrPath(_uri));
+  if(!filePath.empty())
+  {
+    key = SharedMeshCache::Key(filePath, nullptr, _importFlags);
+  }
+  else
+  {
+    std::string uri = common::Uri::getUri(_uri);
+    if(uri.empty())
+      uri = _uri;
+
+    key = SharedMeshCache::Key(uri, _retriever.get(), _importFlags);
+  }
+
+  SharedMeshCache& cache = getSharedMeshCache();
+
+  {
+    std::lock_guard<std::mutex> lock(cache.mMutex);
+
+    // Expired meshes are removed lazily, so the entry can be stale
+    const auto it = cache.mMeshes.find(key);
+    if(it != cache.mMeshes.end())
+    {
+      std::shared_ptr<const aiScene> mesh = it->second.lock();
+      if(mesh)
+        return mesh;
+    }
+  }
+
+  // Import without holding the lock, so that loading a mesh doesn't block
+  // the threads that load other meshes. If several threads import the same
+  // mesh at once, the first one that is added to the cache is shared.
+  const aiScene* scene = loadMesh(_uri, _retriever, _importFlags);
+  if(!scene)
+    return nullptr;
+
+  const std::shared_ptr<const aiScene> mesh(scene);
+
+  std::lock_guard<std::mutex> lock(cache.mMutex);
+  return cache.addMesh(key, mesh);
+}
+
+std::shared_ptr<const aiScene> MeshShape::loadSharedMesh(
+  const std::string& _fileName)
+{
+  const auto retriever = std::make_shared<common::LocalResourceRetriever>();
+  return loadSharedMesh("file://" + _fileName, retriever);
+}
+
+size_t MeshShape::getNumSharedMeshes()
+{
+  SharedMeshCache& cache = getSharedMeshCache();
+  std::lock_guard<std::mutex> lock(cache.mMutex);
+
+  cache.removeExpiredMeshes();
+
+  return cache.mMeshes.size();
+}
+
 }  // namespace dynamics
 }  // namespace dart
@@ -38,6 +38,7 @@
 #ifndef DART_DYNAMICS_MESHSHAPE_H_
 #define DART_DYNAMICS_MESHSHAPE_H_
 
+#include <memory>
 #include <string>
 
 #include <assimp/scene.h>
@@ -65,13 +66,21 @@ public:
     SHAPE_COLOR,        ///< Use the color specified by the Shape base class
   };
 
-  /// \brief Constructor.
+  /// \brief Constructor. The shape takes the ownership of _mesh.
   MeshShape(
     const Eigen::Vector3d& _scale,
     const aiScene* _mesh,
     const std::string& _path = "",
     const common::ResourceRetrieverPtr& _resourceRetriever = nullptr);
 
+  /// Constructor. The shape shares _mesh with the other owners of it, such as
+  /// the meshes returned by loadSharedMesh().
+  MeshShape(
+    const Eigen::Vector3d& _scale,
+    const std::shared_ptr<const aiScene>& _mesh,
+    const std::string& _path = "",
+    const common::ResourceRetrieverPtr& _resourceRetriever = nullptr);
+
   /// \brief Destructor.
   virtual ~MeshShape();
 
@@ -85,14 +94,24 @@ public:
   virtual void update();
 
   // Documentation inherited
+  ///
+  /// This also changes the alpha of the vertex colors of the mesh. A mesh that
+  /// is shared with other shapes is copied first, so the other shapes keep
+  /// their colors.
   virtual void setAlpha(double _alpha) override;
 
-  /// \brief
+  /// Set the mesh. The shape takes the ownership of _mesh.
   void setMesh(
     const aiScene* _mesh,
     const std::string& path = "",
     const common::ResourceRetrieverPtr& _resourceRetriever = nullptr);
 
+  /// Set the mesh. The shape shares _mesh with the other owners of it.
+  void setMesh(
+    const std::shared_ptr<const aiScene>& _mesh,
+    const std::string& path = "",
+    const common::ResourceRetrieverPtr& _resourceRetriever = nullptr);
+
   /// \brief URI to the mesh; an empty string if unavailable.
   const std::string &getMeshUri() const;
 
@@ -131,12 +150,36 @@ public:
             const Eigen::Vector4d& _col = Eigen::Vector4d::Ones(),
             bool _default = true) const;
 
+  /// Post-processing steps of Assimp that are applied to the loaded meshes by
+  /// default
+  static const unsigned int DEFAULT_IMPORT_FLAGS;
+
   /// \brief
   static const aiScene* loadMesh(const std::string& _fileName);
 
-  /// \brief 
+  /// Load the mesh at _uri applying the post-processing steps _importFlags.
+  /// The caller takes the ownership of the returned mesh.
   static const aiScene* loadMesh(
-    const std::string& _uri, const common::ResourceRetrieverPtr& _retriever);
+    const std::string& _uri, const common::ResourceRetrieverPtr& _retriever,
+    unsigned int _importFlags = DEFAULT_IMPORT_FLAGS);
+
+  /// Load the mesh at _uri through the process-wide mesh cache. The cache is
+  /// keyed by the file that _retriever resolves _uri to, or by _uri and
+  /// _retriever if the mesh isn't a local file, and by the import flags. The
+  /// mesh is imported only once as long as any of the returned pointers is
+  /// alive, and the callers share the same mesh. The shared meshes must not be
+  /// modified.
+  static std::shared_ptr<const aiScene> loadSharedMesh(
+    const std::string& _uri, const common::ResourceRetrieverPtr& _retriever,
+    unsigned int _importFlags = DEFAULT_IMPORT_FLAGS);
+
+  /// Load the mesh file at _fileName through the process-wide mesh cache
+  static std::shared_ptr<const aiScene> loadSharedMesh(
+    const std::string& _fileName);
+
+  /// Get the number of meshes in the process-wide mesh cache that are still
+  /// in use
+  static size_t getNumSharedMeshes();
 
   // Documentation inherited.
   virtual Eigen::Matrix3d computeInertia(double _mass) const;
@@ -153,6 +196,10 @@ protected:
   /// \brief
   const aiScene* mMesh;
 
+  /// Owner of mMesh if the mesh is shared with other shapes, otherwise
+  /// nullptr and mMesh is owned by this shape
+  std::shared_ptr<const aiScene> mSharedMesh;
+
   /// \brief URI the mesh, if available).
   std::string mMeshUri;
 
@@ -37,6 +37,7 @@
 #include "dart/common/Console.h"
 #include "dart/dynamics/MetaSkeleton.h"
 #include "dart/dynamics/DegreeOfFreedom.h"
+#include "dart/dynamics/Skeleton.h"
 
 namespace dart {
 namespace dynamics {
@@ -122,13 +123,11 @@ static void setValuesFromVector(MetaSkeleton* skel,
 }
 
 //==============================================================================
-template <void (DegreeOfFreedom::*setValue)(double _value)>
-static void setAllValuesFromVector(MetaSkeleton* skel,
-                                   const Eigen::VectorXd& _values,
-                                   const std::string& _fname,
-                                   const std::string& _vname)
+static bool checkValueArraySize(const MetaSkeleton* skel,
+                                const Eigen::VectorXd& _values,
+                                const std::string& _fname,
+                                const std::string& _vname)
 {
-  size_t nDofs = skel->getNumDofs();
   if( _values.size() != static_cast<int>(skel->getNumDofs()) )
   {
     dterr << "[MetaSkeleton::" << _fname << "] Invalid number of entries ("
@@ -136,9 +135,23 @@ static void setAllValuesFromVector(MetaSkeleton* skel,
           << skel->getName() << "] (" << skel << "). Must be equal to ("
           << skel->getNumDofs() << "). Nothing will be set!\n";
     assert(false);
-    return;
+    return false;
   }
 
+  return true;
+}
+
+//==============================================================================
+template <void (DegreeOfFreedom::*setValue)(double _value)>
+static void setAllValuesFromVector(MetaSkeleton* skel,
+                                   const Eigen::VectorXd& _values,
+                                   const std::string& _fname,
+                                   const std::string& _vname)
+{
+  size_t nDofs = skel->getNumDofs();
+  if(!checkValueArraySize(skel, _values, _fname, _vname))
+    return;
+
   for(size_t i=0; i < nDofs; ++i)
   {
     DegreeOfFreedom* dof = skel->getDof(i);
@@ -381,30 +394,33 @@ double MetaSkeleton::getPosition(size_t _index) const
 //==============================================================================
 void MetaSkeleton::setPositions(const Eigen::VectorXd& _positions)
 {
-  setAllValuesFromVector<&DegreeOfFreedom::setPosition>(
-        this, _positions, "setPositions", "_positions");
+  if(checkValueArraySize(this, _positions, "setPositions", "_positions"))
+    Skeleton::setDofValues(this, Skeleton::BATCH_POSITIONS, nullptr,
+                           _positions, "setPositions");
 }
 
 //==============================================================================
 void MetaSkeleton::setPositions(const std::vector<size_t>& _indices,
                             const Eigen::VectorXd& _positions)
 {
-  setValuesFromVector<&DegreeOfFreedom::setPosition>(
-        this, _indices, _positions, "setPositions", "_positions");
+  if(checkIndexArrayAgreement(this, _indices, _positions, "setPositions",
+                               "_positions"))
+    Skeleton::setDofValues(this, Skeleton::BATCH_POSITIONS, &_indices,
+                           _positions, "setPositions");
 }
 
 //==============================================================================
 Eigen::VectorXd MetaSkeleton::getPositions() const
 {
-  return getValuesFromAllDofs<&DegreeOfFreedom::getPosition>(
-        this, "getPositions");
+  return Skeleton::getDofValues(this, Skeleton::BATCH_POSITIONS, nullptr,
+                                "getPositions");
 }
 
 //==============================================================================
 Eigen::VectorXd MetaSkeleton::getPositions(const std::vector<size_t>& _indices) const
 {
-  return getValuesFromVector<&DegreeOfFreedom::getPosition>(
-        this, _indices, "getPositions");
+  return Skeleton::getDofValues(this, Skeleton::BATCH_POSITIONS, &_indices,
+                                "getPositions");
 }
 
 //==============================================================================
@@ -458,30 +474,33 @@ double MetaSkeleton::getVelocity(size_t _index) const
 //==============================================================================
 void MetaSkeleton::setVelocities(const Eigen::VectorXd& _velocities)
 {
-  setAllValuesFromVector<&DegreeOfFreedom::setVelocity>(
-        this, _velocities, "setVelocities", "_velocities");
+  if(checkValueArraySize(this, _velocities, "setVelocities", "_velocities"))
+    Skeleton::setDofValues(this, Skeleton::BATCH_VELOCITIES, nullptr,
+                           _velocities, "setVelocities");
 }
 
 //==============================================================================
 void MetaSkeleton::setVelocities(const std::vector<size_t>& _indices,
                              const Eigen::VectorXd& _velocities)
 {
-  setValuesFromVector<&DegreeOfFreedom::setVelocity>(
-        this, _indices, _velocities, "setVelocities", "_velocities");
+  if(checkIndexArrayAgreement(this, _indices, _velocities, "setVelocities",
+                               "_velocities"))
+    Skeleton::setDofValues(this, Skeleton::BATCH_VELOCITIES, &_indices,
+                           _velocities, "setVelocities");
 }
 
 //==============================================================================
 Eigen::VectorXd MetaSkeleton::getVelocities() const
 {
-  return getValuesFromAllDofs<&DegreeOfFreedom::getVelocity>(
-        this, "getVelocities");
+  return Skeleton::getDofValues(this, Skeleton::BATCH_VELOCITIES, nullptr,
+                                "getVelocities");
 }
 
 //==============================================================================
 Eigen::VectorXd MetaSkeleton::getVelocities(const std::vector<size_t>& _indices) const
 {
-  return getValuesFromVector<&DegreeOfFreedom::getVelocity>(
-        this, _indices, "getVelocities");
+  return Skeleton::getDofValues(this, Skeleton::BATCH_VELOCITIES, &_indices,
+                                "getVelocities");
 }
 
 //==============================================================================
@@ -535,31 +554,35 @@ double MetaSkeleton::getAcceleration(size_t _index) const
 //==============================================================================
 void MetaSkeleton::setAccelerations(const Eigen::VectorXd& _accelerations)
 {
-  setAllValuesFromVector<&DegreeOfFreedom::setAcceleration>(
-        this, _accelerations, "setAccelerations", "_accelerations");
+  if(checkValueArraySize(this, _accelerations, "setAccelerations",
+                         "_accelerations"))
+    Skeleton::setDofValues(this, Skeleton::BATCH_ACCELERATIONS, nullptr,
+                           _accelerations, "setAccelerations");
 }
 
 //==============================================================================
 void MetaSkeleton::setAccelerations(const std::vector<size_t>& _indices,
                                 const Eigen::VectorXd& _accelerations)
 {
-  setValuesFromVector<&DegreeOfFreedom::setAcceleration>(
-        this, _indices, _accelerations, "setAccelerations", "_accelerations");
+  if(checkIndexArrayAgreement(this, _indices, _accelerations,
+                               "setAccelerations", "_accelerations"))
+    Skeleton::setDofValues(this, Skeleton::BATCH_ACCELERATIONS, &_indices,
+                           _accelerations, "setAccelerations");
 }
 
 //==============================================================================
 Eigen::VectorXd MetaSkeleton::getAccelerations() const
 {
-  return getValuesFromAllDofs<&DegreeOfFreedom::getAcceleration>(
-        this, "getAccelerations");
+  return Skeleton::getDofValues(this, Skeleton::BATCH_ACCELERATIONS, nullptr,
+                                "getAccelerations");
 }
 
 //==============================================================================
 Eigen::VectorXd MetaSkeleton::getAccelerations(
     const std::vector<size_t>& _indices) const
 {
-  return getValuesFromVector<&DegreeOfFreedom::getAcceleration>(
-        this, _indices, "getAccelerations");
+  return Skeleton::getDofValues(this, Skeleton::BATCH_ACCELERATIONS, &_indices,
+                                "getAccelerations");
 }
 
 //==============================================================================
@@ -613,30 +636,33 @@ double MetaSkeleton::getForce(size_t _index) const
 //==============================================================================
 void MetaSkeleton::setForces(const Eigen::VectorXd& _forces)
 {
-  setAllValuesFromVector<&DegreeOfFreedom::setForce>(
-        this, _forces, "setForces", "_forces");
+  if(checkValueArraySize(this, _forces, "setForces", "_forces"))
+    Skeleton::setDofValues(this, Skeleton::BATCH_FORCES, nullptr,
+                           _forces, "setForces");
 }
 
 //==============================================================================
 void MetaSkeleton::setForces(const std::vector<size_t>& _indices,
                          const Eigen::VectorXd& _forces)
 {
-  setValuesFromVector<&DegreeOfFreedom::setForce>(
-        this, _indices, _forces, "setForces", "_forces");
+  if(checkIndexArrayAgreement(this, _indices, _forces, "setForces",
+                               "_forces"))
+    Skeleton::setDofValues(this, Skeleton::BATCH_FORCES, &_indices,
+                           _forces, "setForces");
 }
 
 //==============================================================================
 Eigen::VectorXd MetaSkeleton::getForces() const
 {
-  return getValuesFromAllDofs<&DegreeOfFreedom::getForce>(
-        this, "getForces");
+  return Skeleton::getDofValues(this, Skeleton::BATCH_FORCES, nullptr,
+                                "getForces");
 }
 
 //==============================================================================
 Eigen::VectorXd MetaSkeleton::getForces(const std::vector<size_t>& _indices) const
 {
-  return getValuesFromVector<&DegreeOfFreedom::getForce>(
-        this, _indices, "getForces");
+  return Skeleton::getDofValues(this, Skeleton::BATCH_FORCES, &_indices,
+                                "getForces");
 }
 
 //==============================================================================
@@ -39,6 +39,7 @@
 
 #include <string>
 #include <array>
+#include <new>
 
 #include "dart/config.h"
 #include "dart/common/Console.h"
@@ -370,20 +371,22 @@ public:
   /// Fixed-size version of setPositions()
   void setPositionsStatic(const Vector& _positions);
 
-  /// Fixed-size version of getPositions()
-  const Vector& getPositionsStatic() const;
+  /// Fixed-size version of getPositions(). The positions are stored in the
+  /// state arrays of the Skeleton, so this returns a map of them rather than a
+  /// Vector, which stays valid when the Joint moves to other storage.
+  const Eigen::Map<Vector>& getPositionsStatic() const;
 
   /// Fixed-size version of setVelocities()
   void setVelocitiesStatic(const Vector& _velocities);
 
-  /// Fixed-size version of getVelocities()
-  const Vector& getVelocitiesStatic() const;
+  /// Fixed-size version of getVelocities(), see getPositionsStatic()
+  const Eigen::Map<Vector>& getVelocitiesStatic() const;
 
   /// Fixed-size version of setAccelerations()
   void setAccelerationsStatic(const Vector& _accels);
 
-  /// Fixed-size version of getAccelerations()
-  const Vector& getAccelerationsStatic() const;
+  /// Fixed-size version of getAccelerations(), see getPositionsStatic()
+  const Eigen::Map<Vector>& getAccelerationsStatic() const;
 
   //----------------------------------------------------------------------------
   // Force
@@ -452,6 +455,9 @@ public:
   // Documentation inherited
   virtual void integrateVelocities(double _dt) override;
 
+  // Documentation inherited
+  bool hasEuclideanPositions() const override;
+
   // Documentation inherited
   Eigen::VectorXd getPositionDifferences(
       const Eigen::VectorXd& _q2, const Eigen::VectorXd& _q1) const override;
@@ -506,6 +512,10 @@ protected:
   // Docuemntation inherited
   void registerDofs() override;
 
+  // Documentation inherited
+  void bindState(double* _commands, double* _positions, double* _velocities,
+                 double* _accelerations, double* _forces) override;
+
   //----------------------------------------------------------------------------
   /// \{ \name Recursive dynamics routines
   //----------------------------------------------------------------------------
@@ -684,15 +694,20 @@ protected:
   /// Array of DegreeOfFreedom objects
   std::array<DegreeOfFreedom*, DOF> mDofs;
 
+  /// Own storage of the commands, positions, velocities, accelerations, and
+  /// forces (one column each, in this order), which is used while this Joint is
+  /// not bound to the state arrays of a Skeleton
+  Eigen::Matrix<double, DOF, 5> mStateStorage;
+
   /// Command
-  Vector mCommands;
+  Eigen::Map<Vector> mCommands;
 
   //----------------------------------------------------------------------------
   // Configuration
   //----------------------------------------------------------------------------
 
   /// Position
-  Vector mPositions;
+  Eigen::Map<Vector> mPositions;
 
   /// Derivatives w.r.t. an arbitrary scalr variable
   Vector mPositionDeriv;
@@ -702,7 +717,7 @@ protected:
   //----------------------------------------------------------------------------
 
   /// Generalized velocity
-  Vector mVelocities;
+  Eigen::Map<Vector> mVelocities;
 
   /// Derivatives w.r.t. an arbitrary scalr variable
   Vector mVelocitiesDeriv;
@@ -712,7 +727,7 @@ protected:
   //----------------------------------------------------------------------------
 
   /// Generalized acceleration
-  Vector mAccelerations;
+  Eigen::Map<Vector> mAccelerations;
 
   /// Derivatives w.r.t. an arbitrary scalr variable
   Vector mAccelerationsDeriv;
@@ -722,7 +737,7 @@ protected:
   //----------------------------------------------------------------------------
 
   /// Generalized force
-  Vector mForces;
+  Eigen::Map<Vector> mForces;
 
   /// Derivatives w.r.t. an arbitrary scalr variable
   Vector mForcesDeriv;
@@ -1084,10 +1084,9 @@ void PointMassNotifier::clearAccelerationNotice()
 //==============================================================================
 void PointMassNotifier::notifyTransformUpdate()
 {
+  notifyVelocityUpdate(); // Global Velocity depends on the Global Transform
+
   mNeedTransformUpdate = true;
-  mNeedVelocityUpdate = true;
-  mNeedPartialAccelerationUpdate = true;
-  mNeedAccelerationUpdate = true;
 
   mParentSoftBodyNode->notifyArticulatedInertiaUpdate();
   mParentSoftBodyNode->notifyExternalForcesUpdate();
@@ -177,6 +177,7 @@ void PrismaticJoint::updateLocalJacobian(bool _mandatory) const
   if(_mandatory)
   {
     mJacobian = math::AdTLinear(mJointP.mT_ChildBodyToJoint, mPrismaticP.mAxis);
+    mJacobianStructure = LINEAR_JACOBIAN;
 
     // Verification
     assert(!math::isNan(mJacobian));
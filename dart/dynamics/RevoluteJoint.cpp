@@ -179,6 +179,11 @@ void RevoluteJoint::updateLocalJacobian(bool _mandatory) const
   {
     mJacobian = math::AdTAngular(mJointP.mT_ChildBodyToJoint, mRevoluteP.mAxis);
 
+    // The linear part is p x (R * axis), which vanishes whenever the joint
+    // frame sits on the axis through the origin of the child BodyNode frame
+    mJacobianStructure = mJacobian.tail<3>().isZero(0.0)?
+          ANGULAR_JACOBIAN : GENERAL_JACOBIAN;
+
     // Verification
     assert(!math::isNan(mJacobian));
   }
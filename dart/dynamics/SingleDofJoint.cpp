@@ -301,7 +301,7 @@ void SingleDofJoint::setCommand(size_t _index, double _command)
   switch (mJointP.mActuatorType)
   {
     case FORCE:
-      mCommand = math::clip(_command,
+      *mCommand = math::clip(_command,
                             mSingleDofP.mForceLowerLimit,
                             mSingleDofP.mForceUpperLimit);
       break;
@@ -312,20 +312,20 @@ void SingleDofJoint::setCommand(size_t _index, double _command)
                << _command << ") command for a PASSIVE joint [" << getName()
                << "].\n";
       }
-      mCommand = _command;
+      *mCommand = _command;
       break;
     case SERVO:
-      mCommand = math::clip(_command,
+      *mCommand = math::clip(_command,
                             mSingleDofP.mVelocityLowerLimit,
                             mSingleDofP.mVelocityUpperLimit);
       break;
     case ACCELERATION:
-      mCommand = math::clip(_command,
+      *mCommand = math::clip(_command,
                             mSingleDofP.mAccelerationLowerLimit,
                             mSingleDofP.mAccelerationUpperLimit);
       break;
     case VELOCITY:
-      mCommand = math::clip(_command,
+      *mCommand = math::clip(_command,
                             mSingleDofP.mVelocityLowerLimit,
                             mSingleDofP.mVelocityUpperLimit);
       // TODO: This possibly makes the acceleration to exceed the limits.
@@ -337,7 +337,7 @@ void SingleDofJoint::setCommand(size_t _index, double _command)
                << _command << ") command for a LOCKED joint [" << getName()
                << "].\n";
       }
-      mCommand = _command;
+      *mCommand = _command;
       break;
     default:
       assert(false);
@@ -354,7 +354,7 @@ double SingleDofJoint::getCommand(size_t _index) const
     return 0.0;
   }
 
-  return mCommand;
+  return *mCommand;
 }
 
 //==============================================================================
@@ -372,13 +372,13 @@ void SingleDofJoint::setCommands(const Eigen::VectorXd& _commands)
 //==============================================================================
 Eigen::VectorXd SingleDofJoint::getCommands() const
 {
-  return Eigen::Matrix<double, 1, 1>::Constant(mCommand);
+  return Eigen::Matrix<double, 1, 1>::Constant(*mCommand);
 }
 
 //==============================================================================
 void SingleDofJoint::resetCommands()
 {
-  mCommand = 0.0;
+  *mCommand = 0.0;
 }
 
 //==============================================================================
@@ -557,7 +557,7 @@ void SingleDofJoint::setVelocity(size_t _index, double _velocity)
 
 #if DART_MAJOR_MINOR_VERSION_AT_MOST(5,1)
   if (mJointP.mActuatorType == VELOCITY)
-    mCommand = getVelocityStatic();
+    *mCommand = getVelocityStatic();
   // TODO: Remove at DART 5.1.
 #endif
 }
@@ -587,7 +587,7 @@ void SingleDofJoint::setVelocities(const Eigen::VectorXd& _velocities)
 
 #if DART_MAJOR_MINOR_VERSION_AT_MOST(5,1)
   if (mJointP.mActuatorType == VELOCITY)
-    mCommand = getVelocityStatic();
+    *mCommand = getVelocityStatic();
   // TODO: Remove at DART 5.1.
 #endif
 }
@@ -719,7 +719,7 @@ void SingleDofJoint::setAcceleration(size_t _index, double _acceleration)
 
 #if DART_MAJOR_MINOR_VERSION_AT_MOST(5,1)
   if (mJointP.mActuatorType == ACCELERATION)
-    mCommand = getAccelerationStatic();
+    *mCommand = getAccelerationStatic();
   // TODO: Remove at DART 5.1.
 #endif
 }
@@ -749,7 +749,7 @@ void SingleDofJoint::setAccelerations(const Eigen::VectorXd& _accelerations)
 
 #if DART_MAJOR_MINOR_VERSION_AT_MOST(5,1)
   if (mJointP.mActuatorType == ACCELERATION)
-    mCommand = getAccelerationStatic();
+    *mCommand = getAccelerationStatic();
   // TODO: Remove at DART 5.1.
 #endif
 }
@@ -819,49 +819,49 @@ double SingleDofJoint::getAccelerationUpperLimit(size_t _index) const
 //==============================================================================
 void SingleDofJoint::setPositionStatic(const double& _position)
 {
-  if(mPosition == _position)
+  if(*mPosition == _position)
     return;
 
-  mPosition = _position;
+  *mPosition = _position;
   notifyPositionUpdate();
 }
 
 //==============================================================================
 const double& SingleDofJoint::getPositionStatic() const
 {
-  return mPosition;
+  return *mPosition;
 }
 
 //==============================================================================
 void SingleDofJoint::setVelocityStatic(const double& _velocity)
 {
-  if(mVelocity == _velocity)
+  if(*mVelocity == _velocity)
     return;
 
-  mVelocity = _velocity;
+  *mVelocity = _velocity;
   notifyVelocityUpdate();
 }
 
 //==============================================================================
 const double& SingleDofJoint::getVelocityStatic() const
 {
-  return mVelocity;
+  return *mVelocity;
 }
 
 //==============================================================================
 void SingleDofJoint::setAccelerationStatic(const double& _acceleration)
 {
-  if(mAcceleration == _acceleration)
+  if(*mAcceleration == _acceleration)
     return;
 
-  mAcceleration = _acceleration;
+  *mAcceleration = _acceleration;
   notifyAccelerationUpdate();
 }
 
 //==============================================================================
 const double& SingleDofJoint::getAccelerationStatic() const
 {
-  return mAcceleration;
+  return *mAcceleration;
 }
 
 //==============================================================================
@@ -873,11 +873,11 @@ void SingleDofJoint::setForce(size_t _index, double _force)
     return;
   }
 
-  mForce = _force;
+  *mForce = _force;
 
 #if DART_MAJOR_MINOR_VERSION_AT_MOST(5,1)
   if (mJointP.mActuatorType == FORCE)
-    mCommand = mForce;
+    *mCommand = *mForce;
   // TODO: Remove at DART 5.1.
 #endif
 }
@@ -891,7 +891,7 @@ double SingleDofJoint::getForce(size_t _index)
     return 0.0;
   }
 
-  return mForce;
+  return *mForce;
 }
 
 //==============================================================================
@@ -903,11 +903,11 @@ void SingleDofJoint::setForces(const Eigen::VectorXd& _forces)
     return;
   }
 
-  mForce = _forces[0];
+  *mForce = _forces[0];
 
 #if DART_MAJOR_MINOR_VERSION_AT_MOST(5,1)
   if (mJointP.mActuatorType == FORCE)
-    mCommand = mForce;
+    *mCommand = *mForce;
   // TODO: Remove at DART 5.1.
 #endif
 }
@@ -915,17 +915,17 @@ void SingleDofJoint::setForces(const Eigen::VectorXd& _forces)
 //==============================================================================
 Eigen::VectorXd SingleDofJoint::getForces() const
 {
-  return Eigen::Matrix<double, 1, 1>::Constant(mForce);
+  return Eigen::Matrix<double, 1, 1>::Constant(*mForce);
 }
 
 //==============================================================================
 void SingleDofJoint::resetForces()
 {
-  mForce = 0.0;
+  *mForce = 0.0;
 
 #if DART_MAJOR_MINOR_VERSION_AT_MOST(5,1)
   if (mJointP.mActuatorType == FORCE)
-    mCommand = mForce;
+    *mCommand = *mForce;
   // TODO: Remove at DART 5.1.
 #endif
 }
@@ -1050,6 +1050,12 @@ void SingleDofJoint::integrateVelocities(double _dt)
   setVelocityStatic(getVelocityStatic() + getAccelerationStatic() * _dt);
 }
 
+//==============================================================================
+bool SingleDofJoint::hasEuclideanPositions() const
+{
+  return true;
+}
+
 //==============================================================================
 Eigen::VectorXd SingleDofJoint::getPositionDifferences(
     const Eigen::VectorXd& _q2, const Eigen::VectorXd& _q1) const
@@ -1203,19 +1209,21 @@ double SingleDofJoint::getPotentialEnergy() const
 SingleDofJoint::SingleDofJoint(const Properties& _properties)
   : Joint(_properties),
     mDof(createDofPointer(0)),
-    mCommand(0.0),
-    mPosition(0.0),
+    mStateStorage(Eigen::Matrix<double, 1, 5>::Zero()),
+    mCommand(mStateStorage.data()),
+    mPosition(mStateStorage.data() + 1),
     mPositionDeriv(0.0),
-    mVelocity(0.0),
+    mVelocity(mStateStorage.data() + 2),
     mVelocityDeriv(0.0),
-    mAcceleration(0.0),
+    mAcceleration(mStateStorage.data() + 3),
     mAccelerationDeriv(0.0),
-    mForce(0.0),
+    mForce(mStateStorage.data() + 4),
     mForceDeriv(0.0),
     mVelocityChange(0.0),
     mImpulse(0.0),
     mConstraintImpulse(0.0),
     mJacobian(Eigen::Vector6d::Zero()),
+    mJacobianStructure(GENERAL_JACOBIAN),
     mJacobianDeriv(Eigen::Vector6d::Zero()),
     mInvProjArtInertia(0.0),
     mInvProjArtInertiaImplicit(0.0),
@@ -1236,6 +1244,33 @@ void SingleDofJoint::registerDofs()
         skel->mNameMgrForDofs.issueNewNameAndAdd(mDof->getName(), mDof);
 }
 
+//==============================================================================
+void SingleDofJoint::bindState(double* _commands, double* _positions,
+                               double* _velocities, double* _accelerations,
+                               double* _forces)
+{
+  if(nullptr == _positions)
+  {
+    _commands      = mStateStorage.data();
+    _positions     = mStateStorage.data() + 1;
+    _velocities    = mStateStorage.data() + 2;
+    _accelerations = mStateStorage.data() + 3;
+    _forces        = mStateStorage.data() + 4;
+  }
+
+  *_commands      = *mCommand;
+  *_positions     = *mPosition;
+  *_velocities    = *mVelocity;
+  *_accelerations = *mAcceleration;
+  *_forces        = *mForce;
+
+  mCommand      = _commands;
+  mPosition     = _positions;
+  mVelocity     = _velocities;
+  mAcceleration = _accelerations;
+  mForce        = _forces;
+}
+
 //==============================================================================
 void SingleDofJoint::updateDegreeOfFreedomNames()
 {
@@ -1267,7 +1302,7 @@ void SingleDofJoint::updateLocalPrimaryAcceleration() const
 Eigen::Vector6d SingleDofJoint::getBodyConstraintWrench() const
 {
   assert(mChildBodyNode);
-  return mChildBodyNode->getBodyForce() - getLocalJacobianStatic() * mForce;
+  return mChildBodyNode->getBodyForce() - getLocalJacobianStatic() * (*mForce);
 }
 
 //==============================================================================
@@ -1369,6 +1404,55 @@ void SingleDofJoint::addVelocityChangeTo(Eigen::Vector6d& _velocityChange)
   _velocityChange += getLocalJacobianStatic() * mVelocityChange;
 }
 
+//==============================================================================
+Eigen::Vector6d SingleDofJoint::computeArtInertiaJacobian(
+    const Eigen::Matrix6d& _artInertia) const
+{
+  const Eigen::Vector6d& S = getLocalJacobianStatic();
+  switch (mJacobianStructure)
+  {
+    case ANGULAR_JACOBIAN:
+      return _artInertia.leftCols<3>() * S.head<3>();
+    case LINEAR_JACOBIAN:
+      return _artInertia.rightCols<3>() * S.tail<3>();
+    default:
+      return _artInertia * S;
+  }
+}
+
+//==============================================================================
+double SingleDofJoint::computeProjArtInertia(
+    const Eigen::Matrix6d& _artInertia) const
+{
+  const Eigen::Vector6d& S = getLocalJacobianStatic();
+  switch (mJacobianStructure)
+  {
+    case ANGULAR_JACOBIAN:
+      return S.head<3>().dot(_artInertia.topLeftCorner<3,3>() * S.head<3>());
+    case LINEAR_JACOBIAN:
+      return S.tail<3>().dot(
+            _artInertia.bottomRightCorner<3,3>() * S.tail<3>());
+    default:
+      return S.dot(_artInertia * S);
+  }
+}
+
+//==============================================================================
+double SingleDofJoint::projectArtInertia(const Eigen::Matrix6d& _artInertia,
+                                         const Eigen::Vector6d& _vec) const
+{
+  const Eigen::Vector6d& S = getLocalJacobianStatic();
+  switch (mJacobianStructure)
+  {
+    case ANGULAR_JACOBIAN:
+      return S.head<3>().dot(_artInertia.topRows<3>() * _vec);
+    case LINEAR_JACOBIAN:
+      return S.tail<3>().dot(_artInertia.bottomRows<3>() * _vec);
+    default:
+      return S.dot(_artInertia * _vec);
+  }
+}
+
 //==============================================================================
 void SingleDofJoint::addChildArtInertiaTo(
     Eigen::Matrix6d& _parentArtInertia, const Eigen::Matrix6d& _childArtInertia)
@@ -1398,7 +1482,7 @@ void SingleDofJoint::addChildArtInertiaToDynamic(
     Eigen::Matrix6d& _parentArtInertia, const Eigen::Matrix6d& _childArtInertia)
 {
   // Child body's articulated inertia
-  Eigen::Vector6d AIS = _childArtInertia * getLocalJacobianStatic();
+  const Eigen::Vector6d AIS = computeArtInertiaJacobian(_childArtInertia);
   Eigen::Matrix6d PI = _childArtInertia;
   PI.noalias() -= mInvProjArtInertia * AIS * AIS.transpose();
   assert(!math::isNan(PI));
@@ -1447,7 +1531,7 @@ void SingleDofJoint::addChildArtInertiaImplicitToDynamic(
     Eigen::Matrix6d& _parentArtInertia, const Eigen::Matrix6d& _childArtInertia)
 {
   // Child body's articulated inertia
-  const Eigen::Vector6d AIS = _childArtInertia * getLocalJacobianStatic();
+  const Eigen::Vector6d AIS = computeArtInertiaJacobian(_childArtInertia);
   Eigen::Matrix6d PI = _childArtInertia;
   PI.noalias() -= mInvProjArtInertiaImplicit * AIS * AIS.transpose();
   assert(!math::isNan(PI));
@@ -1494,8 +1578,7 @@ void SingleDofJoint::updateInvProjArtInertiaDynamic(
     const Eigen::Matrix6d& _artInertia)
 {
   // Projected articulated inertia
-  const Eigen::Vector6d& Jacobian = getLocalJacobianStatic();
-  double projAI = Jacobian.dot(_artInertia * Jacobian);
+  const double projAI = computeProjArtInertia(_artInertia);
 
   // Inversion of projected articulated inertia
   mInvProjArtInertia = 1.0 / projAI;
@@ -1540,8 +1623,7 @@ void SingleDofJoint::updateInvProjArtInertiaImplicitDynamic(
     const Eigen::Matrix6d& _artInertia, double _timeStep)
 {
   // Projected articulated inertia
-  const Eigen::Vector6d& Jacobian = getLocalJacobianStatic();
-  double projAI = Jacobian.dot(_artInertia * Jacobian);
+  double projAI = computeProjArtInertia(_artInertia);
 
   // Add additional inertia for implicit damping and spring force
   projAI += _timeStep * mSingleDofP.mDampingCoefficient
@@ -1602,7 +1684,7 @@ void SingleDofJoint::addChildBiasForceToDynamic(
 {
   // Compute beta
   Eigen::Vector6d beta = _childBiasForce;
-  const double coeff = getInvProjArtInertiaImplicit() * mTotalForce;
+  const double coeff = mInvProjArtInertiaImplicit * mTotalForce;
   beta.noalias() += _childArtInertia*(_childPartialAcc
                                       + coeff*getLocalJacobianStatic());
 
@@ -1671,8 +1753,8 @@ void SingleDofJoint::addChildBiasImpulseToDynamic(
   // Compute beta
   const Eigen::Vector6d beta
       = _childBiasImpulse
-        + _childArtInertia * getLocalJacobianStatic()
-          * getInvProjArtInertia() * mTotalImpulse;
+        + computeArtInertiaJacobian(_childArtInertia)
+          * mInvProjArtInertia * mTotalImpulse;
 
   // Verification
   assert(!math::isNan(beta));
@@ -1702,20 +1784,20 @@ void SingleDofJoint::updateTotalForce(const Eigen::Vector6d& _bodyForce,
   switch (mJointP.mActuatorType)
   {
     case FORCE:
-      mForce = mCommand;
+      *mForce = *mCommand;
       updateTotalForceDynamic(_bodyForce, _timeStep);
       break;
     case PASSIVE:
     case SERVO:
-      mForce = 0.0;
+      *mForce = 0.0;
       updateTotalForceDynamic(_bodyForce, _timeStep);
       break;
     case ACCELERATION:
-      setAccelerationStatic(mCommand);
+      setAccelerationStatic(*mCommand);
       updateTotalForceKinematic(_bodyForce, _timeStep);
       break;
     case VELOCITY:
-      setAccelerationStatic( (mCommand - getVelocityStatic()) / _timeStep );
+      setAccelerationStatic( (*mCommand - getVelocityStatic()) / _timeStep );
       updateTotalForceKinematic(_bodyForce, _timeStep);
       break;
     case LOCKED:
@@ -1744,7 +1826,7 @@ void SingleDofJoint::updateTotalForceDynamic(
       -mSingleDofP.mDampingCoefficient * getVelocityStatic();
 
   // Compute alpha
-  mTotalForce = mForce + springForce + dampingForce
+  mTotalForce = *mForce + springForce + dampingForce
                 - getLocalJacobianStatic().dot(_bodyForce);
 }
 
@@ -1823,9 +1905,9 @@ void SingleDofJoint::updateAccelerationDynamic(
     const Eigen::Matrix6d& _artInertia, const Eigen::Vector6d& _spatialAcc)
 {
   //
-  const double val = getLocalJacobianStatic().dot(
-        _artInertia * math::AdInvT(getLocalTransform(), _spatialAcc));
-  setAccelerationStatic(getInvProjArtInertiaImplicit() * (mTotalForce - val));
+  const double val = projectArtInertia(
+        _artInertia, math::AdInvT(getLocalTransform(), _spatialAcc));
+  setAccelerationStatic(mInvProjArtInertiaImplicit * (mTotalForce - val));
 
   // Verification
   assert(!math::isNan(getAccelerationStatic()));
@@ -1868,10 +1950,10 @@ void SingleDofJoint::updateVelocityChangeDynamic(
 {
   //
   mVelocityChange
-      = getInvProjArtInertia()
+      = mInvProjArtInertia
         * (mTotalImpulse
-           - getLocalJacobianStatic().dot(
-             _artInertia * math::AdInvT(getLocalTransform(), _velocityChange)));
+           - projectArtInertia(
+             _artInertia, math::AdInvT(getLocalTransform(), _velocityChange)));
 
   // Verification
   assert(!math::isNan(mVelocityChange));
@@ -1891,14 +1973,14 @@ void SingleDofJoint::updateForceID(const Eigen::Vector6d& _bodyForce,
                                    bool _withDampingForces,
                                    bool _withSpringForces)
 {
-  mForce = getLocalJacobianStatic().dot(_bodyForce);
+  *mForce = getLocalJacobianStatic().dot(_bodyForce);
 
   // Damping force
   if (_withDampingForces)
   {
     const double dampingForce =
         -mSingleDofP.mDampingCoefficient * getVelocityStatic();
-    mForce -= dampingForce;
+    *mForce -= dampingForce;
   }
 
   // Spring force
@@ -1908,7 +1990,7 @@ void SingleDofJoint::updateForceID(const Eigen::Vector6d& _bodyForce,
                               + _timeStep*getVelocityStatic();
     const double springForce =
        -mSingleDofP.mSpringStiffness*(nextPosition - mSingleDofP.mRestPosition);
-    mForce -= springForce;
+    *mForce -= springForce;
   }
 }
 
@@ -1990,13 +2072,13 @@ void SingleDofJoint::updateConstrainedTermsDynamic(double _timeStep)
 
   setVelocityStatic(getVelocityStatic() + mVelocityChange);
   setAccelerationStatic(getAccelerationStatic() + mVelocityChange*invTimeStep);
-  mForce        += mConstraintImpulse*invTimeStep;
+  *mForce        += mConstraintImpulse*invTimeStep;
 }
 
 //==============================================================================
 void SingleDofJoint::updateConstrainedTermsKinematic(double _timeStep)
 {
-  mForce += mImpulse / _timeStep;
+  *mForce += mImpulse / _timeStep;
 }
 
 //==============================================================================
@@ -2007,8 +2089,8 @@ void SingleDofJoint::addChildBiasForceForInvMassMatrix(
 {
   // Compute beta
   Eigen::Vector6d beta = _childBiasForce;
-  beta.noalias() += _childArtInertia * getLocalJacobianStatic()
-                    * getInvProjArtInertia() * mInvM_a;
+  beta.noalias() += computeArtInertiaJacobian(_childArtInertia)
+                    * mInvProjArtInertia * mInvM_a;
 
   // Verification
   assert(!math::isNan(beta));
@@ -2026,8 +2108,8 @@ void SingleDofJoint::addChildBiasForceForInvAugMassMatrix(
 {
   // Compute beta
   Eigen::Vector6d beta = _childBiasForce;
-  beta.noalias() += _childArtInertia * getLocalJacobianStatic()
-                    * getInvProjArtInertiaImplicit() * mInvM_a;
+  beta.noalias() += computeArtInertiaJacobian(_childArtInertia)
+                    * mInvProjArtInertiaImplicit * mInvM_a;
 
   // Verification
   assert(!math::isNan(beta));
@@ -2042,7 +2124,7 @@ void SingleDofJoint::updateTotalForceForInvMassMatrix(
     const Eigen::Vector6d& _bodyForce)
 {
   // Compute alpha
-  mInvM_a = mForce - getLocalJacobianStatic().dot(_bodyForce);
+  mInvM_a = *mForce - getLocalJacobianStatic().dot(_bodyForce);
 }
 
 //==============================================================================
@@ -2053,9 +2135,9 @@ void SingleDofJoint::getInvMassMatrixSegment(Eigen::MatrixXd& _invMassMat,
 {
   //
   mInvMassMatrixSegment
-      = getInvProjArtInertia()
-        * (mInvM_a - getLocalJacobianStatic().dot(
-             _artInertia * math::AdInvT(getLocalTransform(), _spatialAcc)));
+      = mInvProjArtInertia
+        * (mInvM_a - projectArtInertia(
+             _artInertia, math::AdInvT(getLocalTransform(), _spatialAcc)));
 
   // Verification
   assert(!math::isNan(mInvMassMatrixSegment));
@@ -2076,9 +2158,9 @@ void SingleDofJoint::getInvAugMassMatrixSegment(
 {
   //
   mInvMassMatrixSegment
-      = getInvProjArtInertiaImplicit()
-        * (mInvM_a - getLocalJacobianStatic().dot(
-             _artInertia * math::AdInvT(getLocalTransform(), _spatialAcc)));
+      = mInvProjArtInertiaImplicit
+        * (mInvM_a - projectArtInertia(
+             _artInertia, math::AdInvT(getLocalTransform(), _spatialAcc)));
 
   // Verification
   assert(!math::isNan(mInvMassMatrixSegment));
@@ -426,6 +426,9 @@ public:
   // Documentation inherited
   virtual void integrateVelocities(double _dt) override;
 
+  // Documentation inherited
+  bool hasEuclideanPositions() const override;
+
   // Documentation inherited
   Eigen::VectorXd getPositionDifferences(
       const Eigen::VectorXd& _q2, const Eigen::VectorXd& _q1) const override;
@@ -479,6 +482,10 @@ protected:
   // Documentation inherited
   void registerDofs() override;
 
+  // Documentation inherited
+  void bindState(double* _commands, double* _positions, double* _velocities,
+                 double* _accelerations, double* _forces) override;
+
   // Documentation inherited
   virtual void updateDegreeOfFreedomNames() override;
 
@@ -653,20 +660,36 @@ protected:
 
 protected:
 
+  /// Parts of the local Jacobian that can be nonzero. Joints whose motion is a
+  /// pure rotation or a pure translation in the child BodyNode frame report it
+  /// through mJacobianStructure, so that the articulated body routines can
+  /// skip the half of each spatial product that is known to vanish.
+  enum JacobianStructure
+  {
+    GENERAL_JACOBIAN = 0,
+    ANGULAR_JACOBIAN,
+    LINEAR_JACOBIAN
+  };
+
   UniqueProperties mSingleDofP;
 
   /// \brief DegreeOfFreedom pointer
   DegreeOfFreedom* mDof;
 
+  /// Own storage of the command, position, velocity, acceleration, and force
+  /// (in this order), which is used while this Joint is not bound to the state
+  /// arrays of a Skeleton
+  Eigen::Matrix<double, 1, 5> mStateStorage;
+
   /// Command
-  double mCommand;
+  double* mCommand;
 
   //----------------------------------------------------------------------------
   // Configuration
   //----------------------------------------------------------------------------
 
   /// Position
-  double mPosition;
+  double* mPosition;
 
   /// Derivatives w.r.t. an arbitrary scalr variable
   double mPositionDeriv;
@@ -676,7 +699,7 @@ protected:
   //----------------------------------------------------------------------------
 
   /// Generalized velocity
-  double mVelocity;
+  double* mVelocity;
 
   /// Derivatives w.r.t. an arbitrary scalr variable
   double mVelocityDeriv;
@@ -686,7 +709,7 @@ protected:
   //----------------------------------------------------------------------------
 
   /// Generalized acceleration
-  double mAcceleration;
+  double* mAcceleration;
 
   /// Derivatives w.r.t. an arbitrary scalr variable
   double mAccelerationDeriv;
@@ -696,7 +719,7 @@ protected:
   //----------------------------------------------------------------------------
 
   /// Generalized force
-  double mForce;
+  double* mForce;
 
   /// Derivatives w.r.t. an arbitrary scalr variable
   double mForceDeriv;
@@ -723,6 +746,10 @@ protected:
   /// Do not use directly! Use getLocalJacobianStatic() to access this quantity
   mutable Eigen::Vector6d mJacobian;
 
+  /// Parts of mJacobian that can be nonzero. Joints that set this must keep it
+  /// up to date whenever they compute mJacobian.
+  mutable JacobianStructure mJacobianStructure;
+
   /// Time derivative of spatial Jacobian expressed in the child body frame
   ///
   /// Do not use directly! Use getLocalJacobianTimeDerivStatic() to access this
@@ -762,6 +789,17 @@ private:
   /// \{ \name Recursive dynamics routines
   //----------------------------------------------------------------------------
 
+  /// Compute _artInertia * S, where S is the local Jacobian
+  Eigen::Vector6d computeArtInertiaJacobian(
+      const Eigen::Matrix6d& _artInertia) const;
+
+  /// Compute S^T * _artInertia * S, where S is the local Jacobian
+  double computeProjArtInertia(const Eigen::Matrix6d& _artInertia) const;
+
+  /// Compute S^T * _artInertia * _vec, where S is the local Jacobian
+  double projectArtInertia(const Eigen::Matrix6d& _artInertia,
+                           const Eigen::Vector6d& _vec) const;
+
   void addChildArtInertiaToDynamic(
       Eigen::Matrix6d& _parentArtInertia,
       const Eigen::Matrix6d& _childArtInertia);
@@ -42,6 +42,7 @@
 #include <string>
 #include <vector>
 
+#include "dart/config.h"
 #include "dart/common/Console.h"
 #include "dart/math/Geometry.h"
 #include "dart/math/Helpers.h"
@@ -65,6 +66,90 @@ namespace dynamics {
 
 #define ON_ALL_TREES( X ) for(size_t i=0; i < mTreeCache.size(); ++i) X (i);
 
+namespace {
+
+//==============================================================================
+/// Factorize _H = L^T * D * L in place, where _parents is the parent DOF index
+/// of each DOF. This is the sparse factorization in Featherstone's "Rigid Body
+/// Dynamics Algorithms", which only touches the entries of the ancestor DOFs.
+void factorizeLTDL(Eigen::MatrixXd& _H, const std::vector<int>& _parents)
+{
+  for (int k = static_cast<int>(_parents.size()) - 1; k >= 0; --k)
+  {
+    for (int i = _parents[k]; i >= 0; i = _parents[i])
+    {
+      const double a = _H(k, i) / _H(k, k);
+
+      for (int j = i; j >= 0; j = _parents[j])
+        _H(i, j) -= a * _H(k, j);
+
+      _H(k, i) = a;
+    }
+  }
+}
+
+//==============================================================================
+/// Overwrite _x with (L^T * D * L)^{-1} * _x for the DOFs in _dofs, where _LD
+/// is the factorization of factorizeLTDL()
+void solveLTDL(const Eigen::MatrixXd& _LD, const std::vector<int>& _parents,
+               const std::vector<DegreeOfFreedom*>& _dofs,
+               Eigen::Ref<Eigen::VectorXd> _x)
+{
+  const int dof = static_cast<int>(_dofs.size());
+
+  // x = L^{-T} * x
+  for (int i = dof - 1; i >= 0; --i)
+  {
+    const double xi = _x[_dofs[i]->getIndexInSkeleton()];
+    for (int j = _parents[i]; j >= 0; j = _parents[j])
+      _x[_dofs[j]->getIndexInSkeleton()] -= _LD(i, j) * xi;
+  }
+
+  // x = D^{-1} * x
+  for (int i = 0; i < dof; ++i)
+    _x[_dofs[i]->getIndexInSkeleton()] /= _LD(i, i);
+
+  // x = L^{-1} * x
+  for (int i = 0; i < dof; ++i)
+  {
+    double& xi = _x[_dofs[i]->getIndexInSkeleton()];
+    for (int j = _parents[i]; j >= 0; j = _parents[j])
+      xi -= _LD(i, j) * _x[_dofs[j]->getIndexInSkeleton()];
+  }
+}
+
+//==============================================================================
+/// Overwrite _x with (L^T * D * L) * _x for the DOFs in _dofs, where _LD is the
+/// factorization of factorizeLTDL()
+void multiplyLTDL(const Eigen::MatrixXd& _LD, const std::vector<int>& _parents,
+                  const std::vector<DegreeOfFreedom*>& _dofs,
+                  Eigen::VectorXd& _x)
+{
+  const int dof = static_cast<int>(_dofs.size());
+
+  // x = L * x
+  for (int i = dof - 1; i >= 0; --i)
+  {
+    double& xi = _x[_dofs[i]->getIndexInSkeleton()];
+    for (int j = _parents[i]; j >= 0; j = _parents[j])
+      xi += _LD(i, j) * _x[_dofs[j]->getIndexInSkeleton()];
+  }
+
+  // x = D * x
+  for (int i = 0; i < dof; ++i)
+    _x[_dofs[i]->getIndexInSkeleton()] *= _LD(i, i);
+
+  // x = L^T * x
+  for (int i = 0; i < dof; ++i)
+  {
+    const double xi = _x[_dofs[i]->getIndexInSkeleton()];
+    for (int j = _parents[i]; j >= 0; j = _parents[j])
+      _x[_dofs[j]->getIndexInSkeleton()] += _LD(i, j) * xi;
+  }
+}
+
+}  // anonymous namespace
+
 //==============================================================================
 Skeleton::Properties::Properties(
     const std::string& _name,
@@ -743,24 +828,31 @@ const Marker* Skeleton::getMarker(const std::string& _name) const
 //==============================================================================
 void Skeleton::setState(const Eigen::VectorXd& _state)
 {
-  assert(_state.size() % 2 == 0);
+  const size_t numDofs = getNumDofs();
+  assert(static_cast<size_t>(_state.size()) == 2 * numDofs);
 
-  size_t index = 0;
-  size_t halfSize = _state.size() / 2;
-  Joint* joint;
+  updateStateArrays();
 
-  for (size_t i = 0; i < mSkelCache.mBodyNodes.size(); ++i)
+  for (DegreeOfFreedom* dof : mSkelCache.mDofs)
   {
-    joint = mSkelCache.mBodyNodes[i]->getParentJoint();
+    if (dof->getIndexInJoint() != 0)
+      continue;
 
-    const size_t dof = joint->getNumDofs();
+    Joint* joint = dof->getJoint();
+    const size_t index = dof->getIndexInSkeleton();
+    const size_t size = joint->getNumDofs();
 
-    if (dof)
+    if (mPositions.segment(index, size) != _state.segment(index, size))
     {
-      joint->setPositions(_state.segment(index, dof));
-      joint->setVelocities(_state.segment(index + halfSize, dof));
+      mPositions.segment(index, size) = _state.segment(index, size);
+      joint->notifyPositionUpdate();
+    }
 
-      index += dof;
+    if (mVelocities.segment(index, size)
+        != _state.segment(numDofs + index, size))
+    {
+      mVelocities.segment(index, size) = _state.segment(numDofs + index, size);
+      joint->notifyVelocityUpdate();
     }
   }
 }
@@ -768,9 +860,11 @@ void Skeleton::setState(const Eigen::VectorXd& _state)
 //==============================================================================
 Eigen::VectorXd Skeleton::getState() const
 {
+  updateStateArrays();
+
   Eigen::VectorXd state(2 * getNumDofs());
 
-  state << getPositions(), getVelocities();
+  state << mPositions, mVelocities;
 
   return state;
 }
@@ -778,8 +872,23 @@ Eigen::VectorXd Skeleton::getState() const
 //==============================================================================
 void Skeleton::integratePositions(double _dt)
 {
-  for (size_t i = 0; i < mSkelCache.mBodyNodes.size(); ++i)
-    mSkelCache.mBodyNodes[i]->getParentJoint()->integratePositions(_dt);
+  updateStateArrays();
+
+  for (const auto& range : mEuclideanDofRanges)
+  {
+    mPositions.segment(range.first, range.second).noalias()
+        += _dt * mVelocities.segment(range.first, range.second);
+  }
+
+  for (Joint* joint : mEuclideanJoints)
+  {
+    const size_t index = joint->getIndexInSkeleton(0);
+    if (!mVelocities.segment(index, joint->getNumDofs()).isZero(0.0))
+      joint->notifyPositionUpdate();
+  }
+
+  for (Joint* joint : mNonEuclideanJoints)
+    joint->integratePositions(_dt);
 
   for (size_t i = 0; i < mSoftBodyNodes.size(); ++i)
   {
@@ -791,8 +900,20 @@ void Skeleton::integratePositions(double _dt)
 //==============================================================================
 void Skeleton::integrateVelocities(double _dt)
 {
-  for (size_t i = 0; i < mSkelCache.mBodyNodes.size(); ++i)
-    mSkelCache.mBodyNodes[i]->getParentJoint()->integrateVelocities(_dt);
+  updateStateArrays();
+
+  mVelocities.noalias() += _dt * mAccelerations;
+
+  for (DegreeOfFreedom* dof : mSkelCache.mDofs)
+  {
+    if (dof->getIndexInJoint() != 0)
+      continue;
+
+    Joint* joint = dof->getJoint();
+    const size_t index = dof->getIndexInSkeleton();
+    if (!mAccelerations.segment(index, joint->getNumDofs()).isZero(0.0))
+      joint->notifyVelocityUpdate();
+  }
 
   for (size_t i = 0; i < mSoftBodyNodes.size(); ++i)
   {
@@ -1266,6 +1387,86 @@ const Eigen::MatrixXd& Skeleton::getInvAugMassMatrix() const
   return mSkelCache.mInvAugM;
 }
 
+//==============================================================================
+Eigen::VectorXd Skeleton::solveMassMatrix(const Eigen::VectorXd& _b) const
+{
+  assert(static_cast<size_t>(_b.size()) == getNumDofs());
+
+  Eigen::VectorXd x = _b;
+  solveMassMatrixInPlace(x);
+
+  return x;
+}
+
+//==============================================================================
+void Skeleton::solveMassMatrixInPlace(Eigen::Ref<Eigen::VectorXd> _x) const
+{
+  assert(static_cast<size_t>(_x.size()) == getNumDofs());
+
+  for (size_t tree = 0; tree < mTreeCache.size(); ++tree)
+  {
+    const DataCache& cache = mTreeCache[tree];
+    if (cache.mDirty.mMassMatrixFactor)
+      updateMassMatrixFactor(tree);
+
+    solveLTDL(cache.mMFactor, cache.mParentDofs, cache.mDofs, _x);
+  }
+}
+
+//==============================================================================
+Eigen::VectorXd Skeleton::solveInvMassMatrix(const Eigen::VectorXd& _b) const
+{
+  assert(static_cast<size_t>(_b.size()) == getNumDofs());
+
+  Eigen::VectorXd x = _b;
+  for (size_t tree = 0; tree < mTreeCache.size(); ++tree)
+  {
+    const DataCache& cache = mTreeCache[tree];
+    if (cache.mDirty.mMassMatrixFactor)
+      updateMassMatrixFactor(tree);
+
+    multiplyLTDL(cache.mMFactor, cache.mParentDofs, cache.mDofs, x);
+  }
+
+  return x;
+}
+
+//==============================================================================
+Eigen::VectorXd Skeleton::solveAugMassMatrix(const Eigen::VectorXd& _b) const
+{
+  assert(static_cast<size_t>(_b.size()) == getNumDofs());
+
+  Eigen::VectorXd x = _b;
+  for (size_t tree = 0; tree < mTreeCache.size(); ++tree)
+  {
+    const DataCache& cache = mTreeCache[tree];
+    if (cache.mDirty.mAugMassMatrixFactor)
+      updateAugMassMatrixFactor(tree);
+
+    solveLTDL(cache.mAugMFactor, cache.mParentDofs, cache.mDofs, x);
+  }
+
+  return x;
+}
+
+//==============================================================================
+Eigen::VectorXd Skeleton::solveInvAugMassMatrix(const Eigen::VectorXd& _b) const
+{
+  assert(static_cast<size_t>(_b.size()) == getNumDofs());
+
+  Eigen::VectorXd x = _b;
+  for (size_t tree = 0; tree < mTreeCache.size(); ++tree)
+  {
+    const DataCache& cache = mTreeCache[tree];
+    if (cache.mDirty.mAugMassMatrixFactor)
+      updateAugMassMatrixFactor(tree);
+
+    multiplyLTDL(cache.mAugMFactor, cache.mParentDofs, cache.mDofs, x);
+  }
+
+  return x;
+}
+
 //==============================================================================
 const Eigen::VectorXd& Skeleton::getCoriolisForces(size_t _treeIdx) const
 {
@@ -1377,7 +1578,9 @@ void Skeleton::drawMarkers(renderer::RenderInterface* _ri,
 Skeleton::Skeleton(const Properties& _properties)
   : mSkeletonP(""),
     mTotalMass(0.0),
+    mIsStateArraysDirty(false),
     mIsImpulseApplied(false),
+    mIsSleeping(false),
     mUnionSize(1)
 {
   setProperties(_properties);
@@ -1515,6 +1718,9 @@ void Skeleton::registerJoint(Joint* _newJoint)
     treeDofs.push_back(_newJoint->getDof(i));
     _newJoint->getDof(i)->mIndexInTree = treeDofs.size()-1;
   }
+
+  if(_newJoint->getNumDofs() > 0)
+    mIsStateArraysDirty = true;
 }
 
 //==============================================================================
@@ -1635,6 +1841,11 @@ void Skeleton::unregisterJoint(Joint* _oldJoint)
 
   mNameMgrForJoints.removeName(_oldJoint->getName());
 
+  // Move the values of the Joint back into its own storage before the state
+  // arrays of this Skeleton are reallocated. The remaining Joints keep their
+  // segments of the old arrays until then.
+  _oldJoint->bindState(nullptr, nullptr, nullptr, nullptr, nullptr);
+
   size_t tree = _oldJoint->getChildBodyNode()->getTreeIndex();
   std::vector<DegreeOfFreedom*>& treeDofs = mTreeCache[tree].mDofs;
   std::vector<DegreeOfFreedom*>& skelDofs = mSkelCache.mDofs;
@@ -1666,6 +1877,9 @@ void Skeleton::unregisterJoint(Joint* _oldJoint)
     DegreeOfFreedom* dof = treeDofs[i];
     dof->mIndexInTree = i;
   }
+
+  if(_oldJoint->getNumDofs() > 0)
+    mIsStateArraysDirty = true;
 }
 
 //==============================================================================
@@ -1905,6 +2119,8 @@ void Skeleton::updateCacheDimensions(Skeleton::DataCache& _cache)
   _cache.mAugM     = Eigen::MatrixXd::Zero(dof, dof);
   _cache.mInvM     = Eigen::MatrixXd::Zero(dof, dof);
   _cache.mInvAugM  = Eigen::MatrixXd::Zero(dof, dof);
+  _cache.mMFactor  = Eigen::MatrixXd::Zero(dof, dof);
+  _cache.mAugMFactor = Eigen::MatrixXd::Zero(dof, dof);
   _cache.mCvec     = Eigen::VectorXd::Zero(dof);
   _cache.mG        = Eigen::VectorXd::Zero(dof);
   _cache.mCg       = Eigen::VectorXd::Zero(dof);
@@ -1921,6 +2137,308 @@ void Skeleton::updateCacheDimensions(size_t _treeIdx)
   notifyArticulatedInertiaUpdate(_treeIdx);
 }
 
+//==============================================================================
+void Skeleton::updateStateArrays() const
+{
+  if(!mIsStateArraysDirty)
+    return;
+
+  const size_t numDofs = getNumDofs();
+  Eigen::VectorXd commands(numDofs);
+  Eigen::VectorXd positions(numDofs);
+  Eigen::VectorXd velocities(numDofs);
+  Eigen::VectorXd accelerations(numDofs);
+  Eigen::VectorXd forces(numDofs);
+
+  mEuclideanDofRanges.clear();
+  mEuclideanJoints.clear();
+  mNonEuclideanJoints.clear();
+
+  // The Joints copy their current values out of the old arrays while binding,
+  // so the old arrays must stay alive until every Joint has been rebound
+  for(DegreeOfFreedom* dof : mSkelCache.mDofs)
+  {
+    if(dof->getIndexInJoint() != 0)
+      continue;
+
+    Joint* joint = dof->getJoint();
+    const size_t index = dof->getIndexInSkeleton();
+    const size_t size = joint->getNumDofs();
+
+    joint->bindState(commands.data() + index, positions.data() + index,
+                     velocities.data() + index, accelerations.data() + index,
+                     forces.data() + index);
+
+    if(!joint->hasEuclideanPositions())
+    {
+      mNonEuclideanJoints.push_back(joint);
+      continue;
+    }
+
+    mEuclideanJoints.push_back(joint);
+    if(!mEuclideanDofRanges.empty()
+       && mEuclideanDofRanges.back().first
+          + mEuclideanDofRanges.back().second == index)
+      mEuclideanDofRanges.back().second += size;
+    else
+      mEuclideanDofRanges.push_back(std::make_pair(index, size));
+  }
+
+  mCommands.swap(commands);
+  mPositions.swap(positions);
+  mVelocities.swap(velocities);
+  mAccelerations.swap(accelerations);
+  mForces.swap(forces);
+
+  mIsStateArraysDirty = false;
+}
+
+//==============================================================================
+void Skeleton::setDofValues(MetaSkeleton* _skel, BatchQuantity _quantity,
+                            const std::vector<size_t>* _indices,
+                            const Eigen::VectorXd& _values,
+                            const std::string& _fname)
+{
+  // The Skeleton is only looked up again when the Joint changes, which
+  // happens at most once per Joint for the usual DOF orderings
+  Joint* joint = nullptr;
+  SkeletonPtr skel;
+  Eigen::VectorXd* array = nullptr;
+  std::vector<SkeletonPtr> others;
+
+  for(size_t i=0; i < static_cast<size_t>(_values.size()); ++i)
+  {
+    const size_t index = _indices? (*_indices)[i] : i;
+    DegreeOfFreedom* dof = _skel->getDof(index);
+    if(nullptr == dof)
+    {
+      dterr << "[MetaSkeleton::" << _fname << "] DegreeOfFreedom #" << index
+            << " in the MetaSkeleton named [" << _skel->getName() << "] ("
+            << _skel << ") has expired! ReferentialSkeletons should call "
+            << "update() after structural changes have been made to the "
+            << "BodyNodes they refer to. Nothing will be set for this specific "
+            << "DegreeOfFreedom.\n";
+      assert(false);
+      continue;
+    }
+
+    if(dof->getJoint() != joint)
+    {
+      joint = dof->getJoint();
+      SkeletonPtr owner = joint->getSkeleton();
+      if(owner != skel)
+      {
+        if(skel && std::find(others.begin(), others.end(), skel) == others.end())
+          others.push_back(skel);
+
+        skel = owner;
+        array = &skel->getStateArray(_quantity);
+        if(skel->mBatchMarks.size() != skel->mSkelCache.mBodyNodes.size())
+          skel->mBatchMarks.assign(skel->mSkelCache.mBodyNodes.size(), 0);
+      }
+    }
+
+    const size_t indexInSkel = dof->getIndexInSkeleton();
+    double& value = (*array)[indexInSkel];
+
+    if(BATCH_FORCES == _quantity)
+    {
+      // Generalized forces do not invalidate anything
+      value = _values[i];
+#if DART_MAJOR_MINOR_VERSION_AT_MOST(5,1)
+      if(Joint::FORCE == joint->getActuatorType())
+        skel->mCommands[indexInSkel] = value;
+      // TODO: Remove at DART 5.1.
+#endif
+      continue;
+    }
+
+    if(value == _values[i])
+      continue;
+
+    value = _values[i];
+
+#if DART_MAJOR_MINOR_VERSION_AT_MOST(5,1)
+    const Joint::ActuatorType actuatorType = joint->getActuatorType();
+    if( (BATCH_VELOCITIES == _quantity && Joint::VELOCITY == actuatorType)
+        || (BATCH_ACCELERATIONS == _quantity
+            && Joint::ACCELERATION == actuatorType) )
+      skel->mCommands[indexInSkel] = value;
+    // TODO: Remove at DART 5.1.
+#endif
+
+    char& mark = skel->mBatchMarks[joint->getJointIndexInSkeleton()];
+    if(!mark)
+    {
+      mark = 1;
+      skel->mBatchedJoints.push_back(joint);
+    }
+  }
+
+  if(skel)
+    skel->notifyBatchedJoints(_quantity);
+
+  for(const SkeletonPtr& other : others)
+    other->notifyBatchedJoints(_quantity);
+}
+
+//==============================================================================
+Eigen::VectorXd Skeleton::getDofValues(const MetaSkeleton* _skel,
+                                       BatchQuantity _quantity,
+                                       const std::vector<size_t>* _indices,
+                                       const std::string& _fname)
+{
+  const size_t numDofs = _skel->getNumDofs();
+  const size_t size = _indices? _indices->size() : numDofs;
+
+  if(nullptr == _indices && numDofs > 0)
+  {
+    // A Skeleton can hand out its whole state array at once
+    const DegreeOfFreedom* dof = _skel->getDof(0);
+    if(dof)
+    {
+      ConstSkeletonPtr owner = dof->getSkeleton();
+      if(owner.get() == _skel)
+        return owner->getStateArray(_quantity);
+    }
+  }
+
+  Eigen::VectorXd values(size);
+
+  const Joint* joint = nullptr;
+  ConstSkeletonPtr skel;
+  const Eigen::VectorXd* array = nullptr;
+
+  for(size_t i=0; i < size; ++i)
+  {
+    const size_t index = _indices? (*_indices)[i] : i;
+    const DegreeOfFreedom* dof = _skel->getDof(index);
+    if(nullptr == dof)
+    {
+      values[i] = 0.0;
+      if(index < numDofs)
+      {
+        dterr << "[MetaSkeleton::" << _fname << "] Requesting value for "
+              << "DegreeOfFreedom #" << index << " (" << "entry #" << i
+              << "), but this index has expired! ReferentialSkeletons should "
+              << "call update() after structural changes have been made to "
+              << "the BodyNodes they refer to. The return value for this "
+              << "entry will be zero.\n";
+      }
+      else
+      {
+        dterr << "[MetaSkeleton::" << _fname << "] Requesting out of bounds "
+              << "DegreeOfFreedom #" << index << " (entry #" << i
+              << ") for MetaSkeleton named [" << _skel->getName() << "] ("
+              << _skel << "). The max index is (" << numDofs << "). The "
+              << "return value for this entry will be zero.\n";
+      }
+      assert(false);
+      continue;
+    }
+
+    if(dof->getJoint() != joint)
+    {
+      joint = dof->getJoint();
+      ConstSkeletonPtr owner = joint->getSkeleton();
+      if(owner != skel)
+      {
+        skel = owner;
+        array = &skel->getStateArray(_quantity);
+      }
+    }
+
+    values[i] = (*array)[dof->getIndexInSkeleton()];
+  }
+
+  return values;
+}
+
+//==============================================================================
+Eigen::VectorXd& Skeleton::getStateArray(BatchQuantity _quantity)
+{
+  return const_cast<Eigen::VectorXd&>(
+        static_cast<const Skeleton*>(this)->getStateArray(_quantity));
+}
+
+//==============================================================================
+const Eigen::VectorXd& Skeleton::getStateArray(BatchQuantity _quantity) const
+{
+  updateStateArrays();
+
+  switch(_quantity)
+  {
+    case BATCH_POSITIONS:
+      return mPositions;
+    case BATCH_VELOCITIES:
+      return mVelocities;
+    case BATCH_ACCELERATIONS:
+      return mAccelerations;
+    case BATCH_FORCES:
+      return mForces;
+  }
+
+  assert(false);
+  return mPositions;
+}
+
+//==============================================================================
+void Skeleton::notifyBatchedJoints(BatchQuantity _quantity)
+{
+  if(mBatchedJoints.empty())
+    return;
+
+  std::sort(mBatchedJoints.begin(), mBatchedJoints.end(),
+            [](const Joint* _a, const Joint* _b)
+  { return _a->getJointIndexInSkeleton() < _b->getJointIndexInSkeleton(); });
+
+  // A BodyNode always comes after its parent in mSkelCache.mBodyNodes, so a
+  // single forward sweep marks every BodyNode that descends from a batched
+  // Joint. Those subtrees get notified once by the topmost batched Joint.
+  const size_t first = mBatchedJoints.front()->getJointIndexInSkeleton();
+  const size_t last = mBatchedJoints.back()->getJointIndexInSkeleton();
+  for(size_t i = first + 1; i <= last; ++i)
+  {
+    const BodyNode* parent = mSkelCache.mBodyNodes[i]->getParentBodyNode();
+    if(parent && mBatchMarks[parent->getIndexInSkeleton()])
+      mBatchMarks[i] = 1;
+  }
+
+  for(Joint* joint : mBatchedJoints)
+  {
+    const BodyNode* parent = joint->getChildBodyNode()->getParentBodyNode();
+    const bool isSubtreeNotified =
+        parent && mBatchMarks[parent->getIndexInSkeleton()];
+
+    switch(_quantity)
+    {
+      case BATCH_POSITIONS:
+        if(isSubtreeNotified)
+          joint->notifyLocalPositionUpdate();
+        else
+          joint->notifyPositionUpdate();
+        break;
+      case BATCH_VELOCITIES:
+        if(isSubtreeNotified)
+          joint->notifyLocalVelocityUpdate();
+        else
+          joint->notifyVelocityUpdate();
+        break;
+      case BATCH_ACCELERATIONS:
+        if(isSubtreeNotified)
+          joint->notifyLocalAccelerationUpdate();
+        else
+          joint->notifyAccelerationUpdate();
+        break;
+      case BATCH_FORCES:
+        break;
+    }
+  }
+
+  std::fill(mBatchMarks.begin() + first, mBatchMarks.begin() + last + 1, 0);
+  mBatchedJoints.clear();
+}
+
 //==============================================================================
 void Skeleton::updateArticulatedInertia(size_t _tree) const
 {
@@ -1960,50 +2478,24 @@ void Skeleton::updateMassMatrix(size_t _treeIdx) const
     return;
   }
 
+  // The blocks of DOFs that are not in the same branch stay zero
   cache.mM.setZero();
 
-  // Backup the original internal force
-  Eigen::VectorXd originalGenAcceleration = getAccelerations();
-
-  // Clear out the accelerations of the dofs in this tree so that we can set
-  // them to 1.0 one at a time to build up the mass matrix
-  for (size_t i = 0; i < dof; ++i)
-    cache.mDofs[i]->setAcceleration(0.0);
-
-  for (size_t j = 0; j < dof; ++j)
+  // Composite rigid body algorithm: accumulate the composite rigid body
+  // inertias from the leaves to the root
+  for (std::vector<BodyNode*>::const_reverse_iterator it =
+       cache.mBodyNodes.rbegin(); it != cache.mBodyNodes.rend(); ++it)
   {
-    // Set the acceleration of this DOF to 1.0 while all the rest are 0.0
-    cache.mDofs[j]->setAcceleration(1.0);
-
-    // Prepare cache data
-    for (std::vector<BodyNode*>::const_iterator it = cache.mBodyNodes.begin();
-         it != cache.mBodyNodes.end(); ++it)
-    {
-      (*it)->updateMassMatrix();
-    }
-
-    // Mass matrix
-    for (std::vector<BodyNode*>::const_reverse_iterator it =
-         cache.mBodyNodes.rbegin(); it != cache.mBodyNodes.rend(); ++it)
-    {
-      (*it)->aggregateMassMatrix(cache.mM, j);
-      size_t localDof = (*it)->mParentJoint->getNumDofs();
-      if (localDof > 0)
-      {
-        size_t iStart = (*it)->mParentJoint->getIndexInTree(0);
-
-        if (iStart + localDof < j)
-          break;
-      }
-    }
-
-    // Set the acceleration of this DOF back to 0.0
-    cache.mDofs[j]->setAcceleration(0.0);
+    (*it)->updateCompositeInertia();
   }
-  cache.mM.triangularView<Eigen::StrictlyUpper>() = cache.mM.transpose();
 
-  // Restore the original generalized accelerations
-  const_cast<Skeleton*>(this)->setAccelerations(originalGenAcceleration);
+  // and fill the blocks of the mass matrix by propagating the forces of each
+  // joint up to the root
+  for (std::vector<BodyNode*>::const_iterator it = cache.mBodyNodes.begin();
+       it != cache.mBodyNodes.end(); ++it)
+  {
+    (*it)->aggregateCompositeMassMatrix(cache.mM);
+  }
 
   cache.mDirty.mMassMatrix = false;
 }
@@ -2150,6 +2642,9 @@ void Skeleton::updateInvMassMatrix(size_t _treeIdx) const
     return;
   }
 
+  if(cache.mDirty.mArticulatedInertia)
+    updateArticulatedInertia(_treeIdx);
+
   // We don't need to set mInvM as zero matrix as long as the below is correct
   // cache.mInvM.setZero();
 
@@ -2246,6 +2741,9 @@ void Skeleton::updateInvAugMassMatrix(size_t _treeIdx) const
     return;
   }
 
+  if(cache.mDirty.mArticulatedInertia)
+    updateArticulatedInertia(_treeIdx);
+
   // We don't need to set mInvM as zero matrix as long as the below is correct
   // mInvM.setZero();
 
@@ -2330,6 +2828,71 @@ void Skeleton::updateInvAugMassMatrix() const
   mSkelCache.mDirty.mInvAugMassMatrix = false;
 }
 
+//==============================================================================
+void Skeleton::updateParentDofs(size_t _treeIdx) const
+{
+  DataCache& cache = mTreeCache[_treeIdx];
+  cache.mParentDofs.resize(cache.mDofs.size());
+
+  for (const auto& bodyNode : cache.mBodyNodes)
+  {
+    const Joint* joint = bodyNode->getParentJoint();
+    const size_t dof = joint->getNumDofs();
+    if (dof == 0)
+      continue;
+
+    // Find the closest ancestor joint that has DOFs
+    const BodyNode* parent = bodyNode->getParentBodyNode();
+    while (parent && parent->getParentJoint()->getNumDofs() == 0)
+      parent = parent->getParentBodyNode();
+
+    const size_t iStart = joint->getIndexInTree(0);
+    if (parent)
+    {
+      const Joint* parentJoint = parent->getParentJoint();
+      cache.mParentDofs[iStart] = static_cast<int>(
+            parentJoint->getIndexInTree(parentJoint->getNumDofs() - 1));
+    }
+    else
+    {
+      cache.mParentDofs[iStart] = -1;
+    }
+
+    // The DOFs of a joint are chained one after another
+    for (size_t i = 1; i < dof; ++i)
+      cache.mParentDofs[iStart + i] = static_cast<int>(iStart + i - 1);
+  }
+
+#ifndef NDEBUG
+  for (size_t i = 0; i < cache.mParentDofs.size(); ++i)
+    assert(cache.mParentDofs[i] < static_cast<int>(i));
+#endif
+}
+
+//==============================================================================
+void Skeleton::updateMassMatrixFactor(size_t _treeIdx) const
+{
+  DataCache& cache = mTreeCache[_treeIdx];
+
+  updateParentDofs(_treeIdx);
+  cache.mMFactor = getMassMatrix(_treeIdx);
+  factorizeLTDL(cache.mMFactor, cache.mParentDofs);
+
+  cache.mDirty.mMassMatrixFactor = false;
+}
+
+//==============================================================================
+void Skeleton::updateAugMassMatrixFactor(size_t _treeIdx) const
+{
+  DataCache& cache = mTreeCache[_treeIdx];
+
+  updateParentDofs(_treeIdx);
+  cache.mAugMFactor = getAugMassMatrix(_treeIdx);
+  factorizeLTDL(cache.mAugMFactor, cache.mParentDofs);
+
+  cache.mDirty.mAugMassMatrixFactor = false;
+}
+
 //==============================================================================
 void Skeleton::updateCoriolisForces(size_t _treeIdx) const
 {
@@ -2800,8 +3363,9 @@ void Skeleton::computeForwardKinematics(bool _updateTransforms,
 //==============================================================================
 void Skeleton::computeForwardDynamics()
 {
-  // Note: Articulated Inertias will be updated automatically when
-  // getArtInertiaImplicit() is called in BodyNode::updateBiasForce()
+  // Bring the articulated inertias up to date once so that the recursions
+  // below can read them without checking the dirty flags of each BodyNode
+  updateArticulatedInertia();
 
   for (auto it = mSkelCache.mBodyNodes.rbegin();
        it != mSkelCache.mBodyNodes.rend(); ++it)
@@ -2858,6 +3422,8 @@ void Skeleton::notifyArticulatedInertiaUpdate(size_t _treeIdx)
   SET_FLAG(_treeIdx, mAugMassMatrix);
   SET_FLAG(_treeIdx, mInvMassMatrix);
   SET_FLAG(_treeIdx, mInvAugMassMatrix);
+  SET_FLAG(_treeIdx, mMassMatrixFactor);
+  SET_FLAG(_treeIdx, mAugMassMatrixFactor);
   SET_FLAG(_treeIdx, mCoriolisForces);
   SET_FLAG(_treeIdx, mGravityForces);
   SET_FLAG(_treeIdx, mCoriolisAndGravityForces);
@@ -2897,6 +3463,9 @@ void Skeleton::updateBiasImpulse(BodyNode* _bodyNode)
     assert(mSkelCache.mBodyNodes[i]->mConstraintImpulse == Eigen::Vector6d::Zero());
 #endif
 
+  // The recursion below reads the articulated inertias directly
+  updateArticulatedInertia();
+
   // Prepare cache data
   BodyNode* it = _bodyNode;
   while (it != nullptr)
@@ -2931,6 +3500,9 @@ void Skeleton::updateBiasImpulse(BodyNode* _bodyNode,
   // Set impulse of _bodyNode
   _bodyNode->mConstraintImpulse = _imp;
 
+  // The recursion below reads the articulated inertias directly
+  updateArticulatedInertia();
+
   // Prepare cache data
   BodyNode* it = _bodyNode;
   while (it != nullptr)
@@ -2986,6 +3558,9 @@ void Skeleton::updateBiasImpulse(BodyNode* _bodyNode1,
 
   size_t index = std::max(index1, index2);
 
+  // The recursion below reads the articulated inertias directly
+  updateArticulatedInertia();
+
   // Prepare cache data
   for (int i = index; 0 <= i; --i)
     mSkelCache.mBodyNodes[i]->updateBiasImpulse();
@@ -3018,6 +3593,9 @@ void Skeleton::updateBiasImpulse(SoftBodyNode* _softBodyNode,
   Eigen::Vector3d oldConstraintImpulse =_pointMass->getConstraintImpulses();
   _pointMass->setConstraintImpulse(_imp, true);
 
+  // The recursion below reads the articulated inertias directly
+  updateArticulatedInertia();
+
   // Prepare cache data
   BodyNode* it = _softBodyNode;
   while (it != nullptr)
@@ -3033,6 +3611,8 @@ void Skeleton::updateBiasImpulse(SoftBodyNode* _softBodyNode,
 //==============================================================================
 void Skeleton::updateVelocityChange()
 {
+  updateArticulatedInertia();
+
   for (auto& bodyNode : mSkelCache.mBodyNodes)
     bodyNode->updateVelocityChangeFD();
 }
@@ -3049,6 +3629,18 @@ bool Skeleton::isImpulseApplied() const
   return mIsImpulseApplied;
 }
 
+//==============================================================================
+void Skeleton::setSleeping(bool _isSleeping)
+{
+  mIsSleeping = _isSleeping;
+}
+
+//==============================================================================
+bool Skeleton::isSleeping() const
+{
+  return mIsSleeping;
+}
+
 //==============================================================================
 void Skeleton::computeImpulseForwardDynamics()
 {
@@ -3056,9 +3648,9 @@ void Skeleton::computeImpulseForwardDynamics()
   if (!isMobile() || getNumDofs() == 0)
     return;
 
-  // Note: we do not need to update articulated inertias here, because they will
-  // be updated when BodyNode::updateBiasImpulse() calls
-  // BodyNode::getArticulatedInertia()
+  // Bring the articulated inertias up to date once so that the recursions
+  // below can read them without checking the dirty flags of each BodyNode
+  updateArticulatedInertia();
 
   // Backward recursion
   for (auto it = mSkelCache.mBodyNodes.rbegin();
@@ -3258,6 +3850,8 @@ Skeleton::DirtyFlags::DirtyFlags()
     mAugMassMatrix(true),
     mInvMassMatrix(true),
     mInvAugMassMatrix(true),
+    mMassMatrixFactor(true),
+    mAugMassMatrixFactor(true),
     mGravityForces(true),
     mCoriolisForces(true),
     mCoriolisAndGravityForces(true),
@@ -551,6 +551,14 @@ public:
   /// Get whether this skeleton is constrained
   bool isImpulseApplied() const;
 
+  /// Set whether this skeleton is sleeping. World doesn't simulate sleeping
+  /// skeletons, and they are not checked for collision with each other or
+  /// with immobile skeletons.
+  void setSleeping(bool _isSleeping);
+
+  /// Get whether this skeleton is sleeping
+  bool isSleeping() const;
+
   /// Compute impulse-based forward dynamics
   void computeImpulseForwardDynamics();
 
@@ -688,6 +696,27 @@ public:
   // Documentation inherited
   const Eigen::MatrixXd& getInvAugMassMatrix() const override;
 
+  /// Return M^{-1} * _b, that is, the solution x of M * x = _b, where M is the
+  /// mass matrix. This uses the sparse L^T * D * L factorization of M along
+  /// the kinematic tree instead of forming the dense inverse.
+  Eigen::VectorXd solveMassMatrix(const Eigen::VectorXd& _b) const;
+
+  /// Overwrite _x with M^{-1} * _x like solveMassMatrix(), but without
+  /// allocating the result
+  void solveMassMatrixInPlace(Eigen::Ref<Eigen::VectorXd> _x) const;
+
+  /// Return M * _b, that is, the solution x of M^{-1} * x = _b, using the
+  /// sparse L^T * D * L factorization of the mass matrix M.
+  Eigen::VectorXd solveInvMassMatrix(const Eigen::VectorXd& _b) const;
+
+  /// Return the solution x of M_aug * x = _b, where M_aug is the augmented
+  /// mass matrix, using its sparse L^T * D * L factorization.
+  Eigen::VectorXd solveAugMassMatrix(const Eigen::VectorXd& _b) const;
+
+  /// Return M_aug * _b using the sparse L^T * D * L factorization of the
+  /// augmented mass matrix M_aug.
+  Eigen::VectorXd solveInvAugMassMatrix(const Eigen::VectorXd& _b) const;
+
   /// Get the Coriolis force vector of a tree in this Skeleton
   const Eigen::VectorXd& getCoriolisForces(size_t _treeIdx) const;
 
@@ -828,10 +857,48 @@ public:
   template<size_t> friend class MultiDofJoint;
   friend class DegreeOfFreedom;
   friend class EndEffector;
+  friend class MetaSkeleton;
 
 protected:
   class DataCache;
 
+  /// Generalized quantities that MetaSkeleton reads and writes in batches
+  enum BatchQuantity
+  {
+    BATCH_POSITIONS = 0,
+    BATCH_VELOCITIES,
+    BATCH_ACCELERATIONS,
+    BATCH_FORCES
+  };
+
+  /// Set one generalized quantity for many DOFs of a MetaSkeleton at once. The
+  /// values are written straight into the state arrays of the Skeletons that
+  /// own the DOFs, and afterwards each Joint whose values changed is notified
+  /// once, with the kinematics of each affected subtree dirtied only once.
+  /// Every DOF of _skel is set in order if _indices is nullptr. The sizes must
+  /// already have been checked by the caller.
+  static void setDofValues(MetaSkeleton* _skel, BatchQuantity _quantity,
+                           const std::vector<size_t>* _indices,
+                           const Eigen::VectorXd& _values,
+                           const std::string& _fname);
+
+  /// Get one generalized quantity for many DOFs of a MetaSkeleton at once by
+  /// reading the state arrays of the Skeletons that own the DOFs. Every DOF of
+  /// _skel is read in order if _indices is nullptr.
+  static Eigen::VectorXd getDofValues(const MetaSkeleton* _skel,
+                                      BatchQuantity _quantity,
+                                      const std::vector<size_t>* _indices,
+                                      const std::string& _fname);
+
+  /// Return the state array that holds the given quantity
+  Eigen::VectorXd& getStateArray(BatchQuantity _quantity);
+
+  /// Return the state array that holds the given quantity
+  const Eigen::VectorXd& getStateArray(BatchQuantity _quantity) const;
+
+  /// Notify the Joints whose values were changed by setDofValues()
+  void notifyBatchedJoints(BatchQuantity _quantity);
+
   /// Constructor called by create()
   Skeleton(const Properties& _properties);
 
@@ -913,6 +980,13 @@ protected:
   /// Update the dimensions for a tree's cache
   void updateCacheDimensions(size_t _treeIdx);
 
+  /// Reallocate the contiguous state arrays if the DOFs of this Skeleton have
+  /// changed since they were last allocated, and bind every Joint to its
+  /// segment of the new arrays. The Joints keep working on their old storage
+  /// in between, so only the functions that access the arrays directly need
+  /// to call this.
+  void updateStateArrays() const;
+
   /// Update the articulated inertia of a tree
   void updateArticulatedInertia(size_t _tree) const;
 
@@ -942,6 +1016,16 @@ protected:
   /// Update inverse of augmented mass matrix of the skeleton.
   void updateInvAugMassMatrix() const;
 
+  /// Update the parent DOF indices of the DOFs in a tree
+  void updateParentDofs(size_t _treeIdx) const;
+
+  /// Update the L^T * D * L factorization of the mass matrix of a tree
+  void updateMassMatrixFactor(size_t _treeIdx) const;
+
+  /// Update the L^T * D * L factorization of the augmented mass matrix of a
+  /// tree
+  void updateAugMassMatrixFactor(size_t _treeIdx) const;
+
   /// Update Coriolis force vector for a tree in the Skeleton
   void updateCoriolisForces(size_t _treeIdx) const;
 
@@ -1049,6 +1133,12 @@ protected:
     /// Dirty flag for the inverse of augmented mass matrix.
     bool mInvAugMassMatrix;
 
+    /// Dirty flag for the factorization of the mass matrix.
+    bool mMassMatrixFactor;
+
+    /// Dirty flag for the factorization of the augmented mass matrix.
+    bool mAugMassMatrixFactor;
+
     /// Dirty flag for the gravity force vector.
     bool mGravityForces;
 
@@ -1100,6 +1190,19 @@ protected:
     /// Inverse of augmented mass matrix for the skeleton.
     Eigen::MatrixXd mInvAugM;
 
+    /// Index of the parent DOF of each DOF in the tree, which is the previous
+    /// DOF of the same joint or the last DOF of the closest ancestor joint
+    /// that has DOFs. -1 for the first DOF of the root joint.
+    std::vector<int> mParentDofs;
+
+    /// L^T * D * L factorization of the mass matrix. D is stored in the
+    /// diagonal and L in the strictly lower triangular part. Only the entries
+    /// of the DOFs in the same branch are used.
+    Eigen::MatrixXd mMFactor;
+
+    /// L^T * D * L factorization of the augmented mass matrix
+    Eigen::MatrixXd mAugMFactor;
+
     /// Coriolis vector for the skeleton which is C(q,dq)*dq.
     Eigen::VectorXd mCvec;
 
@@ -1144,10 +1247,53 @@ protected:
   /// Total mass.
   double mTotalMass;
 
+  /// Generalized commands of all the DOFs, ordered by their indices in this
+  /// Skeleton. This and the following state arrays are the actual storage of
+  /// the Joints' values, which the Joints view into.
+  mutable Eigen::VectorXd mCommands;
+
+  /// Generalized positions of all the DOFs
+  mutable Eigen::VectorXd mPositions;
+
+  /// Generalized velocities of all the DOFs
+  mutable Eigen::VectorXd mVelocities;
+
+  /// Generalized accelerations of all the DOFs
+  mutable Eigen::VectorXd mAccelerations;
+
+  /// Generalized forces of all the DOFs
+  mutable Eigen::VectorXd mForces;
+
+  /// True if Joints with DOFs have been registered or unregistered since the
+  /// state arrays were last allocated. Rebuilding the arrays once before they
+  /// are accessed keeps adding or removing many Joints linear in time.
+  mutable bool mIsStateArraysDirty;
+
+  /// Ranges (first index, number of DOFs) of consecutive DOFs whose positions
+  /// are integrated in a single pass by integratePositions()
+  mutable std::vector<std::pair<size_t, size_t>> mEuclideanDofRanges;
+
+  /// Joints whose positions lie in mEuclideanDofRanges
+  mutable std::vector<Joint*> mEuclideanJoints;
+
+  /// Joints with DOFs whose positions are integrated by the Joints themselves
+  mutable std::vector<Joint*> mNonEuclideanJoints;
+
+  /// Joints whose values were changed by setDofValues() and are waiting to be
+  /// notified
+  std::vector<Joint*> mBatchedJoints;
+
+  /// Scratch marks, one per BodyNode, used by setDofValues() and
+  /// notifyBatchedJoints(). They are all zero between batches.
+  std::vector<char> mBatchMarks;
+
   // TODO(JS): Better naming
   /// Flag for status of impulse testing.
   bool mIsImpulseApplied;
 
+  /// Whether this skeleton is sleeping
+  bool mIsSleeping;
+
   mutable std::mutex mMutex;
 
 public:
@@ -575,6 +575,14 @@ void ZeroDofJoint::registerDofs()
   // Do nothing
 }
 
+//==============================================================================
+void ZeroDofJoint::bindState(double* /*_commands*/, double* /*_positions*/,
+                             double* /*_velocities*/,
+                             double* /*_accelerations*/, double* /*_forces*/)
+{
+  // Do nothing
+}
+
 //==============================================================================
 void ZeroDofJoint::updateDegreeOfFreedomNames()
 {
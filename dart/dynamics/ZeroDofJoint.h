@@ -358,6 +358,10 @@ protected:
   // Documentation inherited
   void registerDofs() override;
 
+  // Documentation inherited
+  void bindState(double* _commands, double* _positions, double* _velocities,
+                 double* _accelerations, double* _forces) override;
+
   // Documentation inherited
   virtual void updateDegreeOfFreedomNames() override;
 
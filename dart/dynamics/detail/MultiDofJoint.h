@@ -986,7 +986,7 @@ void MultiDofJoint<DOF>::setPositionsStatic(const Vector& _positions)
 
 //==============================================================================
 template <size_t DOF>
-const typename MultiDofJoint<DOF>::Vector&
+const Eigen::Map<typename MultiDofJoint<DOF>::Vector>&
 MultiDofJoint<DOF>::getPositionsStatic() const
 {
   return mPositions;
@@ -1005,7 +1005,7 @@ void MultiDofJoint<DOF>::setVelocitiesStatic(const Vector& _velocities)
 
 //==============================================================================
 template <size_t DOF>
-const typename MultiDofJoint<DOF>::Vector&
+const Eigen::Map<typename MultiDofJoint<DOF>::Vector>&
 MultiDofJoint<DOF>::getVelocitiesStatic() const
 {
   return mVelocities;
@@ -1024,7 +1024,7 @@ void MultiDofJoint<DOF>::setAccelerationsStatic(const Vector& _accels)
 
 //==============================================================================
 template <size_t DOF>
-const typename MultiDofJoint<DOF>::Vector&
+const Eigen::Map<typename MultiDofJoint<DOF>::Vector>&
 MultiDofJoint<DOF>::getAccelerationsStatic() const
 {
   return mAccelerations;
@@ -1234,6 +1234,13 @@ void MultiDofJoint<DOF>::integrateVelocities(double _dt)
   setVelocitiesStatic(getVelocitiesStatic() + getAccelerationsStatic() * _dt);
 }
 
+//==============================================================================
+template <size_t DOF>
+bool MultiDofJoint<DOF>::hasEuclideanPositions() const
+{
+  return true;
+}
+
 //==============================================================================
 template <size_t DOF>
 Eigen::VectorXd MultiDofJoint<DOF>::getPositionDifferences(
@@ -1407,14 +1414,15 @@ template <size_t DOF>
 MultiDofJoint<DOF>::MultiDofJoint(const Properties& _properties)
   : Joint(_properties),
     mMultiDofP(_properties),
-    mCommands(Vector::Zero()),
-    mPositions(Vector::Zero()),
+    mStateStorage(Eigen::Matrix<double, DOF, 5>::Zero()),
+    mCommands(mStateStorage.col(0).data()),
+    mPositions(mStateStorage.col(1).data()),
     mPositionDeriv(Vector::Zero()),
-    mVelocities(Vector::Zero()),
+    mVelocities(mStateStorage.col(2).data()),
     mVelocitiesDeriv(Vector::Zero()),
-    mAccelerations(Vector::Zero()),
+    mAccelerations(mStateStorage.col(3).data()),
     mAccelerationsDeriv(Vector::Zero()),
-    mForces(Vector::Zero()),
+    mForces(mStateStorage.col(4).data()),
     mForcesDeriv(Vector::Zero()),
     mVelocityChanges(Vector::Zero()),
     mImpulses(Vector::Zero()),
@@ -1442,6 +1450,35 @@ void MultiDofJoint<DOF>::registerDofs()
   }
 }
 
+//==============================================================================
+template <size_t DOF>
+void MultiDofJoint<DOF>::bindState(double* _commands, double* _positions,
+                                   double* _velocities, double* _accelerations,
+                                   double* _forces)
+{
+  if(nullptr == _positions)
+  {
+    _commands      = mStateStorage.col(0).data();
+    _positions     = mStateStorage.col(1).data();
+    _velocities    = mStateStorage.col(2).data();
+    _accelerations = mStateStorage.col(3).data();
+    _forces        = mStateStorage.col(4).data();
+  }
+
+  Vector::Map(_commands)      = mCommands;
+  Vector::Map(_positions)     = mPositions;
+  Vector::Map(_velocities)    = mVelocities;
+  Vector::Map(_accelerations) = mAccelerations;
+  Vector::Map(_forces)        = mForces;
+
+  // Eigen::Map cannot be reassigned, so the maps are reconstructed in place
+  new (&mCommands) Eigen::Map<Vector>(_commands);
+  new (&mPositions) Eigen::Map<Vector>(_positions);
+  new (&mVelocities) Eigen::Map<Vector>(_velocities);
+  new (&mAccelerations) Eigen::Map<Vector>(_accelerations);
+  new (&mForces) Eigen::Map<Vector>(_forces);
+}
+
 //==============================================================================
 template <size_t DOF>
 const math::Jacobian MultiDofJoint<DOF>::getLocalJacobian() const
@@ -1848,7 +1885,7 @@ void MultiDofJoint<DOF>::addChildBiasForceToDynamic(
       = _childBiasForce
         + _childArtInertia
           * (_childPartialAcc
-             + getLocalJacobianStatic()*getInvProjArtInertiaImplicit()
+             + getLocalJacobianStatic()*mInvProjArtInertiaImplicit
                *mTotalForce);
 
   //    Eigen::Vector6d beta
@@ -1931,7 +1968,7 @@ void MultiDofJoint<DOF>::addChildBiasImpulseToDynamic(
   const Eigen::Vector6d beta
       = _childBiasImpulse
         + _childArtInertia*getLocalJacobianStatic()
-          *getInvProjArtInertia()*mTotalImpulse;
+          *mInvProjArtInertia*mTotalImpulse;
 
   // Verification
   assert(!math::isNan(beta));
@@ -2100,7 +2137,7 @@ void MultiDofJoint<DOF>::updateAccelerationDynamic(
     const Eigen::Vector6d& _spatialAcc)
 {
   //
-  setAccelerationsStatic( getInvProjArtInertiaImplicit()
+  setAccelerationsStatic( mInvProjArtInertiaImplicit
         * (mTotalForce - getLocalJacobianStatic().transpose()
            *_artInertia*math::AdInvT(getLocalTransform(), _spatialAcc)) );
 
@@ -2149,7 +2186,7 @@ void MultiDofJoint<DOF>::updateVelocityChangeDynamic(
 {
   //
   mVelocityChanges
-      = getInvProjArtInertia()
+      = mInvProjArtInertia
       * (mTotalImpulse - getLocalJacobianStatic().transpose()
          *_artInertia*math::AdInvT(getLocalTransform(), _velocityChange));
 
@@ -2300,7 +2337,7 @@ void MultiDofJoint<DOF>::addChildBiasForceForInvMassMatrix(
   // Compute beta
   Eigen::Vector6d beta = _childBiasForce;
   beta.noalias() += _childArtInertia * getLocalJacobianStatic()
-                    * getInvProjArtInertia() * mInvM_a;
+                    * mInvProjArtInertia * mInvM_a;
 
   // Verification
   assert(!math::isNan(beta));
@@ -2320,7 +2357,7 @@ void MultiDofJoint<DOF>::addChildBiasForceForInvAugMassMatrix(
   // Compute beta
   Eigen::Vector6d beta = _childBiasForce;
   beta.noalias() += _childArtInertia * getLocalJacobianStatic()
-                    * getInvProjArtInertiaImplicit() * mInvM_a;
+                    * mInvProjArtInertiaImplicit * mInvM_a;
 
   // Verification
   assert(!math::isNan(beta));
@@ -2350,7 +2387,7 @@ void MultiDofJoint<DOF>::getInvMassMatrixSegment(
 {
   //
   mInvMassMatrixSegment
-      = getInvProjArtInertia()
+      = mInvProjArtInertia
       * (mInvM_a - getLocalJacobianStatic().transpose()
          * _artInertia * math::AdInvT(getLocalTransform(), _spatialAcc));
 
@@ -2374,7 +2411,7 @@ void MultiDofJoint<DOF>::getInvAugMassMatrixSegment(
 {
   //
   mInvMassMatrixSegment
-      = getInvProjArtInertiaImplicit()
+      = mInvProjArtInertiaImplicit
       * (mInvM_a - getLocalJacobianStatic().transpose()
          * _artInertia * math::AdInvT(getLocalTransform(), _spatialAcc));
 
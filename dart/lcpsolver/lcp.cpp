@@ -774,11 +774,26 @@ void dLCP::unpermute()
 #endif // dLCP_FAST
 
 
+//***************************************************************************
+// memory layout of the temporary buffer of dSolveLCP(). every array starts at
+// a 16 byte boundary relative to the beginning of the buffer.
+
+#define dLCP_ALIGNED_SIZE(size) ((((size_t)(size)) + 15) & ~((size_t)15))
+
+template <typename T>
+static T *dLCPTakeFromBuffer (char *&buf, size_t count)
+{
+  T *res = reinterpret_cast<T *>(buf);
+  buf += dLCP_ALIGNED_SIZE(count * sizeof(T));
+  return res;
+}
+
 //***************************************************************************
 // an optimized Dantzig LCP driver routine for the lo-hi LCP problem.
 
 void dSolveLCP (int n, dReal *A, dReal *x, dReal *b,
-                dReal *outer_w/*=nullptr*/, int nub, dReal *lo, dReal *hi, int *findex)
+                dReal *outer_w/*=nullptr*/, int nub, dReal *lo, dReal *hi, int *findex,
+                void *tmpbuf/*=nullptr*/)
 {
   dAASSERT (n>0 && A && x && b && lo && hi && nub >= 0 && nub <= n);
 # ifndef dNODEBUG
@@ -791,8 +806,14 @@ void dSolveLCP (int n, dReal *A, dReal *x, dReal *b,
 
   // if all the variables are unbounded then we can just factor, solve,
   // and return
+  // all the temporary arrays are taken from a single buffer, which is only
+  // allocated here if the caller doesn't provide one
+  char *ownbuf = tmpbuf ? nullptr
+      : new char[dEstimateSolveLCPMemoryReq(n, outer_w != nullptr)];
+  char *buf = tmpbuf ? static_cast<char *>(tmpbuf) : ownbuf;
+
   if (nub >= n) {
-    dReal *d = new dReal[n];
+    dReal *d = dLCPTakeFromBuffer<dReal>(buf, n);
     dSetZero (d, n);
 
     int nskip = dPAD(n);
@@ -800,27 +821,28 @@ void dSolveLCP (int n, dReal *A, dReal *x, dReal *b,
     dSolveLDLT (A, d, b, n, nskip);
     memcpy (x, b, n*sizeof(dReal));
 
+    delete[] ownbuf;
     return;
   }
 
   const int nskip = dPAD(n);
-  dReal *L = new dReal[ (n*nskip)];
-  dReal *d = new dReal[ (n)];
-  dReal *w = outer_w ? outer_w : (new dReal[n]);
-  dReal *delta_w = new dReal[ (n)];
-  dReal *delta_x = new dReal[ (n)];
-  dReal *Dell = new dReal[ (n)];
-  dReal *ell = new dReal[ (n)];
+  dReal *L = dLCPTakeFromBuffer<dReal>(buf, n*nskip);
+  dReal *d = dLCPTakeFromBuffer<dReal>(buf, n);
+  dReal *w = outer_w ? outer_w : dLCPTakeFromBuffer<dReal>(buf, n);
+  dReal *delta_w = dLCPTakeFromBuffer<dReal>(buf, n);
+  dReal *delta_x = dLCPTakeFromBuffer<dReal>(buf, n);
+  dReal *Dell = dLCPTakeFromBuffer<dReal>(buf, n);
+  dReal *ell = dLCPTakeFromBuffer<dReal>(buf, n);
 #ifdef ROWPTRS
-  dReal **Arows = new dReal* [n];
+  dReal **Arows = dLCPTakeFromBuffer<dReal *>(buf, n);
 #else
   dReal **Arows = nullptr;
 #endif
-  int *p = new int[n];
-  int *C = new int[n];
+  int *p = dLCPTakeFromBuffer<int>(buf, n);
+  int *C = dLCPTakeFromBuffer<int>(buf, n);
 
   // for i in N, state[i] is 0 if x(i)==lo(i) or 1 if x(i)==hi(i)
-  bool *state = new bool[n];
+  bool *state = dLCPTakeFromBuffer<bool>(buf, n);
 
   // create LCP object. note that tmp is set to delta_w to save space, this
   // optimization relies on knowledge of how tmp is used, so be careful!
@@ -1065,21 +1087,7 @@ void dSolveLCP (int n, dReal *A, dReal *x, dReal *b,
 
   lcp.unpermute();
 
-  if (!outer_w)
-	  delete[] w;
-  delete[] L;
-  delete[] d;
-  delete[] delta_w;
-  delete[] delta_x;
-  delete[] Dell;
-  delete[] ell;
-#ifdef ROWPTRS
-  delete[] Arows;
-#endif
-  delete[] p;
-  delete[] C;
-
-  delete[] state;
+  delete[] ownbuf;
 }
 
 size_t dEstimateSolveLCPMemoryReq(int n, bool outer_w_avail)
@@ -1088,20 +1096,18 @@ size_t dEstimateSolveLCPMemoryReq(int n, bool outer_w_avail)
 
   size_t res = 0;
 
-  res += (sizeof(dReal) * (n * nskip)); // for L
-  res += 5 * (sizeof(dReal) * n); // for d, delta_w, delta_x, Dell, ell
+  res += dLCP_ALIGNED_SIZE(sizeof(dReal) * (n * nskip)); // for L
+  res += 5 * dLCP_ALIGNED_SIZE(sizeof(dReal) * n); // for d, delta_w, delta_x, Dell, ell
   if (!outer_w_avail) {
-    res += (sizeof(dReal) * n); // for w
+    res += dLCP_ALIGNED_SIZE(sizeof(dReal) * n); // for w
   }
 #ifdef ROWPTRS
-  res += (sizeof(dReal *) * n); // for Arows
+  res += dLCP_ALIGNED_SIZE(sizeof(dReal *) * n); // for Arows
 #endif
-  res += 2 * (sizeof(int) * n); // for p, C
-  res += (sizeof(bool) * n); // for state
+  res += 2 * dLCP_ALIGNED_SIZE(sizeof(int) * n); // for p, C
+  res += dLCP_ALIGNED_SIZE(sizeof(bool) * n); // for state
 
-  // Use n instead of nC as nC varies at runtime while n is greater or equal to nC
-  size_t lcp_transfer_req = dLCP::estimate_transfer_i_from_C_to_N_mem_req(n, nskip);
-  res += (lcp_transfer_req); // for dLCP::transfer_i_from_C_to_N
+  // dLCP::transfer_i_from_C_to_N takes its temporary buffer from the stack
 
   return res;
 }
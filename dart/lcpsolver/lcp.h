@@ -58,8 +58,10 @@ to be implemented. the first `nub' variables are assumed to have findex < 0.
 #include "dart/lcpsolver/common.h"
 
 void dSolveLCP (int n, dReal *A, dReal *x, dReal *b, dReal *w,
-	int nub, dReal *lo, dReal *hi, int *findex);
+	int nub, dReal *lo, dReal *hi, int *findex, void *tmpbuf = nullptr);
 
+/* size in bytes of the temporary buffer `tmpbuf' of dSolveLCP(). the buffer
+   has to be 16 byte aligned. if `tmpbuf' is null, dSolveLCP() allocates it. */
 size_t dEstimateSolveLCPMemoryReq(int n, bool outer_w_avail);
 
 
@@ -40,38 +40,291 @@
  *   POSSIBILITY OF SUCH DAMAGE.
  */
 
+
 #include "dart/simulation/Recording.h"
 
+#include <algorithm>
+#include <cmath>
+#include <cstring>
 #include <iostream>
 
+#include "dart/common/Console.h"
 #include "dart/dynamics/Skeleton.h"
 
 namespace dart {
 namespace simulation {
 
+namespace {
+
+const char FILE_MAGIC[8] = {'D', 'A', 'R', 'T', 'R', 'E', 'C', '\0'};
+const char INDEX_MAGIC[8] = {'D', 'A', 'R', 'T', 'I', 'D', 'X', '\0'};
+const uint32_t CHUNK_MAGIC = 0x4b4e4843;
+const uint32_t FILE_VERSION = 1;
+
+/// Magic, version, frames per chunk and quantization steps
+const uint64_t HEADER_SIZE = 32;
+
+/// Magic, number of frames and payload size
+const uint64_t CHUNK_HEADER_SIZE = 12;
+
+/// Number of chunks, number of frames and magic
+const uint64_t INDEX_FOOTER_SIZE = 24;
+
+//==============================================================================
+template <typename T>
+void writeRaw(std::ostream& _stream, const T& _value)
+{
+  _stream.write(reinterpret_cast<const char*>(&_value), sizeof(T));
+}
+
+//==============================================================================
+template <typename T>
+bool readRaw(std::istream& _stream, T& _value)
+{
+  return static_cast<bool>(
+        _stream.read(reinterpret_cast<char*>(&_value), sizeof(T)));
+}
+
+//==============================================================================
+void writeVarint(std::string& _buffer, uint64_t _value)
+{
+  while(_value >= 0x80)
+  {
+    _buffer.push_back(static_cast<char>((_value & 0x7f) | 0x80));
+    _value >>= 7;
+  }
+  _buffer.push_back(static_cast<char>(_value));
+}
+
+//==============================================================================
+bool readVarint(const char*& _data, const char* _end, uint64_t& _value)
+{
+  _value = 0;
+  for(int shift = 0; shift < 64 && _data < _end; shift += 7)
+  {
+    const uint8_t byte = static_cast<uint8_t>(*_data++);
+    _value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+    if(!(byte & 0x80))
+      return true;
+  }
+
+  return false;
+}
+
+//==============================================================================
+/// Map signed integers to unsigned ones so that small magnitudes get short
+/// varints
+uint64_t zigzag(int64_t _value)
+{
+  return (static_cast<uint64_t>(_value) << 1)
+      ^ static_cast<uint64_t>(_value >> 63);
+}
+
+//==============================================================================
+int64_t unzigzag(uint64_t _value)
+{
+  return static_cast<int64_t>(_value >> 1) ^ -static_cast<int64_t>(_value & 1);
+}
+
+//==============================================================================
+int64_t quantize(double _value, double _step)
+{
+  // Keep the codes and their differences within the range of int64_t
+  const double limit = 1e18;
+  const double code = std::round(_value / _step);
+  if(std::isnan(code))
+    return 0;
+
+  return static_cast<int64_t>(std::max(-limit, std::min(limit, code)));
+}
+
+//==============================================================================
+/// Encode _count values. If _step is positive, the values are quantized with
+/// it; otherwise they are stored losslessly. If _delta is true, the values are
+/// coded relative to _codes, which are the codes of the previous values.
+/// _codes are replaced by the codes of _values.
+void encodeValues(std::string& _buffer, const double* _values, size_t _count,
+                  double _step, bool _delta, std::vector<int64_t>& _codes)
+{
+  _codes.resize(_count);
+  for(size_t i = 0; i < _count; ++i)
+  {
+    if(_step > 0.0)
+    {
+      const int64_t code = quantize(_values[i], _step);
+      writeVarint(_buffer, zigzag(_delta ? code - _codes[i] : code));
+      _codes[i] = code;
+    }
+    else
+    {
+      uint64_t bits;
+      std::memcpy(&bits, &_values[i], sizeof(bits));
+      if(_delta)
+        writeVarint(_buffer, bits ^ static_cast<uint64_t>(_codes[i]));
+      else
+        _buffer.append(reinterpret_cast<const char*>(&bits), sizeof(bits));
+      _codes[i] = static_cast<int64_t>(bits);
+    }
+  }
+}
+
+//==============================================================================
+/// Decode the values encoded by encodeValues()
+bool decodeValues(const char*& _data, const char* _end, double* _values,
+                  size_t _count, double _step, bool _delta,
+                  std::vector<int64_t>& _codes)
+{
+  _codes.resize(_count);
+  for(size_t i = 0; i < _count; ++i)
+  {
+    if(_step > 0.0)
+    {
+      uint64_t value;
+      if(!readVarint(_data, _end, value))
+        return false;
+      const int64_t code = (_delta ? _codes[i] : 0) + unzigzag(value);
+      _values[i] = code * _step;
+      _codes[i] = code;
+    }
+    else
+    {
+      uint64_t bits;
+      if(_delta)
+      {
+        if(!readVarint(_data, _end, bits))
+          return false;
+        bits ^= static_cast<uint64_t>(_codes[i]);
+      }
+      else
+      {
+        if(_end - _data < static_cast<std::ptrdiff_t>(sizeof(bits)))
+          return false;
+        std::memcpy(&bits, _data, sizeof(bits));
+        _data += sizeof(bits);
+      }
+      std::memcpy(&_values[i], &bits, sizeof(bits));
+      _codes[i] = static_cast<int64_t>(bits);
+    }
+  }
+
+  return true;
+}
+
+} // anonymous namespace
+
+//==============================================================================
+Recording::FileOptions::FileOptions(double _positionStep, double _contactStep,
+                                    size_t _framesPerChunk)
+  : mPositionStep(_positionStep),
+    mContactStep(_contactStep),
+    mFramesPerChunk(_framesPerChunk)
+{
+  // Do nothing
+}
+
+//==============================================================================
+Recording::Frames::Frames()
+  : mContactOffsets(1, 0)
+{
+  // Do nothing
+}
+
+//==============================================================================
+size_t Recording::Frames::getNumFrames() const
+{
+  return mContactOffsets.size() - 1;
+}
+
+//==============================================================================
+void Recording::Frames::clear()
+{
+  mPositions.clear();
+  mContacts.clear();
+  mContactOffsets.assign(1, 0);
+}
+
+//==============================================================================
+void Recording::Frames::addState(const Eigen::VectorXd& _state,
+                                 const std::vector<size_t>& _genCoordOffsets)
+{
+  // The positions that are missing in _state are zero
+  const size_t size = _state.size();
+  const size_t numSkeletons = _genCoordOffsets.size() - 1;
+  mPositions.resize(numSkeletons);
+  for (size_t i = 0; i < numSkeletons; ++i)
+  {
+    std::vector<double>& positions = mPositions[i];
+    const size_t begin = std::min(_genCoordOffsets[i], size);
+    const size_t end = std::min(_genCoordOffsets[i + 1], size);
+    positions.insert(positions.end(), _state.data() + begin,
+                     _state.data() + end);
+    positions.resize(positions.size()
+                     + _genCoordOffsets[i + 1] - _genCoordOffsets[i]
+                     - (end - begin), 0.0);
+  }
+
+  const size_t numDofs = std::min(_genCoordOffsets.back(), size);
+  mContacts.insert(mContacts.end(), _state.data() + numDofs,
+                   _state.data() + size);
+  mContactOffsets.push_back(mContacts.size());
+}
+
+//==============================================================================
+Eigen::VectorXd Recording::Frames::getState(
+    size_t _frameIdx, const std::vector<size_t>& _genCoordOffsets) const
+{
+  const size_t numDofs = _genCoordOffsets.back();
+  const size_t contactBegin = mContactOffsets[_frameIdx];
+  const size_t contactEnd = mContactOffsets[_frameIdx + 1];
+
+  Eigen::VectorXd state(numDofs + contactEnd - contactBegin);
+  for (size_t i = 0; i + 1 < _genCoordOffsets.size(); ++i)
+  {
+    const size_t skelDofs = _genCoordOffsets[i + 1] - _genCoordOffsets[i];
+    state.segment(_genCoordOffsets[i], skelDofs)
+        = Eigen::Map<const Eigen::VectorXd>(
+            mPositions[i].data() + _frameIdx * skelDofs, skelDofs);
+  }
+  state.tail(contactEnd - contactBegin) = Eigen::Map<const Eigen::VectorXd>(
+      mContacts.data() + contactBegin, contactEnd - contactBegin);
+
+  return state;
+}
+
 //==============================================================================
 Recording::Recording(const std::vector<dynamics::SkeletonPtr>& _skeletons)
+  : mReadOnly(false),
+    mEndOffset(0),
+    mNumFileFrames(0),
+    mCachedChunk(-1)
 {
   for (size_t i = 0; i < _skeletons.size(); i++)
     mNumGenCoordsForSkeletons.push_back(_skeletons[i]->getNumDofs());
+  updateGenCoordOffsets();
 }
 
 //==============================================================================
 Recording::Recording(const std::vector<int>& _skelDofs)
+  : mReadOnly(false),
+    mEndOffset(0),
+    mNumFileFrames(0),
+    mCachedChunk(-1)
 {
   for (size_t i = 0; i < _skelDofs.size(); i++)
     mNumGenCoordsForSkeletons.push_back(_skelDofs[i]);
+  updateGenCoordOffsets();
 }
 
 //==============================================================================
 Recording::~Recording()
 {
+  closeFile();
 }
 
 //==============================================================================
 int Recording::getNumFrames() const
 {
-  return mBakedStates.size();
+  return mNumFileFrames + mBakedFrames.getNumFrames();
 }
 
 //==============================================================================
@@ -89,57 +342,105 @@ int Recording::getNumDofs(int _skelIdx) const
 //==============================================================================
 int Recording::getNumContacts(int _frameIdx) const
 {
-  int totalDofs = 0;
-  for (size_t i = 0; i < mNumGenCoordsForSkeletons.size(); i++)
-    totalDofs += mNumGenCoordsForSkeletons[i];
-  return (mBakedStates[_frameIdx].size() - totalDofs) / 6;
+  std::lock_guard<std::mutex> lock(mCacheMutex);
+  size_t index;
+  const Frames& frames = getFrames(_frameIdx, index);
+  return (frames.mContactOffsets[index + 1] - frames.mContactOffsets[index])
+      / 6;
 }
 
 //==============================================================================
 Eigen::VectorXd Recording::getConfig(int _frameIdx, int _skelIdx) const
 {
-  int index = 0;
-  for (int i = 0; i < _skelIdx; i++)
-    index += mNumGenCoordsForSkeletons[i];
-  return mBakedStates[_frameIdx].segment(index, getNumDofs(_skelIdx));
+  std::lock_guard<std::mutex> lock(mCacheMutex);
+  size_t index;
+  const Frames& frames = getFrames(_frameIdx, index);
+  const int numDofs = getNumDofs(_skelIdx);
+  return Eigen::Map<const Eigen::VectorXd>(
+        frames.mPositions[_skelIdx].data() + index * numDofs, numDofs);
+}
+
+//==============================================================================
+Recording::ConfigView Recording::getConfigView(int _frameIdx,
+                                               int _skelIdx) const
+{
+  std::lock_guard<std::mutex> lock(mCacheMutex);
+  size_t index;
+  const Frames& frames = getFrames(_frameIdx, index);
+
+  ConfigView view;
+  view.mData = frames.mPositions[_skelIdx].data();
+  view.mStride = getNumDofs(_skelIdx);
+  view.mFirstFrame = _frameIdx - static_cast<int>(index);
+  view.mNumFrames = frames.getNumFrames();
+  return view;
 }
 
 //==============================================================================
 double Recording::getGenCoord(int _frameIdx, int _skelIdx, int _dofIdx) const
 {
-  int index = 0;
-  for (int i = 0; i < _skelIdx; i++)
-    index += mNumGenCoordsForSkeletons[i];
-  return mBakedStates[_frameIdx][index + _dofIdx];
+  std::lock_guard<std::mutex> lock(mCacheMutex);
+  size_t index;
+  const Frames& frames = getFrames(_frameIdx, index);
+  return frames.mPositions[_skelIdx][index * getNumDofs(_skelIdx) + _dofIdx];
 }
 
 //==============================================================================
 Eigen::Vector3d Recording::getContactPoint(int _frameIdx, int _contactIdx) const
 {
-  int totalDofs = 0;
-  for (size_t i = 0; i < mNumGenCoordsForSkeletons.size(); i++)
-    totalDofs += mNumGenCoordsForSkeletons[i];
-  return mBakedStates[_frameIdx].segment(totalDofs + _contactIdx * 6, 3);
+  std::lock_guard<std::mutex> lock(mCacheMutex);
+  size_t index;
+  const Frames& frames = getFrames(_frameIdx, index);
+  return Eigen::Map<const Eigen::Vector3d>(
+        frames.mContacts.data() + frames.mContactOffsets[index]
+        + _contactIdx * 6);
 }
 
 //==============================================================================
 Eigen::Vector3d Recording::getContactForce(int _frameIdx, int _contactIdx) const
 {
-  int totalDofs = 0;
-  for (size_t i = 0; i < mNumGenCoordsForSkeletons.size(); i++)
-    totalDofs += mNumGenCoordsForSkeletons[i];
-  return mBakedStates[_frameIdx].segment(totalDofs + _contactIdx * 6 + 3, 3);
+  std::lock_guard<std::mutex> lock(mCacheMutex);
+  size_t index;
+  const Frames& frames = getFrames(_frameIdx, index);
+  return Eigen::Map<const Eigen::Vector3d>(
+        frames.mContacts.data() + frames.mContactOffsets[index]
+        + _contactIdx * 6 + 3);
 }
 
 //==============================================================================
 void Recording::clear() {
-  mBakedStates.clear();
+  mBakedFrames.clear();
+
+  if (!mFile)
+    return;
+
+  if (mReadOnly)
+  {
+    closeFile();
+    return;
+  }
+
+  // Restart the file
+  mFile->close();
+  mFile->open(mFileName,
+              std::ios::in | std::ios::out | std::ios::binary | std::ios::trunc);
+  writeHeader();
 }
 
 //==============================================================================
 void Recording::addState(const Eigen::VectorXd& _state)
 {
-  mBakedStates.push_back(_state);
+  if (mFile && mReadOnly)
+  {
+    dterr << "[Recording::addState] The recording file [" << mFileName
+          << "] is read-only. The state is not recorded.\n";
+    return;
+  }
+
+  mBakedFrames.addState(_state, mGenCoordOffsets);
+
+  if (mFile && mBakedFrames.getNumFrames() >= mFileOptions.mFramesPerChunk)
+    writeChunk();
 }
 
 //==============================================================================
@@ -149,8 +450,440 @@ void Recording::updateNumGenCoords(
   mNumGenCoordsForSkeletons.clear();
   for (size_t i = 0; i < _skeletons.size(); ++i)
     mNumGenCoordsForSkeletons.push_back(_skeletons[i]->getNumDofs());
+  updateGenCoordOffsets();
+}
+
+//==============================================================================
+bool Recording::startStreaming(const std::string& _fileName,
+                               const FileOptions& _options)
+{
+  closeFile();
+  mBakedFrames.clear();
+
+  std::unique_ptr<std::fstream> file(new std::fstream(
+      _fileName,
+      std::ios::in | std::ios::out | std::ios::binary | std::ios::trunc));
+  if (!file->is_open())
+  {
+    dterr << "[Recording::startStreaming] Failed to create [" << _fileName
+          << "].\n";
+    return false;
+  }
+
+  mFile = std::move(file);
+  mFileName = _fileName;
+  mReadOnly = false;
+  mFileOptions = _options;
+  mFileOptions.mFramesPerChunk = std::max<size_t>(_options.mFramesPerChunk, 1);
+  writeHeader();
+
+  return true;
+}
+
+//==============================================================================
+bool Recording::isStreaming() const
+{
+  return mFile != nullptr;
+}
+
+//==============================================================================
+void Recording::closeFile()
+{
+  if (!mFile)
+    return;
+
+  if (!mReadOnly)
+  {
+    if (mBakedFrames.getNumFrames() > 0)
+      writeChunk();
+    writeIndex();
+  }
+
+  mFile.reset();
+  mFileName.clear();
+  mReadOnly = false;
+  mBakedFrames.clear();
+  mChunkOffsets.clear();
+  mEndOffset = 0;
+  mNumFileFrames = 0;
+  mCachedChunk = -1;
+  mCachedFrames.clear();
+}
+
+//==============================================================================
+bool Recording::saveFile(const std::string& _fileName,
+                         const FileOptions& _options) const
+{
+  Recording recording(mNumGenCoordsForSkeletons);
+  if (!recording.startStreaming(_fileName, _options))
+    return false;
+
+  for (int i = 0; i < getNumFrames(); ++i)
+  {
+    Eigen::VectorXd state;
+    {
+      std::lock_guard<std::mutex> lock(mCacheMutex);
+      size_t index;
+      const Frames& frames = getFrames(i, index);
+      state = frames.getState(index, mGenCoordOffsets);
+    }
+    recording.addState(state);
+  }
+  recording.closeFile();
+
+  return true;
+}
+
+//==============================================================================
+bool Recording::loadFile(const std::string& _fileName)
+{
+  closeFile();
+  mBakedFrames.clear();
+
+  bool readOnly = false;
+  std::unique_ptr<std::fstream> file(new std::fstream(
+      _fileName, std::ios::in | std::ios::out | std::ios::binary));
+  if (!file->is_open())
+  {
+    file.reset(new std::fstream(_fileName, std::ios::in | std::ios::binary));
+    readOnly = true;
+  }
+
+  char magic[sizeof(FILE_MAGIC)];
+  uint32_t version = 0;
+  uint32_t framesPerChunk = 0;
+  FileOptions options;
+  if (!file->is_open()
+      || !file->read(magic, sizeof(magic))
+      || std::memcmp(magic, FILE_MAGIC, sizeof(magic)) != 0
+      || !readRaw(*file, version) || version != FILE_VERSION
+      || !readRaw(*file, framesPerChunk) || framesPerChunk == 0
+      || !readRaw(*file, options.mPositionStep)
+      || !readRaw(*file, options.mContactStep))
+  {
+    dterr << "[Recording::loadFile] [" << _fileName << "] is not a valid "
+          << "recording file.\n";
+    return false;
+  }
+  options.mFramesPerChunk = framesPerChunk;
+
+  file->seekg(0, std::ios::end);
+  const uint64_t fileSize = file->tellg();
+
+  mFile = std::move(file);
+  mFileName = _fileName;
+  mReadOnly = readOnly;
+  mFileOptions = options;
+  mCachedChunk = -1;
+
+  // Read the index. It is accepted only if it directly follows its last
+  // chunk, because a file that was not closed properly may end with a stale
+  // index that has been partially overwritten.
+  bool indexed = false;
+  uint64_t numChunks = 0;
+  uint64_t numFrames = 0;
+  char indexMagic[sizeof(INDEX_MAGIC)];
+  if (fileSize >= HEADER_SIZE + INDEX_FOOTER_SIZE)
+  {
+    mFile->seekg(fileSize - INDEX_FOOTER_SIZE);
+    if (readRaw(*mFile, numChunks) && readRaw(*mFile, numFrames)
+        && mFile->read(indexMagic, sizeof(indexMagic))
+        && std::memcmp(indexMagic, INDEX_MAGIC, sizeof(indexMagic)) == 0
+        && numChunks
+           <= (fileSize - HEADER_SIZE - INDEX_FOOTER_SIZE) / sizeof(uint64_t))
+    {
+      const uint64_t indexOffset
+          = fileSize - INDEX_FOOTER_SIZE - numChunks * sizeof(uint64_t);
+      mChunkOffsets.resize(numChunks);
+      mFile->seekg(indexOffset);
+      indexed = static_cast<bool>(mFile->read(
+          reinterpret_cast<char*>(mChunkOffsets.data()),
+          numChunks * sizeof(uint64_t)));
+
+      if (indexed && numChunks > 0)
+      {
+        uint32_t chunkMagic = 0;
+        uint32_t chunkFrames = 0;
+        uint32_t payloadSize = 0;
+        const uint64_t last = mChunkOffsets.back();
+        mFile->seekg(last);
+        indexed = mChunkOffsets.front() == HEADER_SIZE
+            && last < indexOffset
+            && readRaw(*mFile, chunkMagic) && chunkMagic == CHUNK_MAGIC
+            && readRaw(*mFile, chunkFrames) && readRaw(*mFile, payloadSize)
+            && last + CHUNK_HEADER_SIZE + payloadSize == indexOffset;
+      }
+      else if (indexed)
+      {
+        indexed = indexOffset == HEADER_SIZE;
+      }
+
+      mEndOffset = indexOffset;
+    }
+  }
+
+  // Otherwise, recover the chunks by scanning the file
+  if (!indexed)
+  {
+    mChunkOffsets.clear();
+    mEndOffset = HEADER_SIZE;
+    uint32_t chunkMagic = 0;
+    uint32_t chunkFrames = 0;
+    uint32_t payloadSize = 0;
+    mFile->clear();
+    mFile->seekg(mEndOffset);
+    while (readRaw(*mFile, chunkMagic) && chunkMagic == CHUNK_MAGIC
+           && readRaw(*mFile, chunkFrames) && readRaw(*mFile, payloadSize)
+           && mEndOffset + CHUNK_HEADER_SIZE + payloadSize <= fileSize)
+    {
+      mChunkOffsets.push_back(mEndOffset);
+      mEndOffset += CHUNK_HEADER_SIZE + payloadSize;
+      mFile->seekg(mEndOffset);
+    }
+    mFile->clear();
+  }
+
+  // Every chunk but the last is full. The frames of the last chunk are kept
+  // in memory if it is not full, so that new frames can complete it.
+  mNumFileFrames = 0;
+  if (!mChunkOffsets.empty())
+  {
+    std::vector<Eigen::VectorXd> states;
+    if (!readChunk(mChunkOffsets.back(), states, mNumGenCoordsForSkeletons))
+    {
+      dterr << "[Recording::loadFile] [" << _fileName << "] is corrupted.\n";
+      closeFile();
+      return false;
+    }
+    updateGenCoordOffsets();
+
+    if (states.size() < mFileOptions.mFramesPerChunk)
+    {
+      for (size_t i = 0; i < states.size(); ++i)
+        mBakedFrames.addState(states[i], mGenCoordOffsets);
+      mEndOffset = mChunkOffsets.back();
+      mChunkOffsets.pop_back();
+    }
+
+    mNumFileFrames = mChunkOffsets.size() * mFileOptions.mFramesPerChunk;
+  }
+
+  return true;
+}
+
+//==============================================================================
+bool Recording::isRecordingFile(const std::string& _fileName)
+{
+  std::ifstream file(_fileName, std::ios::binary);
+  char magic[sizeof(FILE_MAGIC)];
+  return file.read(magic, sizeof(magic))
+      && std::memcmp(magic, FILE_MAGIC, sizeof(magic)) == 0;
+}
+
+//==============================================================================
+const Recording::Frames& Recording::getFrames(int _frameIdx,
+                                              size_t& _localIdx) const
+{
+  const size_t frameIdx = static_cast<size_t>(_frameIdx);
+  if (frameIdx >= mNumFileFrames)
+  {
+    _localIdx = frameIdx - mNumFileFrames;
+    return mBakedFrames;
+  }
+
+  const size_t framesPerChunk = mFileOptions.mFramesPerChunk;
+  const int chunkIdx = static_cast<int>(frameIdx / framesPerChunk);
+  if (chunkIdx != mCachedChunk)
+  {
+    std::vector<Eigen::VectorXd> states;
+    std::vector<int> skelDofs;
+    if (!readChunk(mChunkOffsets[chunkIdx], states, skelDofs)
+        || states.size() != framesPerChunk)
+    {
+      dterr << "[Recording::getFrames] Chunk " << chunkIdx << " of ["
+            << mFileName << "] is corrupted.\n";
+      states.assign(framesPerChunk, Eigen::VectorXd());
+    }
+
+    mCachedFrames.clear();
+    for (size_t i = 0; i < states.size(); ++i)
+      mCachedFrames.addState(states[i], mGenCoordOffsets);
+    mCachedChunk = chunkIdx;
+  }
+
+  _localIdx = frameIdx - chunkIdx * framesPerChunk;
+  return mCachedFrames;
+}
+
+//==============================================================================
+void Recording::updateGenCoordOffsets()
+{
+  std::vector<Eigen::VectorXd> states(mBakedFrames.getNumFrames());
+  for (size_t i = 0; i < states.size(); ++i)
+    states[i] = mBakedFrames.getState(i, mGenCoordOffsets);
+
+  mGenCoordOffsets.assign(1, 0);
+  for (size_t i = 0; i < mNumGenCoordsForSkeletons.size(); ++i)
+  {
+    mGenCoordOffsets.push_back(
+          mGenCoordOffsets.back() + mNumGenCoordsForSkeletons[i]);
+  }
+
+  mBakedFrames.clear();
+  for (size_t i = 0; i < states.size(); ++i)
+    mBakedFrames.addState(states[i], mGenCoordOffsets);
+
+  mCachedChunk = -1;
+  mCachedFrames.clear();
+}
+
+//==============================================================================
+void Recording::writeHeader()
+{
+  mFile->seekp(0);
+  mFile->write(FILE_MAGIC, sizeof(FILE_MAGIC));
+  writeRaw(*mFile, FILE_VERSION);
+  writeRaw(*mFile, static_cast<uint32_t>(mFileOptions.mFramesPerChunk));
+  writeRaw(*mFile, mFileOptions.mPositionStep);
+  writeRaw(*mFile, mFileOptions.mContactStep);
+  mFile->flush();
+
+  mChunkOffsets.clear();
+  mEndOffset = HEADER_SIZE;
+  mNumFileFrames = 0;
+  mCachedChunk = -1;
+  mCachedFrames.clear();
+}
+
+//==============================================================================
+void Recording::writeChunk()
+{
+  const size_t totalDofs = mGenCoordOffsets.back();
+
+  std::string payload;
+  writeVarint(payload, mNumGenCoordsForSkeletons.size());
+  for (size_t i = 0; i < mNumGenCoordsForSkeletons.size(); i++)
+    writeVarint(payload, mNumGenCoordsForSkeletons[i]);
+
+  // The positions are delta coded against the previous frame of the chunk,
+  // and the contacts, whose number changes from frame to frame, are not
+  std::vector<int64_t> positionCodes;
+  std::vector<int64_t> contactCodes;
+  size_t lastNumPositions = 0;
+  const size_t numFrames = mBakedFrames.getNumFrames();
+  for (size_t i = 0; i < numFrames; ++i)
+  {
+    const Eigen::VectorXd state = mBakedFrames.getState(i, mGenCoordOffsets);
+    const size_t size = state.size();
+    const size_t numPositions = std::min<size_t>(size, totalDofs);
+    const bool delta = i > 0 && numPositions == lastNumPositions;
+
+    writeVarint(payload, size);
+    encodeValues(payload, state.data(), numPositions,
+                 mFileOptions.mPositionStep, delta, positionCodes);
+    encodeValues(payload, state.data() + numPositions, size - numPositions,
+                 mFileOptions.mContactStep, false, contactCodes);
+
+    lastNumPositions = numPositions;
+  }
+
+  mFile->clear();
+  mFile->seekp(mEndOffset);
+  writeRaw(*mFile, CHUNK_MAGIC);
+  writeRaw(*mFile, static_cast<uint32_t>(numFrames));
+  writeRaw(*mFile, static_cast<uint32_t>(payload.size()));
+  mFile->write(payload.data(), payload.size());
+  mFile->flush();
+
+  mChunkOffsets.push_back(mEndOffset);
+  mEndOffset += CHUNK_HEADER_SIZE + payload.size();
+  mNumFileFrames += numFrames;
+  mBakedFrames.clear();
+}
+
+//==============================================================================
+void Recording::writeIndex()
+{
+  mFile->clear();
+  mFile->seekp(mEndOffset);
+  mFile->write(reinterpret_cast<const char*>(mChunkOffsets.data()),
+               mChunkOffsets.size() * sizeof(uint64_t));
+  writeRaw(*mFile, static_cast<uint64_t>(mChunkOffsets.size()));
+  writeRaw(*mFile, static_cast<uint64_t>(getNumFrames()));
+  mFile->write(INDEX_MAGIC, sizeof(INDEX_MAGIC));
+  mFile->flush();
+}
+
+//==============================================================================
+bool Recording::readChunk(uint64_t _offset,
+                          std::vector<Eigen::VectorXd>& _states,
+                          std::vector<int>& _skelDofs) const
+{
+  uint32_t chunkMagic = 0;
+  uint32_t numFrames = 0;
+  uint32_t payloadSize = 0;
+  mFile->clear();
+  mFile->seekg(_offset);
+  if (!readRaw(*mFile, chunkMagic) || chunkMagic != CHUNK_MAGIC
+      || !readRaw(*mFile, numFrames) || !readRaw(*mFile, payloadSize)
+      || _offset + CHUNK_HEADER_SIZE + payloadSize > mEndOffset)
+    return false;
+
+  std::string payload(payloadSize, '\0');
+  if (!mFile->read(&payload[0], payloadSize))
+    return false;
+
+  const char* data = payload.data();
+  const char* end = data + payload.size();
+
+  uint64_t numSkeletons;
+  if (!readVarint(data, end, numSkeletons)
+      || numSkeletons > static_cast<uint64_t>(end - data))
+    return false;
+
+  _skelDofs.resize(numSkeletons);
+  size_t totalDofs = 0;
+  for (size_t i = 0; i < numSkeletons; ++i)
+  {
+    uint64_t numDofs;
+    if (!readVarint(data, end, numDofs) || numDofs > payloadSize)
+      return false;
+    _skelDofs[i] = numDofs;
+    totalDofs += numDofs;
+  }
+
+  if (numFrames > payloadSize)
+    return false;
+
+  std::vector<int64_t> positionCodes;
+  std::vector<int64_t> contactCodes;
+  size_t lastNumPositions = 0;
+  _states.resize(numFrames);
+  for (size_t i = 0; i < numFrames; ++i)
+  {
+    // Every value takes at least one byte
+    uint64_t size;
+    if (!readVarint(data, end, size)
+        || size > static_cast<uint64_t>(end - data))
+      return false;
+
+    Eigen::VectorXd& state = _states[i];
+    state.resize(size);
+    const size_t numPositions = std::min<size_t>(size, totalDofs);
+    const bool delta = i > 0 && numPositions == lastNumPositions;
+
+    if (!decodeValues(data, end, state.data(), numPositions,
+                      mFileOptions.mPositionStep, delta, positionCodes)
+        || !decodeValues(data, end, state.data() + numPositions,
+                         size - numPositions, mFileOptions.mContactStep,
+                         false, contactCodes))
+      return false;
+
+    lastNumPositions = numPositions;
+  }
+
+  return true;
 }
 
 }  // namespace simulation
 }  // namespace dart
-
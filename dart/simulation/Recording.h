@@ -43,6 +43,11 @@
 #ifndef DART_SIMULATION_RECORDING_H_
 #define DART_SIMULATION_RECORDING_H_
 
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
 #include <vector>
 
 #include <Eigen/Dense>
@@ -58,9 +63,60 @@ class Skeleton;
 namespace simulation {
 
 /// \brief class Recording
+///
+/// The generalized positions of each skeleton are stored contiguously, frame
+/// after frame, and so are the contacts of all the frames.
+///
+/// The frames are kept in memory by default. They can also be streamed to a
+/// binary recording file instead, see startStreaming(), so that long
+/// recordings do not need to fit in memory. The file consists of chunks of
+/// frames that are compressed by delta coding the positions and optionally
+/// quantizing the positions and contacts, and of an index of the chunks, so
+/// that any frame can be read after decoding at most one chunk. The const
+/// getters of a streamed recording read the file and replace the decoded
+/// chunk that is cached; they are serialized by a mutex, so they can be called
+/// concurrently, but not concurrently with the non-const functions.
 class Recording
 {
 public:
+  /// Options of binary recording files
+  struct FileOptions
+  {
+    /// Quantization step of the generalized positions. The positions are
+    /// stored losslessly if this is zero.
+    double mPositionStep;
+
+    /// Quantization step of the contact points and forces. The contacts are
+    /// stored losslessly if this is zero.
+    double mContactStep;
+
+    /// Number of frames in a chunk
+    size_t mFramesPerChunk;
+
+    /// Constructor
+    FileOptions(double _positionStep = 0.0, double _contactStep = 0.0,
+                size_t _framesPerChunk = 64);
+  };
+
+  /// Read-only view of the generalized positions of a skeleton in a range of
+  /// consecutive frames. The positions of frame number (mFirstFrame + i) are
+  /// the mStride values starting at mData + i * mStride.
+  struct ConfigView
+  {
+    /// Positions of frame number mFirstFrame
+    const double* mData;
+
+    /// Distance between the positions of consecutive frames, which is the
+    /// number of generalized coordinates of the skeleton
+    size_t mStride;
+
+    /// Index of the first frame of the view
+    int mFirstFrame;
+
+    /// Number of frames in the view
+    int mNumFrames;
+  };
+
   /// \brief Create Recording with a list of skeletons
   explicit Recording(const std::vector<dynamics::SkeletonPtr>& _skeletons);
 
@@ -87,6 +143,13 @@ public:
   /// _frameIdx
   Eigen::VectorXd getConfig(int _frameIdx, int _skelIdx) const;
 
+  /// Get a view of the positions of skeleton _skelIdx in the frames that are
+  /// stored together with frame number _frameIdx: all the frames that are in
+  /// memory, or the chunk of the binary recording file that contains the
+  /// frame. The view is invalidated by any non-const function, and, for
+  /// frames read from a file, by the const getters of other chunks.
+  ConfigView getConfigView(int _frameIdx, int _skelIdx) const;
+
   /// \brief Get _dofIdx-th single configruation of a skeleton whose index is
   /// _skelIdx at frame number _frameIdx
   double getGenCoord(int _frameIdx, int _skelIdx, int _dofIdx) const;
@@ -99,8 +162,9 @@ public:
   /// _frameIdx
   Eigen::Vector3d getContactForce(int _frameIdx, int _contactIdx) const;
 
-  /// \brief Clear the saved histories
-  void clear();  
+  /// \brief Clear the saved histories. A writable recording file is restarted
+  /// and a read-only one is closed.
+  void clear();
 
   /// \brief Add state
   void addState(const Eigen::VectorXd& _state);
@@ -108,12 +172,126 @@ public:
   /// \brief Update list for number of generalized coordinates
   void updateNumGenCoords(const std::vector<dynamics::SkeletonPtr>& _skeletons);
 
+  /// Discard the frames and write the frames added from now on to the binary
+  /// recording file _fileName instead of keeping them in memory. Only the
+  /// frames of the chunk that is being filled are kept in memory. Return
+  /// false if the file cannot be created.
+  bool startStreaming(const std::string& _fileName,
+                      const FileOptions& _options = FileOptions());
+
+  /// Return true if the frames are backed by a binary recording file
+  bool isStreaming() const;
+
+  /// Finish writing the binary recording file and close it. The recording is
+  /// empty afterwards.
+  void closeFile();
+
+  /// Write all the frames to the binary recording file _fileName
+  bool saveFile(const std::string& _fileName,
+                const FileOptions& _options = FileOptions()) const;
+
+  /// Discard the frames and open the binary recording file _fileName. The
+  /// frames are read from the file on demand, and the frames added afterwards
+  /// are appended to it unless the file is read-only. Files that were not
+  /// closed properly are recovered up to their last complete chunk.
+  bool loadFile(const std::string& _fileName);
+
+  /// Return true if _fileName is a binary recording file
+  static bool isRecordingFile(const std::string& _fileName);
+
 private:
-  /// \brief Baked states
-  std::vector<Eigen::VectorXd> mBakedStates;
+  /// Frames stored as a structure of arrays
+  struct Frames
+  {
+    /// Generalized positions of each skeleton, frame after frame
+    std::vector<std::vector<double>> mPositions;
+
+    /// Contact points and forces of all the frames, frame after frame
+    std::vector<double> mContacts;
+
+    /// Offsets of the contacts of each frame in mContacts, followed by the
+    /// size of mContacts
+    std::vector<size_t> mContactOffsets;
+
+    /// Constructor
+    Frames();
+
+    /// Get number of frames
+    size_t getNumFrames() const;
+
+    /// Remove all the frames
+    void clear();
+
+    /// Add a state whose positions are split at _genCoordOffsets
+    void addState(const Eigen::VectorXd& _state,
+                  const std::vector<size_t>& _genCoordOffsets);
+
+    /// Get the state at frame number _frameIdx
+    Eigen::VectorXd getState(size_t _frameIdx,
+                             const std::vector<size_t>& _genCoordOffsets) const;
+  };
+
+  /// Get the frames that contain frame number _frameIdx, and the index of the
+  /// frame in them. mCacheMutex must be locked while the frames are used.
+  const Frames& getFrames(int _frameIdx, size_t& _localIdx) const;
+
+  /// Update mGenCoordOffsets and rearrange the baked frames accordingly
+  void updateGenCoordOffsets();
+
+  /// Write the header of a new binary recording file
+  void writeHeader();
+
+  /// Encode the pending frames into a chunk and append it to the file
+  void writeChunk();
+
+  /// Write the index of the chunks at the end of the file
+  void writeIndex();
+
+  /// Decode the chunk at _offset; return false if it is invalid
+  bool readChunk(uint64_t _offset, std::vector<Eigen::VectorXd>& _states,
+                 std::vector<int>& _skelDofs) const;
+
+  /// \brief Baked frames. If the frames are streamed to a file, these are the
+  /// frames that are not written to the file yet.
+  Frames mBakedFrames;
+
+  /// Binary recording file; nullptr if the frames are kept in memory
+  std::unique_ptr<std::fstream> mFile;
+
+  /// Name of mFile
+  std::string mFileName;
+
+  /// True if the frames cannot be appended to mFile
+  bool mReadOnly;
+
+  /// Options of mFile
+  FileOptions mFileOptions;
+
+  /// Offsets of the chunks in mFile
+  std::vector<uint64_t> mChunkOffsets;
+
+  /// Offset in mFile where the next chunk will be written
+  uint64_t mEndOffset;
+
+  /// Number of frames stored in the chunks of mFile
+  size_t mNumFileFrames;
+
+  /// Index of the chunk in mCachedFrames
+  mutable int mCachedChunk;
+
+  /// Decoded frames of the most recently read chunk
+  mutable Frames mCachedFrames;
+
+  /// Serializes the reads of mFile and the updates of mCachedFrames by the
+  /// const getters
+  mutable std::mutex mCacheMutex;
 
   /// \brief Number of generalized coordinates for skeletons
   std::vector<int> mNumGenCoordsForSkeletons;
+
+  /// Offsets of the generalized coordinates of each skeleton in a state,
+  /// followed by the total number of generalized coordinates
+  std::vector<size_t> mGenCoordOffsets;
 };
 
 }  // namespace simulation
@@ -42,32 +42,57 @@
 
 #include "dart/simulation/World.h"
 
+#include <algorithm>
+#include <atomic>
+#include <cmath>
 #include <iostream>
+#include <limits>
 #include <string>
 #include <vector>
 
 #include "dart/common/Console.h"
 #include "dart/integration/SemiImplicitEulerIntegrator.h"
+#include "dart/dynamics/BodyNode.h"
+#include "dart/dynamics/DegreeOfFreedom.h"
 #include "dart/dynamics/Skeleton.h"
 #include "dart/constraint/ConstraintSolver.h"
 
 namespace dart {
 namespace simulation {
 
+namespace {
+
+/// ID of the next World
+std::atomic<size_t> gNextWorldId(0);
+
+/// Island of the skeletons that are not sleeping
+const size_t NO_ISLAND = static_cast<size_t>(-1);
+
+} // anonymous namespace
+
 //==============================================================================
 World::World(const std::string& _name)
   : mName(_name),
+    mId(gNextWorldId++),
     mNameMgrForSkeletons("World::Skeleton | " + _name, "skeleton"),
     mNameMgrForSimpleFrames("World::SimpleFrame | " + _name, "frame"),
     mGravity(0.0, 0.0, -9.81),
     mTimeStep(0.001),
     mTime(0.0),
     mFrame(0),
+    mNumThreads(1),
+    mIsSleepingEnabled(false),
+    mSleepVelocityThreshold(1e-2),
+    mSleepTime(0.5),
+    mNextIsland(0),
     mConstraintSolver(new constraint::ConstraintSolver(mTimeStep)),
     mRecording(new Recording(mSkeletons)),
     onNameChanged(mNameChangedSignal)
 {
   mIndices.push_back(0);
+#ifdef DART_ENABLE_PROFILING
+  mConstraintSolver->setProfiler(&mProfiler);
+#endif
 }
 
 //==============================================================================
@@ -90,6 +115,10 @@ WorldPtr World::clone() const
 
   worldClone->setGravity(mGravity);
   worldClone->setTimeStep(mTimeStep);
+  worldClone->setNumThreads(mNumThreads);
+  worldClone->setSleepingEnabled(mIsSleepingEnabled);
+  worldClone->setSleepVelocityThreshold(mSleepVelocityThreshold);
+  worldClone->setSleepTime(mSleepTime);
 
   // Clone and add each Skeleton
   for(size_t i=0; i<mSkeletons.size(); ++i)
@@ -148,18 +177,43 @@ void World::reset()
   mTime = 0.0;
   mFrame = 0;
   mRecording->clear();
+
+  mConstraintSolver->reset();
+
+  wakeUpAllSkeletons();
+  std::fill(mRestTimes.begin(), mRestTimes.end(), 0.0);
 }
 
 //==============================================================================
 void World::step(bool _resetCommand)
 {
-  // Integrate velocity for unconstrained skeletons
-  for (auto& skel : mSkeletons)
+  // The skeletons are independent of each other until the constraints are
+  // solved, so they can be stepped in parallel without changing the results
+  const int numSkeletons = static_cast<int>(mSkeletons.size());
+  const int numThreads = static_cast<int>(mNumThreads);
+
+  DART_PROFILE_BEGIN_STEP(&mProfiler);
+
+  wakeUpDisturbedSkeletons();
+
+  // Integrate velocity for unconstrained skeletons. Sleeping skeletons are
+  // skipped until they wake up.
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(numThreads) if(numThreads > 1) \
+  schedule(dynamic)
+#endif
+  for (int i = 0; i < numSkeletons; ++i)
   {
-    if (!skel->isMobile())
+    const dynamics::SkeletonPtr& skel = mSkeletons[i];
+
+    if (!skel->isMobile() || skel->isSleeping())
       continue;
 
+    DART_PROFILE_BEGIN(dynamicsTimer, &mProfiler, FORWARD_DYNAMICS);
     skel->computeForwardDynamics();
+    DART_PROFILE_END(dynamicsTimer);
+
+    DART_PROFILE_SCOPE(&mProfiler, INTEGRATION);
     skel->integrateVelocities(mTimeStep);
   }
 
@@ -167,18 +221,34 @@ void World::step(bool _resetCommand)
   mConstraintSolver->solve();
 
   // Compute velocity changes given constraint impulses
-  for (auto& skel : mSkeletons)
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(numThreads) if(numThreads > 1) \
+  schedule(dynamic)
+#endif
+  for (int i = 0; i < numSkeletons; ++i)
   {
+    const dynamics::SkeletonPtr& skel = mSkeletons[i];
+
     if (!skel->isMobile())
       continue;
 
-    if (skel->isImpulseApplied())
+    if (skel->isSleeping())
     {
-      skel->computeImpulseForwardDynamics();
       skel->setImpulseApplied(false);
     }
-
-    skel->integratePositions(mTimeStep);
+    else
+    {
+      if (skel->isImpulseApplied())
+      {
+        DART_PROFILE_SCOPE(&mProfiler, IMPULSE_DYNAMICS);
+        skel->computeImpulseForwardDynamics();
+        skel->setImpulseApplied(false);
+      }
+
+      DART_PROFILE_BEGIN(integrationTimer, &mProfiler, INTEGRATION);
+      skel->integratePositions(mTimeStep);
+      DART_PROFILE_END(integrationTimer);
+    }
 
     if (_resetCommand)
     {
@@ -189,8 +259,13 @@ void World::step(bool _resetCommand)
     }
   }
 
+  if (mIsSleepingEnabled)
+    updateSleepingSkeletons();
+
   mTime += mTimeStep;
   mFrame++;
+
+  DART_PROFILE_END_STEP(&mProfiler);
 }
 
 //==============================================================================
@@ -205,6 +280,75 @@ double World::getTime() const
   return mTime;
 }
 
+//==============================================================================
+void World::setNumThreads(size_t _numThreads)
+{
+  if (_numThreads == 0)
+  {
+    dtwarn << "[World::setNumThreads] Number of threads should be positive. "
+           << "It is set to 1." << std::endl;
+    _numThreads = 1;
+  }
+
+#ifndef _OPENMP
+  if (_numThreads > 1)
+  {
+    dtwarn << "[World::setNumThreads] DART is built without OpenMP, so the "
+           << "world is stepped serially." << std::endl;
+  }
+#endif
+
+  mNumThreads = _numThreads;
+  mConstraintSolver->setNumThreads(_numThreads);
+}
+
+//==============================================================================
+size_t World::getNumThreads() const
+{
+  return mNumThreads;
+}
+
+//==============================================================================
+void World::setSleepingEnabled(bool _enabled)
+{
+  mIsSleepingEnabled = _enabled;
+
+  if (!mIsSleepingEnabled)
+    wakeUpAllSkeletons();
+
+  std::fill(mRestTimes.begin(), mRestTimes.end(), 0.0);
+}
+
+//==============================================================================
+bool World::isSleepingEnabled() const
+{
+  return mIsSleepingEnabled;
+}
+
+//==============================================================================
+void World::setSleepVelocityThreshold(double _threshold)
+{
+  mSleepVelocityThreshold = _threshold;
+}
+
+//==============================================================================
+double World::getSleepVelocityThreshold() const
+{
+  return mSleepVelocityThreshold;
+}
+
+//==============================================================================
+void World::setSleepTime(double _time)
+{
+  mSleepTime = _time;
+}
+
+//==============================================================================
+double World::getSleepTime() const
+{
+  return mSleepTime;
+}
+
 //==============================================================================
 int World::getSimFrames() const
 {
@@ -239,6 +383,10 @@ const std::string& World::getName() const
 //==============================================================================
 void World::setGravity(const Eigen::Vector3d& _gravity)
 {
+  // The skeletons sleeping under the old gravity may not rest anymore
+  if (_gravity != mGravity)
+    wakeUpAllSkeletons();
+
   mGravity = _gravity;
   for (std::vector<dynamics::SkeletonPtr>::iterator it = mSkeletons.begin();
        it != mSkeletons.end(); ++it)
@@ -296,6 +444,10 @@ std::string World::addSkeleton(dynamics::SkeletonPtr _skeleton)
 
   mSkeletons.push_back(_skeleton);
   mMapForSkeletons[_skeleton] = _skeleton;
+  mRestTimes.push_back(0.0);
+  mIslands.push_back(NO_ISLAND);
+  mSupports.push_back(std::vector<size_t>());
+  mPoses.push_back(Eigen::VectorXd());
 
   mNameConnectionsForSkeletons.push_back(_skeleton->onNameChanged.connect(
         [=](dynamics::ConstMetaSkeletonPtr skel,
@@ -346,6 +498,11 @@ void World::removeSkeleton(dynamics::SkeletonPtr _skeleton)
     return;
   }
 
+  // The skeletons sleeping with or on _skeleton lose their support
+  if (_skeleton->isSleeping())
+    wakeUpIsland(index);
+  wakeUpSupportedSkeletons(index);
+
   // Update mIndices.
   for (size_t i = index+1; i < mSkeletons.size() - 1; ++i)
     mIndices[i] = mIndices[i+1] - _skeleton->getNumDofs();
@@ -357,6 +514,19 @@ void World::removeSkeleton(dynamics::SkeletonPtr _skeleton)
   // Remove _skeleton from mSkeletons
   mSkeletons.erase(remove(mSkeletons.begin(), mSkeletons.end(), _skeleton),
                    mSkeletons.end());
+  mRestTimes.erase(mRestTimes.begin() + index);
+  mIslands.erase(mIslands.begin() + index);
+  mSupports.erase(mSupports.begin() + index);
+  mPoses.erase(mPoses.begin() + index);
+  for (std::vector<size_t>& supports : mSupports)
+  {
+    for (size_t& support : supports)
+    {
+      if (support > index)
+        --support;
+    }
+  }
+  _skeleton->setSleeping(false);
 
   // Disconnect the name change monitor
   mNameConnectionsForSkeletons[index].disconnect();
@@ -531,6 +701,280 @@ Recording* World::getRecording()
   return mRecording;
 }
 
+#ifdef DART_ENABLE_PROFILING
+//==============================================================================
+common::Profiler* World::getProfiler()
+{
+  return &mProfiler;
+}
+
+//==============================================================================
+const common::Profiler* World::getProfiler() const
+{
+  return &mProfiler;
+}
+#endif
+
+//==============================================================================
+void World::wakeUpDisturbedSkeletons()
+{
+  // The poses of the immobile skeletons are only tracked while some skeleton
+  // is sleeping
+  bool hasSleepingSkeleton = false;
+  for (const dynamics::SkeletonPtr& skel : mSkeletons)
+  {
+    if (skel->isSleeping())
+    {
+      hasSleepingSkeleton = true;
+      break;
+    }
+  }
+
+  if (!hasSleepingSkeleton)
+    return;
+
+  for (size_t k = 0; k < mSkeletons.size(); ++k)
+  {
+    const dynamics::SkeletonPtr& skel = mSkeletons[k];
+
+    // Immobile skeletons are only moved by the user, and their velocities
+    // move the skeletons in contact with them
+    if (!skel->isMobile())
+    {
+      bool isMoved = updatePose(k, true);
+      for (size_t i = 0; i < skel->getNumDofs() && !isMoved; ++i)
+        isMoved = skel->getDof(i)->getVelocity() != 0.0;
+
+      if (isMoved)
+      {
+        wakeUpSupportedSkeletons(k);
+        updatePose(k, false);
+      }
+
+      continue;
+    }
+
+    if (!skel->isSleeping())
+      continue;
+
+    // The velocities of a sleeping skeleton are zero and it is not
+    // integrated, so the skeleton is only disturbed by the user
+    bool isDisturbed = updatePose(k, true);
+    for (size_t i = 0; i < skel->getNumDofs() && !isDisturbed; ++i)
+    {
+      const dynamics::DegreeOfFreedom* dof = skel->getDof(i);
+      isDisturbed = dof->getVelocity() != 0.0 || dof->getForce() != 0.0
+          || dof->getCommand() != 0.0;
+    }
+
+    for (size_t i = 0; i < skel->getNumBodyNodes() && !isDisturbed; ++i)
+      isDisturbed = !skel->getBodyNode(i)->getExternalForceLocal().isZero(0.0);
+
+    if (isDisturbed)
+      wakeUpIsland(k);
+  }
+}
+
+//==============================================================================
+void World::wakeUpIsland(size_t _index)
+{
+  const size_t island = mIslands[_index];
+  for (size_t i = 0; i < mSkeletons.size(); ++i)
+  {
+    if (i != _index && (island == NO_ISLAND || mIslands[i] != island))
+      continue;
+
+    mSkeletons[i]->setSleeping(false);
+    mIslands[i] = NO_ISLAND;
+    mSupports[i].clear();
+  }
+}
+
+//==============================================================================
+void World::wakeUpSupportedSkeletons(size_t _index)
+{
+  for (size_t i = 0; i < mSkeletons.size(); ++i)
+  {
+    if (mSkeletons[i]->isSleeping()
+        && std::find(mSupports[i].begin(), mSupports[i].end(), _index)
+           != mSupports[i].end())
+    {
+      wakeUpIsland(i);
+    }
+  }
+}
+
+//==============================================================================
+void World::wakeUpAllSkeletons()
+{
+  for (size_t i = 0; i < mSkeletons.size(); ++i)
+  {
+    mSkeletons[i]->setSleeping(false);
+    mIslands[i] = NO_ISLAND;
+    mSupports[i].clear();
+  }
+}
+
+//==============================================================================
+bool World::updatePose(size_t _index, bool _compare)
+{
+  const dynamics::SkeletonPtr& skel = mSkeletons[_index];
+  Eigen::VectorXd& pose = mPoses[_index];
+
+  const size_t numDofs = skel->getNumDofs();
+  const size_t numTrees = skel->getNumTrees();
+  const size_t size = numDofs + 12 * numTrees;
+  if (static_cast<size_t>(pose.size()) != size)
+  {
+    if (_compare)
+      return true;
+
+    pose.resize(size);
+  }
+
+  bool isChanged = false;
+  double* data = pose.data();
+  const auto update = [&](double _value)
+  {
+    if (_compare)
+      isChanged = isChanged || *data != _value;
+    else
+      *data = _value;
+    ++data;
+  };
+
+  for (size_t i = 0; i < numDofs; ++i)
+    update(skel->getDof(i)->getPosition());
+
+  for (size_t i = 0; i < numTrees; ++i)
+  {
+    const Eigen::Isometry3d& tf = skel->getRootBodyNode(i)->getTransform();
+    for (int col = 0; col < 4; ++col)
+    {
+      for (int row = 0; row < 3; ++row)
+        update(tf(row, col));
+    }
+  }
+
+  return isChanged;
+}
+
+//==============================================================================
+void World::updateSleepingSkeletons()
+{
+  // The skeletons constrained with each other go to sleep together, so the
+  // constrained groups of the last solve are the islands of the skeletons
+  const size_t numGroups = mConstraintSolver->getNumConstrainedGroups();
+  mGroupRestTimes.assign(numGroups, std::numeric_limits<double>::infinity());
+  mGroupIslands.assign(numGroups, NO_ISLAND);
+
+  for (size_t i = 0; i < mSkeletons.size(); ++i)
+  {
+    const dynamics::SkeletonPtr& skel = mSkeletons[i];
+    if (!skel->isMobile() || skel->isSleeping())
+      continue;
+
+    // The skeletons woken up by the constraint solver leave their islands
+    mIslands[i] = NO_ISLAND;
+    mSupports[i].clear();
+
+    bool isResting = true;
+    for (size_t j = 0; j < skel->getNumDofs() && isResting; ++j)
+    {
+      isResting = std::abs(skel->getDof(j)->getVelocity())
+          < mSleepVelocityThreshold;
+    }
+
+    mRestTimes[i] = isResting ? mRestTimes[i] + mTimeStep : 0.0;
+
+    const size_t group = mConstraintSolver->getConstrainedGroupIndex(i);
+    if (group != constraint::ConstraintSolver::NO_CONSTRAINED_GROUP)
+      mGroupRestTimes[group] = std::min(mGroupRestTimes[group], mRestTimes[i]);
+  }
+
+  bool hasNewSleepingSkeleton = false;
+  for (size_t i = 0; i < mSkeletons.size(); ++i)
+  {
+    const dynamics::SkeletonPtr& skel = mSkeletons[i];
+    if (!skel->isMobile() || skel->isSleeping())
+      continue;
+
+    const size_t group = mConstraintSolver->getConstrainedGroupIndex(i);
+    const double restTime
+        = group == constraint::ConstraintSolver::NO_CONSTRAINED_GROUP
+          ? mRestTimes[i] : mGroupRestTimes[group];
+    if (restTime < mSleepTime)
+      continue;
+
+    // The rest time starts over when the skeleton wakes up
+    skel->setSleeping(true);
+    skel->setVelocities(Eigen::VectorXd::Zero(skel->getNumDofs()));
+    skel->setAccelerations(Eigen::VectorXd::Zero(skel->getNumDofs()));
+    mRestTimes[i] = 0.0;
+
+    if (group == constraint::ConstraintSolver::NO_CONSTRAINED_GROUP)
+    {
+      mIslands[i] = mNextIsland++;
+    }
+    else
+    {
+      if (mGroupIslands[group] == NO_ISLAND)
+        mGroupIslands[group] = mNextIsland++;
+      mIslands[i] = mGroupIslands[group];
+    }
+
+    updatePose(i, false);
+    hasNewSleepingSkeleton = true;
+  }
+
+  if (!hasNewSleepingSkeleton)
+    return;
+
+  // Remember the immobile skeletons that the new sleeping skeletons are in
+  // contact with, whose contacts are not detected while they sleep
+  const auto findIndex = [this](const dynamics::BodyNodePtr& _bodyNode)
+  {
+    return static_cast<size_t>(
+          std::find(mSkeletons.begin(), mSkeletons.end(),
+                    _bodyNode->getSkeleton()) - mSkeletons.begin());
+  };
+
+  const auto addSupport = [this](size_t _index, size_t _support)
+  {
+    if (!mSkeletons[_index]->isSleeping() || mSkeletons[_support]->isMobile())
+      return;
+
+    std::vector<size_t>& supports = mSupports[_index];
+    if (std::find(supports.begin(), supports.end(), _support) == supports.end())
+      supports.push_back(_support);
+  };
+
+  const collision::CollisionDetector* detector
+      = mConstraintSolver->getCollisionDetector();
+  for (const collision::Contact& contact : detector->getContacts())
+  {
+    const dynamics::BodyNodePtr bodyNode1 = contact.bodyNode1.lock();
+    const dynamics::BodyNodePtr bodyNode2 = contact.bodyNode2.lock();
+    if (!bodyNode1 || !bodyNode2)
+      continue;
+
+    const size_t index1 = findIndex(bodyNode1);
+    const size_t index2 = findIndex(bodyNode2);
+    if (index1 >= mSkeletons.size() || index2 >= mSkeletons.size())
+      continue;
+
+    addSupport(index1, index2);
+    addSupport(index2, index1);
+  }
+
+  // The immobile skeletons are moved if their poses change from now on
+  for (size_t i = 0; i < mSkeletons.size(); ++i)
+  {
+    if (!mSkeletons[i]->isMobile())
+      updatePose(i, false);
+  }
+}
+
 //==============================================================================
 void World::handleSkeletonNameChange(
     dynamics::ConstMetaSkeletonPtr _skeleton)
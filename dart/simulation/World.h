@@ -50,6 +50,7 @@
 #include <Eigen/Dense>
 
 #include "dart/common/Timer.h"
+#include "dart/common/Profiler.h"
 #include "dart/common/NameManager.h"
 #include "dart/common/Subject.h"
 #include "dart/simulation/Recording.h"
@@ -178,7 +179,10 @@ public:
   // Simulation
   //--------------------------------------------------------------------------
 
-  /// Reset the time, frame counter and recorded histories
+  /// Reset the time, frame counter and recorded histories. The contacts and
+  /// constraint impulses that the next step would reuse are discarded and
+  /// every skeleton is woken up, so that stepping from a reset world doesn't
+  /// depend on what happened before the reset.
   void reset();
 
   /// Calculate the dynamics and integrate the world for one step
@@ -198,6 +202,55 @@ public:
   /// getSimpleFrame()
   int getSimFrames() const;
 
+  /// Set the number of threads that step the skeletons and solve the
+  /// constrained groups in parallel. The default is 1, which steps everything
+  /// serially. The results don't depend on the number of threads. This has no
+  /// effect if DART is built without OpenMP.
+  void setNumThreads(size_t _numThreads);
+
+  /// Get the number of threads used to step this world
+  size_t getNumThreads() const;
+
+  //--------------------------------------------------------------------------
+  // Sleeping
+  //--------------------------------------------------------------------------
+
+  /// Enable or disable sleeping, which is disabled by default.
+  ///
+  /// When sleeping is enabled, a mobile skeleton whose generalized velocities
+  /// stay below the sleep velocity threshold for the sleep time goes to sleep
+  /// together with the skeletons it is constrained with, which form its
+  /// island. A sleeping skeleton is not simulated, and it is not checked for
+  /// collision with other sleeping skeletons or with immobile skeletons.
+  ///
+  /// A sleeping skeleton wakes up along with its island when
+  /// - it comes into contact or is constrained with an awake skeleton, in
+  ///   which case it is simulated from the same step on;
+  /// - any of its velocities, forces, commands or external forces is set to
+  ///   nonzero, or its positions or root transforms are changed;
+  /// - another skeleton of its island, or an immobile skeleton that it was in
+  ///   contact with when it went to sleep, is moved, gets nonzero velocities
+  ///   or is removed from this world;
+  /// - the gravity of this world is changed by setGravity().
+  ///
+  /// Disabling sleeping wakes up all the skeletons.
+  void setSleepingEnabled(bool _enabled);
+
+  /// Return true if sleeping is enabled
+  bool isSleepingEnabled() const;
+
+  /// Set the largest absolute generalized velocity of a resting skeleton
+  void setSleepVelocityThreshold(double _threshold);
+
+  /// Get the largest absolute generalized velocity of a resting skeleton
+  double getSleepVelocityThreshold() const;
+
+  /// Set how long a skeleton should rest before it goes to sleep
+  void setSleepTime(double _time);
+
+  /// Get how long a skeleton should rest before it goes to sleep
+  double getSleepTime() const;
+
   //--------------------------------------------------------------------------
   // Constraint
   //--------------------------------------------------------------------------
@@ -211,7 +264,46 @@ public:
   /// Get recording
   Recording* getRecording();
 
+  //--------------------------------------------------------------------------
+  // Profiling
+  //--------------------------------------------------------------------------
+
+#ifdef DART_ENABLE_PROFILING
+  /// Get the profiler that holds the time spent in each phase of the last
+  /// steps. The profiler is only available if DART is built with
+  /// DART_ENABLE_PROFILING.
+  common::Profiler* getProfiler();
+
+  /// Get the profiler that holds the time spent in each phase of the last
+  /// steps
+  const common::Profiler* getProfiler() const;
+#endif
+
 protected:
+  friend class WorldSnapshot;
+
+  /// Wake up the sleeping skeletons that are disturbed since they went to
+  /// sleep, and the ones that are supported by moved immobile skeletons
+  void wakeUpDisturbedSkeletons();
+
+  /// Wake up the skeleton of _index along with its island
+  void wakeUpIsland(size_t _index);
+
+  /// Wake up the islands of the sleeping skeletons that were in contact with
+  /// the immobile skeleton of _index when they went to sleep
+  void wakeUpSupportedSkeletons(size_t _index);
+
+  /// Wake up all the skeletons
+  void wakeUpAllSkeletons();
+
+  /// Write the positions and the root transforms of the skeleton of _index to
+  /// mPoses, or return true if they differ from mPoses when _compare is true
+  bool updatePose(size_t _index, bool _compare);
+
+  /// Update how long the awake skeletons have been resting, and put the
+  /// groups of the skeletons that have been resting for the sleep time to
+  /// sleep
+  void updateSleepingSkeletons();
 
   /// Register when a Skeleton's name is changed
   void handleSkeletonNameChange(dynamics::ConstMetaSkeletonPtr _skeleton);
@@ -222,6 +314,9 @@ protected:
   /// Name of this World
   std::string mName;
 
+  /// ID of this World, which is unique among all the Worlds ever created
+  size_t mId;
+
   /// Skeletons in this world
   std::vector<dynamics::SkeletonPtr> mSkeletons;
 
@@ -266,6 +361,47 @@ protected:
   /// Current simulation frame number
   int mFrame;
 
+  /// Number of threads used to step this world
+  size_t mNumThreads;
+
+  /// Whether the resting skeletons go to sleep
+  bool mIsSleepingEnabled;
+
+  /// Largest absolute generalized velocity of a resting skeleton
+  double mSleepVelocityThreshold;
+
+  /// How long a skeleton should rest before it goes to sleep
+  double mSleepTime;
+
+  /// How long each skeleton has been resting while it is awake
+  std::vector<double> mRestTimes;
+
+  /// Shortest rest time of the skeletons of each constrained group
+  std::vector<double> mGroupRestTimes;
+
+  /// Island that each sleeping skeleton went to sleep with
+  std::vector<size_t> mIslands;
+
+  /// Island of each constrained group that goes to sleep in the current step
+  std::vector<size_t> mGroupIslands;
+
+  /// ID of the next island
+  size_t mNextIsland;
+
+  /// Indices of the immobile skeletons that each sleeping skeleton was in
+  /// contact with when it went to sleep
+  std::vector<std::vector<size_t>> mSupports;
+
+  /// Positions followed by the root transforms of each sleeping or immobile
+  /// skeleton, which are compared in every step to find the skeletons moved
+  /// by the user
+  std::vector<Eigen::VectorXd> mPoses;
+
+#ifdef DART_ENABLE_PROFILING
+  /// Profiler of the steps
+  common::Profiler mProfiler;
+#endif
+
   /// Constraint solver
   constraint::ConstraintSolver* mConstraintSolver;
 
@@ -0,0 +1,314 @@
+/*
+ * Copyright (c) 2016, Graphics Lab, Georgia Tech Research Corporation
+ * Copyright (c) 2016, Humanoid Lab, Georgia Tech Research Corporation
+ * Copyright (c) 2016, Personal Robotics Lab, Carnegie Mellon University
+ * All rights reserved.
+ *
+ * This file is provided under the following "BSD-style" License:
+ *   Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following
+ *   conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ *   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ *   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ *   USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *   POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "dart/simulation/WorldBatch.h"
+
+#include <cassert>
+
+#include "dart/common/Console.h"
+#include "dart/constraint/ConstraintSolver.h"
+
+namespace dart {
+namespace simulation {
+
+//==============================================================================
+WorldBatch::WorldBatch(const WorldPtr& _world, size_t _numWorlds)
+  : mNumDofs(0),
+    mNumThreads(1)
+{
+  assert(_world != nullptr);
+
+  mDofOffsets.reserve(_world->getNumSkeletons());
+  for (size_t i = 0; i < _world->getNumSkeletons(); ++i)
+  {
+    mDofOffsets.push_back(mNumDofs);
+    mNumDofs += _world->getSkeleton(i)->getNumDofs();
+  }
+
+  // Each world is stepped by a single thread since the worlds are already
+  // stepped in parallel
+  mWorlds.reserve(_numWorlds);
+  for (size_t i = 0; i < _numWorlds; ++i)
+  {
+    mWorlds.push_back(_world->clone());
+    mWorlds.back()->setNumThreads(1);
+  }
+
+  // Cloning doesn't copy the state, so start every world from the state of the
+  // template world
+  Eigen::VectorXd state(getStateSize());
+  for (size_t i = 0; i < _world->getNumSkeletons(); ++i)
+  {
+    const dynamics::SkeletonPtr& skel = _world->getSkeleton(i);
+    const size_t numDofs = skel->getNumDofs();
+
+    state.segment(mDofOffsets[i], numDofs) = skel->getPositions();
+    state.segment(mNumDofs + mDofOffsets[i], numDofs) = skel->getVelocities();
+  }
+
+  for (size_t i = 0; i < _numWorlds; ++i)
+    setState(i, state);
+}
+
+//==============================================================================
+WorldBatch::~WorldBatch()
+{
+}
+
+//==============================================================================
+size_t WorldBatch::getNumWorlds() const
+{
+  return mWorlds.size();
+}
+
+//==============================================================================
+WorldPtr WorldBatch::getWorld(size_t _index) const
+{
+  assert(_index < mWorlds.size());
+
+  return mWorlds[_index];
+}
+
+//==============================================================================
+size_t WorldBatch::getNumDofs() const
+{
+  return mNumDofs;
+}
+
+//==============================================================================
+size_t WorldBatch::getStateSize() const
+{
+  return 2 * mNumDofs;
+}
+
+//==============================================================================
+void WorldBatch::setNumThreads(size_t _numThreads)
+{
+  if (_numThreads == 0)
+  {
+    dtwarn << "[WorldBatch::setNumThreads] Number of threads should be "
+           << "positive. It is set to 1." << std::endl;
+    _numThreads = 1;
+  }
+
+#ifndef _OPENMP
+  if (_numThreads > 1)
+  {
+    dtwarn << "[WorldBatch::setNumThreads] DART is built without OpenMP, so "
+           << "the worlds are stepped serially." << std::endl;
+  }
+#endif
+
+  mNumThreads = _numThreads;
+}
+
+//==============================================================================
+size_t WorldBatch::getNumThreads() const
+{
+  return mNumThreads;
+}
+
+//==============================================================================
+void WorldBatch::setStates(const Eigen::MatrixXd& _states)
+{
+  assert(static_cast<size_t>(_states.rows()) == getStateSize());
+  assert(static_cast<size_t>(_states.cols()) == mWorlds.size());
+
+  const int numWorlds = static_cast<int>(mWorlds.size());
+  const int numThreads = static_cast<int>(mNumThreads);
+
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(numThreads) if(numThreads > 1)
+#endif
+  for (int i = 0; i < numWorlds; ++i)
+    setState(i, _states.col(i));
+}
+
+//==============================================================================
+void WorldBatch::setState(size_t _index, const Eigen::VectorXd& _state)
+{
+  assert(_index < mWorlds.size());
+  assert(static_cast<size_t>(_state.size()) == getStateSize());
+
+  const WorldPtr& world = mWorlds[_index];
+
+  for (size_t i = 0; i < world->getNumSkeletons(); ++i)
+  {
+    const dynamics::SkeletonPtr& skel = world->getSkeleton(i);
+    const size_t numDofs = skel->getNumDofs();
+
+    skel->setPositions(_state.segment(mDofOffsets[i], numDofs));
+    skel->setVelocities(_state.segment(mNumDofs + mDofOffsets[i], numDofs));
+    skel->clearInternalForces();
+    skel->clearExternalForces();
+    skel->resetCommands();
+  }
+
+  world->reset();
+}
+
+//==============================================================================
+Eigen::MatrixXd WorldBatch::getStates() const
+{
+  Eigen::MatrixXd states(getStateSize(), mWorlds.size());
+
+  for (size_t i = 0; i < mWorlds.size(); ++i)
+    states.col(i) = getState(i);
+
+  return states;
+}
+
+//==============================================================================
+Eigen::VectorXd WorldBatch::getState(size_t _index) const
+{
+  assert(_index < mWorlds.size());
+
+  const WorldPtr& world = mWorlds[_index];
+  Eigen::VectorXd state(getStateSize());
+
+  for (size_t i = 0; i < world->getNumSkeletons(); ++i)
+  {
+    const dynamics::SkeletonPtr& skel = world->getSkeleton(i);
+    const size_t numDofs = skel->getNumDofs();
+
+    state.segment(mDofOffsets[i], numDofs) = skel->getPositions();
+    state.segment(mNumDofs + mDofOffsets[i], numDofs) = skel->getVelocities();
+  }
+
+  return state;
+}
+
+//==============================================================================
+void WorldBatch::setForces(const Eigen::MatrixXd& _forces)
+{
+  assert(static_cast<size_t>(_forces.rows()) == mNumDofs);
+  assert(static_cast<size_t>(_forces.cols()) == mWorlds.size());
+
+  for (size_t i = 0; i < mWorlds.size(); ++i)
+  {
+    const WorldPtr& world = mWorlds[i];
+
+    for (size_t j = 0; j < world->getNumSkeletons(); ++j)
+    {
+      const dynamics::SkeletonPtr& skel = world->getSkeleton(j);
+      skel->setForces(_forces.col(i).segment(mDofOffsets[j],
+                                             skel->getNumDofs()));
+    }
+  }
+}
+
+//==============================================================================
+Eigen::MatrixXd WorldBatch::getPositions() const
+{
+  Eigen::MatrixXd positions(mNumDofs, mWorlds.size());
+
+  for (size_t i = 0; i < mWorlds.size(); ++i)
+  {
+    const WorldPtr& world = mWorlds[i];
+
+    for (size_t j = 0; j < world->getNumSkeletons(); ++j)
+    {
+      const dynamics::SkeletonPtr& skel = world->getSkeleton(j);
+      positions.col(i).segment(mDofOffsets[j], skel->getNumDofs())
+          = skel->getPositions();
+    }
+  }
+
+  return positions;
+}
+
+//==============================================================================
+Eigen::MatrixXd WorldBatch::getVelocities() const
+{
+  Eigen::MatrixXd velocities(mNumDofs, mWorlds.size());
+
+  for (size_t i = 0; i < mWorlds.size(); ++i)
+  {
+    const WorldPtr& world = mWorlds[i];
+
+    for (size_t j = 0; j < world->getNumSkeletons(); ++j)
+    {
+      const dynamics::SkeletonPtr& skel = world->getSkeleton(j);
+      velocities.col(i).segment(mDofOffsets[j], skel->getNumDofs())
+          = skel->getVelocities();
+    }
+  }
+
+  return velocities;
+}
+
+//==============================================================================
+std::vector<size_t> WorldBatch::getNumContacts() const
+{
+  std::vector<size_t> numContacts(mWorlds.size());
+
+  for (size_t i = 0; i < mWorlds.size(); ++i)
+  {
+    numContacts[i] = mWorlds[i]->getConstraintSolver()
+        ->getCollisionDetector()->getNumContacts();
+  }
+
+  return numContacts;
+}
+
+//==============================================================================
+std::vector<collision::Contact> WorldBatch::getContacts() const
+{
+  std::vector<collision::Contact> contacts;
+
+  for (size_t i = 0; i < mWorlds.size(); ++i)
+  {
+    collision::CollisionDetector* cd
+        = mWorlds[i]->getConstraintSolver()->getCollisionDetector();
+
+    for (size_t j = 0; j < cd->getNumContacts(); ++j)
+      contacts.push_back(cd->getContact(j));
+  }
+
+  return contacts;
+}
+
+//==============================================================================
+void WorldBatch::step(bool _resetCommand)
+{
+  const int numWorlds = static_cast<int>(mWorlds.size());
+  const int numThreads = static_cast<int>(mNumThreads);
+
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(numThreads) if(numThreads > 1) \
+  schedule(dynamic)
+#endif
+  for (int i = 0; i < numWorlds; ++i)
+    mWorlds[i]->step(_resetCommand);
+}
+
+}  // namespace simulation
+}  // namespace dart
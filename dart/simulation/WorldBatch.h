@@ -0,0 +1,134 @@
+/*
+ * Copyright (c) 2016, Graphics Lab, Georgia Tech Research Corporation
+ * Copyright (c) 2016, Humanoid Lab, Georgia Tech Research Corporation
+ * Copyright (c) 2016, Personal Robotics Lab, Carnegie Mellon University
+ * All rights reserved.
+ *
+ * This file is provided under the following "BSD-style" License:
+ *   Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following
+ *   conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ *   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ *   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ *   USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *   POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef DART_SIMULATION_WORLDBATCH_H_
+#define DART_SIMULATION_WORLDBATCH_H_
+
+#include <vector>
+
+#include <Eigen/Dense>
+
+#include "dart/collision/CollisionDetector.h"
+#include "dart/simulation/World.h"
+
+namespace dart {
+namespace simulation {
+
+/// WorldBatch holds a number of copies of a template world and steps them
+/// together, which is useful to run many short rollouts of the same scene.
+///
+/// The copies are created once by cloning the template world. After that, the
+/// worlds are reset by setting their states rather than by cloning again. The
+/// state of a world is the positions of all the skeletons in the world order
+/// followed by their velocities. The stacked quantities have one column per
+/// world.
+class WorldBatch
+{
+public:
+  /// Constructor. The template world is cloned _numWorlds times.
+  WorldBatch(const WorldPtr& _world, size_t _numWorlds);
+
+  /// Destructor
+  virtual ~WorldBatch();
+
+  /// Get the number of worlds
+  size_t getNumWorlds() const;
+
+  /// Get the _index-th world
+  WorldPtr getWorld(size_t _index) const;
+
+  /// Get the number of degrees of freedom of each world
+  size_t getNumDofs() const;
+
+  /// Get the size of the state of each world, which is twice the number of
+  /// degrees of freedom
+  size_t getStateSize() const;
+
+  /// Set the number of threads that step the worlds in parallel. The results
+  /// don't depend on the number of threads. This has no effect if DART is built
+  /// without OpenMP.
+  void setNumThreads(size_t _numThreads);
+
+  /// Get the number of threads that step the worlds
+  size_t getNumThreads() const;
+
+  /// Reset every world to the state in the corresponding column of _states.
+  /// The time, the forces, the contacts and the warm starts of the constraint
+  /// solver are reset as well, so every episode runs independently of the
+  /// previous ones.
+  void setStates(const Eigen::MatrixXd& _states);
+
+  /// Reset the _index-th world to _state
+  void setState(size_t _index, const Eigen::VectorXd& _state);
+
+  /// Get the stacked states of the worlds
+  Eigen::MatrixXd getStates() const;
+
+  /// Get the state of the _index-th world
+  Eigen::VectorXd getState(size_t _index) const;
+
+  /// Set the stacked generalized forces that are applied in the next step
+  void setForces(const Eigen::MatrixXd& _forces);
+
+  /// Get the stacked positions of the worlds
+  Eigen::MatrixXd getPositions() const;
+
+  /// Get the stacked velocities of the worlds
+  Eigen::MatrixXd getVelocities() const;
+
+  /// Get the number of contacts of each world from the last step
+  std::vector<size_t> getNumContacts() const;
+
+  /// Get the contacts of all the worlds from the last step, stacked in the
+  /// world order. Use getNumContacts() to find the contacts of each world.
+  std::vector<collision::Contact> getContacts() const;
+
+  /// Step every world forward by one time step
+  void step(bool _resetCommand = true);
+
+protected:
+  /// Worlds cloned from the template world
+  std::vector<WorldPtr> mWorlds;
+
+  /// Index of the first degree of freedom of each skeleton in the state
+  std::vector<size_t> mDofOffsets;
+
+  /// Number of degrees of freedom of each world
+  size_t mNumDofs;
+
+  /// Number of threads that step the worlds
+  size_t mNumThreads;
+};
+
+}  // namespace simulation
+}  // namespace dart
+
+#endif  // DART_SIMULATION_WORLDBATCH_H_
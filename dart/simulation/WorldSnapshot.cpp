@@ -0,0 +1,292 @@
+/*
+ * Copyright (c) 2016, Graphics Lab, Georgia Tech Research Corporation
+ * Copyright (c) 2016, Humanoid Lab, Georgia Tech Research Corporation
+ * Copyright (c) 2016, Personal Robotics Lab, Carnegie Mellon University
+ * All rights reserved.
+ *
+ * This file is provided under the following "BSD-style" License:
+ *   Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following
+ *   conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ *   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ *   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ *   USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *   POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "dart/simulation/WorldSnapshot.h"
+
+#include <algorithm>
+
+#include "dart/common/Console.h"
+#include "dart/constraint/ConstraintSolver.h"
+#include "dart/dynamics/DegreeOfFreedom.h"
+#include "dart/dynamics/PointMass.h"
+#include "dart/dynamics/SoftBodyNode.h"
+
+namespace dart {
+namespace simulation {
+
+//==============================================================================
+WorldSnapshot::WorldSnapshot()
+  : mWorldId(0),
+    mNextIsland(0)
+{
+  // Do nothing
+}
+
+//==============================================================================
+WorldSnapshot::WorldSnapshot(const World& _world)
+  : mWorldId(0),
+    mNextIsland(0)
+{
+  capture(_world);
+}
+
+//==============================================================================
+WorldSnapshot::~WorldSnapshot()
+{
+  // Do nothing
+}
+
+//==============================================================================
+void WorldSnapshot::capture(const World& _world)
+{
+  constraint::ConstraintSolver* solver = _world.getConstraintSolver();
+
+  // The time and the frame counter are followed by the states of the
+  // skeletons and the warm start state of the constraint solver
+  size_t size = 2;
+  mStructure.clear();
+  mSkeletons.clear();
+  for (const dynamics::SkeletonPtr& skel : _world.mSkeletons)
+  {
+    mSkeletons.push_back(skel);
+
+    size_t numPointMasses = 0;
+    for (size_t i = 0; i < skel->getNumSoftBodyNodes(); ++i)
+      numPointMasses += skel->getSoftBodyNode(i)->getNumPointMasses();
+
+    mStructure.push_back(skel->getNumDofs());
+    mStructure.push_back(numPointMasses);
+    size += 2 + 5 * skel->getNumDofs() + 12 * numPointMasses;
+  }
+  size += solver->getWarmStartStateSize();
+
+  mWorldId = _world.mId;
+  mData.resize(size);
+
+  double* data = mData.data();
+  *data++ = _world.mTime;
+  *data++ = _world.mFrame;
+
+  for (size_t k = 0; k < _world.mSkeletons.size(); ++k)
+  {
+    const dynamics::SkeletonPtr& skel = _world.mSkeletons[k];
+    *data++ = skel->isSleeping();
+    *data++ = _world.mRestTimes[k];
+
+    const size_t numDofs = skel->getNumDofs();
+    for (size_t i = 0; i < numDofs; ++i)
+    {
+      const dynamics::DegreeOfFreedom* dof = skel->getDof(i);
+      data[i] = dof->getPosition();
+      data[numDofs + i] = dof->getVelocity();
+      data[2 * numDofs + i] = dof->getAcceleration();
+      data[3 * numDofs + i] = dof->getForce();
+      data[4 * numDofs + i] = dof->getCommand();
+    }
+    data += 5 * numDofs;
+
+    for (size_t i = 0; i < skel->getNumSoftBodyNodes(); ++i)
+    {
+      const dynamics::SoftBodyNode* softBodyNode = skel->getSoftBodyNode(i);
+      for (size_t j = 0; j < softBodyNode->getNumPointMasses(); ++j)
+      {
+        const dynamics::PointMass* pointMass = softBodyNode->getPointMass(j);
+        Eigen::Vector3d::Map(data) = pointMass->getPositions();
+        Eigen::Vector3d::Map(data + 3) = pointMass->getVelocities();
+        Eigen::Vector3d::Map(data + 6) = pointMass->getAccelerations();
+        Eigen::Vector3d::Map(data + 9) = pointMass->getForces();
+        data += 12;
+      }
+    }
+  }
+
+  solver->getWarmStartState(data);
+  mContacts = solver->getCollisionDetector()->getContacts();
+  solver->getCollisionDetector()->getContactManifolds(mContactManifolds);
+
+  mIslands = _world.mIslands;
+  mNextIsland = _world.mNextIsland;
+  mSupports = _world.mSupports;
+  mPoses = _world.mPoses;
+}
+
+//==============================================================================
+bool WorldSnapshot::restore(World& _world) const
+{
+  if (isEmpty())
+  {
+    dterr << "[WorldSnapshot::restore] The snapshot is empty.\n";
+    return false;
+  }
+
+  if (!isCompatible(_world))
+  {
+    dterr << "[WorldSnapshot::restore] The structure of the world ["
+          << _world.getName() << "] doesn't match the snapshot.\n";
+    return false;
+  }
+
+  const double* data = mData.data();
+  _world.mTime = *data++;
+  _world.mFrame = static_cast<int>(*data++);
+
+  for (size_t k = 0; k < _world.mSkeletons.size(); ++k)
+  {
+    const dynamics::SkeletonPtr& skel = _world.mSkeletons[k];
+    skel->setSleeping(*data++ != 0.0);
+    _world.mRestTimes[k] = *data++;
+
+    // The commands are set last since setting the forces, velocities or
+    // accelerations also sets the commands of some actuator types
+    const size_t numDofs = skel->getNumDofs();
+    skel->setPositions(Eigen::Map<const Eigen::VectorXd>(data, numDofs));
+    skel->setVelocities(
+          Eigen::Map<const Eigen::VectorXd>(data + numDofs, numDofs));
+    skel->setAccelerations(
+          Eigen::Map<const Eigen::VectorXd>(data + 2 * numDofs, numDofs));
+    skel->setForces(
+          Eigen::Map<const Eigen::VectorXd>(data + 3 * numDofs, numDofs));
+    skel->setCommands(
+          Eigen::Map<const Eigen::VectorXd>(data + 4 * numDofs, numDofs));
+    data += 5 * numDofs;
+
+    for (size_t i = 0; i < skel->getNumSoftBodyNodes(); ++i)
+    {
+      dynamics::SoftBodyNode* softBodyNode = skel->getSoftBodyNode(i);
+      for (size_t j = 0; j < softBodyNode->getNumPointMasses(); ++j)
+      {
+        dynamics::PointMass* pointMass = softBodyNode->getPointMass(j);
+        pointMass->setPositions(Eigen::Map<const Eigen::Vector3d>(data));
+        pointMass->setVelocities(Eigen::Map<const Eigen::Vector3d>(data + 3));
+        pointMass->setAccelerations(
+              Eigen::Map<const Eigen::Vector3d>(data + 6));
+        pointMass->setForces(Eigen::Map<const Eigen::Vector3d>(data + 9));
+        data += 12;
+      }
+    }
+  }
+
+  // The islands and the supports refer to the skeletons by their indices, and
+  // the poses tell whether they are moved after the restoration
+  _world.mIslands = mIslands;
+  _world.mNextIsland = mNextIsland;
+  _world.mSupports = mSupports;
+  _world.mPoses = mPoses;
+
+  // The contacts refer to the bodies of the captured world, so they are only
+  // restored to that world
+  constraint::ConstraintSolver* solver = _world.getConstraintSolver();
+  if (canRestoreContacts(_world))
+  {
+    solver->getCollisionDetector()->setContacts(mContacts);
+    solver->getCollisionDetector()->setContactManifolds(mContactManifolds);
+    solver->setWarmStartState(data);
+  }
+  else
+  {
+    const double noWarmStartState[3] = {0.0, 0.0, 0.0};
+    solver->getCollisionDetector()->clearAllContacts();
+    solver->getCollisionDetector()->setContactManifolds(
+          collision::CollisionDetector::ContactManifoldMap());
+    solver->setWarmStartState(noWarmStartState);
+  }
+
+  return true;
+}
+
+//==============================================================================
+bool WorldSnapshot::isEmpty() const
+{
+  return mData.empty();
+}
+
+//==============================================================================
+const std::vector<double>& WorldSnapshot::getData() const
+{
+  return mData;
+}
+
+//==============================================================================
+bool WorldSnapshot::isCompatible(const World& _world) const
+{
+  if (mStructure.size() != 2 * _world.mSkeletons.size())
+    return false;
+
+  for (size_t i = 0; i < _world.mSkeletons.size(); ++i)
+  {
+    const dynamics::SkeletonPtr& skel = _world.mSkeletons[i];
+    if (mStructure[2 * i] != skel->getNumDofs())
+      return false;
+
+    size_t numPointMasses = 0;
+    for (size_t j = 0; j < skel->getNumSoftBodyNodes(); ++j)
+      numPointMasses += skel->getSoftBodyNode(j)->getNumPointMasses();
+    if (mStructure[2 * i + 1] != numPointMasses)
+      return false;
+  }
+
+  return true;
+}
+
+//==============================================================================
+bool WorldSnapshot::canRestoreContacts(const World& _world) const
+{
+  // The ID is compared instead of the address, which may be reused by another
+  // world after the captured one is destroyed
+  if (_world.mId != mWorldId)
+    return false;
+
+  // The skeletons may have been replaced by others with the same structure
+  for (size_t i = 0; i < _world.mSkeletons.size(); ++i)
+  {
+    if (mSkeletons[i].lock() != _world.mSkeletons[i])
+      return false;
+  }
+
+  // The BodyNodes of the contacts may have been removed or moved to other
+  // skeletons
+  for (const collision::Contact& contact : mContacts)
+  {
+    const dynamics::BodyNodePtr bodyNode1 = contact.bodyNode1.lock();
+    const dynamics::BodyNodePtr bodyNode2 = contact.bodyNode2.lock();
+    if (!bodyNode1 || !bodyNode2
+        || std::find(_world.mSkeletons.begin(), _world.mSkeletons.end(),
+                     bodyNode1->getSkeleton()) == _world.mSkeletons.end()
+        || std::find(_world.mSkeletons.begin(), _world.mSkeletons.end(),
+                     bodyNode2->getSkeleton()) == _world.mSkeletons.end())
+      return false;
+  }
+
+  return true;
+}
+
+}  // namespace simulation
+}  // namespace dart
@@ -0,0 +1,129 @@
+/*
+ * Copyright (c) 2016, Graphics Lab, Georgia Tech Research Corporation
+ * Copyright (c) 2016, Humanoid Lab, Georgia Tech Research Corporation
+ * Copyright (c) 2016, Personal Robotics Lab, Carnegie Mellon University
+ * All rights reserved.
+ *
+ * This file is provided under the following "BSD-style" License:
+ *   Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following
+ *   conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ *   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ *   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ *   USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *   POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef DART_SIMULATION_WORLDSNAPSHOT_H_
+#define DART_SIMULATION_WORLDSNAPSHOT_H_
+
+#include <memory>
+#include <vector>
+
+#include "dart/collision/CollisionDetector.h"
+#include "dart/simulation/World.h"
+
+namespace dart {
+namespace simulation {
+
+/// WorldSnapshot holds the complete dynamic state of a World so that the world
+/// can be rolled back to it, for example to branch simulations from a
+/// checkpoint.
+///
+/// The state consists of the time and the frame counter of the world, the
+/// sleeping states and the islands of the skeletons, the positions, velocities,
+/// accelerations, forces and commands of all the degrees of freedom, the
+/// states of the point masses of soft bodies, the contacts and the contact
+/// manifolds of the last step and the warm start state of the constraint
+/// solver. It is stored in a flat buffer that is reused by later captures.
+/// The contact manifolds are copied in place, so capturing and restoring the
+/// same pairs in contact repeatedly doesn't allocate memory either.
+/// The external forces of the bodies are not part of the state since they are
+/// cleared in every step.
+class WorldSnapshot
+{
+public:
+  /// Constructor. The snapshot is empty until capture() is called.
+  WorldSnapshot();
+
+  /// Constructor that captures _world
+  explicit WorldSnapshot(const World& _world);
+
+  /// Destructor
+  virtual ~WorldSnapshot();
+
+  /// Capture the state of _world
+  void capture(const World& _world);
+
+  /// Restore the captured state to _world. The state can also be restored to
+  /// a world with the same structure, such as a clone of the captured world.
+  /// The contacts and the warm start state are only restored to the captured
+  /// world if it still holds the captured skeletons and all the BodyNodes of
+  /// the contacts. Return false if the snapshot is empty or the structure of
+  /// _world doesn't match.
+  bool restore(World& _world) const;
+
+  /// Return true if nothing has been captured
+  bool isEmpty() const;
+
+  /// Get the captured state as a flat buffer
+  const std::vector<double>& getData() const;
+
+protected:
+  /// Return true if _world has the structure of the captured world
+  bool isCompatible(const World& _world) const;
+
+  /// Return true if the contacts and the warm start state can be restored to
+  /// _world, which must be compatible
+  bool canRestoreContacts(const World& _world) const;
+
+  /// ID of the world that the state is captured from
+  size_t mWorldId;
+
+  /// Skeletons of the world that the state is captured from
+  std::vector<std::weak_ptr<dynamics::Skeleton>> mSkeletons;
+
+  /// Number of degrees of freedom and number of point masses of each skeleton
+  std::vector<size_t> mStructure;
+
+  /// Captured state
+  std::vector<double> mData;
+
+  /// Contacts of the last step
+  std::vector<collision::Contact> mContacts;
+
+  /// Contact manifolds of the last step
+  collision::CollisionDetector::ContactManifoldMap mContactManifolds;
+
+  /// Island of each sleeping skeleton
+  std::vector<size_t> mIslands;
+
+  /// ID of the next island
+  size_t mNextIsland;
+
+  /// Immobile skeletons that each sleeping skeleton went to sleep on
+  std::vector<std::vector<size_t>> mSupports;
+
+  /// Poses of the sleeping and the immobile skeletons at the last step
+  std::vector<Eigen::VectorXd> mPoses;
+};
+
+}  // namespace simulation
+}  // namespace dart
+
+#endif  // DART_SIMULATION_WORLDSNAPSHOT_H_
@@ -0,0 +1,1734 @@
+/*
+ * Copyright (c) 2016, Graphics Lab, Georgia Tech Research Corporation
+ * Copyright (c) 2016, Humanoid Lab, Georgia Tech Research Corporation
+ * Copyright (c) 2016, Personal Robotics Lab, Carnegie Mellon University
+ * All rights reserved.
+ *
+ * This file is provided under the following "BSD-style" License:
+ *   Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following
+ *   conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ *   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ *   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ *   USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *   POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "dart/utils/CompiledWorld.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <set>
+
+#include <sys/stat.h>
+#ifndef _WIN32
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <unistd.h>
+#endif
+
+#include <assimp/scene.h>
+
+#include "dart/config.h"
+#include "dart/common/Console.h"
+#ifdef HAVE_BULLET_COLLISION
+  #include "dart/collision/bullet/BulletCollisionDetector.h"
+#endif
+#include "dart/collision/dart/DARTCollisionDetector.h"
+#include "dart/collision/fcl/FCLCollisionDetector.h"
+#include "dart/collision/fcl_mesh/FCLMeshCollisionDetector.h"
+#include "dart/constraint/ConstraintSolver.h"
+#include "dart/dynamics/BodyNode.h"
+#include "dart/dynamics/SoftBodyNode.h"
+#include "dart/dynamics/BoxShape.h"
+#include "dart/dynamics/CylinderShape.h"
+#include "dart/dynamics/EllipsoidShape.h"
+#include "dart/dynamics/LineSegmentShape.h"
+#include "dart/dynamics/PlaneShape.h"
+#include "dart/dynamics/MeshShape.h"
+#include "dart/dynamics/WeldJoint.h"
+#include "dart/dynamics/PrismaticJoint.h"
+#include "dart/dynamics/RevoluteJoint.h"
+#include "dart/dynamics/ScrewJoint.h"
+#include "dart/dynamics/TranslationalJoint.h"
+#include "dart/dynamics/BallJoint.h"
+#include "dart/dynamics/FreeJoint.h"
+#include "dart/dynamics/EulerJoint.h"
+#include "dart/dynamics/UniversalJoint.h"
+#include "dart/dynamics/PlanarJoint.h"
+#include "dart/dynamics/Skeleton.h"
+#include "dart/dynamics/Marker.h"
+
+namespace dart {
+namespace utils {
+
+using namespace dynamics;
+
+const unsigned int CompiledWorld::FORMAT_VERSION = 1;
+
+namespace {
+
+const char MAGIC[8] = {'D', 'A', 'R', 'T', 'W', 'L', 'D', '\0'};
+
+/// Written in the native byte order, so files written on a machine with a
+/// different byte order are rejected
+const uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+/// The file contains the state of the world
+const uint32_t FLAG_STATE = 1 << 0;
+
+enum DetectorType
+{
+  DETECTOR_UNKNOWN = 0,
+  DETECTOR_DART,
+  DETECTOR_FCL,
+  DETECTOR_FCL_MESH,
+  DETECTOR_BULLET
+};
+
+enum MaterialKey
+{
+  MATERIAL_DIFFUSE            = 1 << 0,
+  MATERIAL_SPECULAR           = 1 << 1,
+  MATERIAL_AMBIENT            = 1 << 2,
+  MATERIAL_EMISSIVE           = 1 << 3,
+  MATERIAL_SHININESS          = 1 << 4,
+  MATERIAL_SHININESS_STRENGTH = 1 << 5,
+  MATERIAL_TWO_SIDED          = 1 << 6
+};
+
+/// Bits of the vertex arrays that an aiMesh has; bit (1 + i) is the color set i
+const uint32_t MESH_NORMALS = 1 << 0;
+
+/// Maximum depth of the node hierarchy of a mesh, which bounds the recursion
+/// of readNode() on corrupted files
+const size_t MAX_NODE_DEPTH = 256;
+
+struct Source
+{
+  std::string mPath;
+  uint64_t mSize;
+  int64_t mTime;
+};
+
+//==============================================================================
+bool getFileStatus(const std::string& _path, uint64_t& _size, int64_t& _time)
+{
+  struct stat status;
+  if(stat(_path.c_str(), &status) != 0)
+    return false;
+
+  _size = static_cast<uint64_t>(status.st_size);
+#if defined(__linux__)
+  _time = static_cast<int64_t>(status.st_mtim.tv_sec) * 1000000000
+      + status.st_mtim.tv_nsec;
+#else
+  _time = static_cast<int64_t>(status.st_mtime) * 1000000000;
+#endif
+
+  return true;
+}
+
+//==============================================================================
+/// Read-only view of a whole file. The file is mapped into memory where that
+/// is supported, and read into a buffer otherwise.
+class MappedFile
+{
+public:
+  explicit MappedFile(const std::string& _fileName)
+    : mData(nullptr), mSize(0)
+  {
+#ifdef _WIN32
+    std::ifstream stream(_fileName, std::ios::binary | std::ios::ate);
+    if(!stream)
+      return;
+
+    mBuffer.resize(static_cast<size_t>(stream.tellg()));
+    stream.seekg(0);
+    if(!stream.read(mBuffer.data(), mBuffer.size()))
+      return;
+
+    mData = mBuffer.data();
+    mSize = mBuffer.size();
+#else
+    const int fd = open(_fileName.c_str(), O_RDONLY);
+    if(fd < 0)
+      return;
+
+    struct stat status;
+    if(fstat(fd, &status) == 0 && status.st_size > 0)
+    {
+      void* data = mmap(nullptr, status.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if(data != MAP_FAILED)
+      {
+        mData = static_cast<const char*>(data);
+        mSize = static_cast<size_t>(status.st_size);
+      }
+    }
+
+    close(fd);
+#endif
+  }
+
+  ~MappedFile()
+  {
+#ifndef _WIN32
+    if(mData)
+      munmap(const_cast<char*>(mData), mSize);
+#endif
+  }
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  const char* getData() const { return mData; }
+
+  size_t getSize() const { return mSize; }
+
+private:
+  const char* mData;
+  size_t mSize;
+#ifdef _WIN32
+  std::vector<char> mBuffer;
+#endif
+};
+
+//==============================================================================
+class BinaryWriter
+{
+public:
+  void writeBytes(const void* _data, size_t _size)
+  {
+    const char* data = static_cast<const char*>(_data);
+    mBuffer.insert(mBuffer.end(), data, data + _size);
+  }
+
+  template <typename T>
+  void write(const T& _value)
+  {
+    writeBytes(&_value, sizeof(T));
+  }
+
+  void writeString(const std::string& _string)
+  {
+    write<uint32_t>(_string.size());
+    writeBytes(_string.data(), _string.size());
+  }
+
+  template <int Rows, int Cols>
+  void writeMatrix(const Eigen::Matrix<double, Rows, Cols>& _matrix)
+  {
+    writeBytes(_matrix.data(), sizeof(double) * Rows * Cols);
+  }
+
+  void writeVector(const Eigen::VectorXd& _vector)
+  {
+    write<uint32_t>(_vector.size());
+    writeBytes(_vector.data(), sizeof(double) * _vector.size());
+  }
+
+  /// Write the whole buffer to _fileName. The buffer is written to a temporary
+  /// file first, so that readers never see a partially written file.
+  bool save(const std::string& _fileName) const
+  {
+    const std::string tempName = _fileName + ".tmp";
+    {
+      std::ofstream stream(tempName, std::ios::binary | std::ios::trunc);
+      if(!stream.write(mBuffer.data(), mBuffer.size()))
+        return false;
+    }
+
+    if(std::rename(tempName.c_str(), _fileName.c_str()) != 0)
+    {
+      std::remove(_fileName.c_str());
+      if(std::rename(tempName.c_str(), _fileName.c_str()) != 0)
+      {
+        std::remove(tempName.c_str());
+        return false;
+      }
+    }
+
+    return true;
+  }
+
+private:
+  std::vector<char> mBuffer;
+};
+
+//==============================================================================
+/// Bounds-checked reader of a memory block. Once a read goes out of bounds,
+/// every following read fails and isValid() returns false.
+class BinaryReader
+{
+public:
+  BinaryReader(const char* _data, size_t _size)
+    : mCurrent(_data), mEnd(_data + _size), mValid(_data != nullptr)
+  {
+    // Do nothing
+  }
+
+  bool isValid() const { return mValid; }
+
+  /// Mark the data as invalid, e.g. because it contains an index out of range
+  void invalidate() { mValid = false; }
+
+  /// Return true if _count elements of _size bytes can be read. This is used
+  /// to reject corrupted sizes before allocating memory for them.
+  bool canRead(size_t _count, size_t _size = 1) const
+  {
+    return mValid && _count <= static_cast<size_t>(mEnd - mCurrent) / _size;
+  }
+
+  bool readBytes(void* _data, size_t _count, size_t _size = 1)
+  {
+    if(!canRead(_count, _size))
+    {
+      mValid = false;
+      return false;
+    }
+
+    std::memcpy(_data, mCurrent, _count * _size);
+    mCurrent += _count * _size;
+    return true;
+  }
+
+  template <typename T>
+  T read()
+  {
+    T value = T();
+    readBytes(&value, sizeof(T));
+    return value;
+  }
+
+  /// Read the size of an array of elements of _size bytes
+  uint32_t readCount(size_t _size)
+  {
+    const uint32_t count = read<uint32_t>();
+    if(!canRead(count, _size))
+    {
+      mValid = false;
+      return 0;
+    }
+
+    return count;
+  }
+
+  std::string readString()
+  {
+    const uint32_t size = readCount(1);
+    std::string string(mCurrent, size);
+    mCurrent += size;
+    return string;
+  }
+
+  template <int Rows, int Cols>
+  Eigen::Matrix<double, Rows, Cols> readMatrix()
+  {
+    Eigen::Matrix<double, Rows, Cols> matrix
+        = Eigen::Matrix<double, Rows, Cols>::Zero();
+    readBytes(matrix.data(), Rows * Cols, sizeof(double));
+    return matrix;
+  }
+
+  Eigen::VectorXd readVector()
+  {
+    Eigen::VectorXd vector(readCount(sizeof(double)));
+    readBytes(vector.data(), vector.size(), sizeof(double));
+    return vector;
+  }
+
+private:
+  const char* mCurrent;
+  const char* mEnd;
+  bool mValid;
+};
+
+//==============================================================================
+bool readHeader(BinaryReader& _reader, uint32_t& _flags,
+                std::vector<Source>& _sources)
+{
+  char magic[sizeof(MAGIC)];
+  if(!_reader.readBytes(magic, sizeof(MAGIC))
+     || std::memcmp(magic, MAGIC, sizeof(MAGIC)) != 0)
+    return false;
+
+  if(_reader.read<uint32_t>() != CompiledWorld::FORMAT_VERSION
+     || _reader.read<uint32_t>() != BYTE_ORDER_MARK)
+    return false;
+
+  _flags = _reader.read<uint32_t>();
+
+  _sources.resize(_reader.readCount(2 * sizeof(uint64_t)));
+  for(Source& source : _sources)
+  {
+    source.mPath = _reader.readString();
+    source.mSize = _reader.read<uint64_t>();
+    source.mTime = _reader.read<int64_t>();
+  }
+
+  return _reader.isValid();
+}
+
+//==============================================================================
+/// Shapes and meshes of a world; every shape and mesh is stored once, even if
+/// it is used by several BodyNodes
+struct ShapeTable
+{
+  std::vector<const Shape*> mShapes;
+  std::map<const Shape*, uint32_t> mShapeIndices;
+
+  std::vector<const aiScene*> mMeshes;
+  std::map<const aiScene*, uint32_t> mMeshIndices;
+
+  bool addShape(const ShapePtr& _shape)
+  {
+    if(mShapeIndices.count(_shape.get()))
+      return true;
+
+    switch(_shape->getShapeType())
+    {
+      case Shape::BOX:
+      case Shape::ELLIPSOID:
+      case Shape::CYLINDER:
+      case Shape::PLANE:
+      case Shape::LINE_SEGMENT:
+        break;
+      case Shape::MESH:
+      {
+        const aiScene* mesh
+            = static_cast<const MeshShape*>(_shape.get())->getMesh();
+        if(mesh && !mMeshIndices.count(mesh))
+        {
+          mMeshIndices[mesh] = mMeshes.size();
+          mMeshes.push_back(mesh);
+        }
+        break;
+      }
+      default:
+        return false;
+    }
+
+    mShapeIndices[_shape.get()] = mShapes.size();
+    mShapes.push_back(_shape.get());
+    return true;
+  }
+};
+
+//==============================================================================
+void writeVertices(BinaryWriter& _writer, const aiVector3D* _vertices,
+                   size_t _count)
+{
+  if(sizeof(aiVector3D) == 3 * sizeof(float))
+  {
+    _writer.writeBytes(_vertices, _count * sizeof(aiVector3D));
+    return;
+  }
+
+  for(size_t i = 0; i < _count; ++i)
+    for(size_t j = 0; j < 3; ++j)
+      _writer.write<float>(_vertices[i][j]);
+}
+
+//==============================================================================
+void readVertices(BinaryReader& _reader, aiVector3D* _vertices, size_t _count)
+{
+  if(sizeof(aiVector3D) == 3 * sizeof(float))
+  {
+    _reader.readBytes(_vertices, _count, sizeof(aiVector3D));
+    return;
+  }
+
+  for(size_t i = 0; i < _count; ++i)
+    for(size_t j = 0; j < 3; ++j)
+      _vertices[i][j] = _reader.read<float>();
+}
+
+//==============================================================================
+void writeColors(BinaryWriter& _writer, const aiColor4D* _colors,
+                 size_t _count)
+{
+  if(sizeof(aiColor4D) == 4 * sizeof(float))
+  {
+    _writer.writeBytes(_colors, _count * sizeof(aiColor4D));
+    return;
+  }
+
+  for(size_t i = 0; i < _count; ++i)
+    for(size_t j = 0; j < 4; ++j)
+      _writer.write<float>(_colors[i][j]);
+}
+
+//==============================================================================
+void readColors(BinaryReader& _reader, aiColor4D* _colors, size_t _count)
+{
+  if(sizeof(aiColor4D) == 4 * sizeof(float))
+  {
+    _reader.readBytes(_colors, _count, sizeof(aiColor4D));
+    return;
+  }
+
+  for(size_t i = 0; i < _count; ++i)
+    for(size_t j = 0; j < 4; ++j)
+      _colors[i][j] = _reader.read<float>();
+}
+
+//==============================================================================
+void writeNode(BinaryWriter& _writer, const aiNode* _node)
+{
+  _writer.writeString(_node->mName.C_Str());
+
+  for(size_t i = 0; i < 4; ++i)
+    for(size_t j = 0; j < 4; ++j)
+      _writer.write<float>(_node->mTransformation[i][j]);
+
+  _writer.write<uint32_t>(_node->mNumMeshes);
+  _writer.writeBytes(_node->mMeshes, _node->mNumMeshes * sizeof(unsigned int));
+
+  _writer.write<uint32_t>(_node->mNumChildren);
+  for(size_t i = 0; i < _node->mNumChildren; ++i)
+    writeNode(_writer, _node->mChildren[i]);
+}
+
+//==============================================================================
+aiNode* readNode(BinaryReader& _reader, aiNode* _parent, size_t _depth)
+{
+  if(_depth > MAX_NODE_DEPTH)
+  {
+    _reader.invalidate();
+    return nullptr;
+  }
+
+  aiNode* node = new aiNode;
+  node->mParent = _parent;
+
+  const std::string name = _reader.readString();
+  node->mName.Set(name);
+
+  for(size_t i = 0; i < 4; ++i)
+    for(size_t j = 0; j < 4; ++j)
+      node->mTransformation[i][j] = _reader.read<float>();
+
+  node->mNumMeshes = _reader.readCount(sizeof(unsigned int));
+  if(node->mNumMeshes > 0)
+  {
+    node->mMeshes = new unsigned int[node->mNumMeshes];
+    _reader.readBytes(node->mMeshes, node->mNumMeshes, sizeof(unsigned int));
+  }
+
+  // Every child takes at least the size of its name and its transformation
+  const uint32_t numChildren = _reader.readCount(16 * sizeof(float));
+  if(numChildren > 0)
+  {
+    node->mChildren = new aiNode*[numChildren];
+    for(size_t i = 0; i < numChildren && _reader.isValid(); ++i)
+    {
+      aiNode* child = readNode(_reader, node, _depth + 1);
+      if(!child)
+        break;
+
+      node->mChildren[i] = child;
+      node->mNumChildren = i + 1;
+    }
+  }
+
+  return node;
+}
+
+//==============================================================================
+void writeMaterial(BinaryWriter& _writer, const aiMaterial* _material)
+{
+  aiColor4D colors[4];
+  float shininess = 0.0f;
+  float strength = 0.0f;
+  int twoSided = 0;
+  unsigned int max = 1;
+
+  uint32_t keys = 0;
+  if(AI_SUCCESS == aiGetMaterialColor(
+       _material, AI_MATKEY_COLOR_DIFFUSE, &colors[0]))
+    keys |= MATERIAL_DIFFUSE;
+  if(AI_SUCCESS == aiGetMaterialColor(
+       _material, AI_MATKEY_COLOR_SPECULAR, &colors[1]))
+    keys |= MATERIAL_SPECULAR;
+  if(AI_SUCCESS == aiGetMaterialColor(
+       _material, AI_MATKEY_COLOR_AMBIENT, &colors[2]))
+    keys |= MATERIAL_AMBIENT;
+  if(AI_SUCCESS == aiGetMaterialColor(
+       _material, AI_MATKEY_COLOR_EMISSIVE, &colors[3]))
+    keys |= MATERIAL_EMISSIVE;
+  if(AI_SUCCESS == aiGetMaterialFloatArray(
+       _material, AI_MATKEY_SHININESS, &shininess, &max))
+    keys |= MATERIAL_SHININESS;
+  max = 1;
+  if(AI_SUCCESS == aiGetMaterialFloatArray(
+       _material, AI_MATKEY_SHININESS_STRENGTH, &strength, &max))
+    keys |= MATERIAL_SHININESS_STRENGTH;
+  max = 1;
+  if(AI_SUCCESS == aiGetMaterialIntegerArray(
+       _material, AI_MATKEY_TWOSIDED, &twoSided, &max))
+    keys |= MATERIAL_TWO_SIDED;
+
+  _writer.write<uint32_t>(keys);
+  writeColors(_writer, colors, 4);
+  _writer.write<float>(shininess);
+  _writer.write<float>(strength);
+  _writer.write<int32_t>(twoSided);
+}
+
+//==============================================================================
+aiMaterial* readMaterial(BinaryReader& _reader)
+{
+  const uint32_t keys = _reader.read<uint32_t>();
+  aiColor4D colors[4];
+  readColors(_reader, colors, 4);
+  float shininess = _reader.read<float>();
+  float strength = _reader.read<float>();
+  int twoSided = _reader.read<int32_t>();
+
+  aiMaterial* material = new aiMaterial;
+  if(keys & MATERIAL_DIFFUSE)
+    material->AddProperty(&colors[0], 1, AI_MATKEY_COLOR_DIFFUSE);
+  if(keys & MATERIAL_SPECULAR)
+    material->AddProperty(&colors[1], 1, AI_MATKEY_COLOR_SPECULAR);
+  if(keys & MATERIAL_AMBIENT)
+    material->AddProperty(&colors[2], 1, AI_MATKEY_COLOR_AMBIENT);
+  if(keys & MATERIAL_EMISSIVE)
+    material->AddProperty(&colors[3], 1, AI_MATKEY_COLOR_EMISSIVE);
+  if(keys & MATERIAL_SHININESS)
+    material->AddProperty(&shininess, 1, AI_MATKEY_SHININESS);
+  if(keys & MATERIAL_SHININESS_STRENGTH)
+    material->AddProperty(&strength, 1, AI_MATKEY_SHININESS_STRENGTH);
+  if(keys & MATERIAL_TWO_SIDED)
+    material->AddProperty(&twoSided, 1, AI_MATKEY_TWOSIDED);
+
+  return material;
+}
+
+//==============================================================================
+void writeMesh(BinaryWriter& _writer, const aiMesh* _mesh)
+{
+  uint32_t arrays = 0;
+  if(_mesh->mNormals)
+    arrays |= MESH_NORMALS;
+  for(size_t i = 0; i < AI_MAX_NUMBER_OF_COLOR_SETS; ++i)
+    if(_mesh->mColors[i])
+      arrays |= 1 << (i + 1);
+
+  _writer.write<uint32_t>(_mesh->mPrimitiveTypes);
+  _writer.write<uint32_t>(_mesh->mMaterialIndex);
+  _writer.write<uint32_t>(arrays);
+
+  _writer.write<uint32_t>(_mesh->mNumVertices);
+  writeVertices(_writer, _mesh->mVertices, _mesh->mNumVertices);
+  if(_mesh->mNormals)
+    writeVertices(_writer, _mesh->mNormals, _mesh->mNumVertices);
+  for(size_t i = 0; i < AI_MAX_NUMBER_OF_COLOR_SETS; ++i)
+    if(_mesh->mColors[i])
+      writeColors(_writer, _mesh->mColors[i], _mesh->mNumVertices);
+
+  _writer.write<uint32_t>(_mesh->mNumFaces);
+  for(size_t i = 0; i < _mesh->mNumFaces; ++i)
+  {
+    const aiFace& face = _mesh->mFaces[i];
+    _writer.write<uint32_t>(face.mNumIndices);
+    _writer.writeBytes(face.mIndices, face.mNumIndices * sizeof(unsigned int));
+  }
+}
+
+//==============================================================================
+aiMesh* readMesh(BinaryReader& _reader)
+{
+  aiMesh* mesh = new aiMesh;
+  mesh->mPrimitiveTypes = _reader.read<uint32_t>();
+  mesh->mMaterialIndex = _reader.read<uint32_t>();
+  const uint32_t arrays = _reader.read<uint32_t>();
+
+  mesh->mNumVertices = _reader.readCount(3 * sizeof(float));
+  mesh->mVertices = new aiVector3D[mesh->mNumVertices];
+  readVertices(_reader, mesh->mVertices, mesh->mNumVertices);
+
+  if(arrays & MESH_NORMALS && _reader.isValid())
+  {
+    mesh->mNormals = new aiVector3D[mesh->mNumVertices];
+    readVertices(_reader, mesh->mNormals, mesh->mNumVertices);
+  }
+
+  for(size_t i = 0; i < AI_MAX_NUMBER_OF_COLOR_SETS; ++i)
+  {
+    if(arrays & (1 << (i + 1)) && _reader.isValid())
+    {
+      mesh->mColors[i] = new aiColor4D[mesh->mNumVertices];
+      readColors(_reader, mesh->mColors[i], mesh->mNumVertices);
+    }
+  }
+
+  const uint32_t numFaces = _reader.readCount(sizeof(uint32_t));
+  mesh->mFaces = new aiFace[numFaces];
+  mesh->mNumFaces = numFaces;
+  for(size_t i = 0; i < numFaces && _reader.isValid(); ++i)
+  {
+    aiFace& face = mesh->mFaces[i];
+    const uint32_t numIndices = _reader.readCount(sizeof(unsigned int));
+    face.mIndices = new unsigned int[numIndices];
+    face.mNumIndices = numIndices;
+    _reader.readBytes(face.mIndices, numIndices, sizeof(unsigned int));
+
+    for(size_t j = 0; j < numIndices && _reader.isValid(); ++j)
+    {
+      if(face.mIndices[j] >= mesh->mNumVertices)
+        _reader.invalidate();
+    }
+  }
+
+  return mesh;
+}
+
+//==============================================================================
+/// Return true if every mesh index of _node and its descendants refers to one
+/// of the _numMeshes meshes of the scene
+bool checkMeshIndices(const aiNode* _node, unsigned int _numMeshes)
+{
+  for(size_t i = 0; i < _node->mNumMeshes; ++i)
+  {
+    if(_node->mMeshes[i] >= _numMeshes)
+      return false;
+  }
+
+  for(size_t i = 0; i < _node->mNumChildren; ++i)
+  {
+    if(!checkMeshIndices(_node->mChildren[i], _numMeshes))
+      return false;
+  }
+
+  return true;
+}
+
+//==============================================================================
+void writeScene(BinaryWriter& _writer, const aiScene* _scene)
+{
+  _writer.write<uint32_t>(_scene->mFlags);
+
+  _writer.write<uint8_t>(_scene->mRootNode != nullptr);
+  if(_scene->mRootNode)
+    writeNode(_writer, _scene->mRootNode);
+
+  _writer.write<uint32_t>(_scene->mNumMeshes);
+  for(size_t i = 0; i < _scene->mNumMeshes; ++i)
+    writeMesh(_writer, _scene->mMeshes[i]);
+
+  _writer.write<uint32_t>(_scene->mNumMaterials);
+  for(size_t i = 0; i < _scene->mNumMaterials; ++i)
+    writeMaterial(_writer, _scene->mMaterials[i]);
+}
+
+//==============================================================================
+std::shared_ptr<const aiScene> readScene(BinaryReader& _reader)
+{
+  std::shared_ptr<aiScene> scene = std::make_shared<aiScene>();
+  scene->mFlags = _reader.read<uint32_t>();
+
+  if(_reader.read<uint8_t>())
+    scene->mRootNode = readNode(_reader, nullptr, 0);
+
+  // Every mesh takes at least the sizes of its arrays
+  const uint32_t numMeshes = _reader.readCount(5 * sizeof(uint32_t));
+  if(numMeshes > 0)
+  {
+    scene->mMeshes = new aiMesh*[numMeshes];
+    for(size_t i = 0; i < numMeshes && _reader.isValid(); ++i)
+    {
+      scene->mMeshes[i] = readMesh(_reader);
+      scene->mNumMeshes = i + 1;
+    }
+  }
+
+  const uint32_t numMaterials = _reader.readCount(sizeof(uint32_t));
+  if(numMaterials > 0)
+  {
+    scene->mMaterials = new aiMaterial*[numMaterials];
+    for(size_t i = 0; i < numMaterials && _reader.isValid(); ++i)
+    {
+      scene->mMaterials[i] = readMaterial(_reader);
+      scene->mNumMaterials = i + 1;
+    }
+  }
+
+  // The nodes are read before the meshes, and the meshes before the
+  // materials, so their indices are checked once the whole scene is read. A
+  // material index of -1 means that the mesh has no material.
+  if(!_reader.isValid())
+    return scene;
+
+  if(scene->mRootNode && !checkMeshIndices(scene->mRootNode, scene->mNumMeshes))
+    _reader.invalidate();
+
+  for(size_t i = 0; i < scene->mNumMeshes; ++i)
+  {
+    const unsigned int materialIndex = scene->mMeshes[i]->mMaterialIndex;
+    if(materialIndex >= scene->mNumMaterials
+       && materialIndex != static_cast<unsigned int>(-1))
+      _reader.invalidate();
+  }
+
+  return scene;
+}
+
+//==============================================================================
+void writeShape(BinaryWriter& _writer, const Shape* _shape,
+                const ShapeTable& _table)
+{
+  _writer.write<uint32_t>(_shape->getShapeType());
+  _writer.writeMatrix(_shape->getLocalTransform().matrix());
+  _writer.writeMatrix(_shape->getRGBA());
+  _writer.write<uint32_t>(_shape->getDataVariance());
+  _writer.write<uint8_t>(_shape->isHidden());
+
+  switch(_shape->getShapeType())
+  {
+    case Shape::BOX:
+      _writer.writeMatrix(static_cast<const BoxShape*>(_shape)->getSize());
+      break;
+    case Shape::ELLIPSOID:
+      _writer.writeMatrix(
+            static_cast<const EllipsoidShape*>(_shape)->getSize());
+      break;
+    case Shape::CYLINDER:
+    {
+      const CylinderShape* cylinder = static_cast<const CylinderShape*>(_shape);
+      _writer.write<double>(cylinder->getRadius());
+      _writer.write<double>(cylinder->getHeight());
+      break;
+    }
+    case Shape::PLANE:
+    {
+      const PlaneShape* plane = static_cast<const PlaneShape*>(_shape);
+      _writer.writeMatrix(plane->getNormal());
+      _writer.write<double>(plane->getOffset());
+      break;
+    }
+    case Shape::MESH:
+    {
+      const MeshShape* mesh = static_cast<const MeshShape*>(_shape);
+      const auto it = _table.mMeshIndices.find(mesh->getMesh());
+      _writer.write<int32_t>(
+            it == _table.mMeshIndices.end() ? -1 : int32_t(it->second));
+      _writer.writeMatrix(mesh->getScale());
+      _writer.writeString(mesh->getMeshUri());
+      _writer.write<int32_t>(mesh->getColorMode());
+      _writer.write<int32_t>(mesh->getColorIndex());
+      break;
+    }
+    case Shape::LINE_SEGMENT:
+    {
+      const LineSegmentShape* lines
+          = static_cast<const LineSegmentShape*>(_shape);
+      _writer.write<float>(lines->getThickness());
+
+      const std::vector<Eigen::Vector3d>& vertices = lines->getVertices();
+      _writer.write<uint32_t>(vertices.size());
+      for(const Eigen::Vector3d& vertex : vertices)
+        _writer.writeMatrix(vertex);
+
+      const Eigen::aligned_vector<Eigen::Vector2i>& connections
+          = lines->getConnections();
+      _writer.write<uint32_t>(connections.size());
+      for(const Eigen::Vector2i& connection : connections)
+      {
+        _writer.write<int32_t>(connection[0]);
+        _writer.write<int32_t>(connection[1]);
+      }
+      break;
+    }
+    default:
+      break;
+  }
+}
+
+//==============================================================================
+ShapePtr readShape(BinaryReader& _reader,
+                   const std::vector<std::shared_ptr<const aiScene>>& _meshes)
+{
+  const uint32_t type = _reader.read<uint32_t>();
+  Eigen::Isometry3d transform(_reader.readMatrix<4, 4>());
+  const Eigen::Vector4d rgba = _reader.readMatrix<4, 1>();
+  const uint32_t variance = _reader.read<uint32_t>();
+  const bool hidden = _reader.read<uint8_t>() != 0;
+
+  ShapePtr shape;
+  switch(type)
+  {
+    case Shape::BOX:
+      shape = std::make_shared<BoxShape>(_reader.readMatrix<3, 1>());
+      break;
+    case Shape::ELLIPSOID:
+      shape = std::make_shared<EllipsoidShape>(_reader.readMatrix<3, 1>());
+      break;
+    case Shape::CYLINDER:
+    {
+      const double radius = _reader.read<double>();
+      const double height = _reader.read<double>();
+      shape = std::make_shared<CylinderShape>(radius, height);
+      break;
+    }
+    case Shape::PLANE:
+    {
+      const Eigen::Vector3d normal = _reader.readMatrix<3, 1>();
+      const double offset = _reader.read<double>();
+      shape = std::make_shared<PlaneShape>(normal, offset);
+      break;
+    }
+    case Shape::MESH:
+    {
+      const int32_t index = _reader.read<int32_t>();
+      const Eigen::Vector3d scale = _reader.readMatrix<3, 1>();
+      const std::string uri = _reader.readString();
+      const int32_t colorMode = _reader.read<int32_t>();
+      const int32_t colorIndex = _reader.read<int32_t>();
+
+      if(index >= static_cast<int32_t>(_meshes.size()))
+        return nullptr;
+
+      std::shared_ptr<MeshShape> mesh = std::make_shared<MeshShape>(
+            scale, index < 0 ? nullptr : _meshes[index], uri);
+      mesh->setColorMode(static_cast<MeshShape::ColorMode>(colorMode));
+      mesh->setColorIndex(colorIndex);
+      shape = mesh;
+      break;
+    }
+    case Shape::LINE_SEGMENT:
+    {
+      std::shared_ptr<LineSegmentShape> lines
+          = std::make_shared<LineSegmentShape>(_reader.read<float>());
+
+      const uint32_t numVertices = _reader.readCount(3 * sizeof(double));
+      for(size_t i = 0; i < numVertices; ++i)
+        lines->addVertex(_reader.readMatrix<3, 1>());
+
+      const uint32_t numConnections = _reader.readCount(2 * sizeof(int32_t));
+      for(size_t i = 0; i < numConnections; ++i)
+      {
+        const int32_t first = _reader.read<int32_t>();
+        const int32_t second = _reader.read<int32_t>();
+        if(first < 0 || second < 0 || uint32_t(first) >= numVertices
+           || uint32_t(second) >= numVertices)
+          return nullptr;
+        lines->addConnection(first, second);
+      }
+
+      shape = lines;
+      break;
+    }
+    default:
+      return nullptr;
+  }
+
+  shape->setLocalTransform(transform);
+  shape->setRGBA(rgba);
+  shape->setDataVariance(variance);
+  shape->setHidden(hidden);
+
+  return shape;
+}
+
+//==============================================================================
+/// Parameters of the joint types beyond Joint::Properties, stored in the same
+/// layout for every joint type
+struct JointParameters
+{
+  Eigen::Vector3d mAxis1;
+  Eigen::Vector3d mAxis2;
+  double mPitch;
+  uint32_t mMode;
+
+  JointParameters()
+    : mAxis1(Eigen::Vector3d::UnitZ()),
+      mAxis2(Eigen::Vector3d::UnitY()),
+      mPitch(0.0),
+      mMode(0)
+  {
+    // Do nothing
+  }
+};
+
+//==============================================================================
+JointParameters getJointParameters(const Joint* _joint)
+{
+  JointParameters parameters;
+  const std::string& type = _joint->getType();
+
+  if(type == RevoluteJoint::getStaticType())
+  {
+    parameters.mAxis1 = static_cast<const RevoluteJoint*>(_joint)->getAxis();
+  }
+  else if(type == PrismaticJoint::getStaticType())
+  {
+    parameters.mAxis1 = static_cast<const PrismaticJoint*>(_joint)->getAxis();
+  }
+  else if(type == ScrewJoint::getStaticType())
+  {
+    const ScrewJoint* joint = static_cast<const ScrewJoint*>(_joint);
+    parameters.mAxis1 = joint->getAxis();
+    parameters.mPitch = joint->getPitch();
+  }
+  else if(type == UniversalJoint::getStaticType())
+  {
+    const UniversalJoint* joint = static_cast<const UniversalJoint*>(_joint);
+    parameters.mAxis1 = joint->getAxis1();
+    parameters.mAxis2 = joint->getAxis2();
+  }
+  else if(type == EulerJoint::getStaticType())
+  {
+    parameters.mMode = static_cast<const EulerJoint*>(_joint)->getAxisOrder();
+  }
+  else if(type == PlanarJoint::getStaticType())
+  {
+    const PlanarJoint* joint = static_cast<const PlanarJoint*>(_joint);
+    parameters.mMode = joint->getPlaneType();
+    parameters.mAxis1 = joint->getTranslationalAxis1();
+    parameters.mAxis2 = joint->getTranslationalAxis2();
+  }
+
+  return parameters;
+}
+
+//==============================================================================
+bool isSupportedJointType(const std::string& _type)
+{
+  return _type == WeldJoint::getStaticType()
+      || _type == RevoluteJoint::getStaticType()
+      || _type == PrismaticJoint::getStaticType()
+      || _type == ScrewJoint::getStaticType()
+      || _type == UniversalJoint::getStaticType()
+      || _type == BallJoint::getStaticType()
+      || _type == EulerJoint::getStaticType()
+      || _type == TranslationalJoint::getStaticType()
+      || _type == PlanarJoint::getStaticType()
+      || _type == FreeJoint::getStaticType();
+}
+
+//==============================================================================
+template <class JointType>
+std::pair<JointType*, BodyNode*> createPair(
+    const SkeletonPtr& _skeleton, BodyNode* _parent,
+    const Joint::Properties& _jointProperties,
+    const BodyNode::Properties& _bodyProperties)
+{
+  typename JointType::Properties properties;
+  static_cast<Joint::Properties&>(properties) = _jointProperties;
+
+  return _skeleton->createJointAndBodyNodePair<JointType>(
+        _parent, properties, _bodyProperties);
+}
+
+//==============================================================================
+BodyNode* createBodyNode(
+    const std::string& _type, const SkeletonPtr& _skeleton, BodyNode* _parent,
+    const Joint::Properties& _jointProperties,
+    const BodyNode::Properties& _bodyProperties,
+    const JointParameters& _parameters)
+{
+  if(_type == WeldJoint::getStaticType())
+  {
+    return createPair<WeldJoint>(
+          _skeleton, _parent, _jointProperties, _bodyProperties).second;
+  }
+  else if(_type == RevoluteJoint::getStaticType())
+  {
+    auto pair = createPair<RevoluteJoint>(
+          _skeleton, _parent, _jointProperties, _bodyProperties);
+    pair.first->setAxis(_parameters.mAxis1);
+    return pair.second;
+  }
+  else if(_type == PrismaticJoint::getStaticType())
+  {
+    auto pair = createPair<PrismaticJoint>(
+          _skeleton, _parent, _jointProperties, _bodyProperties);
+    pair.first->setAxis(_parameters.mAxis1);
+    return pair.second;
+  }
+  else if(_type == ScrewJoint::getStaticType())
+  {
+    auto pair = createPair<ScrewJoint>(
+          _skeleton, _parent, _jointProperties, _bodyProperties);
+    pair.first->setAxis(_parameters.mAxis1);
+    pair.first->setPitch(_parameters.mPitch);
+    return pair.second;
+  }
+  else if(_type == UniversalJoint::getStaticType())
+  {
+    auto pair = createPair<UniversalJoint>(
+          _skeleton, _parent, _jointProperties, _bodyProperties);
+    pair.first->setAxis1(_parameters.mAxis1);
+    pair.first->setAxis2(_parameters.mAxis2);
+    return pair.second;
+  }
+  else if(_type == BallJoint::getStaticType())
+  {
+    return createPair<BallJoint>(
+          _skeleton, _parent, _jointProperties, _bodyProperties).second;
+  }
+  else if(_type == EulerJoint::getStaticType())
+  {
+    auto pair = createPair<EulerJoint>(
+          _skeleton, _parent, _jointProperties, _bodyProperties);
+    pair.first->setAxisOrder(
+          static_cast<EulerJoint::AxisOrder>(_parameters.mMode), false);
+    return pair.second;
+  }
+  else if(_type == TranslationalJoint::getStaticType())
+  {
+    return createPair<TranslationalJoint>(
+          _skeleton, _parent, _jointProperties, _bodyProperties).second;
+  }
+  else if(_type == PlanarJoint::getStaticType())
+  {
+    auto pair = createPair<PlanarJoint>(
+          _skeleton, _parent, _jointProperties, _bodyProperties);
+    switch(_parameters.mMode)
+    {
+      case PlanarJoint::PT_XY:
+        pair.first->setXYPlane(false);
+        break;
+      case PlanarJoint::PT_YZ:
+        pair.first->setYZPlane(false);
+        break;
+      case PlanarJoint::PT_ZX:
+        pair.first->setZXPlane(false);
+        break;
+      default:
+        pair.first->setArbitraryPlane(
+              _parameters.mAxis1, _parameters.mAxis2, false);
+        break;
+    }
+    return pair.second;
+  }
+  else if(_type == FreeJoint::getStaticType())
+  {
+    return createPair<FreeJoint>(
+          _skeleton, _parent, _jointProperties, _bodyProperties).second;
+  }
+
+  return nullptr;
+}
+
+//==============================================================================
+void writeDofs(BinaryWriter& _writer, const Joint* _joint)
+{
+  _writer.write<uint32_t>(_joint->getNumDofs());
+  for(size_t i = 0; i < _joint->getNumDofs(); ++i)
+  {
+    _writer.writeString(_joint->getDofName(i));
+    _writer.write<uint8_t>(_joint->isDofNamePreserved(i));
+
+    const double values[] = {
+      _joint->getPositionLowerLimit(i),
+      _joint->getPositionUpperLimit(i),
+      _joint->getVelocityLowerLimit(i),
+      _joint->getVelocityUpperLimit(i),
+      _joint->getAccelerationLowerLimit(i),
+      _joint->getAccelerationUpperLimit(i),
+      _joint->getForceLowerLimit(i),
+      _joint->getForceUpperLimit(i),
+      _joint->getInitialPosition(i),
+      _joint->getInitialVelocity(i),
+      _joint->getSpringStiffness(i),
+      _joint->getRestPosition(i),
+      _joint->getDampingCoefficient(i),
+      _joint->getCoulombFriction(i)
+    };
+    _writer.writeBytes(values, sizeof(values));
+  }
+}
+
+//==============================================================================
+bool readDofs(BinaryReader& _reader, Joint* _joint)
+{
+  if(_reader.read<uint32_t>() != _joint->getNumDofs())
+    return false;
+
+  for(size_t i = 0; i < _joint->getNumDofs(); ++i)
+  {
+    const std::string name = _reader.readString();
+    const bool preserved = _reader.read<uint8_t>() != 0;
+    double values[14];
+    if(!_reader.readBytes(values, 14, sizeof(double)))
+      return false;
+
+    _joint->setDofName(i, name, false);
+    _joint->preserveDofName(i, preserved);
+    _joint->setPositionLowerLimit(i, values[0]);
+    _joint->setPositionUpperLimit(i, values[1]);
+    _joint->setVelocityLowerLimit(i, values[2]);
+    _joint->setVelocityUpperLimit(i, values[3]);
+    _joint->setAccelerationLowerLimit(i, values[4]);
+    _joint->setAccelerationUpperLimit(i, values[5]);
+    _joint->setForceLowerLimit(i, values[6]);
+    _joint->setForceUpperLimit(i, values[7]);
+    _joint->setInitialPosition(i, values[8]);
+    _joint->setInitialVelocity(i, values[9]);
+    _joint->setSpringStiffness(i, values[10]);
+    _joint->setRestPosition(i, values[11]);
+    _joint->setDampingCoefficient(i, values[12]);
+    _joint->setCoulombFriction(i, values[13]);
+  }
+
+  return true;
+}
+
+//==============================================================================
+void writeShapeIndices(BinaryWriter& _writer,
+                       const std::vector<ShapePtr>& _shapes,
+                       const ShapeTable& _table)
+{
+  _writer.write<uint32_t>(_shapes.size());
+  for(const ShapePtr& shape : _shapes)
+    _writer.write<uint32_t>(_table.mShapeIndices.at(shape.get()));
+}
+
+//==============================================================================
+bool readShapeIndices(BinaryReader& _reader,
+                      const std::vector<ShapePtr>& _shapes,
+                      std::vector<ShapePtr>& _result)
+{
+  const uint32_t numShapes = _reader.readCount(sizeof(uint32_t));
+  _result.resize(numShapes);
+  for(ShapePtr& shape : _result)
+  {
+    const uint32_t index = _reader.read<uint32_t>();
+    if(index >= _shapes.size())
+      return false;
+    shape = _shapes[index];
+  }
+
+  return _reader.isValid();
+}
+
+//==============================================================================
+void writeBodyNode(BinaryWriter& _writer, const BodyNode* _bodyNode,
+                   const ShapeTable& _table)
+{
+  const BodyNode* parent = _bodyNode->getParentBodyNode();
+  _writer.write<int32_t>(
+        parent ? static_cast<int32_t>(parent->getIndexInSkeleton()) : -1);
+
+  // BodyNode
+  const BodyNode::Properties properties = _bodyNode->getBodyNodeProperties();
+  _writer.writeString(properties.mName);
+  _writer.write<double>(properties.mInertia.getMass());
+  _writer.writeMatrix(properties.mInertia.getLocalCOM());
+  _writer.writeMatrix(properties.mInertia.getMoment());
+  _writer.write<uint8_t>(properties.mIsCollidable);
+  _writer.write<double>(properties.mFrictionCoeff);
+  _writer.write<double>(properties.mRestitutionCoeff);
+  _writer.write<uint8_t>(properties.mGravityMode);
+  writeShapeIndices(_writer, properties.mVizShapes, _table);
+  writeShapeIndices(_writer, properties.mColShapes, _table);
+
+  _writer.write<uint32_t>(properties.mMarkerProperties.size());
+  for(const Marker::Properties& marker : properties.mMarkerProperties)
+  {
+    _writer.writeString(marker.mName);
+    _writer.writeMatrix(marker.mOffset);
+    _writer.write<uint32_t>(marker.mType);
+  }
+
+  // Joint
+  const Joint* joint = _bodyNode->getParentJoint();
+  const Joint::Properties& jointProperties = joint->getJointProperties();
+  _writer.writeString(joint->getType());
+  _writer.writeString(jointProperties.mName);
+  _writer.writeMatrix(jointProperties.mT_ParentBodyToJoint.matrix());
+  _writer.writeMatrix(jointProperties.mT_ChildBodyToJoint.matrix());
+  _writer.write<uint8_t>(jointProperties.mIsPositionLimited);
+  _writer.write<uint32_t>(jointProperties.mActuatorType);
+
+  const JointParameters parameters = getJointParameters(joint);
+  _writer.writeMatrix(parameters.mAxis1);
+  _writer.writeMatrix(parameters.mAxis2);
+  _writer.write<double>(parameters.mPitch);
+  _writer.write<uint32_t>(parameters.mMode);
+
+  writeDofs(_writer, joint);
+}
+
+//==============================================================================
+BodyNode* readBodyNode(BinaryReader& _reader, const SkeletonPtr& _skeleton,
+                       const std::vector<BodyNode*>& _bodyNodes,
+                       const std::vector<ShapePtr>& _shapes)
+{
+  const int32_t parentIndex = _reader.read<int32_t>();
+  if(parentIndex >= static_cast<int32_t>(_bodyNodes.size()))
+    return nullptr;
+
+  BodyNode* parent = nullptr;
+  if(parentIndex >= 0)
+  {
+    // The parent must have been read already
+    parent = _bodyNodes[parentIndex];
+    if(!parent)
+      return nullptr;
+  }
+
+  // BodyNode
+  BodyNode::Properties properties;
+  properties.mName = _reader.readString();
+  const double mass = _reader.read<double>();
+  const Eigen::Vector3d com = _reader.readMatrix<3, 1>();
+  const Eigen::Matrix3d moment = _reader.readMatrix<3, 3>();
+  properties.mInertia = Inertia(mass, com, moment);
+  properties.mIsCollidable = _reader.read<uint8_t>() != 0;
+  properties.mFrictionCoeff = _reader.read<double>();
+  properties.mRestitutionCoeff = _reader.read<double>();
+  properties.mGravityMode = _reader.read<uint8_t>() != 0;
+  if(!readShapeIndices(_reader, _shapes, properties.mVizShapes)
+     || !readShapeIndices(_reader, _shapes, properties.mColShapes))
+    return nullptr;
+
+  const uint32_t numMarkers = _reader.readCount(sizeof(uint32_t));
+  properties.mMarkerProperties.resize(numMarkers);
+  for(Marker::Properties& marker : properties.mMarkerProperties)
+  {
+    marker.mName = _reader.readString();
+    marker.mOffset = _reader.readMatrix<3, 1>();
+    marker.mType
+        = static_cast<Marker::ConstraintType>(_reader.read<uint32_t>());
+  }
+
+  // Joint
+  const std::string type = _reader.readString();
+  Joint::Properties jointProperties;
+  jointProperties.mName = _reader.readString();
+  jointProperties.mT_ParentBodyToJoint.matrix() = _reader.readMatrix<4, 4>();
+  jointProperties.mT_ChildBodyToJoint.matrix() = _reader.readMatrix<4, 4>();
+  jointProperties.mIsPositionLimited = _reader.read<uint8_t>() != 0;
+  jointProperties.mActuatorType
+      = static_cast<Joint::ActuatorType>(_reader.read<uint32_t>());
+
+  JointParameters parameters;
+  parameters.mAxis1 = _reader.readMatrix<3, 1>();
+  parameters.mAxis2 = _reader.readMatrix<3, 1>();
+  parameters.mPitch = _reader.read<double>();
+  parameters.mMode = _reader.read<uint32_t>();
+
+  if(!_reader.isValid() || !isSupportedJointType(type))
+    return nullptr;
+
+  BodyNode* bodyNode = createBodyNode(type, _skeleton, parent, jointProperties,
+                                      properties, parameters);
+
+  if(!readDofs(_reader, bodyNode->getParentJoint()))
+    return nullptr;
+
+  return bodyNode;
+}
+
+//==============================================================================
+uint32_t getDetectorType(const collision::CollisionDetector* _detector)
+{
+  // FCLMeshCollisionDetector is checked first in case it derives from one of
+  // the other detectors
+  if(dynamic_cast<const collision::FCLMeshCollisionDetector*>(_detector))
+    return DETECTOR_FCL_MESH;
+  if(dynamic_cast<const collision::FCLCollisionDetector*>(_detector))
+    return DETECTOR_FCL;
+#ifdef HAVE_BULLET_COLLISION
+  if(dynamic_cast<const collision::BulletCollisionDetector*>(_detector))
+    return DETECTOR_BULLET;
+#endif
+  if(dynamic_cast<const collision::DARTCollisionDetector*>(_detector))
+    return DETECTOR_DART;
+
+  return DETECTOR_UNKNOWN;
+}
+
+//==============================================================================
+collision::CollisionDetector* createDetector(uint32_t _type)
+{
+  switch(_type)
+  {
+    case DETECTOR_DART:
+      return new collision::DARTCollisionDetector();
+    case DETECTOR_FCL:
+      return new collision::FCLCollisionDetector();
+    case DETECTOR_FCL_MESH:
+      return new collision::FCLMeshCollisionDetector();
+#ifdef HAVE_BULLET_COLLISION
+    case DETECTOR_BULLET:
+      return new collision::BulletCollisionDetector();
+#endif
+    default:
+      return nullptr;
+  }
+}
+
+} // anonymous namespace
+
+//==============================================================================
+bool CompiledWorld::writeWorld(
+    const simulation::WorldPtr& _world,
+    const std::string& _fileName,
+    const std::vector<std::string>& _sources,
+    bool _includeState)
+{
+  if(!_world)
+  {
+    dterr << "[CompiledWorld::writeWorld] Attempting to write a nullptr "
+          << "World.\n";
+    return false;
+  }
+
+  // Collect the shapes, the meshes and the local mesh files
+  ShapeTable table;
+  std::vector<std::string> sourcePaths = _sources;
+  for(size_t i = 0; i < _world->getNumSkeletons(); ++i)
+  {
+    const SkeletonPtr skeleton = _world->getSkeleton(i);
+    for(size_t j = 0; j < skeleton->getNumBodyNodes(); ++j)
+    {
+      const BodyNode* bodyNode = skeleton->getBodyNode(j);
+      if(dynamic_cast<const SoftBodyNode*>(bodyNode))
+      {
+        dterr << "[CompiledWorld::writeWorld] BodyNode ["
+              << bodyNode->getName() << "] of Skeleton ["
+              << skeleton->getName() << "] is a SoftBodyNode, which is not "
+              << "supported.\n";
+        return false;
+      }
+
+      if(!isSupportedJointType(bodyNode->getParentJoint()->getType()))
+      {
+        dterr << "[CompiledWorld::writeWorld] Joint ["
+              << bodyNode->getParentJoint()->getName() << "] of Skeleton ["
+              << skeleton->getName() << "] has an unsupported type ["
+              << bodyNode->getParentJoint()->getType() << "].\n";
+        return false;
+      }
+
+      const BodyNode::Properties properties
+          = bodyNode->getBodyNodeProperties();
+      std::vector<ShapePtr> shapes = properties.mVizShapes;
+      shapes.insert(shapes.end(), properties.mColShapes.begin(),
+                    properties.mColShapes.end());
+      for(const ShapePtr& shape : shapes)
+      {
+        if(!table.addShape(shape))
+        {
+          dterr << "[CompiledWorld::writeWorld] BodyNode ["
+                << bodyNode->getName() << "] of Skeleton ["
+                << skeleton->getName() << "] has a shape of unsupported type ["
+                << shape->getShapeType() << "].\n";
+          return false;
+        }
+
+        if(shape->getShapeType() == Shape::MESH)
+        {
+          const std::string& path
+              = static_cast<const MeshShape*>(shape.get())->getMeshPath();
+          if(!path.empty())
+            sourcePaths.push_back(path);
+        }
+      }
+    }
+  }
+
+  BinaryWriter writer;
+
+  // Header
+  writer.writeBytes(MAGIC, sizeof(MAGIC));
+  writer.write<uint32_t>(FORMAT_VERSION);
+  writer.write<uint32_t>(BYTE_ORDER_MARK);
+  writer.write<uint32_t>(_includeState ? FLAG_STATE : 0);
+
+  // Sources
+  std::vector<Source> sources;
+  std::set<std::string> visited;
+  for(const std::string& path : sourcePaths)
+  {
+    if(!visited.insert(path).second)
+      continue;
+
+    Source source;
+    source.mPath = path;
+    if(!getFileStatus(path, source.mSize, source.mTime))
+    {
+      dtwarn << "[CompiledWorld::writeWorld] Source file [" << path
+             << "] does not exist, so it will not be recorded.\n";
+      continue;
+    }
+    sources.push_back(source);
+  }
+
+  writer.write<uint32_t>(sources.size());
+  for(const Source& source : sources)
+  {
+    writer.writeString(source.mPath);
+    writer.write<uint64_t>(source.mSize);
+    writer.write<int64_t>(source.mTime);
+  }
+
+  // World
+  writer.writeString(_world->getName());
+  writer.writeMatrix(_world->getGravity());
+  writer.write<double>(_world->getTimeStep());
+  writer.write<uint32_t>(getDetectorType(
+      _world->getConstraintSolver()->getCollisionDetector()));
+  writer.write<double>(_includeState ? _world->getTime() : 0.0);
+
+  // Meshes
+  writer.write<uint32_t>(table.mMeshes.size());
+  for(const aiScene* mesh : table.mMeshes)
+    writeScene(writer, mesh);
+
+  // Shapes
+  writer.write<uint32_t>(table.mShapes.size());
+  for(const Shape* shape : table.mShapes)
+    writeShape(writer, shape, table);
+
+  // Skeletons
+  writer.write<uint32_t>(_world->getNumSkeletons());
+  for(size_t i = 0; i < _world->getNumSkeletons(); ++i)
+  {
+    const SkeletonPtr skeleton = _world->getSkeleton(i);
+    writer.writeString(skeleton->getName());
+    writer.write<uint8_t>(skeleton->isMobile());
+    writer.writeMatrix(skeleton->getGravity());
+    writer.write<double>(skeleton->getTimeStep());
+    writer.write<uint8_t>(skeleton->isEnabledSelfCollisionCheck());
+    writer.write<uint8_t>(skeleton->isEnabledAdjacentBodyCheck());
+
+    // BodyNodes are written in the order of the Skeleton, so that the DOFs
+    // of the loaded Skeleton are in the same order as the written state. A
+    // Skeleton registers every parent before its children.
+    writer.write<uint32_t>(skeleton->getNumBodyNodes());
+    for(size_t j = 0; j < skeleton->getNumBodyNodes(); ++j)
+      writeBodyNode(writer, skeleton->getBodyNode(j), table);
+
+    if(_includeState)
+    {
+      writer.writeVector(skeleton->getPositions());
+      writer.writeVector(skeleton->getVelocities());
+    }
+  }
+
+  if(!writer.save(_fileName))
+  {
+    dterr << "[CompiledWorld::writeWorld] Failed to write [" << _fileName
+          << "].\n";
+    return false;
+  }
+
+  return true;
+}
+
+//==============================================================================
+simulation::WorldPtr CompiledWorld::readWorld(const std::string& _fileName)
+{
+  MappedFile file(_fileName);
+  BinaryReader reader(file.getData(), file.getSize());
+
+  uint32_t flags = 0;
+  std::vector<Source> sources;
+  if(!readHeader(reader, flags, sources))
+  {
+    dterr << "[CompiledWorld::readWorld] [" << _fileName << "] is not a "
+          << "compiled world of version " << FORMAT_VERSION << ".\n";
+    return nullptr;
+  }
+
+  // World
+  simulation::WorldPtr world(new simulation::World(reader.readString()));
+  world->setGravity(reader.readMatrix<3, 1>());
+  world->setTimeStep(reader.read<double>());
+  collision::CollisionDetector* detector
+      = createDetector(reader.read<uint32_t>());
+  if(detector)
+    world->getConstraintSolver()->setCollisionDetector(detector);
+  const double time = reader.read<double>();
+
+  // Meshes
+  std::vector<std::shared_ptr<const aiScene>> meshes(
+        reader.readCount(2 * sizeof(uint32_t)));
+  for(size_t i = 0; i < meshes.size() && reader.isValid(); ++i)
+    meshes[i] = readScene(reader);
+
+  // Shapes
+  std::vector<ShapePtr> shapes(reader.readCount(sizeof(uint32_t)));
+  for(size_t i = 0; i < shapes.size() && reader.isValid(); ++i)
+  {
+    shapes[i] = readShape(reader, meshes);
+    if(!shapes[i])
+    {
+      dterr << "[CompiledWorld::readWorld] [" << _fileName << "] contains an "
+            << "invalid shape.\n";
+      return nullptr;
+    }
+  }
+
+  // Skeletons
+  const uint32_t numSkeletons = reader.readCount(sizeof(uint32_t));
+  for(size_t i = 0; i < numSkeletons && reader.isValid(); ++i)
+  {
+    Skeleton::Properties properties;
+    properties.mName = reader.readString();
+    properties.mIsMobile = reader.read<uint8_t>() != 0;
+    properties.mGravity = reader.readMatrix<3, 1>();
+    properties.mTimeStep = reader.read<double>();
+    properties.mEnabledSelfCollisionCheck = reader.read<uint8_t>() != 0;
+    properties.mEnabledAdjacentBodyCheck = reader.read<uint8_t>() != 0;
+    const SkeletonPtr skeleton = Skeleton::create(properties);
+
+    std::vector<BodyNode*> bodyNodes(reader.readCount(sizeof(int32_t)));
+    for(size_t j = 0; j < bodyNodes.size(); ++j)
+    {
+      bodyNodes[j] = readBodyNode(reader, skeleton, bodyNodes, shapes);
+      if(!bodyNodes[j])
+      {
+        dterr << "[CompiledWorld::readWorld] [" << _fileName << "] contains "
+              << "an invalid BodyNode in Skeleton [" << skeleton->getName()
+              << "].\n";
+        return nullptr;
+      }
+    }
+
+    if(flags & FLAG_STATE)
+    {
+      const Eigen::VectorXd positions = reader.readVector();
+      const Eigen::VectorXd velocities = reader.readVector();
+      if(static_cast<size_t>(positions.size()) != skeleton->getNumDofs()
+         || static_cast<size_t>(velocities.size()) != skeleton->getNumDofs())
+        break;
+
+      skeleton->setPositions(positions);
+      skeleton->setVelocities(velocities);
+    }
+    else
+    {
+      skeleton->resetPositions();
+      skeleton->resetVelocities();
+    }
+
+    world->addSkeleton(skeleton);
+  }
+
+  if(!reader.isValid() || world->getNumSkeletons() != numSkeletons)
+  {
+    dterr << "[CompiledWorld::readWorld] [" << _fileName << "] is "
+          << "truncated or corrupted.\n";
+    return nullptr;
+  }
+
+  if(flags & FLAG_STATE)
+    world->setTime(time);
+
+  return world;
+}
+
+//==============================================================================
+bool CompiledWorld::isUpToDate(const std::string& _fileName,
+                               const std::vector<std::string>& _sources)
+{
+  MappedFile file(_fileName);
+  BinaryReader reader(file.getData(), file.getSize());
+
+  uint32_t flags = 0;
+  std::vector<Source> sources;
+  if(!readHeader(reader, flags, sources))
+    return false;
+
+  std::set<std::string> paths;
+  for(const Source& source : sources)
+  {
+    uint64_t size;
+    int64_t time;
+    if(!getFileStatus(source.mPath, size, time)
+       || size != source.mSize || time != source.mTime)
+      return false;
+
+    paths.insert(source.mPath);
+  }
+
+  for(const std::string& path : _sources)
+  {
+    if(!paths.count(path))
+      return false;
+  }
+
+  return true;
+}
+
+//==============================================================================
+simulation::WorldPtr CompiledWorld::loadWorld(
+    const std::string& _fileName,
+    const std::vector<std::string>& _sources,
+    const std::function<simulation::WorldPtr()>& _parse)
+{
+  return loadWorld(_fileName, _sources, nullptr, _parse);
+}
+
+//==============================================================================
+simulation::WorldPtr CompiledWorld::loadWorld(
+    const std::string& _fileName,
+    const std::vector<std::string>& _sources,
+    const RecordingResourceRetrieverPtr& _recorder,
+    const std::function<simulation::WorldPtr()>& _parse)
+{
+  if(isUpToDate(_fileName, _sources))
+  {
+    simulation::WorldPtr world = readWorld(_fileName);
+    if(world)
+      return world;
+  }
+
+  simulation::WorldPtr world = _parse();
+  if(!world)
+    return nullptr;
+
+  std::vector<std::string> sources = _sources;
+  if(_recorder)
+  {
+    for(const common::Uri& uri : _recorder->getRetrievedUris())
+    {
+      const std::string path = getLocalPath(uri);
+      if(!path.empty())
+        sources.push_back(path);
+    }
+  }
+
+  if(!writeWorld(world, _fileName, sources))
+  {
+    dtwarn << "[CompiledWorld::loadWorld] Failed to cache the World in ["
+           << _fileName << "].\n";
+  }
+
+  return world;
+}
+
+//==============================================================================
+std::string CompiledWorld::getLocalPath(const common::Uri& _uri)
+{
+  if(_uri.mScheme.get_value_or("file") != "file" || !_uri.mPath)
+    return "";
+
+  return _uri.getFilesystemPath();
+}
+
+} // namespace utils
+} // namespace dart
@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) 2016, Graphics Lab, Georgia Tech Research Corporation
+ * Copyright (c) 2016, Humanoid Lab, Georgia Tech Research Corporation
+ * Copyright (c) 2016, Personal Robotics Lab, Carnegie Mellon University
+ * All rights reserved.
+ *
+ * This file is provided under the following "BSD-style" License:
+ *   Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following
+ *   conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ *   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ *   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ *   USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *   POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef DART_UTILS_COMPILEDWORLD_H
+#define DART_UTILS_COMPILEDWORLD_H
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "dart/common/Uri.h"
+#include "dart/simulation/World.h"
+#include "dart/utils/RecordingResourceRetriever.h"
+
+namespace dart {
+namespace utils {
+
+/// CompiledWorld stores a fully constructed World in a compact binary file,
+/// so that it can be loaded again without parsing XML files or importing
+/// meshes. The file holds the skeleton topology, the joint and BodyNode
+/// properties, the shapes including the imported meshes, the collision
+/// detector of the world and, optionally, the state of the world. Reading
+/// maps the file into memory and copies the mesh data in bulk.
+///
+/// The file also records the source files that the world was created from,
+/// along with their sizes and modification times, so that it can be used as a
+/// cache of the parsers, see loadWorld().
+///
+/// Soft bodies, EndEffectors and SimpleFrames are not supported.
+class CompiledWorld
+{
+public:
+  /// Write _world to the file _fileName; return success. _sources are the
+  /// files that the world was created from. The local mesh files of the world
+  /// are recorded as sources as well. If _includeState is false, the joints of
+  /// the loaded world will be at their initial positions and velocities.
+  static bool writeWorld(
+      const simulation::WorldPtr& _world,
+      const std::string& _fileName,
+      const std::vector<std::string>& _sources = std::vector<std::string>(),
+      bool _includeState = true);
+
+  /// Read the World from the file _fileName; return a nullptr on failure.
+  /// This does not check whether the sources of the file have changed.
+  static simulation::WorldPtr readWorld(const std::string& _fileName);
+
+  /// Return true if _fileName is a valid compiled world whose sources have
+  /// not changed since it was written, and _sources are among its sources.
+  static bool isUpToDate(
+      const std::string& _fileName,
+      const std::vector<std::string>& _sources = std::vector<std::string>());
+
+  /// Read the World from _fileName if it is up to date with _sources.
+  /// Otherwise create the World using _parse and write it to _fileName. For
+  /// example:
+  /// \code
+  /// CompiledWorld::loadWorld("world.dwc", {"world.skel"}, []() {
+  ///   return SkelParser::readWorld("world.skel"); });
+  /// \endcode
+  static simulation::WorldPtr loadWorld(
+      const std::string& _fileName,
+      const std::vector<std::string>& _sources,
+      const std::function<simulation::WorldPtr()>& _parse);
+
+  /// Same as the above, but the local files retrieved through _recorder while
+  /// _parse runs are recorded as sources as well. _parse should open every
+  /// resource through _recorder, so that changes to the files that are
+  /// included by the sources are detected too.
+  static simulation::WorldPtr loadWorld(
+      const std::string& _fileName,
+      const std::vector<std::string>& _sources,
+      const RecordingResourceRetrieverPtr& _recorder,
+      const std::function<simulation::WorldPtr()>& _parse);
+
+  /// Get the local file path of _uri; return an empty string if _uri does not
+  /// refer to a local file.
+  static std::string getLocalPath(const common::Uri& _uri);
+
+  /// Version of the file format written by writeWorld()
+  static const unsigned int FORMAT_VERSION;
+};
+
+} // namespace utils
+} // namespace dart
+
+#endif // DART_UTILS_COMPILEDWORLD_H
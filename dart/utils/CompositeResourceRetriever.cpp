@@ -104,6 +104,19 @@ common::ResourcePtr CompositeResourceRetriever::retrieve(
   return nullptr;
 }
 
+//==============================================================================
+std::string CompositeResourceRetriever::getFilePath(const common::Uri& _uri)
+{
+  for(const common::ResourceRetrieverPtr& resourceRetriever
+      : getRetrievers(_uri))
+  {
+    const std::string path = resourceRetriever->getFilePath(_uri);
+    if(!path.empty())
+      return path;
+  }
+  return "";
+}
+
 //==============================================================================
 std::vector<common::ResourceRetrieverPtr>
   CompositeResourceRetriever::getRetrievers(const common::Uri& _uri) const
@@ -60,6 +60,27 @@ FileInfoWorld::~FileInfoWorld()
 //==============================================================================
 bool FileInfoWorld::loadFile(const char* _fName)
 {
+  // Binary recordings are read on demand by the recording itself
+  if (simulation::Recording::isRecordingFile(_fName))
+  {
+    simulation::Recording* record
+        = new simulation::Recording(std::vector<int>());
+    if (!record->loadFile(_fName))
+    {
+      delete record;
+      return false;
+    }
+
+    delete mRecord;
+    mRecord = record;
+
+    std::string text = _fName;
+    int lastSlash = text.find_last_of("/");
+    text = text.substr(lastSlash+1);
+    strcpy(mFileName, text.c_str());
+    return true;
+  }
+
   std::ifstream inFile(_fName);
   if (inFile.fail() == 1) return false;
 
@@ -55,7 +55,8 @@ public:
   /// \brief Destructor
   virtual ~FileInfoWorld();
 
-  /// \brief Load file
+  /// \brief Load file. Binary recording files written by
+  /// simulation::Recording are detected and loaded as well.
   bool loadFile(const char* _fileName);
 
   /// \brief Save file
@@ -55,6 +55,15 @@ PackageResourceRetriever::PackageResourceRetriever(
     mLocalRetriever = std::make_shared<common::LocalResourceRetriever>();
 }
 
+//==============================================================================
+PackageResourceRetriever::PackageResourceRetriever(
+  const PackageResourceRetriever& _other,
+  const common::ResourceRetrieverPtr& _localRetriever)
+  : PackageResourceRetriever(_localRetriever)
+{
+  mPackageMap = _other.mPackageMap;
+}
+
 //==============================================================================
 void PackageResourceRetriever::addPackageDirectory(
   const std::string& _packageName, const std::string& _packageDirectory)
@@ -106,6 +115,25 @@ common::ResourcePtr PackageResourceRetriever::retrieve(const common::Uri& _uri)
   return nullptr;
 }
 
+//==============================================================================
+std::string PackageResourceRetriever::getFilePath(const common::Uri& _uri)
+{
+  std::string packageName, relativePath;
+  if (!resolvePackageUri(_uri, packageName, relativePath))
+    return "";
+
+  for(const std::string& packagePath : getPackagePaths(packageName))
+  {
+    common::Uri fileUri;
+    fileUri.fromPath(packagePath + relativePath);
+
+    const std::string path = mLocalRetriever->getFilePath(fileUri);
+    if(!path.empty())
+      return path;
+  }
+  return "";
+}
+
 //==============================================================================
 const std::vector<std::string>& PackageResourceRetriever::getPackagePaths(
   const std::string& _packageName) const
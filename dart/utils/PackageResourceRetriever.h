@@ -57,6 +57,13 @@ public:
   explicit PackageResourceRetriever(
     const common::ResourceRetrieverPtr& _localRetriever = nullptr);
 
+  /// Construct a PackageResourceRetriever that resolves the same packages as
+  /// \a _other, but uses the specified \a _localRetriever to load resolved
+  /// URIs.
+  PackageResourceRetriever(
+    const PackageResourceRetriever& _other,
+    const common::ResourceRetrieverPtr& _localRetriever);
+
   virtual ~PackageResourceRetriever() = default;
 
   /// Specify the directory of a ROS package. In your URDF files, you may see
@@ -95,6 +102,9 @@ public:
   // Documentation inherited.
   common::ResourcePtr retrieve(const common::Uri& _uri) override;
 
+  // Documentation inherited.
+  std::string getFilePath(const common::Uri& _uri) override;
+
 private:
   common::ResourceRetrieverPtr mLocalRetriever;
   std::unordered_map<std::string, std::vector<std::string> > mPackageMap;
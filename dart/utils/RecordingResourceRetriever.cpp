@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) 2016, Graphics Lab, Georgia Tech Research Corporation
+ * Copyright (c) 2016, Humanoid Lab, Georgia Tech Research Corporation
+ * Copyright (c) 2016, Personal Robotics Lab, Carnegie Mellon University
+ * All rights reserved.
+ *
+ * This file is provided under the following "BSD-style" License:
+ *   Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following
+ *   conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ *   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ *   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ *   USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *   POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "dart/utils/CompiledWorld.h"
+
+#include <cstdint>
+
+#include "dart/utils/RecordingResourceRetriever.h"
+
+#include <algorithm>
+#include "dart/common/LocalResourceRetriever.h"
+
+namespace dart {
+namespace utils {
+
+//==============================================================================
+RecordingResourceRetriever::RecordingResourceRetriever(
+  const common::ResourceRetrieverPtr& _retriever)
+{
+  if (_retriever)
+    mRetriever = _retriever;
+  else
+    mRetriever = std::make_shared<common::LocalResourceRetriever>();
+}
+
+//==============================================================================
+bool RecordingResourceRetriever::exists(const common::Uri& _uri)
+{
+  return mRetriever->exists(_uri);
+}
+
+//==============================================================================
+common::ResourcePtr RecordingResourceRetriever::retrieve(
+  const common::Uri& _uri)
+{
+  common::ResourcePtr resource = mRetriever->retrieve(_uri);
+  if(!resource)
+    return nullptr;
+
+  record(_uri);
+
+  return resource;
+}
+
+//==============================================================================
+std::string RecordingResourceRetriever::getFilePath(const common::Uri& _uri)
+{
+  // The shared meshes are looked up by their file paths and not retrieved
+  // again once they are loaded, so the file is recorded here as well
+  const std::string path = mRetriever->getFilePath(_uri);
+  if(!path.empty())
+    record(_uri);
+
+  return path;
+}
+
+//==============================================================================
+const std::vector<common::Uri>&
+  RecordingResourceRetriever::getRetrievedUris() const
+{
+  return mRetrievedUris;
+}
+
+//==============================================================================
+void RecordingResourceRetriever::record(const common::Uri& _uri)
+{
+  const std::string uri = _uri.toString();
+  const auto it = std::find_if(mRetrievedUris.begin(), mRetrievedUris.end(),
+    [&](const common::Uri& _retrieved) { return _retrieved.toString() == uri; });
+  if(it == mRetrievedUris.end())
+    mRetrievedUris.push_back(_uri);
+}
+
+} // namespace utils
+} // namespace dart
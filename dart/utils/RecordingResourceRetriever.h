@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2016, Graphics Lab, Georgia Tech Research Corporation
+ * Copyright (c) 2016, Humanoid Lab, Georgia Tech Research Corporation
+ * Copyright (c) 2016, Personal Robotics Lab, Carnegie Mellon University
+ * All rights reserved.
+ *
+ * This file is provided under the following "BSD-style" License:
+ *   Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following
+ *   conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ *   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ *   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ *   USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *   POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "dart/utils/CompiledWorld.h"
+
+#include <cstdint>
+
+#ifndef DART_UTILS_RECORDINGRESOURCERETRIEVER_H_
+#define DART_UTILS_RECORDINGRESOURCERETRIEVER_H_
+
+#include <vector>
+#include "dart/common/ResourceRetriever.h"
+#include "dart/common/Uri.h"
+
+namespace dart {
+namespace utils {
+
+/// RecordingResourceRetriever passes every request to another
+/// \ref ResourceRetriever and records the URIs of the resources that were
+/// retrieved or whose file paths were looked up successfully. This is used to find every file that a parser
+/// opens, e.g. to detect the changes of a cached world, see CompiledWorld.
+class RecordingResourceRetriever : public virtual common::ResourceRetriever
+{
+public:
+  /// Construct a RecordingResourceRetriever that uses the specified \a
+  /// _retriever to retrieve resources.
+  explicit RecordingResourceRetriever(
+    const common::ResourceRetrieverPtr& _retriever);
+
+  virtual ~RecordingResourceRetriever() = default;
+
+  // Documentation inherited.
+  bool exists(const common::Uri& _uri) override;
+
+  // Documentation inherited.
+  common::ResourcePtr retrieve(const common::Uri& _uri) override;
+
+  // Documentation inherited.
+  std::string getFilePath(const common::Uri& _uri) override;
+
+  /// Get the URIs of the resources that have been retrieved, in the order in
+  /// which they were first retrieved
+  const std::vector<common::Uri>& getRetrievedUris() const;
+
+private:
+  /// Add _uri to the retrieved URIs unless it is there already
+  void record(const common::Uri& _uri);
+
+  common::ResourceRetrieverPtr mRetriever;
+  std::vector<common::Uri> mRetrievedUris;
+};
+
+using RecordingResourceRetrieverPtr
+  = std::shared_ptr<RecordingResourceRetriever>;
+
+} // namespace utils
+} // namespace dart
+
+#endif // ifndef DART_UTILS_RECORDINGRESOURCERETRIEVER_H_
@@ -71,6 +71,7 @@
 #include "dart/dynamics/Marker.h"
 #include "dart/simulation/World.h"
 #include "dart/utils/SkelParser.h"
+#include "dart/utils/CompiledWorld.h"
 #include "dart/common/LocalResourceRetriever.h"
 #include "dart/common/Uri.h"
 
@@ -137,6 +138,29 @@ simulation::WorldPtr SkelParser::readWorld(
   return readWorld(worldElement, _uri, retriever);
 }
 
+//==============================================================================
+simulation::WorldPtr SkelParser::readCompiledWorld(
+  const common::Uri& _uri,
+  const std::string& _compiledFile,
+  const common::ResourceRetrieverPtr& _retriever)
+{
+  const std::string path = CompiledWorld::getLocalPath(_uri);
+  if(path.empty())
+  {
+    dtwarn << "[SkelParser::readCompiledWorld] [" << _uri.toString()
+           << "] is not a local file, so its changes cannot be detected. "
+           << "Parsing it without the compiled world.\n";
+    return readWorld(_uri, _retriever);
+  }
+
+  // Record the files included by the world file as sources as well
+  const RecordingResourceRetrieverPtr recorder
+      = std::make_shared<RecordingResourceRetriever>(getRetriever(_retriever));
+  return CompiledWorld::loadWorld(_compiledFile, {path}, recorder, [&]() {
+    return readWorld(_uri, recorder);
+  });
+}
+
 //==============================================================================
 simulation::WorldPtr SkelParser::readWorldXML(
   const std::string& _xmlString,
@@ -866,7 +890,8 @@ dynamics::ShapePtr SkelParser::readShape(
     Eigen::Vector3d       scale        = getValueVector3d(meshEle, "scale");
 
     const std::string meshUri = common::Uri::getRelativeUri(_baseUri, filename);
-    const aiScene* model = dynamics::MeshShape::loadMesh(meshUri, _retriever);
+    const std::shared_ptr<const aiScene> model
+        = dynamics::MeshShape::loadSharedMesh(meshUri, _retriever);
     if (model)
     {
       newShape = Eigen::make_aligned_shared<dynamics::MeshShape>(
@@ -93,6 +93,16 @@ public:
     const common::Uri& _uri,
     const common::ResourceRetrieverPtr& _retriever = nullptr);
 
+  /// Read World from skel file through the compiled world _compiledFile. The
+  /// compiled world is read if it is up to date with the skel file, its
+  /// meshes and the other local files that were retrieved while parsing it;
+  /// otherwise the skel file is parsed and compiled into _compiledFile. See
+  /// CompiledWorld.
+  static simulation::WorldPtr readCompiledWorld(
+    const common::Uri& _uri,
+    const std::string& _compiledFile,
+    const common::ResourceRetrieverPtr& _retriever = nullptr);
+
   /// Read World from an xml-formatted string
   static simulation::WorldPtr readWorldXML(
     const std::string& _xmlString,
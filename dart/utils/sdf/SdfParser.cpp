@@ -643,7 +643,8 @@ dynamics::ShapePtr SdfParser::readShape(
           getValueVector3d(meshEle, "scale") : Eigen::Vector3d::Ones();
 
     const std::string meshUri = common::Uri::getRelativeUri(_skelPath, uri);
-    const aiScene* model = dynamics::MeshShape::loadMesh(meshUri, _retriever);
+    const std::shared_ptr<const aiScene> model
+        = dynamics::MeshShape::loadSharedMesh(meshUri, _retriever);
 
     if (model)
       newShape = Eigen::make_aligned_shared<dynamics::MeshShape>(
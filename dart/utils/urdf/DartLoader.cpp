@@ -21,6 +21,7 @@
 #include "dart/dynamics/CylinderShape.h"
 #include "dart/dynamics/MeshShape.h"
 #include "dart/simulation/World.h"
+#include "dart/utils/CompiledWorld.h"
 #include "dart/utils/urdf/URDFTypes.h"
 #include "dart/utils/urdf/urdf_world_parser.h"
 
@@ -103,6 +104,47 @@ simulation::WorldPtr DartLoader::parseWorld(
   return parseWorldString(content, _uri, _resourceRetriever);
 }
 
+simulation::WorldPtr DartLoader::parseCompiledWorld(
+  const common::Uri& _uri,
+  const std::string& _compiledFile,
+  const common::ResourceRetrieverPtr& _resourceRetriever)
+{
+  const std::string path = CompiledWorld::getLocalPath(_uri);
+  if(path.empty())
+  {
+    dtwarn << "[DartLoader::parseCompiledWorld] [" << _uri.toString()
+           << "] is not a local file, so its changes cannot be detected. "
+           << "Parsing it without the compiled world.\n";
+    return parseWorld(_uri, _resourceRetriever);
+  }
+
+  // Record the files included by the world file as sources as well. The
+  // default retrievers are rebuilt around the recorder, so that the files
+  // that package URIs resolve to are recorded too.
+  RecordingResourceRetrieverPtr recorder;
+  common::ResourceRetrieverPtr retriever;
+  if(_resourceRetriever)
+  {
+    recorder = std::make_shared<RecordingResourceRetriever>(_resourceRetriever);
+    retriever = recorder;
+  }
+  else
+  {
+    recorder = std::make_shared<RecordingResourceRetriever>(mLocalRetriever);
+    const CompositeResourceRetrieverPtr composite
+        = std::make_shared<CompositeResourceRetriever>();
+    composite->addSchemaRetriever("file", recorder);
+    composite->addSchemaRetriever("package",
+        std::make_shared<PackageResourceRetriever>(
+          *mPackageRetriever, recorder));
+    retriever = composite;
+  }
+
+  return CompiledWorld::loadWorld(_compiledFile, {path}, recorder, [&]() {
+    return parseWorld(_uri, retriever);
+  });
+}
+
 simulation::WorldPtr DartLoader::parseWorldString(
     const std::string& _urdfString, const common::Uri& _baseUri,
     const common::ResourceRetrieverPtr& _resourceRetriever)
@@ -487,8 +529,8 @@ dynamics::ShapePtr DartLoader::createShape(
 
     // Load the mesh.
     const std::string resolvedUri = absoluteUri.toString();
-    const aiScene* scene = dynamics::MeshShape::loadMesh(
-      resolvedUri, _resourceRetriever);
+    const std::shared_ptr<const aiScene> scene
+        = dynamics::MeshShape::loadSharedMesh(resolvedUri, _resourceRetriever);
     if (!scene)
       return nullptr;
 
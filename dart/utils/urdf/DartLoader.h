@@ -90,6 +90,16 @@ class DartLoader {
     dart::simulation::WorldPtr parseWorld(const common::Uri& _uri,
       const common::ResourceRetrieverPtr& _resourceRetriever = nullptr);
 
+    /// Parse a file to produce a World through the compiled world
+    /// _compiledFile. The compiled world is read if it is up to date with the
+    /// file, its local meshes and the other local files that were retrieved
+    /// while parsing it; otherwise the file is parsed and compiled into
+    /// _compiledFile. If _resourceRetriever resolves package URIs itself, the
+    /// files that they resolve to are not tracked. See CompiledWorld.
+    dart::simulation::WorldPtr parseCompiledWorld(const common::Uri& _uri,
+      const std::string& _compiledFile,
+      const common::ResourceRetrieverPtr& _resourceRetriever = nullptr);
+
     /// Parse a text string to produce a World
     dart::simulation::WorldPtr parseWorldString(
       const std::string& _urdfString, const common::Uri& _baseUri,
@@ -35,7 +35,10 @@
  */
 
 #include <iostream>
+#include <map>
+#include <set>
 #include <gtest/gtest.h>
+#include "TestHelpers.h"
 
 #include <fcl/collision.h>
 #include <fcl/shape/geometric_shapes.h>
@@ -45,6 +48,10 @@
 #include "dart/common/common.h"
 #include "dart/math/math.h"
 #include "dart/dynamics/dynamics.h"
+#include "dart/collision/dart/DARTCollisionDetector.h"
+#include "dart/collision/fcl/FCLCollisionDetector.h"
+#include "dart/collision/fcl/FCLGeometryCache.h"
+#include "dart/collision/fcl_mesh/FCLMeshCollisionDetector.h"
 //#include "dart/collision/unc/UNCCollisionDetector.h"
 #include "dart/simulation/simulation.h"
 #include "dart/utils/utils.h"
@@ -586,6 +593,414 @@ TEST_F(COLLISION, CollisionOfPrescribedJoints)
   }
 }
 
+//==============================================================================
+TEST_F(COLLISION, DARTCollisionDetectorBroadphase)
+{
+  // Scatter boxes and spheres so that only some of them touch each other, and
+  // check that the broadphase doesn't drop any of the colliding pairs that the
+  // pairwise test finds.
+  const size_t numObjects = 60;
+
+  DARTCollisionDetector detector;
+  std::vector<SkeletonPtr> skeletons;
+  for (size_t i = 0; i < numObjects; ++i)
+  {
+    const Eigen::Vector3d position = 2.0 * Eigen::Vector3d::Random();
+
+    SkeletonPtr skel;
+    if (i % 2 == 0)
+    {
+      skel = createBox(Eigen::Vector3d(0.5, 0.3, 0.4), position,
+                       DART_PI * Eigen::Vector3d::Random());
+    }
+    else
+    {
+      skel = createSphere(0.25, position);
+    }
+
+    detector.addSkeleton(skel);
+    skeletons.push_back(skel);
+  }
+
+  for (size_t frame = 0; frame < 3; ++frame)
+  {
+    // Move the objects a bit between the frames to exercise the incremental
+    // sort of the sweep
+    for (const auto& skel : skeletons)
+    {
+      Eigen::Isometry3d T = skel->getBodyNode(0)->getTransform();
+      T.translation() += 0.2 * Eigen::Vector3d::Random();
+      skel->getJoint(0)->setPositions(FreeJoint::convertToPositions(T));
+    }
+
+    detector.detectCollision(true, true);
+
+    std::set<std::pair<BodyNode*, BodyNode*>> broadphasePairs;
+    for (size_t i = 0; i < detector.getNumContacts(); ++i)
+    {
+      const Contact& contact = detector.getContact(i);
+      broadphasePairs.insert(std::make_pair(contact.bodyNode1.lock().get(),
+                                            contact.bodyNode2.lock().get()));
+    }
+
+    // Pairwise test on every pair as the reference
+    CollisionDetector& pairwise = detector;
+    size_t numCollidingPairs = 0;
+    for (size_t i = 0; i < numObjects; ++i)
+    {
+      for (size_t j = i + 1; j < numObjects; ++j)
+      {
+        BodyNode* bodyNode1 = skeletons[i]->getBodyNode(0);
+        BodyNode* bodyNode2 = skeletons[j]->getBodyNode(0);
+
+        const bool colliding
+            = pairwise.detectCollision(bodyNode1, bodyNode2, true);
+        const bool found
+            = broadphasePairs.count(std::make_pair(bodyNode1, bodyNode2)) > 0;
+
+        EXPECT_EQ(colliding, found);
+        if (colliding)
+          ++numCollidingPairs;
+      }
+    }
+
+    EXPECT_EQ(broadphasePairs.size(), numCollidingPairs);
+  }
+}
+
+//==============================================================================
+TEST_F(COLLISION, SharedFCLGeometries)
+{
+  // Identical shapes of different skeletons share one FCL geometry, while
+  // shapes of different sizes get their own
+  typedef FCLGeometryCache<fcl::CollisionGeometry> GeometryCache;
+  typedef FCLGeometryCache<fcl::BVHModel<fcl::OBBRSS>> MeshCache;
+
+  const size_t numGeometries = GeometryCache::getNumGeometries();
+  const size_t numMeshes = MeshCache::getNumGeometries();
+
+  {
+    FCLCollisionDetector fclDetector;
+    FCLMeshCollisionDetector fclMeshDetector;
+    std::vector<SkeletonPtr> skeletons;
+    for (size_t i = 0; i < 10; ++i)
+    {
+      skeletons.push_back(createBox(Eigen::Vector3d(0.5, 0.3, 0.4)));
+      skeletons.push_back(createSphere(0.25));
+    }
+    skeletons.push_back(createBox(Eigen::Vector3d(0.1, 0.1, 0.1)));
+
+    for (const auto& skel : skeletons)
+    {
+      fclDetector.addSkeleton(skel);
+      fclMeshDetector.addSkeleton(skel);
+    }
+
+    EXPECT_EQ(GeometryCache::getNumGeometries(), numGeometries + 3u);
+    EXPECT_EQ(MeshCache::getNumGeometries(), numMeshes + 3u);
+
+    // The shared geometries work the same as separate ones
+    fclDetector.detectCollision(true, true);
+    EXPECT_GT(fclDetector.getNumContacts(), 0u);
+  }
+
+  // The geometries are released with the collision detectors
+  EXPECT_EQ(GeometryCache::getNumGeometries(), numGeometries);
+  EXPECT_EQ(MeshCache::getNumGeometries(), numMeshes);
+}
+
+//==============================================================================
+size_t getNumCollidingPairs(CollisionDetector& _detector)
+{
+  std::set<std::pair<BodyNode*, BodyNode*>> pairs;
+  for (size_t i = 0; i < _detector.getNumContacts(); ++i)
+  {
+    const Contact& contact = _detector.getContact(i);
+    pairs.insert(std::make_pair(contact.bodyNode1.lock().get(),
+                                contact.bodyNode2.lock().get()));
+  }
+
+  return pairs.size();
+}
+
+//==============================================================================
+TEST_F(COLLISION, CollisionFilter)
+{
+  // Pairs that cross the words of the packed bit matrix keep their flags when
+  // an object before them is removed
+  CollisionFilter filter;
+  const size_t numObjects = 100;
+  for (size_t i = 0; i < numObjects; ++i)
+    filter.addObject(nullptr);
+  filter.setParent(11, 10);
+
+  std::set<std::pair<size_t, size_t>> disabledPairs
+      = {{3, 70}, {10, 11}, {65, 99}, {63, 64}};
+  for (const auto& pair : disabledPairs)
+    filter.setPairEnabled(pair.second, pair.first, false);
+
+  filter.removeObject(5);
+  EXPECT_EQ(filter.getNumObjects(), numObjects - 1);
+  EXPECT_TRUE(filter.isAdjacent(9, 10));
+
+  std::set<std::pair<size_t, size_t>> shiftedPairs
+      = {{3, 69}, {9, 10}, {64, 98}, {62, 63}};
+  for (size_t i = 0; i < filter.getNumObjects(); ++i)
+  {
+    for (size_t j = i + 1; j < filter.getNumObjects(); ++j)
+    {
+      const bool disabled = shiftedPairs.count(std::make_pair(i, j)) > 0;
+      EXPECT_EQ(filter.isPairEnabled(i, j), !disabled);
+      EXPECT_EQ(filter.isPairEnabled(j, i), !disabled);
+      EXPECT_EQ(filter.isCollidable(i, j), !disabled);
+    }
+  }
+
+  // Groups and masks filter the pairs of the collision detector
+  DARTCollisionDetector detector;
+  std::vector<SkeletonPtr> spheres;
+  for (size_t i = 0; i < 3; ++i)
+  {
+    spheres.push_back(createSphere(0.5, Eigen::Vector3d(0.1 * i, 0.0, 0.0)));
+    detector.addSkeleton(spheres.back());
+  }
+
+  detector.detectCollision(true, true);
+  EXPECT_EQ(getNumCollidingPairs(detector), 3u);
+
+  detector.setCollisionGroup(spheres[0], 0x2, 0x2);
+  EXPECT_EQ(detector.getCollisionGroup(spheres[0]->getBodyNode(0)), 0x2u);
+  EXPECT_EQ(detector.getCollisionMask(spheres[1]->getBodyNode(0)),
+            CollisionFilter::ALL_GROUPS);
+  detector.detectCollision(true, true);
+  EXPECT_EQ(getNumCollidingPairs(detector), 1u);
+
+  detector.setCollisionGroup(spheres[1]->getBodyNode(0), 0x3);
+  detector.detectCollision(true, true);
+  EXPECT_EQ(getNumCollidingPairs(detector), 2u);
+
+  detector.disablePair(spheres[1]->getBodyNode(0), spheres[2]->getBodyNode(0));
+  detector.detectCollision(true, true);
+  EXPECT_EQ(getNumCollidingPairs(detector), 1u);
+
+  // The flags of the remaining body nodes are kept when a skeleton is removed
+  detector.removeSkeleton(spheres[0]);
+  detector.detectCollision(true, true);
+  EXPECT_EQ(getNumCollidingPairs(detector), 0u);
+  EXPECT_EQ(detector.getCollisionGroup(spheres[1]->getBodyNode(0)), 0x3u);
+}
+
+//==============================================================================
+TEST_F(COLLISION, CollisionFilterStructuralChange)
+{
+  // The filter follows the body nodes when they are moved between skeletons
+  DARTCollisionDetector detector;
+  SkeletonPtr box1 = createBox(Eigen::Vector3d(1.0, 1.0, 1.0));
+  SkeletonPtr box2 = createBox(Eigen::Vector3d(1.0, 1.0, 1.0),
+                               Eigen::Vector3d(0.0, 0.0, 0.9));
+  detector.addSkeleton(box1);
+  detector.addSkeleton(box2);
+
+  BodyNode* body1 = box1->getBodyNode(0);
+  BodyNode* body2 = box2->getBodyNode(0);
+  detector.detectCollision(true, true);
+  EXPECT_EQ(getNumCollidingPairs(detector), 1u);
+
+  // The self collision of the merged skeleton is disabled
+  EXPECT_TRUE(body2->moveTo(body1));
+  EXPECT_EQ(body2->getSkeleton(), box1);
+  detector.detectCollision(true, true);
+  EXPECT_EQ(getNumCollidingPairs(detector), 0u);
+
+  // The body nodes are adjacent after the move
+  box1->enableSelfCollision(false);
+  detector.detectCollision(true, true);
+  EXPECT_EQ(getNumCollidingPairs(detector), 0u);
+
+  box1->enableSelfCollision(true);
+  detector.detectCollision(true, true);
+  EXPECT_EQ(getNumCollidingPairs(detector), 1u);
+
+  // The split body node collides with its former skeleton again
+  box1->disableSelfCollision();
+  SkeletonPtr box3 = body2->split("box3");
+  EXPECT_EQ(body2->getSkeleton(), box3);
+  detector.detectCollision(true, true);
+  EXPECT_EQ(getNumCollidingPairs(detector), 1u);
+}
+
+//==============================================================================
+TEST_F(COLLISION, ContactReduction)
+{
+  // A grid of contacts where every contact has a duplicate closer than the
+  // tolerance, which is merged using the spatial hash grid
+  std::vector<Contact> contacts;
+  for (int i = 0; i < 10; ++i)
+  {
+    for (int j = 0; j < 10; ++j)
+    {
+      Contact contact;
+      contact.point = Eigen::Vector3d(0.1 * i, 0.1 * j, 0.0);
+      contact.normal = Eigen::Vector3d::UnitZ();
+      contact.penetrationDepth = 0.01;
+      contacts.push_back(contact);
+
+      contact.point += Eigen::Vector3d(1e-4, -1e-4, 1e-4);
+      contact.penetrationDepth = (i == 4 && j == 5) ? 0.05 : 0.02;
+      contacts.push_back(contact);
+    }
+  }
+
+  // The contacts before _begin are untouched
+  Contact first;
+  first.point = contacts[0].point;
+  first.penetrationDepth = 0.0;
+  contacts.insert(contacts.begin(), first);
+
+  ContactReduction reduction(1e-3);
+  reduction.reduce(contacts, 1);
+  EXPECT_EQ(contacts.size(), 101u);
+  EXPECT_EQ(contacts[0].penetrationDepth, 0.0);
+  for (size_t i = 1; i < contacts.size(); ++i)
+    EXPECT_GE(contacts[i].penetrationDepth, 0.02);
+
+  // The deepest contact and the corners of the grid span the largest area
+  reduction.setMaxNumContacts(5);
+  reduction.reduce(contacts, 1);
+  EXPECT_EQ(contacts.size(), 6u);
+
+  size_t numCorners = 0;
+  bool hasDeepest = false;
+  for (size_t i = 1; i < contacts.size(); ++i)
+  {
+    const Eigen::Vector3d& point = contacts[i].point;
+    if ((point.x() < 0.01 || point.x() > 0.89)
+        && (point.y() < 0.01 || point.y() > 0.89))
+    {
+      ++numCorners;
+    }
+    if (contacts[i].penetrationDepth == 0.05)
+      hasDeepest = true;
+  }
+  EXPECT_EQ(numCorners, 4u);
+  EXPECT_TRUE(hasDeepest);
+
+  // The contacts between a pair of boxes in the collision detector
+  DARTCollisionDetector detector;
+  SkeletonPtr box1 = createBox(Eigen::Vector3d(1.0, 1.0, 1.0));
+  SkeletonPtr box2 = createBox(Eigen::Vector3d(1.0, 1.0, 1.0),
+                               Eigen::Vector3d(0.2, 0.1, 0.95));
+  detector.addSkeleton(box1);
+  detector.addSkeleton(box2);
+
+  detector.detectCollision(true, true);
+  const size_t numContacts = detector.getNumContacts();
+  EXPECT_GT(numContacts, 2u);
+
+  detector.setMaxNumContactsPerPair(2);
+  EXPECT_EQ(detector.getMaxNumContactsPerPair(), 2u);
+  detector.detectCollision(true, true);
+  EXPECT_EQ(detector.getNumContacts(), 2u);
+
+  detector.setMaxNumContactsPerPair(0);
+  detector.detectCollision(true, true);
+  EXPECT_EQ(detector.getNumContacts(), numContacts);
+}
+
+//==============================================================================
+TEST_F(COLLISION, ContactManifold)
+{
+  DARTCollisionDetector detector;
+  SkeletonPtr ground = createBox(Eigen::Vector3d(10.0, 10.0, 1.0));
+  SkeletonPtr box = createBox(Eigen::Vector3d(1.0, 1.0, 1.0),
+                              Eigen::Vector3d(0.0, 0.0, 0.99));
+  SkeletonPtr sphere = createSphere(0.5, Eigen::Vector3d(3.0, 0.0, 0.99));
+  detector.addSkeleton(ground);
+  detector.addSkeleton(box);
+  detector.addSkeleton(sphere);
+
+  detector.detectCollision(true, true);
+  EXPECT_EQ(detector.getNumContactManifolds(), 2u);
+
+  std::map<std::pair<size_t, size_t>, Eigen::Vector3d> points;
+  for (size_t i = 0; i < detector.getNumContacts(); ++i)
+  {
+    const Contact& contact = detector.getContact(i);
+    const auto id = std::make_pair(contact.manifoldId, contact.featureId);
+    EXPECT_EQ(points.count(id), 0u);
+    points[id] = contact.point;
+  }
+
+  // The contacts keep their IDs while the bodies move slightly
+  box->getDof(3)->setPosition(1e-3);
+  sphere->getDof(5)->setPosition(sphere->getDof(5)->getPosition() - 1e-3);
+  detector.detectCollision(true, true);
+  EXPECT_EQ(detector.getNumContactManifolds(), 2u);
+  EXPECT_EQ(detector.getNumContacts(), points.size());
+  for (size_t i = 0; i < detector.getNumContacts(); ++i)
+  {
+    const Contact& contact = detector.getContact(i);
+    const auto it
+        = points.find(std::make_pair(contact.manifoldId, contact.featureId));
+    ASSERT_TRUE(it != points.end());
+    EXPECT_LT((it->second - contact.point).norm(), 1e-2);
+  }
+
+  // The manifold of a pair is removed when the bodies are separated, and a
+  // new one is created when they touch again
+  const size_t sphereManifoldId = detector.getContactManifolds().rbegin()
+      ->second.getId();
+  sphere->getDof(5)->setPosition(2.0);
+  detector.detectCollision(true, true);
+  EXPECT_EQ(detector.getNumContactManifolds(), 1u);
+
+  sphere->getDof(5)->setPosition(0.99);
+  detector.detectCollision(true, true);
+  EXPECT_EQ(detector.getNumContactManifolds(), 2u);
+  EXPECT_NE(detector.getContactManifolds().rbegin()->second.getId(),
+            sphereManifoldId);
+
+  // The manifolds of the other pairs are kept when a skeleton is removed
+  const size_t boxManifoldId = detector.getContactManifolds().begin()
+      ->second.getId();
+  detector.removeSkeleton(sphere);
+  EXPECT_EQ(detector.getNumContactManifolds(), 1u);
+  detector.detectCollision(true, true);
+  EXPECT_EQ(detector.getNumContactManifolds(), 1u);
+  EXPECT_EQ(detector.getContactManifolds().begin()->second.getId(),
+            boxManifoldId);
+
+  // The manifolds are copied in place over the manifolds of the same pairs
+  CollisionDetector::ContactManifoldMap manifolds;
+  detector.getContactManifolds(manifolds);
+  ASSERT_EQ(manifolds.size(), 1u);
+  const ContactManifold* boxManifold = &manifolds.begin()->second;
+
+  detector.addSkeleton(sphere);
+  detector.detectCollision(true, true);
+  EXPECT_EQ(detector.getNumContactManifolds(), 2u);
+  detector.getContactManifolds(manifolds);
+  EXPECT_EQ(manifolds.size(), 2u);
+  EXPECT_EQ(&manifolds.begin()->second, boxManifold);
+
+  detector.setContactManifolds(manifolds);
+  box->getDof(5)->setPosition(2.0);
+  detector.detectCollision(true, true);
+  EXPECT_EQ(detector.getNumContactManifolds(), 1u);
+
+  detector.setContactManifolds(manifolds);
+  ASSERT_EQ(detector.getNumContactManifolds(), 2u);
+  auto manifold = detector.getContactManifolds().begin();
+  for (const auto& entry : manifolds)
+  {
+    EXPECT_EQ(manifold->first, entry.first);
+    EXPECT_EQ(manifold->second.getId(), entry.second.getId());
+    EXPECT_EQ(manifold->second.getNumContacts(),
+              entry.second.getNumContacts());
+    ++manifold;
+  }
+}
+
 //==============================================================================
 int main(int argc, char* argv[])
 {
@@ -37,6 +37,7 @@
 #include <gtest/gtest.h>
 
 #include "dart/common/Timer.h"
+#include "dart/common/Profiler.h"
 
 using namespace dart::common;
 
@@ -74,6 +75,67 @@ TEST(Common, Timer)
 #endif
 }
 
+//==============================================================================
+TEST(Common, Profiler)
+{
+  Profiler profiler(2);
+  EXPECT_EQ(profiler.getNumSteps(), 0u);
+  EXPECT_EQ(profiler.getLastTime(Profiler::LCP_SOLVE), 0.0);
+
+  // The times and counts are accumulated within a step
+  profiler.beginStep();
+  profiler.addTime(Profiler::LCP_SOLVE, 1.0);
+  profiler.addTime(Profiler::LCP_SOLVE, 2.0);
+  profiler.addCount(Profiler::NUM_CONTACTS, 4u);
+  profiler.endStep();
+
+  EXPECT_EQ(profiler.getNumSteps(), 1u);
+  EXPECT_EQ(profiler.getLastTime(Profiler::LCP_SOLVE), 3.0);
+  EXPECT_EQ(profiler.getLastTime(Profiler::LCP_ASSEMBLY), 0.0);
+  EXPECT_EQ(profiler.getLastCount(Profiler::NUM_CONTACTS), 4u);
+
+  profiler.beginStep();
+  profiler.addTime(Profiler::LCP_SOLVE, 5.0);
+  profiler.endStep();
+
+  EXPECT_EQ(profiler.getLastTime(Profiler::LCP_SOLVE), 5.0);
+  EXPECT_EQ(profiler.getAverageTime(Profiler::LCP_SOLVE), 4.0);
+  EXPECT_EQ(profiler.getAverageCount(Profiler::NUM_CONTACTS), 2.0);
+
+  // Only the last two steps are averaged
+  profiler.beginStep();
+  profiler.addTime(Profiler::LCP_SOLVE, 7.0);
+  profiler.endStep();
+
+  EXPECT_EQ(profiler.getNumSteps(), 3u);
+  EXPECT_EQ(profiler.getAverageTime(Profiler::LCP_SOLVE), 6.0);
+  EXPECT_EQ(profiler.getAverageCount(Profiler::NUM_CONTACTS), 0.0);
+
+  // A ProfileTimer reports when it goes out of scope
+  profiler.beginStep();
+  {
+    ProfileTimer timer(&profiler, Profiler::INTEGRATION);
+#ifdef _WIN32
+    Sleep(2);  // 2 milliseconds
+#else
+    usleep(2000);  // 2 milliseconds
+#endif
+  }
+  profiler.endStep();
+
+#ifdef _WIN32
+  EXPECT_GE(profiler.getLastTime(Profiler::INTEGRATION), 0.00199);
+#else
+  EXPECT_GE(profiler.getLastTime(Profiler::INTEGRATION), 0.002);
+#endif
+  EXPECT_GE(profiler.getLastStepTime(),
+            profiler.getLastTime(Profiler::INTEGRATION));
+
+  profiler.reset();
+  EXPECT_EQ(profiler.getNumSteps(), 0u);
+  EXPECT_EQ(profiler.getAverageTime(Profiler::LCP_SOLVE), 0.0);
+}
+
 //==============================================================================
 int main(int argc, char* argv[])
 {
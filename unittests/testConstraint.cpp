@@ -46,8 +46,13 @@
 #include "dart/math/Geometry.h"
 #include "dart/math/Helpers.h"
 #include "dart/collision/dart/DARTCollisionDetector.h"
+#include "dart/constraint/BlockPGSLCPSolver.h"
+#include "dart/constraint/ConstrainedGroup.h"
+#include "dart/constraint/ContactConstraint.h"
+#include "dart/constraint/DantzigLCPSolver.h"
 #include "dart/dynamics/BodyNode.h"
 #include "dart/dynamics/Skeleton.h"
+#include "dart/lcpsolver/lcp.h"
 #include "dart/simulation/World.h"
 #include "dart/utils/SkelParser.h"
 
@@ -239,6 +244,418 @@ TEST_F(ConstraintTest, SingleContactTest)
   SingleContactTest(getList()[0]);
 }
 
+//==============================================================================
+TEST_F(ConstraintTest, RestingContactAcrossSteps)
+{
+  using namespace Eigen;
+  using namespace dart::collision;
+  using namespace dart::constraint;
+  using namespace dart::dynamics;
+  using namespace dart::simulation;
+
+  // A box resting on the ground keeps the same contacts over the steps so the
+  // contact constraints of the previous steps are reused, and their impulses
+  // are the initial guesses of the next solve. The Dantzig solver ignores the
+  // initial guesses, so use PGS.
+  for (size_t i = 0; i < 2; ++i)
+  {
+    const bool warmStarting = (i == 0);
+
+    WorldPtr world(new World);
+    world->setGravity(Vector3d(0.0, -10.0, 0.0));
+    world->setTimeStep(0.001);
+    ConstraintSolver* solver = world->getConstraintSolver();
+    solver->setCollisionDetector(new DARTCollisionDetector());
+
+    BlockPGSLCPSolver* lcpSolver = new BlockPGSLCPSolver(world->getTimeStep());
+    lcpSolver->setWarmStarting(warmStarting);
+    solver->setLCPSolver(lcpSolver);
+
+    SkeletonPtr boxSkel = createBox(Vector3d(0.4, 0.2, 0.4),
+                                    Vector3d(0.0, 0.1, 0.0));
+    BodyNode* box = boxSkel->getBodyNode(0);
+    world->addSkeleton(boxSkel);
+
+    SkeletonPtr groundSkel = createGround(Vector3d(10.0, 0.1, 10.0),
+                                          Vector3d(0.0, -0.05, 0.0));
+    groundSkel->setMobile(false);
+    world->addSkeleton(groundSkel);
+
+    CollisionDetector* cd = solver->getCollisionDetector();
+
+    for (size_t j = 0; j < 1000; ++j)
+      world->step();
+
+    ASSERT_GT(cd->getNumContacts(), 0u);
+
+    // The contact forces support the weight of the box
+    const double weight = box->getMass() * 10.0;
+    Vector3d totalForce = Vector3d::Zero();
+    for (size_t j = 0; j < cd->getNumContacts(); ++j)
+    {
+      const Contact& contact = cd->getContact(j);
+      if (contact.bodyNode1.lock().get() == box)
+        totalForce += contact.force;
+      else
+        totalForce -= contact.force;
+    }
+    EXPECT_NEAR(std::abs(totalForce[1]), weight, 0.05 * weight);
+
+    // and the box stays at rest
+    EXPECT_NEAR(box->getLinearVelocity().norm(), 0.0, 1e-2);
+    EXPECT_NEAR(box->getTransform().translation()[1], 0.1, 1e-2);
+
+    // Without any iterations, the solve applies exactly the initial guesses
+    std::vector<double> prevState(solver->getWarmStartStateSize());
+    solver->getWarmStartState(prevState.data());
+
+    lcpSolver->setMaxIterations(0);
+    world->step();
+
+    std::vector<double> state(solver->getWarmStartStateSize());
+    solver->getWarmStartState(state.data());
+    ASSERT_EQ(state.size(), prevState.size());
+
+    const size_t numContacts = static_cast<size_t>(state[0]);
+    ASSERT_EQ(numContacts, cd->getNumContacts());
+    for (size_t j = 0; j < numContacts; ++j)
+    {
+      const Vector3d prevImpulse = Vector3d::Map(&prevState[3 + 3 * j]);
+      const Vector3d impulse = Vector3d::Map(&state[3 + 3 * j]);
+
+      if (warmStarting)
+      {
+        // The impulses of the previous step are carried over
+        EXPECT_TRUE(equals(impulse, prevImpulse, 1e-10));
+      }
+      else
+      {
+        EXPECT_TRUE(equals(impulse, Vector3d::Zero().eval()));
+      }
+    }
+
+    if (warmStarting)
+      EXPECT_NEAR(box->getLinearVelocity().norm(), 0.0, 1e-2);
+
+    // Restoring the state forgets the constrained groups, whose constraints
+    // are recreated, and the next step builds them again
+    solver->setWarmStartState(state.data());
+    EXPECT_EQ(solver->getNumConstrainedGroups(), 0u);
+    world->step();
+    EXPECT_EQ(solver->getNumConstrainedGroups(), 1u);
+  }
+}
+
+//==============================================================================
+TEST_F(ConstraintTest, LCPTemporaryBuffer)
+{
+  using namespace Eigen;
+
+  // A random friction LCP solved with and without a preallocated buffer
+  const int n = 9;
+  const int nSkip = dPAD(n);
+
+  MatrixXd J = MatrixXd::Random(n, n);
+  MatrixXd M = J * J.transpose() + MatrixXd::Identity(n, n);
+
+  std::vector<double> A1(n * nSkip, 0.0);
+  std::vector<double> A2(n * nSkip, 0.0);
+  VectorXd b = VectorXd::Random(n);
+  VectorXd b1 = b;
+  VectorXd b2 = b;
+  VectorXd lo(n);
+  VectorXd hi(n);
+  std::vector<int> findex(n);
+  for (int i = 0; i < n; ++i)
+  {
+    for (int j = 0; j < n; ++j)
+      A1[nSkip * i + j] = A2[nSkip * i + j] = M(i, j);
+
+    // Every third variable is a normal impulse followed by two friction ones
+    if (i % 3 == 0)
+    {
+      lo[i] = 0.0;
+      hi[i] = dInfinity;
+      findex[i] = -1;
+    }
+    else
+    {
+      lo[i] = -0.5;
+      hi[i] = 0.5;
+      findex[i] = i - i % 3;
+    }
+  }
+  VectorXd lo1 = lo, lo2 = lo, hi1 = hi, hi2 = hi;
+  VectorXd x1 = VectorXd::Zero(n);
+  VectorXd x2 = VectorXd::Zero(n);
+  VectorXd w1 = VectorXd::Zero(n);
+  VectorXd w2 = VectorXd::Zero(n);
+  std::vector<int> findex1 = findex, findex2 = findex;
+
+  dSolveLCP(n, A1.data(), x1.data(), b1.data(), w1.data(), 0, lo1.data(),
+            hi1.data(), findex1.data());
+
+  std::vector<double> buffer(
+        (dEstimateSolveLCPMemoryReq(n, true) + sizeof(double) - 1)
+        / sizeof(double));
+  dSolveLCP(n, A2.data(), x2.data(), b2.data(), w2.data(), 0, lo2.data(),
+            hi2.data(), findex2.data(), buffer.data());
+
+  EXPECT_TRUE(equals(x1, x2, 0.0));
+  EXPECT_TRUE(equals(w1, w2, 0.0));
+}
+
+//==============================================================================
+class DelassusTestSolver : public dart::constraint::DantzigLCPSolver
+{
+public:
+  explicit DelassusTestSolver(double _timeStep)
+    : dart::constraint::DantzigLCPSolver(_timeStep) {}
+
+  using dart::constraint::LCPSolver::computeDelassusMatrix;
+};
+
+//==============================================================================
+/// Check the LCP matrix of the contacts between the skeletons that is computed
+/// from the constraint Jacobians against the one from the unit impulse tests.
+/// If _hasPrescribedJoints is true, the solver should fall back to the unit
+/// impulse tests instead, so its impulses are checked against the ones of the
+/// LCP of the unit impulse tests.
+void testDelassusMatrix(const std::vector<dart::dynamics::SkeletonPtr>& _skels,
+                        bool _hasPrescribedJoints = false)
+{
+  using namespace dart::collision;
+  using namespace dart::constraint;
+
+  const double timeStep = 0.001;
+
+  DARTCollisionDetector detector;
+  for (const auto& skel : _skels)
+    detector.addSkeleton(skel);
+  detector.detectCollision(true, true);
+  ASSERT_GT(detector.getNumContacts(), 0u);
+
+  ConstrainedGroup group;
+  std::vector<ContactConstraint*> contacts;
+  for (size_t i = 0; i < detector.getNumContacts(); ++i)
+  {
+    contacts.push_back(new ContactConstraint(detector.getContact(i),
+                                             timeStep));
+    ConstraintBase* constraint = contacts.back();
+    constraint->update();
+    if (constraint->isActive())
+      group.addConstraint(constraint);
+  }
+  ASSERT_GT(group.getNumConstraints(), 0u);
+
+  const size_t n = group.getTotalDimension();
+  const int nSkip = dPAD(n);
+  std::vector<size_t> offset(group.getNumConstraints(), 0);
+  for (size_t i = 1; i < group.getNumConstraints(); ++i)
+    offset[i] = offset[i - 1] + group.getConstraint(i - 1)->getDimension();
+
+  // The LCP matrix from the constraint Jacobians
+  DelassusTestSolver solver(timeStep);
+  std::vector<double> A1(n * nSkip, 0.0);
+  std::vector<double> A3(n * nSkip, 0.0);
+  if (_hasPrescribedJoints)
+  {
+    EXPECT_FALSE(solver.computeDelassusMatrix(&group, A1.data(), nSkip,
+                                              offset.data()));
+  }
+  else
+  {
+    ASSERT_TRUE(solver.computeDelassusMatrix(&group, A1.data(), nSkip,
+                                             offset.data()));
+
+    // The buffers of the workspace that are reused give the same matrix
+    ASSERT_TRUE(solver.computeDelassusMatrix(&group, A3.data(), nSkip,
+                                             offset.data()));
+  }
+
+  // The LCP matrix from the unit impulse tests
+  std::vector<double> A2(n * nSkip, 0.0);
+  for (size_t i = 0; i < group.getNumConstraints(); ++i)
+  {
+    ConstraintBase* constraint = group.getConstraint(i);
+    constraint->excite();
+    for (size_t j = 0; j < constraint->getDimension(); ++j)
+    {
+      constraint->applyUnitImpulse(j);
+      for (size_t k = 0; k < group.getNumConstraints(); ++k)
+      {
+        group.getConstraint(k)->getVelocityChange(
+              A2.data() + nSkip * (offset[i] + j) + offset[k], k == i);
+      }
+    }
+    constraint->unexcite();
+  }
+
+  if (!_hasPrescribedJoints)
+  {
+    for (size_t i = 0; i < n; ++i)
+    {
+      for (size_t j = 0; j < n; ++j)
+      {
+        EXPECT_NEAR(A1[nSkip * i + j], A2[nSkip * i + j], 1e-6);
+        EXPECT_EQ(A1[nSkip * i + j], A3[nSkip * i + j]);
+      }
+    }
+  }
+  else
+  {
+    // The impulses of the LCP of the unit impulse tests
+    std::vector<double> x(n, 0.0);
+    std::vector<double> b(n, 0.0);
+    std::vector<double> w(n, 0.0);
+    std::vector<double> lo(n, 0.0);
+    std::vector<double> hi(n, 0.0);
+    std::vector<int> findex(n, -1);
+    ConstraintInfo info;
+    info.invTimeStep = 1.0 / timeStep;
+    for (size_t i = 0; i < group.getNumConstraints(); ++i)
+    {
+      info.x = x.data() + offset[i];
+      info.lo = lo.data() + offset[i];
+      info.hi = hi.data() + offset[i];
+      info.b = b.data() + offset[i];
+      info.findex = findex.data() + offset[i];
+      info.w = w.data() + offset[i];
+      group.getConstraint(i)->getInformation(&info);
+
+      for (size_t j = 0; j < group.getConstraint(i)->getDimension(); ++j)
+      {
+        if (findex[offset[i] + j] >= 0)
+          findex[offset[i] + j] += offset[i];
+      }
+    }
+    dSolveLCP(n, A2.data(), x.data(), b.data(), w.data(), 0, lo.data(),
+              hi.data(), findex.data());
+
+    solver.solve(&group);
+    const LCPWorkspace::Buffer& solverX = group.getWorkspace().x;
+    for (size_t i = 0; i < n; ++i)
+      EXPECT_NEAR(solverX[i], x[i], 1e-6);
+  }
+
+  for (size_t i = 0; i < contacts.size(); ++i)
+    delete contacts[i];
+}
+
+//==============================================================================
+TEST_F(ConstraintTest, DelassusMatrix)
+{
+  using namespace Eigen;
+  using namespace dart::dynamics;
+
+  // Two stacked boxes on the ground
+  SkeletonPtr lowerBox = createBox(Vector3d(0.2, 0.2, 0.2),
+                                   Vector3d(0.0, 0.099, 0.0));
+  SkeletonPtr upperBox = createBox(Vector3d(0.2, 0.2, 0.2),
+                                   Vector3d(0.02, 0.298, 0.0),
+                                   Vector3d(0.0, 0.1, 0.0));
+  SkeletonPtr ground = createGround(Vector3d(10.0, 0.1, 10.0),
+                                    Vector3d(0.0, -0.05, 0.0));
+  ground->setMobile(false);
+
+  testDelassusMatrix({lowerBox, upperBox, ground});
+}
+
+//==============================================================================
+TEST_F(ConstraintTest, ArticulatedDelassusMatrix)
+{
+  using namespace Eigen;
+  using namespace dart::dynamics;
+
+  // A chain of four links that lies on the ground, so that the contacts on
+  // the distal links also act on the joints of the proximal ones, and a box
+  // that rests on the last link
+  SkeletonPtr chain = createNLinkRobot(4, Vector3d(0.1, 0.1, 0.3), DOF_ROLL);
+  Isometry3d T = Isometry3d::Identity();
+  T.translate(Vector3d(0.0, 0.049, 0.0));
+  chain->getJoint(0)->setTransformFromParentBodyNode(T);
+  for (size_t i = 1; i < chain->getNumDofs(); ++i)
+    chain->setPosition(i, 0.001 * i);
+
+  SkeletonPtr box = createBox(Vector3d(0.1, 0.1, 0.1),
+                              Vector3d(0.0, 0.148, 1.05));
+  SkeletonPtr ground = createGround(Vector3d(10.0, 0.1, 10.0),
+                                    Vector3d(0.0, -0.05, 0.0));
+  ground->setMobile(false);
+
+  testDelassusMatrix({chain, box, ground});
+}
+
+//==============================================================================
+TEST_F(ConstraintTest, PrescribedDelassusMatrix)
+{
+  using namespace Eigen;
+  using namespace dart::dynamics;
+
+  // The chain of ArticulatedDelassusMatrix whose second joint is prescribed,
+  // so that its velocity doesn't change by the contact impulses, and a box
+  // that rests on the last link. The ground is left out since the contacts
+  // between the ground and the planar chain make the LCP degenerate.
+  SkeletonPtr chain = createNLinkRobot(4, Vector3d(0.1, 0.1, 0.3), DOF_ROLL);
+  Isometry3d T = Isometry3d::Identity();
+  T.translate(Vector3d(0.0, 0.049, 0.0));
+  chain->getJoint(0)->setTransformFromParentBodyNode(T);
+  for (size_t i = 1; i < chain->getNumDofs(); ++i)
+    chain->setPosition(i, 0.001 * i);
+  chain->getJoint(1)->setActuatorType(Joint::VELOCITY);
+
+  SkeletonPtr box = createBox(Vector3d(0.1, 0.1, 0.1),
+                              Vector3d(0.0, 0.14, 1.05));
+
+  testDelassusMatrix({chain, box}, true);
+}
+
+//==============================================================================
+TEST_F(ConstraintTest, BlockPGSStacking)
+{
+  using namespace Eigen;
+  using namespace dart::collision;
+  using namespace dart::constraint;
+  using namespace dart::dynamics;
+  using namespace dart::simulation;
+
+  WorldPtr world(new World);
+  world->setGravity(Vector3d(0.0, -10.0, 0.0));
+  world->setTimeStep(0.001);
+  world->getConstraintSolver()->setCollisionDetector(
+        new DARTCollisionDetector());
+
+  BlockPGSLCPSolver* lcpSolver = new BlockPGSLCPSolver(world->getTimeStep());
+  world->getConstraintSolver()->setLCPSolver(lcpSolver);
+  EXPECT_EQ(world->getConstraintSolver()->getLCPSolver(), lcpSolver);
+
+  // Three boxes stacked on the ground
+  std::vector<SkeletonPtr> boxes;
+  for (size_t i = 0; i < 3; ++i)
+  {
+    boxes.push_back(createBox(Vector3d(0.2, 0.2, 0.2),
+                              Vector3d(0.0, 0.1 + 0.2 * i, 0.0)));
+    world->addSkeleton(boxes.back());
+  }
+
+  SkeletonPtr ground = createGround(Vector3d(10.0, 0.1, 10.0),
+                                    Vector3d(0.0, -0.05, 0.0));
+  ground->setMobile(false);
+  world->addSkeleton(ground);
+
+  for (size_t i = 0; i < 1000; ++i)
+    world->step();
+
+  // The stack stays at rest
+  for (size_t i = 0; i < boxes.size(); ++i)
+  {
+    BodyNode* box = boxes[i]->getBodyNode(0);
+    EXPECT_NEAR(box->getLinearVelocity().norm(), 0.0, 1e-2);
+    EXPECT_NEAR(box->getTransform().translation()[1], 0.1 + 0.2 * i, 1e-2);
+    EXPECT_NEAR(box->getTransform().translation()[0], 0.0, 1e-2);
+  }
+}
+
 //==============================================================================
 int main(int argc, char* argv[])
 {
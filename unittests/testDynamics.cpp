@@ -45,8 +45,15 @@
 #include "dart/common/Console.h"
 #include "dart/math/Geometry.h"
 #include "dart/math/Helpers.h"
+#include "dart/dynamics/BallJoint.h"
 #include "dart/dynamics/BodyNode.h"
+#include "dart/dynamics/EulerJoint.h"
+#include "dart/dynamics/FreeJoint.h"
+#include "dart/dynamics/PrismaticJoint.h"
+#include "dart/dynamics/RevoluteJoint.h"
 #include "dart/dynamics/Skeleton.h"
+#include "dart/dynamics/SoftBodyNode.h"
+#include "dart/dynamics/UniversalJoint.h"
 #include "dart/dynamics/SimpleFrame.h"
 #include "dart/simulation/World.h"
 #include "dart/utils/SkelParser.h"
@@ -1323,6 +1330,17 @@ void DynamicsTest::compareEquationsOfMotion(const std::string& _fileName)
         cout << "InvAugM_AugM:" << endl << InvAugM_AugM << endl << endl;
       }
 
+      // Check the products with the factorized mass matrices
+      VectorXd v = VectorXd::Random(dof);
+      VectorXd InvM_v = InvM * v;
+      VectorXd M_v = M * v;
+      VectorXd InvAugM_v = InvAugM * v;
+      VectorXd AugM_v = AugM * v;
+      EXPECT_TRUE(equals(skel->solveMassMatrix(v), InvM_v, 1e-6));
+      EXPECT_TRUE(equals(skel->solveInvMassMatrix(v), M_v, 1e-6));
+      EXPECT_TRUE(equals(skel->solveAugMassMatrix(v), InvAugM_v, 1e-6));
+      EXPECT_TRUE(equals(skel->solveInvAugMassMatrix(v), AugM_v, 1e-6));
+
       //------- Coriolis Force Vector and Combined Force Vector Tests --------
       // Get C1, Coriolis force vector using recursive method
       VectorXd C = skel->getCoriolisForces();
@@ -2132,6 +2150,216 @@ TEST_F(DynamicsTest, HybridDynamics)
   }
 }
 
+//==============================================================================
+TEST_F(DynamicsTest, StructuredJointJacobians)
+{
+  using namespace dynamics;
+
+  // Revolute joints whose axis passes through the origin of the child BodyNode
+  // only rotate it, and prismatic joints only translate it. The articulated
+  // body routines skip the vanishing half of their Jacobians, so compare them
+  // against the equations of motion for a mix of those and general joints.
+  SkeletonPtr skel = Skeleton::create("structured");
+  BodyNode* bn = nullptr;
+  for (size_t i = 0; i < 9; ++i)
+  {
+    Eigen::Isometry3d parentToJoint(Eigen::Isometry3d::Identity());
+    parentToJoint.translation() = Vector3d::Random();
+    parentToJoint.linear() = math::expMapRot(Vector3d::Random());
+
+    if (i % 3 == 2)
+    {
+      PrismaticJoint::Properties properties;
+      properties.mAxis = Vector3d::Random().normalized();
+      properties.mT_ParentBodyToJoint = parentToJoint;
+      properties.mT_ChildBodyToJoint.linear()
+          = math::expMapRot(Vector3d::Random());
+      bn = skel->createJointAndBodyNodePair<PrismaticJoint>(
+            bn, properties).second;
+    }
+    else
+    {
+      RevoluteJoint::Properties properties;
+      properties.mAxis = Vector3d::Random().normalized();
+      properties.mT_ParentBodyToJoint = parentToJoint;
+      if (i % 3 == 1)
+        properties.mT_ChildBodyToJoint.translation() = Vector3d::Random();
+      bn = skel->createJointAndBodyNodePair<RevoluteJoint>(
+            bn, properties).second;
+    }
+
+    bn->setMass(1.0 + i);
+    bn->setLocalCOM(Vector3d::Random());
+    bn->setMomentOfInertia(1.0, 2.0, 3.0, 0.1, 0.2, 0.3);
+  }
+
+  const size_t dof = skel->getNumDofs();
+  const MatrixXd I = MatrixXd::Identity(dof, dof);
+  for (size_t i = 0; i < 10; ++i)
+  {
+    skel->setPositions(VectorXd::Random(dof));
+    skel->setVelocities(VectorXd::Random(dof));
+    skel->setForces(VectorXd::Random(dof));
+    skel->computeForwardDynamics();
+
+    const MatrixXd M = skel->getMassMatrix();
+    const VectorXd residual = M * skel->getAccelerations()
+                              + skel->getCoriolisAndGravityForces()
+                              - skel->getForces();
+    EXPECT_TRUE(equals(residual, VectorXd::Zero(dof).eval(), 1e-8));
+    EXPECT_TRUE(equals((skel->getInvMassMatrix() * M).eval(), I, 1e-8));
+  }
+}
+
+//==============================================================================
+TEST_F(DynamicsTest, ArticulatedInertiaResync)
+{
+  using namespace dynamics;
+
+  // The articulated body routines read the articulated inertias without
+  // checking whether they are stale, so change the inertial properties and the
+  // structure of a Skeleton between sweeps without querying anything else.
+  SkeletonPtr skel = Skeleton::create("resync");
+  BodyNode* bn = nullptr;
+  for (size_t i = 0; i < 6; ++i)
+  {
+    RevoluteJoint::Properties properties;
+    properties.mAxis = Vector3d::Random().normalized();
+    properties.mT_ParentBodyToJoint.translation() = Vector3d::Random();
+    bn = skel->createJointAndBodyNodePair<RevoluteJoint>(
+          bn, properties).second;
+    bn->setLocalCOM(Vector3d::Random());
+  }
+
+  for (size_t i = 0; i < 12; ++i)
+  {
+    BodyNode* body = skel->getBodyNode(i % skel->getNumBodyNodes());
+    if (i % 4 == 3)
+    {
+      skel->createJointAndBodyNodePair<RevoluteJoint>(body);
+    }
+    else
+    {
+      body->setMass(1.0 + i);
+      body->setLocalCOM(Vector3d::Random());
+    }
+
+    const size_t dof = skel->getNumDofs();
+    skel->setPositions(VectorXd::Random(dof));
+    skel->setVelocities(VectorXd::Random(dof));
+    skel->setForces(VectorXd::Random(dof));
+
+    if (i % 2 == 0)
+    {
+      const MatrixXd invM = skel->getInvMassMatrix();
+      EXPECT_TRUE(equals((invM * skel->getMassMatrix()).eval(),
+                         MatrixXd::Identity(dof, dof).eval(), 1e-8));
+    }
+    else
+    {
+      skel->computeForwardDynamics();
+      const VectorXd residual = skel->getMassMatrix() * skel->getAccelerations()
+                                + skel->getCoriolisAndGravityForces()
+                                - skel->getForces();
+      EXPECT_TRUE(equals(residual, VectorXd::Zero(dof).eval(), 1e-8));
+    }
+  }
+}
+
+//==============================================================================
+TEST_F(DynamicsTest, CompositeRigidBodyMassMatrix)
+{
+  using namespace dynamics;
+
+  // Branched Skeletons of multi-DOF joints with two trees, the second of which
+  // has soft bodies
+  for (size_t i = 0; i < 5; ++i)
+  {
+    SkeletonPtr skel = Skeleton::create("branched");
+    std::vector<BodyNode*> bodies;
+    bodies.push_back(skel->createJointAndBodyNodePair<FreeJoint>().second);
+    for (size_t j = 0; j < 12; ++j)
+    {
+      BodyNode* parent = bodies[std::rand() % bodies.size()];
+      BodyNode* bn = nullptr;
+      switch (j % 5)
+      {
+        case 0:
+          bn = skel->createJointAndBodyNodePair<RevoluteJoint>(parent).second;
+          break;
+        case 1:
+          bn = skel->createJointAndBodyNodePair<BallJoint>(parent).second;
+          break;
+        case 2:
+          bn = skel->createJointAndBodyNodePair<PrismaticJoint>(parent).second;
+          break;
+        case 3:
+          bn = skel->createJointAndBodyNodePair<UniversalJoint>(parent).second;
+          break;
+        default:
+          bn = skel->createJointAndBodyNodePair<EulerJoint>(parent).second;
+          break;
+      }
+
+      Eigen::Isometry3d parentToJoint(Eigen::Isometry3d::Identity());
+      parentToJoint.translation() = Vector3d::Random();
+      parentToJoint.linear() = math::expMapRot(Vector3d::Random());
+      bn->getParentJoint()->setTransformFromParentBodyNode(parentToJoint);
+      bn->setMass(0.5 + j);
+      bn->setLocalCOM(Vector3d::Random());
+      bn->setMomentOfInertia(1.0 + 0.1 * j, 2.0, 3.0, 0.1, 0.2, 0.3);
+      bodies.push_back(bn);
+    }
+
+    SoftBodyNode::UniqueProperties softProperties
+        = SoftBodyNodeHelper::makeBoxProperties(
+            Vector3d(0.3, 0.4, 0.5), Eigen::Isometry3d::Identity(), 2.0);
+    SoftBodyNode* softRoot = skel->createJointAndBodyNodePair<
+        BallJoint, SoftBodyNode>(
+          nullptr, BallJoint::Properties(),
+          SoftBodyNode::Properties(BodyNode::Properties(),
+                                   softProperties)).second;
+    BodyNode* rigidChild
+        = skel->createJointAndBodyNodePair<RevoluteJoint>(softRoot).second;
+    rigidChild->setLocalCOM(Vector3d::Random());
+    skel->createJointAndBodyNodePair<UniversalJoint, SoftBodyNode>(
+          rigidChild, UniversalJoint::Properties(),
+          SoftBodyNode::Properties(BodyNode::Properties(), softProperties));
+
+    const size_t dof = skel->getNumDofs();
+    skel->setPositions(VectorXd::Random(dof));
+    skel->setVelocities(VectorXd::Random(dof));
+
+    // The mass matrix is the sum of the inertias of the bodies mapped by their
+    // Jacobians
+    const MatrixXd M = skel->getMassMatrix();
+    EXPECT_TRUE(equals(M, getMassMatrix(skel), 1e-8));
+    EXPECT_TRUE(equals(M, MatrixXd(M.transpose()), 1e-12));
+
+    // The columns of the mass matrix of the rigid tree are the generalized
+    // forces for unit accelerations without velocities and gravity, which is
+    // how the mass matrix used to be computed. The point masses of the soft
+    // bodies are not part of the mass matrix, but inverse dynamics accounts
+    // for them.
+    const MatrixXd treeM = skel->getMassMatrix(0);
+    const size_t treeDof = skel->getTreeDofs(0).size();
+    skel->setVelocities(VectorXd::Zero(dof));
+    skel->setGravity(Vector3d::Zero());
+    for (size_t j = 0; j < treeDof; ++j)
+    {
+      VectorXd accelerations = VectorXd::Zero(dof);
+      accelerations[skel->getTreeDofs(0)[j]->getIndexInSkeleton()] = 1.0;
+      skel->setAccelerations(accelerations);
+      skel->computeInverseDynamics();
+
+      VectorXd column(treeDof);
+      for (size_t k = 0; k < treeDof; ++k)
+        column[k] = skel->getTreeDofs(0)[k]->getForce();
+      EXPECT_TRUE(equals(treeM.col(j).eval(), column, 1e-8));
+    }
+  }
+}
+
 //==============================================================================
 int main(int argc, char* argv[])
 {
@@ -34,8 +34,10 @@
  *   POSSIBILITY OF SUCH DAMAGE.
  */
 
+#include <cstdio>
 #include <iostream>
 #include <fstream>
+#include <iterator>
 #include <gtest/gtest.h>
 #include "TestHelpers.h"
 
@@ -135,6 +137,294 @@ TEST(FileInfoWorld, Basic)
   }
 }
 
+//==============================================================================
+void expectEqualRecordings(const Recording* _recording1,
+                           const Recording* _recording2,
+                           double _positionTol, double _contactTol)
+{
+  ASSERT_EQ(_recording1->getNumFrames(), _recording2->getNumFrames());
+  ASSERT_EQ(_recording1->getNumSkeletons(), _recording2->getNumSkeletons());
+
+  for (int i = 0; i < _recording1->getNumSkeletons(); ++i)
+    EXPECT_EQ(_recording1->getNumDofs(i), _recording2->getNumDofs(i));
+
+  for (int i = 0; i < _recording1->getNumFrames(); ++i)
+  {
+    for (int j = 0; j < _recording1->getNumSkeletons(); ++j)
+    {
+      for (int k = 0; k < _recording1->getNumDofs(j); ++k)
+      {
+        EXPECT_NEAR(_recording1->getGenCoord(i, j, k),
+                    _recording2->getGenCoord(i, j, k), _positionTol);
+      }
+    }
+
+    int numContacts = _recording1->getNumContacts(i);
+    ASSERT_EQ(numContacts, _recording2->getNumContacts(i));
+
+    for (int j = 0; j < numContacts; ++j)
+    {
+      for (int k = 0; k < 3; ++k)
+      {
+        EXPECT_NEAR(_recording1->getContactForce(i, j)[k],
+                    _recording2->getContactForce(i, j)[k], _contactTol);
+
+        EXPECT_NEAR(_recording1->getContactPoint(i, j)[k],
+                    _recording2->getContactPoint(i, j)[k], _contactTol);
+      }
+    }
+  }
+}
+
+//==============================================================================
+TEST(FileInfoWorld, BinaryRecording)
+{
+  const size_t numFrames = 150;
+  const std::string fileName = "testWorld.rec";
+  const std::string quantizedFileName = "testWorldQuantized.rec";
+
+  WorldPtr world1 = SkelParser::readWorld(
+      DART_DATA_PATH"/skel/test/file_info_world_test.skel");
+  WorldPtr world2 = SkelParser::readWorld(
+      DART_DATA_PATH"/skel/test/file_info_world_test.skel");
+  ASSERT_TRUE(world1 != nullptr);
+  ASSERT_TRUE(world2 != nullptr);
+
+  // Stream the frames of the first world to a file while it is baked, and
+  // keep the frames of the second one in memory
+  Recording* recording1 = world1->getRecording();
+  Recording* recording2 = world2->getRecording();
+  EXPECT_TRUE(recording1->startStreaming(
+                fileName, Recording::FileOptions(0.0, 0.0, 16)));
+  EXPECT_TRUE(recording1->isStreaming());
+
+  for (size_t i = 0; i < numFrames; ++i)
+  {
+    world1->step();
+    world1->bake();
+    world2->step();
+    world2->bake();
+  }
+
+  // Lossless streaming reproduces the frames exactly
+  expectEqualRecordings(recording1, recording2, 0.0, 0.0);
+
+  // Reload the file after closing it
+  recording1->closeFile();
+  EXPECT_FALSE(recording1->isStreaming());
+  EXPECT_EQ(recording1->getNumFrames(), 0);
+  EXPECT_TRUE(Recording::isRecordingFile(fileName));
+  EXPECT_TRUE(recording1->loadFile(fileName));
+  expectEqualRecordings(recording1, recording2, 0.0, 0.0);
+
+  // Quantized recordings are accurate up to half of the quantization step
+  EXPECT_TRUE(recording2->saveFile(quantizedFileName,
+                                   Recording::FileOptions(1e-6, 1e-4)));
+  Recording quantizedRecording((std::vector<int>()));
+  EXPECT_TRUE(quantizedRecording.loadFile(quantizedFileName));
+  expectEqualRecordings(recording2, &quantizedRecording, 1e-6, 1e-4);
+
+  // FileInfoWorld detects binary recording files
+  FileInfoWorld worldFile;
+  EXPECT_TRUE(worldFile.loadFile(fileName.c_str()));
+  expectEqualRecordings(recording2, worldFile.getRecording(), 0.0, 0.0);
+}
+
+//==============================================================================
+/// Synthetic state of frame number _frameIdx of a recording of two skeletons
+/// with 2 and 3 DOFs, with a varying number of contacts
+Eigen::VectorXd makeRecordingState(int _frameIdx)
+{
+  Eigen::VectorXd state(5 + 6 * (_frameIdx % 3));
+  for (int i = 0; i < state.size(); ++i)
+    state[i] = 0.01 * _frameIdx + 0.1 * i;
+  return state;
+}
+
+//==============================================================================
+void expectRecordingStates(const Recording& _recording, int _numFrames)
+{
+  ASSERT_EQ(_recording.getNumFrames(), _numFrames);
+  for (int i = 0; i < _numFrames; ++i)
+  {
+    const Eigen::VectorXd state = makeRecordingState(i);
+    EXPECT_TRUE(equals(_recording.getConfig(i, 0),
+                       Eigen::VectorXd(state.head(2))));
+    EXPECT_TRUE(equals(_recording.getConfig(i, 1),
+                       Eigen::VectorXd(state.segment(2, 3))));
+    ASSERT_EQ(_recording.getNumContacts(i), i % 3);
+    for (int j = 0; j < i % 3; ++j)
+    {
+      EXPECT_TRUE(equals(_recording.getContactPoint(i, j),
+                         Eigen::Vector3d(state.segment<3>(5 + 6 * j))));
+      EXPECT_TRUE(equals(_recording.getContactForce(i, j),
+                         Eigen::Vector3d(state.segment<3>(8 + 6 * j))));
+    }
+  }
+}
+
+//==============================================================================
+TEST(FileInfoWorld, RecoverBinaryRecording)
+{
+  const std::string fileName = "testRecover.rec";
+  const std::string unclosedFileName = "testRecoverUnclosed.rec";
+  const std::string truncatedFileName = "testRecoverTruncated.rec";
+
+  // Two chunks of four frames are written, and two frames are pending
+  Recording recording1(std::vector<int>{2, 3});
+  ASSERT_TRUE(recording1.startStreaming(
+                fileName, Recording::FileOptions(0.0, 0.0, 4)));
+  for (int i = 0; i < 10; ++i)
+    recording1.addState(makeRecordingState(i));
+
+  // Copy the file as it is before it is closed, and truncate its last chunk
+  std::string content;
+  {
+    std::ifstream file(fileName, std::ios::binary);
+    content.assign(std::istreambuf_iterator<char>(file),
+                   std::istreambuf_iterator<char>());
+  }
+  ASSERT_GT(content.size(), 5u);
+  {
+    std::ofstream file(unclosedFileName, std::ios::binary);
+    file.write(content.data(), content.size());
+  }
+  {
+    std::ofstream file(truncatedFileName, std::ios::binary);
+    file.write(content.data(), content.size() - 5);
+  }
+
+  // A file that was not closed is recovered up to its last complete chunk
+  Recording recording2((std::vector<int>()));
+  ASSERT_TRUE(recording2.loadFile(unclosedFileName));
+  expectRecordingStates(recording2, 8);
+  recording2.closeFile();
+
+  ASSERT_TRUE(recording2.loadFile(truncatedFileName));
+  expectRecordingStates(recording2, 4);
+  recording2.closeFile();
+
+  // The recovered files are valid after they are closed
+  ASSERT_TRUE(recording2.loadFile(unclosedFileName));
+  expectRecordingStates(recording2, 8);
+  recording2.closeFile();
+
+  // The pending frames are written when the file is closed
+  recording1.closeFile();
+  ASSERT_TRUE(recording2.loadFile(fileName));
+  expectRecordingStates(recording2, 10);
+  recording2.closeFile();
+
+  std::remove(fileName.c_str());
+  std::remove(unclosedFileName.c_str());
+  std::remove(truncatedFileName.c_str());
+}
+
+//==============================================================================
+TEST(FileInfoWorld, AppendToBinaryRecording)
+{
+  const std::string fileName = "testAppend.rec";
+
+  // The last chunk of the file is not full
+  Recording recording1(std::vector<int>{2, 3});
+  ASSERT_TRUE(recording1.startStreaming(
+                fileName, Recording::FileOptions(0.0, 0.0, 4)));
+  for (int i = 0; i < 10; ++i)
+    recording1.addState(makeRecordingState(i));
+  recording1.closeFile();
+
+  // Frames added after loading the file complete its last chunk and are
+  // appended to it
+  Recording recording2((std::vector<int>()));
+  ASSERT_TRUE(recording2.loadFile(fileName));
+  expectRecordingStates(recording2, 10);
+  for (int i = 10; i < 15; ++i)
+    recording2.addState(makeRecordingState(i));
+  expectRecordingStates(recording2, 15);
+  recording2.closeFile();
+
+  Recording recording3((std::vector<int>()));
+  ASSERT_TRUE(recording3.loadFile(fileName));
+  expectRecordingStates(recording3, 15);
+  recording3.closeFile();
+
+  std::remove(fileName.c_str());
+}
+
+//==============================================================================
+SkeletonPtr createRevoluteChain(size_t _numDofs)
+{
+  SkeletonPtr skel = Skeleton::create();
+  BodyNode* parent = nullptr;
+  for (size_t i = 0; i < _numDofs; ++i)
+    parent = skel->createJointAndBodyNodePair<RevoluteJoint>(parent).second;
+  return skel;
+}
+
+//==============================================================================
+TEST(FileInfoWorld, RecordingLayoutChange)
+{
+  const std::string fileName = "testLayoutChange.rec";
+  const SkeletonPtr skel2 = createRevoluteChain(2);
+  const SkeletonPtr skel3 = createRevoluteChain(3);
+
+  for (int streaming = 0; streaming < 2; ++streaming)
+  {
+    // The frames recorded before the layout changes are split according to
+    // the new layout, like the frames recorded after it
+    Recording recording(std::vector<SkeletonPtr>{skel2, skel3});
+    if (streaming)
+    {
+      ASSERT_TRUE(recording.startStreaming(
+                    fileName, Recording::FileOptions(0.0, 0.0, 4)));
+    }
+    for (int i = 0; i < 6; ++i)
+      recording.addState(makeRecordingState(i));
+
+    recording.updateNumGenCoords(std::vector<SkeletonPtr>{skel3, skel2});
+    EXPECT_EQ(recording.getNumDofs(0), 3);
+    EXPECT_EQ(recording.getNumDofs(1), 2);
+
+    for (int i = 6; i < 10; ++i)
+      recording.addState(makeRecordingState(i));
+
+    ASSERT_EQ(recording.getNumFrames(), 10);
+    for (int i = 0; i < 10; ++i)
+    {
+      const Eigen::VectorXd state = makeRecordingState(i);
+      EXPECT_TRUE(equals(recording.getConfig(i, 0),
+                         Eigen::VectorXd(state.head(3))));
+      EXPECT_TRUE(equals(recording.getConfig(i, 1),
+                         Eigen::VectorXd(state.segment(3, 2))));
+
+      ASSERT_EQ(recording.getNumContacts(i), i % 3);
+      for (int j = 0; j < i % 3; ++j)
+      {
+        EXPECT_TRUE(equals(recording.getContactPoint(i, j),
+                           Eigen::Vector3d(state.segment<3>(5 + 6 * j))));
+      }
+
+      for (int j = 0; j < 2; ++j)
+      {
+        const Recording::ConfigView view = recording.getConfigView(i, j);
+        ASSERT_LE(view.mFirstFrame, i);
+        ASSERT_LT(i, view.mFirstFrame + view.mNumFrames);
+        EXPECT_EQ(view.mStride, static_cast<size_t>(recording.getNumDofs(j)));
+
+        const Eigen::VectorXd config = recording.getConfig(i, j);
+        EXPECT_TRUE(equals(config, Eigen::VectorXd(
+            Eigen::Map<const Eigen::VectorXd>(
+              view.mData + (i - view.mFirstFrame) * view.mStride,
+              view.mStride))));
+      }
+    }
+
+    recording.closeFile();
+  }
+
+  std::remove(fileName.c_str());
+}
+
 //==============================================================================
 int main(int argc, char* argv[])
 {
@@ -743,6 +743,57 @@ TEST(FRAMES, CHILDHOOD)
   EXPECT_TRUE(F1.getNumChildFrames() == 1);
 }
 
+TEST(FRAMES, NOTIFICATIONS)
+{
+  SimpleFrame F1(Frame::World(), "F1");
+  SimpleFrame F2(&F1, "F2");
+  SimpleFrame F3(&F2, "F3");
+
+  size_t transformNotices = 0;
+  size_t velocityNotices = 0;
+  size_t accelerationNotices = 0;
+  common::Connection transformConnection = F3.onTransformUpdated.connect(
+        [&](const Entity*) { ++transformNotices; });
+  common::Connection velocityConnection = F3.onVelocityChanged.connect(
+        [&](const Entity*) { ++velocityNotices; });
+  common::Connection accelerationConnection = F3.onAccelerationChanged.connect(
+        [&](const Entity*) { ++accelerationNotices; });
+
+  F3.getWorldTransform();
+  F3.getSpatialVelocity();
+  F3.getSpatialAcceleration();
+  EXPECT_FALSE(F3.needsTransformUpdate());
+  EXPECT_FALSE(F3.needsVelocityUpdate());
+  EXPECT_FALSE(F3.needsAccelerationUpdate());
+
+  // Changing a transform dirties everything below it in one pass
+  Eigen::Isometry3d tf;
+  randomize_transform(tf);
+  F1.setRelativeTransform(tf);
+  EXPECT_TRUE(F3.needsTransformUpdate());
+  EXPECT_TRUE(F3.needsVelocityUpdate());
+  EXPECT_TRUE(F3.needsAccelerationUpdate());
+  EXPECT_EQ(transformNotices, 1u);
+  EXPECT_EQ(velocityNotices, 1u);
+  EXPECT_EQ(accelerationNotices, 1u);
+
+  // The velocity can be cleaned while the transform is still dirty, and then
+  // it must be dirtied again by the next transform change
+  F3.getSpatialVelocity();
+  EXPECT_TRUE(F3.needsTransformUpdate());
+  EXPECT_FALSE(F3.needsVelocityUpdate());
+  F1.setRelativeTransform(tf);
+  EXPECT_TRUE(F3.needsVelocityUpdate());
+  EXPECT_TRUE(F3.needsAccelerationUpdate());
+
+  // The result must still be correct after all of that
+  randomize_transform(tf);
+  F2.setRelativeTransform(tf);
+  EXPECT_TRUE(equals(F3.getWorldTransform().matrix(),
+                     (F1.getRelativeTransform()*F2.getRelativeTransform()
+                      *F3.getRelativeTransform()).matrix()));
+}
+
 int main(int argc, char* argv[])
 {
   srand(271828); // Seed with an arbitrary fixed integer. Don't seed with time,
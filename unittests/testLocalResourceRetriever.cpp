@@ -110,6 +110,27 @@ TEST(LocalResourceRetriever, retrieve_Path)
   ASSERT_TRUE(resource != nullptr);
 }
 
+TEST(LocalResourceRetriever, getFilePath_UnsupportedUri_ReturnsEmpty)
+{
+  LocalResourceRetriever retriever;
+  EXPECT_EQ("", retriever.getFilePath("unknown://test"));
+}
+
+TEST(LocalResourceRetriever, getFilePath_FileUriDoesNotExist_ReturnsEmpty)
+{
+  LocalResourceRetriever retriever;
+  EXPECT_EQ("", retriever.getFilePath(FILE_SCHEME DART_DATA_PATH "does/not/exist"));
+}
+
+TEST(LocalResourceRetriever, getFilePath_FileUriAndPath)
+{
+  LocalResourceRetriever retriever;
+  EXPECT_EQ(DART_DATA_PATH "test/hello_world.txt",
+            retriever.getFilePath(FILE_SCHEME DART_DATA_PATH "test/hello_world.txt"));
+  EXPECT_EQ(DART_DATA_PATH "test/hello_world.txt",
+            retriever.getFilePath(DART_DATA_PATH "test/hello_world.txt"));
+}
+
 TEST(LocalResourceRetriever, retrieve_ResourceOperations)
 {
   const std::string content = "Hello World";
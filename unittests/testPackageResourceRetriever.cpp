@@ -242,6 +242,25 @@ TEST(PackageResourceRetriever, retrieve_FallsBackOnSecondUri)
   EXPECT_EQ(expected2, mockRetriever->mRetrieve[1]);
 }
 
+TEST(PackageResourceRetriever, getFilePath_UnableToResolve_ReturnsEmpty)
+{
+  PackageResourceRetriever retriever;
+  retriever.addPackageDirectory("test", DART_DATA_PATH"test");
+
+  EXPECT_EQ("", retriever.getFilePath(Uri::createFromString("package://foo/hello_world.txt")));
+  EXPECT_EQ("", retriever.getFilePath(Uri::createFromString("package://test/foo")));
+}
+
+TEST(PackageResourceRetriever, getFilePath_FallsBackOnSecondUri)
+{
+  PackageResourceRetriever retriever;
+  retriever.addPackageDirectory("test", DART_DATA_PATH"does/not/exist");
+  retriever.addPackageDirectory("test", DART_DATA_PATH"test");
+
+  EXPECT_EQ(DART_DATA_PATH"test/hello_world.txt",
+    retriever.getFilePath(Uri::createFromString("package://test/hello_world.txt")));
+}
+
 int main(int argc, char* argv[])
 {
   ::testing::InitGoogleTest(&argc, argv);
@@ -34,17 +34,22 @@
  *   POSSIBILITY OF SUCH DAMAGE.
  */
 
+#include <algorithm>
+#include <cstdio>
 #include <iostream>
 #include <gtest/gtest.h>
 #include "TestHelpers.h"
 
 #include "dart/dynamics/SoftBodyNode.h"
+#include "dart/dynamics/MeshShape.h"
 #include "dart/dynamics/RevoluteJoint.h"
 #include "dart/dynamics/PlanarJoint.h"
 #include "dart/dynamics/Skeleton.h"
 #include "dart/simulation/World.h"
 #include "dart/simulation/World.h"
 #include "dart/utils/SkelParser.h"
+#include "dart/utils/CompiledWorld.h"
+#include "dart/utils/PackageResourceRetriever.h"
 
 using namespace dart;
 using namespace math;
@@ -165,6 +170,206 @@ TEST(SkelParser, VariousShapes)
     world->step();
 }
 
+//==============================================================================
+TEST(SkelParser, SharedMeshes)
+{
+  // The same mesh file is loaded only once and shared by all the shapes that
+  // use it, even across the worlds
+  WorldPtr world1 = SkelParser::readWorld(DART_DATA_PATH"skel/shapes.skel");
+  WorldPtr world2 = SkelParser::readWorld(DART_DATA_PATH"skel/shapes.skel");
+
+  std::vector<std::shared_ptr<MeshShape>> meshShapes;
+  for (const WorldPtr& world : {world1, world2})
+  {
+    BodyNode* body = world->getSkeleton("mesh skeleton")->getBodyNode(0);
+    meshShapes.push_back(std::dynamic_pointer_cast<MeshShape>(
+                           body->getVisualizationShape(0)));
+    meshShapes.push_back(std::dynamic_pointer_cast<MeshShape>(
+                           body->getCollisionShape(0)));
+  }
+
+  for (const auto& meshShape : meshShapes)
+  {
+    ASSERT_NE(meshShape, nullptr);
+    EXPECT_EQ(meshShape->getMesh(), meshShapes[0]->getMesh());
+  }
+
+  // Changing the alpha of a shape whose mesh has vertex colors changes a copy
+  // of the mesh, so the shapes of the other world keep their colors
+  aiMesh* coloredMesh = meshShapes[0]->getMesh()->mMeshes[0];
+  if (nullptr == coloredMesh->mColors[0])
+  {
+    coloredMesh->mColors[0] = new aiColor4D[coloredMesh->mNumVertices];
+    std::fill(coloredMesh->mColors[0],
+              coloredMesh->mColors[0] + coloredMesh->mNumVertices,
+              aiColor4D(1.0f, 1.0f, 1.0f, 1.0f));
+  }
+  const float sharedAlpha = coloredMesh->mColors[0][0].a;
+
+  const aiScene* sharedMesh = meshShapes[2]->getMesh();
+  meshShapes[0]->setAlpha(0.5);
+  EXPECT_EQ(meshShapes[0]->getRGBA()[3], 0.5);
+  ASSERT_NE(meshShapes[0]->getMesh(), sharedMesh);
+  EXPECT_EQ(meshShapes[0]->getMesh()->mMeshes[0]->mColors[0][0].a, 0.5f);
+  EXPECT_EQ(sharedMesh->mMeshes[0]->mColors[0][0].a, sharedAlpha);
+  EXPECT_EQ(meshShapes[3]->getMesh(), sharedMesh);
+
+  // The mesh is released with the last shape that uses it
+  const size_t numSharedMeshes = MeshShape::getNumSharedMeshes();
+  EXPECT_GE(numSharedMeshes, 1u);
+
+  meshShapes.clear();
+  world1.reset();
+  world2.reset();
+  EXPECT_EQ(MeshShape::getNumSharedMeshes(), numSharedMeshes - 1u);
+}
+
+//==============================================================================
+TEST(SkelParser, SharedMeshesByFilePath)
+{
+  // The same file is shared whether it's referred by a path or a package URI
+  auto retriever1 = std::make_shared<PackageResourceRetriever>();
+  retriever1->addPackageDirectory("meshes", DART_DATA_PATH"sdf/test");
+  const auto mesh1 = MeshShape::loadSharedMesh(
+        DART_DATA_PATH"sdf/test/pelvis.dae");
+  const auto mesh2 = MeshShape::loadSharedMesh(
+        "package://meshes/pelvis.dae", retriever1);
+  ASSERT_NE(mesh1, nullptr);
+  EXPECT_EQ(mesh1, mesh2);
+
+  // The same package URI of retrievers that resolve it to different files
+  // refers to different meshes
+  auto retriever2 = std::make_shared<PackageResourceRetriever>();
+  retriever2->addPackageDirectory("meshes", DART_DATA_PATH"sdf/atlas");
+  const auto mesh3 = MeshShape::loadSharedMesh(
+        "package://meshes/pelvis.dae", retriever2);
+  ASSERT_NE(mesh3, nullptr);
+  EXPECT_NE(mesh1, mesh3);
+}
+
+//==============================================================================
+TEST(SkelParser, CompiledWorld)
+{
+  const std::string skelFile = DART_DATA_PATH"skel/shapes.skel";
+  const std::string compiledFile = "testCompiledWorld.dwc";
+  std::remove(compiledFile.c_str());
+
+  // The first call parses the skel file and compiles it
+  WorldPtr world1 = SkelParser::readCompiledWorld(skelFile, compiledFile);
+  ASSERT_NE(world1, nullptr);
+  EXPECT_TRUE(CompiledWorld::isUpToDate(compiledFile, {skelFile}));
+
+  // The second call reads the compiled world
+  WorldPtr world2 = SkelParser::readCompiledWorld(skelFile, compiledFile);
+  ASSERT_NE(world2, nullptr);
+  EXPECT_NE(world1, world2);
+
+  EXPECT_EQ(world1->getTimeStep(), world2->getTimeStep());
+  EXPECT_TRUE(equals(world1->getGravity(), world2->getGravity()));
+  ASSERT_EQ(world1->getNumSkeletons(), world2->getNumSkeletons());
+  for (size_t i = 0; i < world1->getNumSkeletons(); ++i)
+  {
+    SkeletonPtr skel1 = world1->getSkeleton(i);
+    SkeletonPtr skel2 = world2->getSkeleton(i);
+    EXPECT_EQ(skel1->getName(), skel2->getName());
+    ASSERT_EQ(skel1->getNumBodyNodes(), skel2->getNumBodyNodes());
+    ASSERT_EQ(skel1->getNumDofs(), skel2->getNumDofs());
+    EXPECT_TRUE(equals(skel1->getPositions(), skel2->getPositions()));
+
+    for (size_t j = 0; j < skel1->getNumBodyNodes(); ++j)
+    {
+      BodyNode* body1 = skel1->getBodyNode(j);
+      BodyNode* body2 = skel2->getBodyNode(j);
+      EXPECT_EQ(body1->getName(), body2->getName());
+      EXPECT_EQ(body1->getParentJoint()->getType(),
+                body2->getParentJoint()->getType());
+      EXPECT_EQ(body1->getMass(), body2->getMass());
+      EXPECT_EQ(body1->getNumVisualizationShapes(),
+                body2->getNumVisualizationShapes());
+      ASSERT_EQ(body1->getNumCollisionShapes(),
+                body2->getNumCollisionShapes());
+      for (size_t k = 0; k < body1->getNumCollisionShapes(); ++k)
+      {
+        EXPECT_EQ(body1->getCollisionShape(k)->getShapeType(),
+                  body2->getCollisionShape(k)->getShapeType());
+        EXPECT_TRUE(equals(body1->getCollisionShape(k)->getBoundingBoxDim(),
+                           body2->getCollisionShape(k)->getBoundingBoxDim()));
+      }
+    }
+  }
+
+  // The compiled world simulates the same way as the parsed one
+  for (size_t i = 0; i < 10; ++i)
+  {
+    world1->step();
+    world2->step();
+  }
+
+  for (size_t i = 0; i < world1->getNumSkeletons(); ++i)
+  {
+    EXPECT_TRUE(equals(world1->getSkeleton(i)->getPositions(),
+                       world2->getSkeleton(i)->getPositions()));
+  }
+
+  std::remove(compiledFile.c_str());
+}
+
+//==============================================================================
+TEST(SkelParser, CompiledWorldInterleavedTrees)
+{
+  // The second tree is created before the child of the first tree, so the
+  // BodyNodes and DOFs of the Skeleton are not in tree order
+  SkeletonPtr skel = Skeleton::create("interleaved");
+  BodyNode* root1 = skel->createJointAndBodyNodePair<PlanarJoint>().second;
+  root1->setName("root1");
+  BodyNode* root2 = skel->createJointAndBodyNodePair<RevoluteJoint>().second;
+  root2->setName("root2");
+  BodyNode* child1
+      = skel->createJointAndBodyNodePair<RevoluteJoint>(root1).second;
+  child1->setName("child1");
+  child1->getParentJoint()->setTransformFromParentBodyNode(
+        Eigen::Isometry3d(Eigen::Translation3d(0.0, 0.5, 0.0)));
+  ASSERT_EQ(skel->getNumTrees(), 2u);
+
+  Eigen::VectorXd positions(skel->getNumDofs());
+  Eigen::VectorXd velocities(skel->getNumDofs());
+  for (size_t i = 0; i < skel->getNumDofs(); ++i)
+  {
+    positions[i] = 0.1 * (i + 1);
+    velocities[i] = -0.2 * (i + 1);
+  }
+  skel->setPositions(positions);
+  skel->setVelocities(velocities);
+
+  WorldPtr world1(new World);
+  world1->addSkeleton(skel);
+
+  const std::string compiledFile = "testCompiledWorldInterleaved.dwc";
+  ASSERT_TRUE(CompiledWorld::writeWorld(world1, compiledFile));
+  WorldPtr world2 = CompiledWorld::readWorld(compiledFile);
+  std::remove(compiledFile.c_str());
+  ASSERT_NE(world2, nullptr);
+  ASSERT_EQ(world2->getNumSkeletons(), 1u);
+
+  SkeletonPtr skel2 = world2->getSkeleton(0);
+  ASSERT_EQ(skel2->getNumBodyNodes(), skel->getNumBodyNodes());
+  ASSERT_EQ(skel2->getNumDofs(), skel->getNumDofs());
+  EXPECT_TRUE(equals(skel2->getPositions(), positions));
+  EXPECT_TRUE(equals(skel2->getVelocities(), velocities));
+  for (size_t i = 0; i < skel->getNumBodyNodes(); ++i)
+  {
+    const BodyNode* body1 = skel->getBodyNode(i);
+    const BodyNode* body2 = skel2->getBodyNode(i);
+    EXPECT_EQ(body1->getName(), body2->getName());
+    EXPECT_TRUE(equals(body1->getTransform().matrix(),
+                       body2->getTransform().matrix()));
+  }
+  for (size_t i = 0; i < skel->getNumDofs(); ++i)
+  {
+    EXPECT_EQ(skel->getDof(i)->getName(), skel2->getDof(i)->getName());
+  }
+}
+
 //==============================================================================
 TEST(SkelParser, RigidAndSoftBodies)
 {
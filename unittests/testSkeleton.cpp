@@ -42,6 +42,7 @@
 #include "dart/math/Geometry.h"
 #include "dart/utils/SkelParser.h"
 #include "dart/dynamics/BodyNode.h"
+#include "dart/dynamics/Group.h"
 #include "dart/dynamics/RevoluteJoint.h"
 #include "dart/dynamics/Skeleton.h"
 #include "dart/simulation/World.h"
@@ -936,6 +937,208 @@ TEST(Skeleton, Linkage)
                     "c3b1", "c1b3", "c5b1", "c5b2", "c1b2", "c1b1");
 }
 
+TEST(Skeleton, ContiguousState)
+{
+  SkeletonPtr skel = Skeleton::create("skel");
+  BodyNode* bn = skel->createJointAndBodyNodePair<FreeJoint>().second;
+  bn = skel->createJointAndBodyNodePair<RevoluteJoint>(bn).second;
+  bn = skel->createJointAndBodyNodePair<BallJoint>(bn).second;
+  BodyNode* slider = skel->createJointAndBodyNodePair<PrismaticJoint>(bn).second;
+  skel->createJointAndBodyNodePair<WeldJoint>(slider);
+  skel->createJointAndBodyNodePair<EulerJoint>(slider);
+  skel->createJointAndBodyNodePair<RevoluteJoint>();
+
+  SkeletonPtr copy = skel->clone();
+  const size_t numDofs = skel->getNumDofs();
+  const Eigen::VectorXd q = Eigen::VectorXd::Random(numDofs);
+  const Eigen::VectorXd dq = Eigen::VectorXd::Random(numDofs);
+  const Eigen::VectorXd ddq = Eigen::VectorXd::Random(numDofs);
+  for(const SkeletonPtr& s : {skel, copy})
+  {
+    s->setPositions(q);
+    s->setVelocities(dq);
+    s->setAccelerations(ddq);
+  }
+
+  // Integrating the whole Skeleton must match integrating Joint by Joint
+  const double dt = 1e-3;
+  skel->integratePositions(dt);
+  skel->integrateVelocities(dt);
+  for(size_t i=0; i<copy->getNumJoints(); ++i)
+  {
+    copy->getJoint(i)->integratePositions(dt);
+    copy->getJoint(i)->integrateVelocities(dt);
+  }
+
+  EXPECT_TRUE(equals(skel->getPositions(), copy->getPositions()));
+  EXPECT_TRUE(equals(skel->getVelocities(), copy->getVelocities()));
+  for(size_t i=0; i<skel->getNumBodyNodes(); ++i)
+  {
+    EXPECT_TRUE(equals(skel->getBodyNode(i)->getWorldTransform().matrix(),
+                       copy->getBodyNode(i)->getWorldTransform().matrix()));
+    EXPECT_TRUE(equals(skel->getBodyNode(i)->getSpatialVelocity(),
+                       copy->getBodyNode(i)->getSpatialVelocity()));
+  }
+
+  // Setting the state must update the kinematics of the affected BodyNodes
+  const Eigen::VectorXd state = Eigen::VectorXd::Random(2*numDofs);
+  skel->setState(state);
+  copy->setPositions(state.head(numDofs));
+  copy->setVelocities(state.tail(numDofs));
+  EXPECT_TRUE(equals(skel->getState(), state));
+  for(size_t i=0; i<skel->getNumBodyNodes(); ++i)
+  {
+    EXPECT_TRUE(equals(skel->getBodyNode(i)->getWorldTransform().matrix(),
+                       copy->getBodyNode(i)->getWorldTransform().matrix()));
+    EXPECT_TRUE(equals(skel->getBodyNode(i)->getSpatialVelocity(),
+                       copy->getBodyNode(i)->getSpatialVelocity()));
+  }
+
+  // Restructuring must preserve the values of every Joint
+  skel->setCommands(Eigen::VectorXd::Random(numDofs));
+  std::vector<std::pair<Joint*, Eigen::VectorXd>> values;
+  for(size_t i=0; i<skel->getNumJoints(); ++i)
+  {
+    Joint* joint = skel->getJoint(i);
+    Eigen::VectorXd v(3*joint->getNumDofs());
+    v << joint->getPositions(), joint->getVelocities(), joint->getCommands();
+    values.push_back(std::make_pair(joint, v));
+  }
+
+  SkeletonPtr other = slider->split("other");
+  EXPECT_TRUE(skel->getNumDofs() + other->getNumDofs() == numDofs);
+  skel->getBodyNode(0)->copyTo(other, nullptr);
+  other->getRootBodyNode(0)->moveTo(skel, skel->getBodyNode(0));
+
+  for(const auto& value : values)
+  {
+    Joint* joint = value.first;
+    Eigen::VectorXd v(3*joint->getNumDofs());
+    v << joint->getPositions(), joint->getVelocities(), joint->getCommands();
+    EXPECT_TRUE(equals(v, value.second));
+  }
+
+  // The state arrays are rebuilt once they are accessed, so the values that
+  // are set through the Joints after restructuring are kept as well
+  bn = skel->createJointAndBodyNodePair<RevoluteJoint>(
+        skel->getBodyNode(0)).second;
+  bn->getParentJoint()->setPosition(0, 0.5);
+  slider->getParentJoint()->setPosition(0, -0.5);
+  const Eigen::VectorXd positions = skel->getPositions();
+  EXPECT_EQ(positions[bn->getParentJoint()->getIndexInSkeleton(0)], 0.5);
+  EXPECT_EQ(positions[slider->getParentJoint()->getIndexInSkeleton(0)], -0.5);
+  EXPECT_TRUE(equals(skel->getState().head(skel->getNumDofs()).eval(),
+                     positions));
+}
+
+//==============================================================================
+static void checkMatchingKinematics(const SkeletonPtr& _skel,
+                                    const SkeletonPtr& _copy)
+{
+  for(size_t i=0; i<_skel->getNumBodyNodes(); ++i)
+  {
+    const BodyNode* bn = _skel->getBodyNode(i);
+    const BodyNode* other = _copy->getBodyNode(i);
+    EXPECT_TRUE(equals(bn->getWorldTransform().matrix(),
+                       other->getWorldTransform().matrix()));
+    EXPECT_TRUE(equals(bn->getSpatialVelocity(), other->getSpatialVelocity()));
+    EXPECT_TRUE(equals(bn->getSpatialAcceleration(),
+                       other->getSpatialAcceleration()));
+  }
+}
+
+//==============================================================================
+TEST(Skeleton, BatchedUpdates)
+{
+  SkeletonPtr skel = Skeleton::create("skel");
+  BodyNode* bn = skel->createJointAndBodyNodePair<FreeJoint>().second;
+  bn = skel->createJointAndBodyNodePair<RevoluteJoint>(bn).second;
+  skel->createJointAndBodyNodePair<BallJoint>(bn);
+  bn = skel->createJointAndBodyNodePair<PrismaticJoint>(bn).second;
+  skel->createJointAndBodyNodePair<RevoluteJoint>(bn);
+  skel->getJoint(1)->setActuatorType(Joint::VELOCITY);
+  skel->getJoint(3)->setActuatorType(Joint::ACCELERATION);
+
+  SkeletonPtr other = skel->clone();
+  SkeletonPtr copy = skel->clone();
+  SkeletonPtr otherCopy = skel->clone();
+  const size_t numDofs = skel->getNumDofs();
+
+  // Evaluate everything first so that stale caches would be caught
+  checkMatchingKinematics(skel, copy);
+  checkMatchingKinematics(other, otherCopy);
+
+  // Setting a whole Skeleton at once must match setting each DOF
+  const Eigen::VectorXd q = Eigen::VectorXd::Random(numDofs);
+  const Eigen::VectorXd dq = Eigen::VectorXd::Random(numDofs);
+  const Eigen::VectorXd ddq = Eigen::VectorXd::Random(numDofs);
+  const Eigen::VectorXd f = Eigen::VectorXd::Random(numDofs);
+  skel->setPositions(q);
+  skel->setVelocities(dq);
+  skel->setAccelerations(ddq);
+  skel->setForces(f);
+  for(size_t i=0; i<numDofs; ++i)
+  {
+    copy->getDof(i)->setPosition(q[i]);
+    copy->getDof(i)->setVelocity(dq[i]);
+    copy->getDof(i)->setAcceleration(ddq[i]);
+    copy->getDof(i)->setForce(f[i]);
+  }
+
+  EXPECT_TRUE(equals(skel->getPositions(), q));
+  EXPECT_TRUE(equals(skel->getVelocities(), dq));
+  EXPECT_TRUE(equals(skel->getAccelerations(), ddq));
+  EXPECT_TRUE(equals(skel->getForces(), f));
+  EXPECT_TRUE(equals(skel->getCommands(), copy->getCommands()));
+  checkMatchingKinematics(skel, copy);
+
+  // Indexed setters may touch only some of the Joints, in any order
+  std::vector<size_t> indices;
+  for(size_t i=0; i<numDofs; i += 2)
+    indices.push_back(numDofs-1-i);
+
+  const Eigen::VectorXd values = Eigen::VectorXd::Random(indices.size());
+  skel->setPositions(indices, values);
+  skel->setVelocities(indices, values);
+  for(size_t i=0; i<indices.size(); ++i)
+  {
+    copy->getDof(indices[i])->setPosition(values[i]);
+    copy->getDof(indices[i])->setVelocity(values[i]);
+  }
+
+  EXPECT_TRUE(equals(skel->getPositions(indices), values));
+  EXPECT_TRUE(equals(skel->getVelocities(indices), values));
+  EXPECT_TRUE(equals(skel->getCommands(), copy->getCommands()));
+  checkMatchingKinematics(skel, copy);
+
+  // A Group may interleave the DOFs of several Skeletons
+  std::vector<DegreeOfFreedom*> dofs;
+  for(size_t i=0; i<numDofs; ++i)
+  {
+    dofs.push_back(skel->getDof(numDofs-1-i));
+    dofs.push_back(other->getDof(i));
+  }
+  GroupPtr group = Group::create("group", dofs);
+
+  const Eigen::VectorXd groupValues = Eigen::VectorXd::Random(2*numDofs);
+  group->setPositions(groupValues);
+  group->setAccelerations(groupValues);
+  for(size_t i=0; i<numDofs; ++i)
+  {
+    copy->getDof(numDofs-1-i)->setPosition(groupValues[2*i]);
+    copy->getDof(numDofs-1-i)->setAcceleration(groupValues[2*i]);
+    otherCopy->getDof(i)->setPosition(groupValues[2*i+1]);
+    otherCopy->getDof(i)->setAcceleration(groupValues[2*i+1]);
+  }
+
+  EXPECT_TRUE(equals(group->getPositions(), groupValues));
+  EXPECT_TRUE(equals(group->getAccelerations(), groupValues));
+  EXPECT_TRUE(equals(skel->getCommands(), copy->getCommands()));
+  EXPECT_TRUE(equals(other->getCommands(), otherCopy->getCommands()));
+  checkMatchingKinematics(skel, copy);
+  checkMatchingKinematics(other, otherCopy);
+}
+
 int main(int argc, char* argv[])
 {
   ::testing::InitGoogleTest(&argc, argv);
@@ -41,10 +41,14 @@
 
 #include "dart/math/Geometry.h"
 #include "dart/utils/SkelParser.h"
+#include "dart/collision/dart/DARTCollisionDetector.h"
+#include "dart/constraint/BlockPGSLCPSolver.h"
 #include "dart/dynamics/BodyNode.h"
 #include "dart/dynamics/RevoluteJoint.h"
 #include "dart/dynamics/Skeleton.h"
 #include "dart/simulation/World.h"
+#include "dart/simulation/WorldBatch.h"
+#include "dart/simulation/WorldSnapshot.h"
 
 using namespace dart;
 using namespace math;
@@ -259,6 +263,444 @@ TEST(World, Cloning)
   }
 }
 
+//==============================================================================
+TEST(World, ParallelStepping)
+{
+  // Boxes falling on the ground form independent skeletons and constrained
+  // groups, which are stepped in parallel
+  WorldPtr serialWorld(new World);
+  serialWorld->setGravity(Eigen::Vector3d(0.0, -9.81, 0.0));
+  serialWorld->setTimeStep(0.001);
+
+  for (size_t i = 0; i < 8; ++i)
+  {
+    SkeletonPtr box = createBox(Eigen::Vector3d(0.2, 0.2, 0.2),
+                                Eigen::Vector3d(0.5 * i, 0.2 + 0.05 * i, 0.0),
+                                Eigen::Vector3d(0.1 * i, 0.0, 0.2));
+    serialWorld->addSkeleton(box);
+  }
+
+  SkeletonPtr ground = createGround(Eigen::Vector3d(10.0, 0.1, 10.0),
+                                    Eigen::Vector3d(0.0, -0.05, 0.0));
+  ground->setMobile(false);
+  serialWorld->addSkeleton(ground);
+
+  WorldPtr parallelWorld = serialWorld->clone();
+  parallelWorld->setNumThreads(4);
+  for (size_t i = 0; i < serialWorld->getNumSkeletons(); ++i)
+  {
+    parallelWorld->getSkeleton(i)->setPositions(
+          serialWorld->getSkeleton(i)->getPositions());
+  }
+  EXPECT_EQ(serialWorld->getNumThreads(), 1u);
+  EXPECT_EQ(parallelWorld->getNumThreads(), 4u);
+
+  for (size_t i = 0; i < 500; ++i)
+  {
+    serialWorld->step();
+    parallelWorld->step();
+  }
+
+  // The results don't depend on the number of threads
+  for (size_t i = 0; i < serialWorld->getNumSkeletons(); ++i)
+  {
+    SkeletonPtr serialSkel = serialWorld->getSkeleton(i);
+    SkeletonPtr parallelSkel = parallelWorld->getSkeleton(i);
+
+    EXPECT_TRUE(equals(serialSkel->getPositions(),
+                       parallelSkel->getPositions(), 0));
+    EXPECT_TRUE(equals(serialSkel->getVelocities(),
+                       parallelSkel->getVelocities(), 0));
+  }
+}
+
+//==============================================================================
+TEST(World, Batch)
+{
+  WorldPtr world(new World);
+  world->setGravity(Eigen::Vector3d(0.0, -9.81, 0.0));
+  world->setTimeStep(0.001);
+
+  SkeletonPtr box = createBox(Eigen::Vector3d(0.2, 0.2, 0.2),
+                              Eigen::Vector3d(0.0, 0.5, 0.0));
+  world->addSkeleton(box);
+
+  SkeletonPtr ground = createGround(Eigen::Vector3d(10.0, 0.1, 10.0),
+                                    Eigen::Vector3d(0.0, -0.05, 0.0));
+  ground->setMobile(false);
+  world->addSkeleton(ground);
+
+  const size_t numWorlds = 4;
+  WorldBatch batch(world, numWorlds);
+  batch.setNumThreads(2);
+  EXPECT_EQ(batch.getNumWorlds(), numWorlds);
+  EXPECT_EQ(batch.getNumDofs(), world->getSkeleton(0)->getNumDofs()
+                                + world->getSkeleton(1)->getNumDofs());
+  EXPECT_EQ(batch.getStateSize(), 2 * batch.getNumDofs());
+
+  // Drop the box from a different height in each world
+  Eigen::MatrixXd states = batch.getStates();
+  for (size_t i = 0; i < numWorlds; ++i)
+    states(4, i) = 0.5 + 0.1 * i;
+
+  for (size_t rollout = 0; rollout < 2; ++rollout)
+  {
+    batch.setStates(states);
+    EXPECT_TRUE(equals(batch.getStates(), states, 0));
+
+    for (size_t i = 0; i < 500; ++i)
+      batch.step();
+  }
+
+  // Each world matches a single world stepped from the same state
+  const Eigen::MatrixXd positions = batch.getPositions();
+  const Eigen::MatrixXd velocities = batch.getVelocities();
+  const std::vector<size_t> numContacts = batch.getNumContacts();
+  size_t totalContacts = 0;
+  for (size_t i = 0; i < numWorlds; ++i)
+  {
+    WorldPtr single = world->clone();
+    single->getSkeleton(0)->setPositions(states.col(i).head(6));
+    single->getSkeleton(0)->setVelocities(Eigen::Vector6d::Zero());
+    for (size_t j = 0; j < 500; ++j)
+      single->step();
+
+    EXPECT_TRUE(equals(positions.col(i).head(6).eval(),
+                       single->getSkeleton(0)->getPositions(), 0));
+    EXPECT_TRUE(equals(velocities.col(i).head(6).eval(),
+                       single->getSkeleton(0)->getVelocities(), 0));
+    EXPECT_GT(numContacts[i], 0u);
+    totalContacts += numContacts[i];
+  }
+  EXPECT_EQ(batch.getContacts().size(), totalContacts);
+}
+
+//==============================================================================
+TEST(World, BatchReset)
+{
+  WorldPtr world(new World);
+  world->setGravity(Eigen::Vector3d(0.0, -9.81, 0.0));
+  world->setTimeStep(0.001);
+
+  // A box that sinks slightly into the ground, so that it is in contact from
+  // the first step and the contacts at the end of an episode match the ones at
+  // the start of the next
+  SkeletonPtr box = createBox(Eigen::Vector3d(0.2, 0.2, 0.2),
+                              Eigen::Vector3d(0.0, 0.099, 0.0));
+  world->addSkeleton(box);
+
+  SkeletonPtr ground = createGround(Eigen::Vector3d(10.0, 0.1, 10.0),
+                                    Eigen::Vector3d(0.0, -0.05, 0.0));
+  ground->setMobile(false);
+  world->addSkeleton(ground);
+
+  const size_t numWorlds = 2;
+  WorldBatch batch(world, numWorlds);
+
+  // PGS uses the impulses of the last step as its initial guesses
+  for (size_t i = 0; i < numWorlds; ++i)
+  {
+    constraint::ConstraintSolver* solver
+        = batch.getWorld(i)->getConstraintSolver();
+    solver->setCollisionDetector(new collision::DARTCollisionDetector());
+
+    constraint::BlockPGSLCPSolver* lcpSolver
+        = new constraint::BlockPGSLCPSolver(world->getTimeStep());
+    lcpSolver->setMaxIterations(5);
+    solver->setLCPSolver(lcpSolver);
+  }
+
+  Eigen::MatrixXd states = batch.getStates();
+  states.row(batch.getNumDofs() + 3).setConstant(0.5);
+
+  // Every episode from the same states gives the same results
+  Eigen::MatrixXd positions;
+  Eigen::MatrixXd velocities;
+  for (size_t episode = 0; episode < 3; ++episode)
+  {
+    batch.setStates(states);
+    EXPECT_EQ(batch.getWorld(0)->getTime(), 0.0);
+
+    for (size_t i = 0; i < 200; ++i)
+      batch.step();
+
+    if (episode == 0)
+    {
+      positions = batch.getPositions();
+      velocities = batch.getVelocities();
+      continue;
+    }
+
+    EXPECT_TRUE(equals(batch.getPositions(), positions, 0));
+    EXPECT_TRUE(equals(batch.getVelocities(), velocities, 0));
+  }
+}
+
+#ifdef DART_ENABLE_PROFILING
+//==============================================================================
+TEST(World, Profiling)
+{
+  WorldPtr world(new World);
+  world->setGravity(Eigen::Vector3d(0.0, -9.81, 0.0));
+  world->setTimeStep(0.001);
+
+  SkeletonPtr box = createBox(Eigen::Vector3d(0.2, 0.2, 0.2),
+                              Eigen::Vector3d(0.0, 0.09, 0.0));
+  world->addSkeleton(box);
+
+  SkeletonPtr ground = createGround(Eigen::Vector3d(10.0, 0.1, 10.0),
+                                    Eigen::Vector3d(0.0, -0.05, 0.0));
+  ground->setMobile(false);
+  world->addSkeleton(ground);
+
+  for (size_t i = 0; i < 10; ++i)
+    world->step();
+
+  const dart::common::Profiler* profiler = world->getProfiler();
+
+  // The box rests on the ground, which gives a single constrained group. Each
+  // contact adds three rows to the LCP.
+  const size_t numContacts
+      = profiler->getLastCount(dart::common::Profiler::NUM_CONTACTS);
+  EXPECT_EQ(profiler->getNumSteps(), 10u);
+  EXPECT_GT(numContacts, 0u);
+  EXPECT_EQ(profiler->getLastCount(
+              dart::common::Profiler::NUM_CONSTRAINED_GROUPS), 1u);
+  EXPECT_EQ(profiler->getLastCount(dart::common::Profiler::LCP_SIZE),
+            3u * numContacts);
+  EXPECT_GT(profiler->getAverageStepTime(), 0.0);
+
+  profiler->print();
+}
+#endif  // DART_ENABLE_PROFILING
+
+//==============================================================================
+TEST(World, Snapshot)
+{
+  WorldPtr world(new World);
+  world->setGravity(Eigen::Vector3d(0.0, -9.81, 0.0));
+  world->setTimeStep(0.001);
+
+  for (size_t i = 0; i < 3; ++i)
+  {
+    SkeletonPtr box = createBox(Eigen::Vector3d(0.2, 0.2, 0.2),
+                                Eigen::Vector3d(0.5 * i, 0.2 + 0.1 * i, 0.0),
+                                Eigen::Vector3d(0.1 * i, 0.0, 0.2));
+    world->addSkeleton(box);
+  }
+
+  SkeletonPtr ground = createGround(Eigen::Vector3d(10.0, 0.1, 10.0),
+                                    Eigen::Vector3d(0.0, -0.05, 0.0));
+  ground->setMobile(false);
+  world->addSkeleton(ground);
+
+  WorldSnapshot snapshot;
+  EXPECT_TRUE(snapshot.isEmpty());
+  EXPECT_FALSE(snapshot.restore(*world));
+
+  // Take the snapshot while the boxes are in contact with the ground
+  for (size_t i = 0; i < 300; ++i)
+    world->step();
+  snapshot.capture(*world);
+  EXPECT_FALSE(snapshot.isEmpty());
+
+  std::vector<Eigen::VectorXd> snapshotStates;
+  for (size_t i = 0; i < world->getNumSkeletons(); ++i)
+    snapshotStates.push_back(world->getSkeleton(i)->getState());
+
+  const double time = world->getTime();
+  const int frame = world->getSimFrames();
+  const size_t numContacts
+      = world->getConstraintSolver()->getCollisionDetector()->getNumContacts();
+  EXPECT_GT(numContacts, 0u);
+
+  std::vector<Eigen::VectorXd> states;
+  for (size_t i = 0; i < 200; ++i)
+  {
+    world->step();
+    for (size_t j = 0; j < world->getNumSkeletons(); ++j)
+      states.push_back(world->getSkeleton(j)->getState());
+  }
+
+  // Rolling back reproduces the same trajectory, including the warm started
+  // contacts, every time
+  for (size_t rollout = 0; rollout < 2; ++rollout)
+  {
+    EXPECT_TRUE(snapshot.restore(*world));
+    EXPECT_EQ(world->getTime(), time);
+    EXPECT_EQ(world->getSimFrames(), frame);
+    EXPECT_EQ(world->getConstraintSolver()->getCollisionDetector()
+              ->getNumContacts(), numContacts);
+
+    size_t index = 0;
+    for (size_t i = 0; i < 200; ++i)
+    {
+      world->step();
+      for (size_t j = 0; j < world->getNumSkeletons(); ++j)
+        EXPECT_TRUE(equals(world->getSkeleton(j)->getState(),
+                           states[index++], 0));
+    }
+  }
+
+  // The state can be restored to a world with the same structure
+  WorldPtr clone = world->clone();
+  EXPECT_TRUE(snapshot.restore(*clone));
+  EXPECT_EQ(clone->getTime(), time);
+  for (size_t i = 0; i < clone->getNumSkeletons(); ++i)
+  {
+    EXPECT_TRUE(equals(clone->getSkeleton(i)->getState(), snapshotStates[i],
+                       0));
+  }
+
+  // The contacts refer to the bodies of the captured world, so they are not
+  // restored to the clone
+  EXPECT_EQ(clone->getConstraintSolver()->getCollisionDetector()
+            ->getNumContacts(), 0u);
+
+  // nor to the captured world once one of its skeletons is replaced by
+  // another one with the same structure
+  SkeletonPtr replacement = ground->clone();
+  world->removeSkeleton(ground);
+  world->addSkeleton(replacement);
+  EXPECT_TRUE(snapshot.restore(*world));
+  EXPECT_EQ(world->getConstraintSolver()->getCollisionDetector()
+            ->getNumContacts(), 0u);
+  EXPECT_TRUE(equals(replacement->getState(), snapshotStates.back(), 0));
+
+  // but not to a world with a different structure
+  world->removeSkeleton(world->getSkeleton(0));
+  EXPECT_FALSE(snapshot.restore(*world));
+}
+
+//==============================================================================
+TEST(World, Sleeping)
+{
+  WorldPtr world(new World);
+  world->setGravity(Eigen::Vector3d(0.0, -9.81, 0.0));
+  world->setTimeStep(0.001);
+  EXPECT_FALSE(world->isSleepingEnabled());
+
+  SkeletonPtr box1 = createBox(Eigen::Vector3d(0.2, 0.2, 0.2),
+                               Eigen::Vector3d(0.0, 0.1, 0.0));
+  SkeletonPtr box2 = createBox(Eigen::Vector3d(0.2, 0.2, 0.2),
+                               Eigen::Vector3d(1.0, 0.1, 0.0));
+  world->addSkeleton(box1);
+  world->addSkeleton(box2);
+
+  SkeletonPtr ground = createGround(Eigen::Vector3d(10.0, 0.1, 10.0),
+                                    Eigen::Vector3d(0.0, -0.05, 0.0));
+  ground->setMobile(false);
+  world->addSkeleton(ground);
+
+  collision::CollisionDetector* detector
+      = world->getConstraintSolver()->getCollisionDetector();
+
+  // Resting skeletons don't sleep unless sleeping is enabled
+  for (size_t i = 0; i < 1000; ++i)
+    world->step();
+  EXPECT_FALSE(box1->isSleeping());
+
+  world->setSleepingEnabled(true);
+  world->setSleepTime(0.2);
+  for (size_t i = 0; i < 300; ++i)
+    world->step();
+  EXPECT_TRUE(box1->isSleeping());
+  EXPECT_TRUE(box2->isSleeping());
+  EXPECT_EQ(box1->getVelocities().norm(), 0.0);
+
+  // Sleeping skeletons are neither simulated nor checked for collision with
+  // immobile skeletons
+  const Eigen::VectorXd positions = box1->getPositions();
+  world->step();
+  EXPECT_TRUE(equals(box1->getPositions(), positions, 0));
+  EXPECT_EQ(detector->getNumContacts(), 0u);
+
+  // An external force wakes up a skeleton
+  box2->getBodyNode(0)->addExtForce(Eigen::Vector3d(10.0, 0.0, 0.0));
+  world->step();
+  EXPECT_FALSE(box2->isSleeping());
+  EXPECT_TRUE(box1->isSleeping());
+  EXPECT_GT(box2->getVelocities().norm(), 0.0);
+
+  // A contact with an awake skeleton wakes up a sleeping skeleton
+  SkeletonPtr box3 = createBox(Eigen::Vector3d(0.2, 0.2, 0.2),
+                               Eigen::Vector3d(0.0, 0.4, 0.0));
+  world->addSkeleton(box3);
+  bool isWokenUp = false;
+  for (size_t i = 0; i < 500 && !isWokenUp; ++i)
+  {
+    world->step();
+    isWokenUp = !box1->isSleeping();
+  }
+  EXPECT_TRUE(isWokenUp);
+
+  // The woken skeleton is supported by the ground in the same step
+  bool hasGroundContact = false;
+  for (size_t i = 0; i < detector->getNumContacts(); ++i)
+  {
+    const collision::Contact& contact = detector->getContact(i);
+    const SkeletonPtr skel1 = contact.bodyNode1.lock()->getSkeleton();
+    const SkeletonPtr skel2 = contact.bodyNode2.lock()->getSkeleton();
+    hasGroundContact = hasGroundContact
+        || (skel1 == box1 && skel2 == ground)
+        || (skel1 == ground && skel2 == box1);
+  }
+  EXPECT_TRUE(hasGroundContact);
+  EXPECT_GE(box1->getVelocities()[4], -1e-3);
+
+  // The stacked boxes go to sleep together once they settle down
+  for (size_t i = 0; i < 2000; ++i)
+    world->step();
+  EXPECT_TRUE(box1->isSleeping());
+  EXPECT_TRUE(box2->isSleeping());
+  EXPECT_TRUE(box3->isSleeping());
+  EXPECT_LT(box3->getPositions()[4], 0.31);
+
+  // Moving a sleeping skeleton wakes it up
+  Eigen::VectorXd lifted = box2->getPositions();
+  lifted[4] += 0.1;
+  box2->setPositions(lifted);
+  world->step();
+  EXPECT_FALSE(box2->isSleeping());
+  EXPECT_TRUE(box1->isSleeping());
+
+  // Removing the bottom box wakes up the box sleeping on it
+  world->removeSkeleton(box1);
+  EXPECT_FALSE(box3->isSleeping());
+
+  for (size_t i = 0; i < 2000; ++i)
+    world->step();
+  EXPECT_TRUE(box2->isSleeping());
+  EXPECT_TRUE(box3->isSleeping());
+  EXPECT_LT(box3->getPositions()[4], 0.11);
+
+  // Moving the immobile ground wakes up the skeletons sleeping on it
+  Eigen::Isometry3d groundTransform = Eigen::Isometry3d::Identity();
+  groundTransform.translation() = Eigen::Vector3d(0.0, -0.1, 0.0);
+  ground->getJoint(0)->setTransformFromParentBodyNode(groundTransform);
+  world->step();
+  EXPECT_FALSE(box2->isSleeping());
+  EXPECT_FALSE(box3->isSleeping());
+
+  for (size_t i = 0; i < 2000; ++i)
+    world->step();
+  EXPECT_TRUE(box2->isSleeping());
+  EXPECT_TRUE(box3->isSleeping());
+
+  // Changing the gravity wakes up every skeleton
+  world->setGravity(Eigen::Vector3d(1.0, -9.81, 0.0));
+  EXPECT_FALSE(box2->isSleeping());
+  EXPECT_FALSE(box3->isSleeping());
+
+  // Disabling sleeping wakes up every skeleton
+  for (size_t i = 0; i < 2000; ++i)
+    world->step();
+  EXPECT_TRUE(box3->isSleeping());
+  world->setSleepingEnabled(false);
+  EXPECT_FALSE(box2->isSleeping());
+  EXPECT_FALSE(box3->isSleeping());
+}
+
 //==============================================================================
 int main(int argc, char* argv[])
 {